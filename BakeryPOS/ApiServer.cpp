@@ -0,0 +1,503 @@
+#include "ApiServer.h"
+
+#include "BarcodeScanner.h"
+#include "CheckoutService.h"
+#include "DomainEvents.h"
+#include "LiveQueryModel.h"
+#include "PasswordHash.h"
+#include "ProductRecord.h"
+
+#include <QFutureWatcher>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QPointer>
+#include <QSet>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QTcpSocket>
+#include <QUrl>
+#include <QtConcurrent/QtConcurrentRun>
+#include <QDebug>
+
+// Columns of the catalog copy, as on the cashier page
+enum CatalogColumn { Id, Name, Category, Price, Unit, Stock, Barcode };
+
+// Opened by the order thread, which keeps it for the server's lifetime
+static const char *OrderConnection = "api_orders";
+
+static QByteArray toJson(const QJsonValue &value) {
+    return value.isArray() ? QJsonDocument(value.toArray()).toJson(QJsonDocument::Compact)
+                           : QJsonDocument(value.toObject()).toJson(QJsonDocument::Compact);
+}
+
+static ApiResponse errorResponse(int status, const QString &message) {
+    return {status, toJson(QJsonObject{{"error", message}})};
+}
+
+static QJsonObject batchEntry(const ApiResponse &response) {
+    QJsonDocument body = QJsonDocument::fromJson(response.body);
+    return QJsonObject{{"status", response.status},
+                       {"body", body.isArray() ? QJsonValue(body.array())
+                                               : QJsonValue(body.object())}};
+}
+
+static const char *reasonPhrase(int status) {
+    switch (status) {
+    case 200: return "OK";
+    case 201: return "Created";
+    case 400: return "Bad Request";
+    case 401: return "Unauthorized";
+    case 404: return "Not Found";
+    case 405: return "Method Not Allowed";
+    case 409: return "Conflict";
+    case 413: return "Payload Too Large";
+    case 431: return "Request Header Fields Too Large";
+    default: return "Internal Server Error";
+    }
+}
+
+ApiServer::ApiServer(int userId, QObject *parent) : QObject(parent), userId(userId) {
+    orderPool.setMaxThreadCount(1);
+    orderPool.setExpiryTimeout(-1);
+
+    catalog = new LiveQueryModel(this);
+    reloadCatalog();
+    barcodeIndex = new BarcodeIndex(catalog, Id, Barcode, this);
+    reloadPricing();
+
+    // Any change to the copy means the cached catalog JSON is stale
+    auto invalidate = [this]() { catalogJson.clear(); };
+    connect(catalog, &QAbstractItemModel::dataChanged, this, invalidate);
+    connect(catalog, &QAbstractItemModel::rowsInserted, this, invalidate);
+    connect(catalog, &QAbstractItemModel::rowsRemoved, this, invalidate);
+    connect(catalog, &QAbstractItemModel::modelReset, this, invalidate);
+
+    DomainEvents *events = DomainEvents::instance();
+    connect(events, &DomainEvents::productChanged, this,
+            [this](DomainEvents::ChangeType type, const QList<int> &ids) {
+                if (type == DomainEvents::Removed) {
+                    catalog->removeKeys(ids);
+                } else {
+                    catalog->refreshKeys(ids);
+                }
+            });
+    connect(events, &DomainEvents::catalogReloaded, this, &ApiServer::reloadCatalog);
+    connect(events, &DomainEvents::catalogReloaded, this, &ApiServer::reloadPricing);
+
+    connect(&server, &QTcpServer::newConnection, this, &ApiServer::onNewConnection);
+}
+
+ApiServer::~ApiServer() {
+    // The order connection is removed on the thread that opened it
+    orderPool.start([]() {
+        if (QSqlDatabase::contains(OrderConnection)) {
+            QSqlDatabase::removeDatabase(OrderConnection);
+        }
+    });
+    orderPool.waitForDone();
+}
+
+bool ApiServer::listen(const QHostAddress &address, quint16 port) {
+    // Anyone on the network could place orders without one
+    if (!address.isLoopback() && token.isEmpty()) {
+        qDebug() << "API server not started: listening on" << address.toString()
+                 << "needs api/token to be set";
+        return false;
+    }
+
+    if (!server.listen(address, port)) {
+        qDebug() << "API server cannot listen on" << address.toString() << port << ":"
+                 << server.errorString();
+        return false;
+    }
+    qDebug() << "API server listening on" << address.toString() << server.serverPort();
+    return true;
+}
+
+void ApiServer::reloadCatalog() {
+    catalog->setQuery(QString("SELECT ProductID, Name, Category, %1 AS Price, UnitType, "
+                              "StockQuantity, Barcode FROM products "
+                              "WHERE status = 'Available' "
+                              "ORDER BY Name")
+                          .arg(ProductRecord::SellingPriceSql),
+                      "ProductID");
+    catalogJson.clear();
+}
+
+void ApiServer::reloadPricing() {
+    pricing.load();
+    pricingDate = QDate::currentDate();
+}
+
+void ApiServer::onNewConnection() {
+    while (QTcpSocket *socket = server.nextPendingConnection()) {
+        buffers.insert(socket, QByteArray());
+        connect(socket, &QTcpSocket::readyRead, this, &ApiServer::onReadyRead);
+        connect(socket, &QTcpSocket::disconnected, this, [this, socket]() {
+            buffers.remove(socket);
+            writing.remove(socket);
+            socket->deleteLater();
+        });
+    }
+}
+
+void ApiServer::onReadyRead() {
+    QTcpSocket *socket = qobject_cast<QTcpSocket *>(sender());
+    if (!socket || !buffers.contains(socket)) { return; }
+
+    buffers[socket] += socket->readAll();
+    if (!writing.contains(socket)) { processBuffer(socket); }
+}
+
+void ApiServer::processBuffer(QTcpSocket *socket) {
+    QByteArray buffer = buffers.value(socket);
+
+    // Pipelined requests are answered in the order they arrived
+    for (;;) {
+        ApiRequest request;
+        int        status = takeRequest(buffer, &request);
+        if (status == 0) { break; }
+
+        if (status != 200) {
+            buffers.remove(socket);
+            write(socket, errorResponse(status, reasonPhrase(status)), false);
+            return;
+        }
+
+        QVector<ApiOrder> orders;
+        ApiResponse       response = handle(request, &orders);
+        if (orders.isEmpty()) {
+            write(socket, response, request.keepAlive);
+            if (!request.keepAlive) {
+                buffers.remove(socket);
+                return;
+            }
+            continue;
+        }
+
+        // The rest of this connection's requests wait for the orders
+        buffers.insert(socket, buffer);
+        writing.insert(socket);
+
+        const bool           keepAlive = request.keepAlive;
+        QPointer<QTcpSocket> client(socket);
+        auto                *watcher = new QFutureWatcher<QVector<ApiOrder>>(this);
+        connect(watcher, &QFutureWatcherBase::finished, this,
+                [this, watcher, client, response, keepAlive]() {
+                    ApiResponse done = completeOrders(response, watcher->result());
+                    watcher->deleteLater();
+                    if (!client || !buffers.contains(client)) { return; } // disconnected
+
+                    writing.remove(client);
+                    write(client, done, keepAlive);
+                    if (!keepAlive) {
+                        buffers.remove(client);
+                        return;
+                    }
+                    processBuffer(client);
+                });
+        watcher->setFuture(QtConcurrent::run(&orderPool, [orders, user = userId]() mutable {
+            writeOrders(orders, user, OrderConnection);
+            return orders;
+        }));
+        return;
+    }
+    buffers.insert(socket, buffer);
+}
+
+int ApiServer::takeRequest(QByteArray &buffer, ApiRequest *request) {
+    int headerEnd = buffer.indexOf("\r\n\r\n");
+    if (headerEnd < 0) { return buffer.size() > MaxHeaderBytes ? 431 : 0; }
+    if (headerEnd > MaxHeaderBytes) { return 431; }
+
+    QList<QByteArray> lines = buffer.left(headerEnd).split('\n');
+    QList<QByteArray> start = lines.first().trimmed().split(' ');
+    if (start.size() != 3 || !start.at(2).startsWith("HTTP/1.")) { return 400; }
+
+    for (int i = 1; i < lines.size(); ++i) {
+        int colon = lines.at(i).indexOf(':');
+        if (colon <= 0) { return 400; }
+        request->headers.insert(lines.at(i).left(colon).trimmed().toLower(),
+                                lines.at(i).mid(colon + 1).trimmed());
+    }
+
+    bool ok     = true;
+    int  length = request->headers.value("content-length", "0").toInt(&ok);
+    if (!ok || length < 0) { return 400; }
+    if (length > MaxBodyBytes) { return 413; }
+    if (buffer.size() < headerEnd + 4 + length) { return 0; }
+
+    QUrl url        = QUrl::fromEncoded(start.at(1));
+    request->method = start.at(0);
+    request->path   = url.path();
+    request->query  = QUrlQuery(url);
+    request->body   = buffer.mid(headerEnd + 4, length);
+
+    // HTTP/1.1 connections stay open unless asked otherwise, 1.0 the reverse
+    QByteArray connection = request->headers.value("connection").toLower();
+    request->keepAlive    = start.at(2) == "HTTP/1.1" ? connection != "close"
+                                                      : connection == "keep-alive";
+
+    buffer.remove(0, headerEnd + 4 + length);
+    return 200;
+}
+
+void ApiServer::write(QTcpSocket *socket, const ApiResponse &response, bool keepAlive) {
+    QByteArray head = "HTTP/1.1 " + QByteArray::number(response.status) + " " +
+                      reasonPhrase(response.status) +
+                      "\r\nContent-Type: application/json"
+                      "\r\nContent-Length: " +
+                      QByteArray::number(response.body.size()) +
+                      "\r\nConnection: " + (keepAlive ? "keep-alive" : "close") + "\r\n\r\n";
+    socket->write(head + response.body);
+
+    // Closes once the response has been sent
+    if (!keepAlive) { socket->disconnectFromHost(); }
+}
+
+ApiResponse ApiServer::handle(const ApiRequest &request, QVector<ApiOrder> *orders) {
+    if (!token.isEmpty() &&
+        !PasswordHash::constantTimeEquals(request.headers.value("authorization"),
+                                          "Bearer " + token)) {
+        return errorResponse(401, "Missing or wrong API token.");
+    }
+    return route(request.method, request.path, request.query, request.body, orders);
+}
+
+void ApiServer::writeOrders(QVector<ApiOrder> &orders, int userId,
+                            const QString &connectionName) {
+    // Connections belong to the thread that opened them; the pool's one
+    // thread opens this copy of the default connection once
+    if (!QSqlDatabase::contains(connectionName)) {
+        QSqlDatabase::cloneDatabase(QSqlDatabase::defaultConnection, connectionName);
+    }
+    QSqlDatabase db = QSqlDatabase::database(connectionName);
+    for (ApiOrder &order : orders) {
+        if (!db.isOpen()) {
+            order.error = db.lastError().text();
+            continue;
+        }
+        order.orderId = CheckoutService::submit(order.lines, order.totals, userId, order.payment,
+                                                &order.error, connectionName);
+    }
+}
+
+ApiResponse ApiServer::completeOrders(const ApiResponse        &response,
+                                      const QVector<ApiOrder> &orders) {
+    auto orderResponse = [](const ApiOrder &order) -> ApiResponse {
+        if (order.orderId < 0) {
+            return errorResponse(500, "Failed to save order: " + order.error);
+        }
+        QJsonObject result = order.result;
+        result.insert("orderId", order.orderId);
+        return {201, toJson(result)};
+    };
+
+    // Stock changed: the cashier page and this catalog pick it up
+    QSet<int> sold;
+    for (const ApiOrder &order : orders) {
+        if (order.orderId < 0) { continue; }
+        for (const CheckoutLine &line : order.lines) { sold.insert(line.productId); }
+    }
+    if (!sold.isEmpty()) {
+        DomainEvents::instance()->publishProductChange(DomainEvents::Updated, sold.values());
+    }
+
+    if (orders.size() == 1 && orders.first().batchEntry < 0) {
+        return orderResponse(orders.first());
+    }
+
+    // A batch: each order's entry was left for it
+    QJsonArray responses = QJsonDocument::fromJson(response.body).array();
+    for (const ApiOrder &order : orders) {
+        responses[order.batchEntry] = batchEntry(orderResponse(order));
+    }
+    return {response.status, toJson(responses)};
+}
+
+ApiResponse ApiServer::route(const QByteArray &method, const QString &path,
+                             const QUrlQuery &query, const QByteArray &body,
+                             QVector<ApiOrder> *orders) {
+    const bool get  = method == "GET";
+    const bool post = method == "POST";
+
+    if (path == "/api/health") {
+        if (!get) { return errorResponse(405, "Use GET."); }
+        return {200, toJson(QJsonObject{{"status", "ok"},
+                                        {"products", catalog->rowCount()},
+                                        {"promotions", pricing.ruleCount()}})};
+    }
+
+    if (path == "/api/products") {
+        if (!get) { return errorResponse(405, "Use GET."); }
+
+        QString code = query.queryItemValue("barcode");
+        if (code.isEmpty()) { return products(); }
+
+        BarcodeMatch match = barcodeIndex->match(code);
+        int          row   = match.isValid() ? catalog->rowForKey(match.productId) : -1;
+        if (row < 0) { return errorResponse(404, "Unknown barcode: " + code); }
+        return product(row);
+    }
+
+    if (path.startsWith("/api/products/")) {
+        if (!get) { return errorResponse(405, "Use GET."); }
+
+        bool ok        = false;
+        int  productId = path.mid(int(qstrlen("/api/products/"))).toInt(&ok);
+        int  row       = ok ? catalog->rowForKey(productId) : -1;
+        if (row < 0) { return errorResponse(404, "No such product."); }
+        return product(row);
+    }
+
+    if (path == "/api/cart/price" || path == "/api/orders") {
+        if (!post) { return errorResponse(405, "Use POST."); }
+        return priceCart(body, path == "/api/orders" ? orders : nullptr);
+    }
+
+    if (path == "/api/batch") {
+        if (!post) { return errorResponse(405, "Use POST."); }
+        return batch(body, orders);
+    }
+
+    return errorResponse(404, "No such endpoint.");
+}
+
+QJsonObject ApiServer::productJson(int catalogRow) const {
+    auto value = [this, catalogRow](int column) {
+        return catalog->data(catalog->index(catalogRow, column));
+    };
+    return QJsonObject{{"id", value(Id).toInt()},
+                       {"name", value(Name).toString()},
+                       {"category", value(Category).toString()},
+                       {"price", Money::fromVariant(value(Price)).toDecimalString()},
+                       {"unit", value(Unit).toString()},
+                       {"stock", value(Stock).toDouble()},
+                       {"barcode", value(Barcode).toString()}};
+}
+
+ApiResponse ApiServer::products() {
+    // Built once per catalog change, not per request
+    if (catalogJson.isEmpty()) {
+        QJsonArray items;
+        for (int row = 0; row < catalog->rowCount(); ++row) { items.append(productJson(row)); }
+        catalogJson = toJson(items);
+    }
+    return {200, catalogJson};
+}
+
+ApiResponse ApiServer::product(int catalogRow) { return {200, toJson(productJson(catalogRow))}; }
+
+// Without orders the cart is only priced; with it, the order is queued
+// there and its response filled in once written
+ApiResponse ApiServer::priceCart(const QByteArray &body, QVector<ApiOrder> *orders) {
+    const bool submit = orders != nullptr;
+
+    QJsonDocument document = QJsonDocument::fromJson(body);
+    if (!document.isObject()) { return errorResponse(400, "Expected a JSON object."); }
+
+    QJsonObject order = document.object();
+    QJsonArray  items = order.value("lines").toArray();
+    if (items.isEmpty()) { return errorResponse(400, "The order has no lines."); }
+
+    // Rules are compiled for one day's date range
+    if (pricingDate != QDate::currentDate()) { reloadPricing(); }
+
+    // The same product twice becomes one line, as in the cashier's cart
+    QVector<CheckoutLine> lines;
+    QHash<int, int>       indexForProduct;
+    for (const QJsonValue &item : items) {
+        int    productId = item.toObject().value("productId").toInt();
+        qint64 quantity  = quantityToMilli(item.toObject().value("quantity").toDouble(1.0));
+        if (quantity <= 0) {
+            return errorResponse(400, QString("Invalid quantity for product %1.").arg(productId));
+        }
+
+        int row = catalog->rowForKey(productId);
+        if (row < 0) {
+            return errorResponse(409, QString("Product %1 is not available.").arg(productId));
+        }
+        auto value = [this, row](int column) { return catalog->data(catalog->index(row, column)); };
+        if (submit && value(Stock).toDouble() <= 0) {
+            return errorResponse(409, value(Name).toString() + " is out of stock.");
+        }
+
+        auto existing = indexForProduct.constFind(productId);
+        if (existing != indexForProduct.constEnd()) {
+            lines[existing.value()].quantityMilli += quantity;
+            continue;
+        }
+
+        CheckoutLine line;
+        line.productId     = productId;
+        line.category      = value(Category).toString();
+        line.quantityMilli = quantity;
+        line.unitPrice     = Money::fromVariant(value(Price));
+        indexForProduct.insert(productId, lines.size());
+        lines.append(line);
+    }
+
+    CheckoutTotals totals = CheckoutService::price(pricing, lines);
+
+    QJsonArray priced;
+    for (const CheckoutLine &line : lines) {
+        QString promotion = pricing.promotionName(line.price.promotionId);
+        priced.append(QJsonObject{{"productId", line.productId},
+                                  {"quantity", line.quantityMilli / 1000.0},
+                                  {"unitPrice", line.unitPrice.toDecimalString()},
+                                  {"gross", line.price.gross.toDecimalString()},
+                                  {"discount", line.price.discount.toDecimalString()},
+                                  {"promotion", promotion.isEmpty() ? QJsonValue()
+                                                                    : QJsonValue(promotion)},
+                                  {"net", line.price.net().toDecimalString()}});
+    }
+
+    QJsonObject result{{"lines", priced},
+                       {"discounts", totals.discounts.toDecimalString()},
+                       {"subtotal", totals.subtotal.toDecimalString()},
+                       {"tax", totals.tax.toDecimalString()},
+                       {"total", totals.total.toDecimalString()}};
+    if (!submit) { return {200, toJson(result)}; }
+
+    ApiOrder pending;
+    pending.lines   = lines;
+    pending.totals  = totals;
+    pending.payment = order.value("payment").toString("Online");
+    pending.result  = result;
+    orders->append(pending);
+    return {201, QByteArray()};
+}
+
+ApiResponse ApiServer::batch(const QByteArray &body, QVector<ApiOrder> *orders) {
+    QJsonDocument document = QJsonDocument::fromJson(body);
+    if (!document.isArray()) { return errorResponse(400, "Expected a JSON array."); }
+
+    QJsonArray requests = document.array();
+    if (requests.size() > MaxBatch) {
+        return errorResponse(413, QString("At most %1 requests per batch.").arg(MaxBatch));
+    }
+
+    // Each entry is routed as if it had been sent on its own
+    QJsonArray responses;
+    for (const QJsonValue &entry : requests) {
+        QJsonObject request = entry.toObject();
+        QUrl        url(request.value("path").toString());
+
+        ApiResponse response;
+        const int   queued = orders->size();
+        if (url.path() == "/api/batch") {
+            response = errorResponse(400, "Batches cannot be nested.");
+        } else {
+            QJsonValue requestBody = request.value("body");
+            response = route(request.value("method").toString("GET").toUtf8(), url.path(),
+                             QUrlQuery(url),
+                             requestBody.isUndefined() ? QByteArray() : toJson(requestBody),
+                             orders);
+        }
+
+        // An order's entry is filled in once it is written
+        if (orders->size() > queued) { orders->last().batchEntry = responses.size(); }
+        responses.append(batchEntry(response));
+    }
+    return {200, toJson(responses)};
+}
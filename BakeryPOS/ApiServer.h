@@ -0,0 +1,133 @@
+#ifndef APISERVER_H
+#define APISERVER_H
+
+#include <QByteArray>
+#include <QDate>
+#include <QHash>
+#include <QHostAddress>
+#include <QJsonObject>
+#include <QObject>
+#include <QSet>
+#include <QTcpServer>
+#include <QThreadPool>
+#include <QUrlQuery>
+
+#include "CheckoutService.h"
+#include "PricingEngine.h"
+
+class QTcpSocket;
+class BarcodeIndex;
+class LiveQueryModel;
+
+struct ApiRequest {
+    QByteArray                    method;
+    QString                       path;
+    QUrlQuery                     query;
+    QHash<QByteArray, QByteArray> headers; // names in lower case
+    QByteArray                    body;
+    bool                          keepAlive = true;
+};
+
+struct ApiResponse {
+    int        status = 200;
+    QByteArray body; // JSON
+};
+
+// An order priced on the UI thread, waiting to be written on the worker
+struct ApiOrder {
+    QVector<CheckoutLine> lines;
+    CheckoutTotals        totals;
+    QString               payment;
+    QJsonObject           result;          // the priced cart; orderId is added
+    int                   batchEntry = -1; // its place in a batch response
+    int                   orderId    = -1;
+    QString               error;
+};
+
+// HTTP/JSON service for online orders and self-service kiosks.
+//
+//   GET  /api/health
+//   GET  /api/products               whole catalog
+//   GET  /api/products/<id>
+//   GET  /api/products?barcode=<code>
+//   POST /api/cart/price   {"lines": [{"productId": 1, "quantity": 2}]}
+//   POST /api/orders       same, plus optional "payment"
+//   POST /api/batch        [{"method": "GET", "path": "...", "body": {...}}]
+//
+// Runs on the UI thread's event loop: sockets are read as data arrives and
+// pipelined requests on one connection are answered in order, so a slow
+// client never holds up the others. Catalog reads come from an in-memory
+// copy kept in step through DomainEvents, the same way the cashier page's
+// is, and the catalog JSON is only rebuilt after it changes.
+//
+// Orders are priced on the UI thread and go through CheckoutService like
+// the cashier's, but are written by one worker thread on its own
+// connection, one at a time, so the till never waits on the database for
+// an API order. A connection's later requests wait until its orders are
+// written; orders in a batch are written after its other entries.
+//
+// Listens on localhost unless another address is configured; any other
+// address needs a token. When a token is set, requests must send
+// "Authorization: Bearer <token>". Prices are per kg for weighed products,
+// as on the cashier page.
+class ApiServer : public QObject {
+    Q_OBJECT
+
+  public:
+    explicit ApiServer(int userId, QObject *parent = nullptr);
+    ~ApiServer() override;
+
+    // Port 0 picks a free port; port() says which
+    bool    listen(const QHostAddress &address, quint16 port);
+    quint16 port() const { return server.serverPort(); }
+    void    setToken(const QString &token) { this->token = token.toUtf8(); }
+
+    // Orders found in the request are added to orders, unwritten; their
+    // entries in the response are filled in by completeOrders()
+    ApiResponse handle(const ApiRequest &request, QVector<ApiOrder> *orders);
+
+    // Writes orders on the calling thread's connection connectionName
+    static void writeOrders(QVector<ApiOrder> &orders, int userId,
+                            const QString &connectionName);
+    ApiResponse completeOrders(const ApiResponse &response, const QVector<ApiOrder> &orders);
+
+  private slots:
+    void onNewConnection();
+    void onReadyRead();
+    void reloadCatalog();
+    void reloadPricing();
+
+  private:
+    static constexpr int MaxHeaderBytes = 16 * 1024;
+    static constexpr int MaxBodyBytes   = 1024 * 1024;
+    static constexpr int MaxBatch       = 100;
+
+    QTcpServer                      server;
+    QHash<QTcpSocket *, QByteArray> buffers; // bytes not yet parsed, per connection
+    QSet<QTcpSocket *>              writing; // connections waiting on their orders
+    QThreadPool                     orderPool; // one thread, which keeps its connection
+    LiveQueryModel                 *catalog      = nullptr;
+    BarcodeIndex                   *barcodeIndex = nullptr;
+    QByteArray                      catalogJson; // empty when it needs rebuilding
+    PricingEngine                   pricing;
+    QDate                           pricingDate;
+    QByteArray                      token;
+    int                             userId; // recorded on submitted orders
+
+    // Takes one complete request off the front of buffer. Returns 0 when
+    // more data is needed, 200 for a request, or the HTTP error status.
+    static int  takeRequest(QByteArray &buffer, ApiRequest *request);
+    static void write(QTcpSocket *socket, const ApiResponse &response, bool keepAlive);
+
+    void        processBuffer(QTcpSocket *socket);
+    ApiResponse route(const QByteArray &method, const QString &path, const QUrlQuery &query,
+                      const QByteArray &body, QVector<ApiOrder> *orders);
+    ApiResponse products();
+    ApiResponse product(int catalogRow);
+    ApiResponse priceCart(const QByteArray &body, QVector<ApiOrder> *orders);
+    ApiResponse batch(const QByteArray &body, QVector<ApiOrder> *orders);
+
+    QJsonObject productJson(int catalogRow) const;
+};
+
+#endif // APISERVER_H
@@ -1,4 +1,4 @@
-QT       += core gui sql printsupport
+QT       += core gui sql printsupport serialport concurrent network
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
@@ -8,10 +8,22 @@ CONFIG += c++17
 # In order to do so, uncomment the following line.
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
+# Logic without widgets, shared with the tools under tools/
+include(core.pri)
+
 SOURCES += \
+    ApiServer.cpp \
+    BarcodeScanner.cpp \
     Dashboard.cpp \
     EditProductForm.cpp \
     EditUserForm.cpp \
+    InventoryMonitor.cpp \
+    OrderHistoryForm.cpp \
+    PinSwitchDialog.cpp \
+    ReceiptWidget.cpp \
+    SalesChart.cpp \
+    ScaleReader.cpp \
+    ZReport.cpp \
     analyticsform.cpp \
     cashierform.cpp \
     editcategoryform.cpp \
@@ -20,9 +32,18 @@ SOURCES += \
     CustomTableDelegate.cpp
 
 HEADERS += \
+    ApiServer.h \
+    BarcodeScanner.h \
     Dashboard.h \
     EditProductForm.h \
     EditUserForm.h \
+    InventoryMonitor.h \
+    OrderHistoryForm.h \
+    PinSwitchDialog.h \
+    ReceiptWidget.h \
+    SalesChart.h \
+    ScaleReader.h \
+    ZReport.h \
     analyticsform.h \
     cashierform.h \
     editcategoryform.h \
@@ -53,5 +74,6 @@ DISTFILES += \
     fonts/Poppins-Regular.ttf \
     fonts/Poppins-SemiBold.ttf \
     fonts/Poppins-SemiBoldItalic.ttf \
-    icons/search.png
+    icons/search.png \
+    sim/scale_sample.txt
 
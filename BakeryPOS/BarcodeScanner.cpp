@@ -0,0 +1,197 @@
+#include "BarcodeScanner.h"
+
+#include <QAbstractItemModel>
+#include <QApplication>
+#include <QKeyEvent>
+#include <QTimer>
+#include <QWidget>
+#include <QDebug>
+
+BarcodeIndex::BarcodeIndex(QAbstractItemModel *model, int idColumn,
+                           int codeColumn, QObject *parent)
+    : QObject(parent), model(model), idColumn(idColumn), codeColumn(codeColumn) {
+    connect(model, &QAbstractItemModel::modelReset, this, &BarcodeIndex::rebuild);
+    connect(model, &QAbstractItemModel::layoutChanged, this, &BarcodeIndex::rebuild);
+    connect(model, &QAbstractItemModel::rowsInserted, this,
+            [this](const QModelIndex &, int first, int last) { indexRows(first, last); });
+    connect(model, &QAbstractItemModel::rowsAboutToBeRemoved, this,
+            [this](const QModelIndex &, int first, int last) { dropRows(first, last); });
+    connect(model, &QAbstractItemModel::dataChanged, this,
+            [this](const QModelIndex &topLeft, const QModelIndex &bottomRight) {
+                indexRows(topLeft.row(), bottomRight.row());
+            });
+    rebuild();
+}
+
+BarcodeMatch BarcodeIndex::match(const QString &code) const {
+    BarcodeMatch result;
+
+    auto plain = productForCode.constFind(code);
+    if (plain != productForCode.constEnd()) {
+        result.kind      = BarcodeMatch::Plain;
+        result.productId = plain.value();
+        return result;
+    }
+
+    // Scale label: 2 + type digit + 5 digit PLU + 5 digit value + check
+    if (code.size() != 13 || code.at(0) != QLatin1Char('2') ||
+        !hasValidEan13CheckDigit(code)) {
+        return result;
+    }
+
+    QChar type = code.at(1);
+    if (type != QLatin1Char(WeightPrefix) && type != QLatin1Char(PricePrefix)) {
+        return result;
+    }
+
+    int productId = productForCode.value(code.mid(2, 5), -1);
+    if (productId < 0) { return result; }
+
+    result.kind      = type == QLatin1Char(WeightPrefix) ? BarcodeMatch::Weight
+                                                         : BarcodeMatch::Price;
+    result.productId = productId;
+    result.value     = code.mid(7, 5).toLongLong();
+    return result;
+}
+
+bool BarcodeIndex::hasValidEan13CheckDigit(const QString &code) {
+    if (code.size() != 13) { return false; }
+
+    int sum = 0;
+    for (int i = 0; i < 13; ++i) {
+        if (!code.at(i).isDigit()) { return false; }
+    }
+    for (int i = 0; i < 12; ++i) {
+        int digit = code.at(i).digitValue();
+        sum += (i % 2 == 0) ? digit : digit * 3;
+    }
+    return (10 - sum % 10) % 10 == code.at(12).digitValue();
+}
+
+void BarcodeIndex::rebuild() {
+    productForCode.clear();
+    codeForProduct.clear();
+    if (model->rowCount() > 0) { indexRows(0, model->rowCount() - 1); }
+    qDebug() << "Barcode index holds" << productForCode.size() << "codes";
+}
+
+void BarcodeIndex::indexRows(int first, int last) {
+    for (int row = first; row <= last; ++row) {
+        int     productId = model->index(row, idColumn).data().toInt();
+        QString code      = model->index(row, codeColumn).data().toString().trimmed();
+
+        // Forget the old code if the product was relabelled
+        QString previous = codeForProduct.value(productId);
+        if (!previous.isEmpty() && previous != code &&
+            productForCode.value(previous) == productId) {
+            productForCode.remove(previous);
+        }
+
+        if (code.isEmpty()) {
+            codeForProduct.remove(productId);
+            continue;
+        }
+        productForCode.insert(code, productId);
+        codeForProduct.insert(productId, code);
+    }
+}
+
+void BarcodeIndex::dropRows(int first, int last) {
+    for (int row = first; row <= last; ++row) {
+        int     productId = model->index(row, idColumn).data().toInt();
+        QString code      = codeForProduct.take(productId);
+        if (!code.isEmpty() && productForCode.value(code) == productId) {
+            productForCode.remove(code);
+        }
+    }
+}
+
+BarcodeWedgeFilter::BarcodeWedgeFilter(QWidget *scope, QObject *parent)
+    : QObject(parent), scope(scope), gapTimer(new QTimer(this)) {
+    gapTimer->setSingleShot(true);
+    gapTimer->setInterval(burstGap);
+    connect(gapTimer, &QTimer::timeout, this, &BarcodeWedgeFilter::replayHeldKeys);
+
+    // Key events go to the focused child, so watch them application-wide
+    qApp->installEventFilter(this);
+}
+
+BarcodeWedgeFilter::~BarcodeWedgeFilter() {
+    if (qApp) { qApp->removeEventFilter(this); }
+}
+
+void BarcodeWedgeFilter::setBurstGap(int milliseconds) {
+    burstGap = milliseconds;
+    gapTimer->setInterval(milliseconds);
+}
+
+bool BarcodeWedgeFilter::inScope(QObject *watched) const {
+    if (!scope || !scope->isVisible() || !watched->isWidgetType()) { return false; }
+    QWidget *widget = static_cast<QWidget *>(watched);
+    return widget == scope || scope->isAncestorOf(widget);
+}
+
+bool BarcodeWedgeFilter::eventFilter(QObject *watched, QEvent *event) {
+    if (replaying || event->type() != QEvent::KeyPress || !inScope(watched)) {
+        return false;
+    }
+
+    QKeyEvent *keyEvent = static_cast<QKeyEvent *>(event);
+    int        key      = keyEvent->key();
+
+    if (key == Qt::Key_Return || key == Qt::Key_Enter) {
+        if (held.isEmpty()) { return false; }
+
+        gapTimer->stop();
+        if (buffer.size() >= minimumLength) {
+            QString code = buffer;
+            held.clear();
+            buffer.clear();
+            target = nullptr;
+            emit scanned(code);
+            return true;
+        }
+
+        // Too short for a barcode; let the widget see the keys and the Enter
+        replayHeldKeys();
+        return false;
+    }
+
+    QString text = keyEvent->text();
+    bool    printable =
+        text.size() == 1 && text.at(0).isPrint() &&
+        !(keyEvent->modifiers() & (Qt::ControlModifier | Qt::AltModifier));
+    if (!printable) {
+        if (!held.isEmpty()) { replayHeldKeys(); }
+        return false;
+    }
+
+    // A key meant for another widget ends the current burst
+    if (!held.isEmpty() && watched != target) { replayHeldKeys(); }
+
+    if (held.isEmpty()) { target = watched; }
+    held.append({key, keyEvent->modifiers(), text});
+    buffer += text;
+    gapTimer->start();
+    return true;
+}
+
+void BarcodeWedgeFilter::replayHeldKeys() {
+    gapTimer->stop();
+    QList<HeldKey>    keys = held;
+    QPointer<QObject> to   = target;
+    held.clear();
+    buffer.clear();
+    target = nullptr;
+
+    if (!to) { return; }
+
+    // Typed by a person: deliver the keys as if nothing had intercepted them
+    replaying = true;
+    for (const HeldKey &key : keys) {
+        QKeyEvent press(QEvent::KeyPress, key.key, key.modifiers, key.text);
+        QCoreApplication::sendEvent(to, &press);
+        if (!to) { break; }
+    }
+    replaying = false;
+}
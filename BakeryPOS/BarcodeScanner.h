@@ -0,0 +1,112 @@
+#ifndef BARCODESCANNER_H
+#define BARCODESCANNER_H
+
+#include <QHash>
+#include <QObject>
+#include <QPointer>
+#include <QString>
+
+class QAbstractItemModel;
+class QKeyEvent;
+class QTimer;
+class QWidget;
+
+// What a scanned code resolved to.
+//
+// Plain codes map straight to a product. In-store weighed labels (EAN-13
+// starting with 21 or 22) carry a 5 digit PLU and either the weight in
+// grams or the label price in cents.
+struct BarcodeMatch {
+    enum Kind { NoMatch, Plain, Weight, Price };
+
+    Kind   kind      = NoMatch;
+    int    productId = -1;
+    qint64 value     = 0; // grams for Weight, cents for Price
+
+    bool isValid() const { return kind != NoMatch; }
+};
+
+// Barcode/PLU -> ProductID lookup over the cashier catalog model.
+//
+// Built once from the model's rows and then kept in step from the model's
+// change signals, so a scan is a single hash lookup with no query.
+class BarcodeIndex : public QObject {
+    Q_OBJECT
+
+  public:
+    // GS1 in-store prefixes used for scale labels
+    static constexpr char WeightPrefix = '1'; // 21PPPPPWWWWWC, grams
+    static constexpr char PricePrefix  = '2'; // 22PPPPPVVVVVC, cents
+
+    BarcodeIndex(QAbstractItemModel *model, int idColumn, int codeColumn,
+                 QObject *parent = nullptr);
+
+    BarcodeMatch match(const QString &code) const;
+    int          productFor(const QString &code) const {
+        return productForCode.value(code, -1);
+    }
+    int size() const { return productForCode.size(); }
+
+    static bool hasValidEan13CheckDigit(const QString &code);
+
+  private slots:
+    void rebuild();
+
+  private:
+    QAbstractItemModel *model;
+    int                 idColumn;
+    int                 codeColumn;
+    QHash<QString, int> productForCode;
+    QHash<int, QString> codeForProduct;
+
+    void indexRows(int first, int last);
+    void dropRows(int first, int last);
+};
+
+// Recognises keyboard-wedge barcode scanners.
+//
+// Scanners "type" the code much faster than a person and finish with Enter.
+// Printable keys aimed at widgets inside the scope are held back briefly:
+// if the next key arrives within the burst gap they are collected, and an
+// Enter after at least minimumLength characters emits scanned() and
+// swallows the keys. If the typing is too slow to be a scanner, the held
+// keys are handed back to the widget they were meant for.
+class BarcodeWedgeFilter : public QObject {
+    Q_OBJECT
+
+  public:
+    explicit BarcodeWedgeFilter(QWidget *scope, QObject *parent = nullptr);
+    ~BarcodeWedgeFilter();
+
+    void setBurstGap(int milliseconds);
+    void setMinimumLength(int length) { minimumLength = length; }
+
+  signals:
+    void scanned(const QString &code);
+
+  protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+  private slots:
+    void replayHeldKeys();
+
+  private:
+    struct HeldKey {
+        int                   key;
+        Qt::KeyboardModifiers modifiers;
+        QString               text;
+    };
+
+    QPointer<QWidget> scope;
+    QPointer<QObject> target;
+    QList<HeldKey>    held;
+    QString           buffer;
+    QTimer           *gapTimer;
+    int               burstGap      = 40;
+    int               minimumLength = 4;
+    bool              replaying     = false;
+
+    bool inScope(QObject *watched) const;
+};
+
+#endif // BARCODESCANNER_H
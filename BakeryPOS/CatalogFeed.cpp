@@ -0,0 +1,237 @@
+#include "CatalogFeed.h"
+#include "DomainEvents.h"
+
+#include <QDateTime>
+#include <QHash>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QStringList>
+#include <QTimer>
+#include <QUuid>
+#include <QDebug>
+
+static const char *EntityNames[] = {"product", "category"};
+static const char *ChangeNames[] = {"insert", "update", "delete", "stock",
+                                    "reload"};
+
+CatalogFeed::CatalogFeed(QObject *parent)
+    : QObject(parent), timer(new QTimer(this)) {
+    connect(timer, &QTimer::timeout, this, &CatalogFeed::pollNow);
+}
+
+QString CatalogFeed::sourceId() {
+    static const QString id = QUuid::createUuid().toString();
+    return id;
+}
+
+bool CatalogFeed::record(Entity entity, Change change, const QList<int> &ids,
+                         const QString &connectionName) {
+    if (ids.isEmpty()) { return true; }
+
+    QStringList rows;
+    for (int i = 0; i < ids.size(); ++i) { rows << "(?, ?, ?, ?)"; }
+
+    QSqlQuery query(QSqlDatabase::database(connectionName));
+    query.prepare("INSERT INTO catalog_changes (Entity, EntityID, ChangeType, "
+                  "Source) VALUES " +
+                  rows.join(", "));
+
+    int position = 0;
+    for (int id : ids) {
+        query.bindValue(position++, EntityNames[entity]);
+        query.bindValue(position++, id);
+        query.bindValue(position++, ChangeNames[change]);
+        query.bindValue(position++, sourceId());
+    }
+
+    if (!query.exec()) {
+        qDebug() << "Failed to record catalog change:" << query.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+void CatalogFeed::start(int intervalMs) {
+    initialiseCursor();
+    timer->start(intervalMs);
+}
+
+void CatalogFeed::stop() { timer->stop(); }
+
+bool CatalogFeed::initialiseCursor() {
+    // Whatever is already in the log is reflected in the catalog loaded
+    // after this, so only later changes need applying. Rows still being
+    // committed below the newest one turn up in the re-read window.
+    QSqlQuery query;
+    query.setForwardOnly(true);
+    query.prepare("SELECT ChangeID FROM catalog_changes ORDER BY ChangeID DESC LIMIT ?");
+    query.bindValue(0, ReloadWindow);
+    if (!query.exec()) {
+        qDebug() << "Catalog feed unavailable:" << query.lastError().text();
+        return false;
+    }
+
+    lastChangeId = 0;
+    recentChanges.clear();
+    while (query.next()) {
+        qint64 changeId = query.value(0).toLongLong();
+        lastChangeId    = qMax(lastChangeId, changeId);
+        recentChanges.insert(changeId);
+    }
+
+    // Registered before anything could be pruned past it
+    reportCursor(QDateTime::currentMSecsSinceEpoch());
+    return true;
+}
+
+bool CatalogFeed::reportCursor(qint64 now) {
+    QSqlQuery query;
+    query.prepare("INSERT INTO catalog_feed_cursors (Source, LastChangeID) VALUES (?, ?) "
+                  "ON DUPLICATE KEY UPDATE LastChangeID = VALUES(LastChangeID), "
+                  "SeenAt = NOW()");
+    query.bindValue(0, sourceId());
+    query.bindValue(1, lastChangeId);
+    if (!query.exec()) {
+        qDebug() << "Failed to report catalog feed cursor:" << query.lastError().text();
+        return false;
+    }
+    reportedAt = now;
+    return true;
+}
+
+// Deletes one batch of expired changes; a full batch leaves prunedAt alone
+// so the next poll deletes another
+bool CatalogFeed::prune(qint64 now) {
+    QSqlQuery query;
+    query.prepare("SELECT MIN(LastChangeID) FROM catalog_feed_cursors "
+                  "WHERE SeenAt > NOW() - INTERVAL ? DAY");
+    query.bindValue(0, retentionDays);
+    if (!query.exec() || !query.next()) {
+        qDebug() << "Catalog feed cursors unavailable:" << query.lastError().text();
+        return false;
+    }
+    qint64 lowest = lastChangeId;
+    if (!query.value(0).isNull()) { lowest = qMin(lowest, query.value(0).toLongLong()); }
+
+    // Registers re-read a window below their cursor
+    query.prepare("DELETE FROM catalog_changes "
+                  "WHERE ChangedAt < NOW() - INTERVAL ? DAY AND ChangeID < ? LIMIT ?");
+    query.bindValue(0, retentionDays);
+    query.bindValue(1, lowest - ReloadWindow);
+    query.bindValue(2, pruneBatch);
+    if (!query.exec()) {
+        qDebug() << "Catalog change cleanup failed:" << query.lastError().text();
+        return false;
+    }
+    if (query.numRowsAffected() == pruneBatch) { return true; }
+
+    // Registers that stopped reporting no longer hold changes back
+    query.prepare("DELETE FROM catalog_feed_cursors WHERE SeenAt < NOW() - INTERVAL ? DAY");
+    query.bindValue(0, retentionDays);
+    if (!query.exec()) {
+        qDebug() << "Catalog feed cursor cleanup failed:" << query.lastError().text();
+    }
+    prunedAt = now;
+    return true;
+}
+
+void CatalogFeed::pollNow() {
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+
+    // Other registers may have pruned changes this one never read
+    if (lastChangeId >= 0 && reportedAt > 0 &&
+        now - reportedAt > qint64(retentionDays) * 24 * 3600 * 1000 / 2) {
+        lastChangeId = -1;
+    }
+
+    if (lastChangeId < 0) {
+        // The catalog was loaded without a cursor, so changes made since
+        // may have been missed
+        if (initialiseCursor()) { DomainEvents::instance()->publishCatalogReload(); }
+        return;
+    }
+
+    QSqlQuery query;
+    query.setForwardOnly(true);
+    query.prepare("SELECT ChangeID, Entity, EntityID, ChangeType, Source "
+                  "FROM catalog_changes WHERE ChangeID > ? "
+                  "ORDER BY ChangeID LIMIT ?");
+    query.bindValue(0, qMax<qint64>(0, lastChangeId - ReloadWindow));
+    query.bindValue(1, batchLimit);
+
+    if (!query.exec()) {
+        qDebug() << "Catalog feed poll failed:" << query.lastError().text();
+        return;
+    }
+
+    // Collapse to the final state of each row: removed or (re)read
+    QHash<int, bool> productRemoved;
+    QHash<int, bool> categoryRemoved;
+    bool             reload = false;
+    int              rows   = 0;
+
+    while (query.next()) {
+        ++rows;
+        qint64 changeId = query.value(0).toLongLong();
+        if (recentChanges.contains(changeId)) { continue; } // applied last time
+        lastChangeId = qMax(lastChangeId, changeId);
+        recentChanges.insert(changeId);
+
+        if (query.value(4).toString() == sourceId()) { continue; }
+
+        QString entity  = query.value(1).toString();
+        int     id      = query.value(2).toInt();
+        QString change  = query.value(3).toString();
+        bool    removed = change == "delete";
+
+        if (change == "reload") {
+            reload = true;
+        } else if (entity == "category") {
+            categoryRemoved.insert(id, removed);
+        } else {
+            productRemoved.insert(id, removed);
+        }
+    }
+
+    // Only the window below the newest change needs remembering
+    const qint64 threshold = lastChangeId - ReloadWindow;
+    for (auto it = recentChanges.begin(); it != recentChanges.end();) {
+        if (*it <= threshold) {
+            it = recentChanges.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    DomainEvents *events = DomainEvents::instance();
+
+    auto publish = [](const QHash<int, bool> &changes, auto publishChange) {
+        QList<int> updated;
+        QList<int> removed;
+        for (auto it = changes.constBegin(); it != changes.constEnd(); ++it) {
+            (it.value() ? removed : updated) << it.key();
+        }
+        if (!updated.isEmpty()) { publishChange(DomainEvents::Updated, updated); }
+        if (!removed.isEmpty()) { publishChange(DomainEvents::Removed, removed); }
+    };
+
+    if (reload) {
+        events->publishCatalogReload();
+    } else {
+        publish(productRemoved, [events](DomainEvents::ChangeType type,
+                                         const QList<int>        &ids) {
+            events->publishProductChange(type, ids);
+        });
+    }
+    publish(categoryRemoved, [events](DomainEvents::ChangeType type,
+                                      const QList<int>        &ids) {
+        events->publishCategoryChange(type, ids);
+    });
+
+    if (now - reportedAt >= ReportIntervalMs) { reportCursor(now); }
+    if (now - prunedAt >= PruneIntervalMs) { prune(now); }
+
+    // A full page means there is more waiting; keep draining. The page
+    // includes the re-read window, which is far smaller than a page.
+    if (rows == batchLimit) { QTimer::singleShot(0, this, &CatalogFeed::pollNow); }
+}
@@ -0,0 +1,74 @@
+#ifndef CATALOGFEED_H
+#define CATALOGFEED_H
+
+#include <QList>
+#include <QObject>
+#include <QSet>
+#include <QSqlDatabase>
+
+class QTimer;
+
+// Keeps every register's catalog in step through the catalog_changes table.
+//
+// Writers call record() after changing products or categories. Each running
+// instance polls for rows newer than the last one it applied (a primary key
+// range scan) and republishes them on DomainEvents, so views patch only the
+// changed rows. Rows written by this process are skipped, because they were
+// already published locally.
+//
+// start() takes the cursor, so it must be called before the catalog is
+// loaded; a change made between the two is then applied rather than lost.
+//
+// Each instance reports its cursor to catalog_feed_cursors about once a
+// minute and, about once an hour, deletes a batch of changes older than
+// the retention period. Nothing at or above the lowest cursor reported
+// within that period (less the re-read window) is deleted. An instance
+// that could not report for half the period may have lost unread changes,
+// so it takes a new cursor and reloads the catalog instead.
+class CatalogFeed : public QObject {
+    Q_OBJECT
+
+  public:
+    enum Entity { Product, Category };
+    enum Change { Insert, Update, Delete, Stock, Reload };
+
+    explicit CatalogFeed(QObject *parent = nullptr);
+
+    // Identifies this process in the Source column
+    static QString sourceId();
+
+    static bool record(Entity entity, Change change, const QList<int> &ids,
+                       const QString &connectionName = QSqlDatabase::defaultConnection);
+
+    void setRetentionDays(int days) { retentionDays = qMax(1, days); }
+
+    void start(int intervalMs);
+    void stop();
+
+  public slots:
+    void pollNow();
+
+  private:
+    QTimer *timer         = nullptr;
+    qint64  lastChangeId  = -1;
+    int     batchLimit    = 1000;
+    int     retentionDays = 7;
+    int     pruneBatch    = 5000;
+    qint64  reportedAt    = 0; // ms since the epoch; 0 until the first report
+    qint64  prunedAt      = 0;
+
+    // Changes from other registers can commit out of ChangeID order, so a
+    // short window below the newest ChangeID is re-read on every poll and
+    // the rows already applied in it are skipped
+    QSet<qint64>         recentChanges;
+    static constexpr int ReloadWindow = 64;
+
+    static constexpr qint64 ReportIntervalMs = 60 * 1000;
+    static constexpr qint64 PruneIntervalMs  = 60 * 60 * 1000;
+
+    bool initialiseCursor();
+    bool reportCursor(qint64 now);
+    bool prune(qint64 now);
+};
+
+#endif // CATALOGFEED_H
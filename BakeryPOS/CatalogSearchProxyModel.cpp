@@ -0,0 +1,18 @@
+#include "CatalogSearchProxyModel.h"
+
+void CatalogSearchProxyModel::setSearchText(const QString &text) {
+    searchText = text;
+    invalidateFilter();
+}
+
+bool CatalogSearchProxyModel::filterAcceptsRow(int                sourceRow,
+                                               const QModelIndex &sourceParent) const {
+    if (searchText.isEmpty()) { return true; }
+
+    QAbstractItemModel *model = sourceModel();
+    for (int column : {1, 2}) {
+        QString value = model->index(sourceRow, column, sourceParent).data().toString();
+        if (value.contains(searchText, Qt::CaseInsensitive)) { return true; }
+    }
+    return false;
+}
@@ -0,0 +1,23 @@
+#ifndef CATALOGSEARCHPROXYMODEL_H
+#define CATALOGSEARCHPROXYMODEL_H
+
+#include <QSortFilterProxyModel>
+#include <QString>
+
+// Filters the cashier's in-memory catalog by name or category (columns 1
+// and 2), like the old "Name LIKE '%x%' OR Category LIKE '%x%'" requery
+// did.
+class CatalogSearchProxyModel : public QSortFilterProxyModel {
+  public:
+    using QSortFilterProxyModel::QSortFilterProxyModel;
+
+    void setSearchText(const QString &text);
+
+  protected:
+    bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const override;
+
+  private:
+    QString searchText;
+};
+
+#endif // CATALOGSEARCHPROXYMODEL_H
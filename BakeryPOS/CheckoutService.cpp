@@ -0,0 +1,133 @@
+#include "CheckoutService.h"
+
+#include "CatalogFeed.h"
+#include "ProductionFeed.h"
+#include "SalesHistory.h"
+
+#include <QCoreApplication>
+#include <QHash>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QStringList>
+#include <QDebug>
+
+#include <stdexcept>
+
+static QString quantityText(qint64 quantityMilli) {
+    return QString::number(quantityMilli / 1000.0, 'f', 3);
+}
+
+CheckoutTotals CheckoutService::price(const PricingEngine &pricing, QVector<CheckoutLine> &lines,
+                                      int minuteOfDay) {
+    for (CheckoutLine &line : lines) {
+        line.price = pricing.price(line.productId, line.category, line.unitPrice,
+                                   line.quantityMilli, minuteOfDay);
+    }
+    return totals(pricing, lines);
+}
+
+CheckoutTotals CheckoutService::totals(const PricingEngine &pricing,
+                                       const QVector<CheckoutLine> &lines) {
+    CheckoutTotals totals;
+    TaxTotals      tax;
+    for (const CheckoutLine &line : lines) {
+        totals.discounts += line.price.discount;
+        totals.subtotal += line.price.net();
+        tax.add(pricing.taxRate(line.category), line.price.net());
+    }
+    totals.tax   = tax.tax();
+    totals.total = totals.subtotal + totals.tax;
+    return totals;
+}
+
+int CheckoutService::submit(const QVector<CheckoutLine> &lines, const CheckoutTotals &totals,
+                            int userId, const QString &paymentMethod, QString *error,
+                            const QString &connectionName) {
+    if (lines.isEmpty()) {
+        if (error) { *error = "The order has no lines."; }
+        return -1;
+    }
+
+    QSqlDatabase db = QSqlDatabase::database(connectionName);
+    db.transaction();
+
+    try {
+        QSqlQuery query(db);
+        query.prepare("INSERT INTO Orders (OrderDate, UserID, TotalAmount, payment_method) "
+                      "VALUES (NOW(), ?, ?, ?)");
+        query.bindValue(0, userId);
+        query.bindValue(1, totals.total.toDecimalString());
+        query.bindValue(2, paymentMethod);
+        if (!query.exec()) { throw std::runtime_error(query.lastError().text().toStdString()); }
+
+        int orderId = query.lastInsertId().toInt();
+
+        // All lines in one INSERT and all stock in one UPDATE
+        QStringList        rows;
+        QHash<int, qint64> soldMilli;
+        QList<int>         productIds;
+        for (const CheckoutLine &line : lines) {
+            rows << "(?, ?, ?, ?, ?, ?)";
+            if (!soldMilli.contains(line.productId)) { productIds << line.productId; }
+            soldMilli[line.productId] += line.quantityMilli;
+        }
+
+        query.prepare("INSERT INTO OrderDetails (OrderID, ProductID, Quantity, Price, Discount, "
+                      "PromotionID) VALUES " +
+                      rows.join(", "));
+        int position = 0;
+        for (const CheckoutLine &line : lines) {
+            query.bindValue(position++, orderId);
+            query.bindValue(position++, line.productId);
+            query.bindValue(position++, quantityText(line.quantityMilli));
+            query.bindValue(position++, line.unitPrice.toDecimalString());
+            query.bindValue(position++, line.price.discount.toDecimalString());
+            query.bindValue(position++, line.price.promotionId
+                                            ? QVariant(line.price.promotionId)
+                                            : QVariant(QMetaType(QMetaType::Int)));
+        }
+        if (!query.exec()) { throw std::runtime_error(query.lastError().text().toStdString()); }
+
+        QStringList cases;
+        QStringList ids;
+        for (int i = 0; i < productIds.size(); ++i) {
+            cases << "WHEN ? THEN ?";
+            ids << "?";
+        }
+        query.prepare("UPDATE products SET StockQuantity = StockQuantity - CASE ProductID " +
+                      cases.join(" ") + " END WHERE ProductID IN (" + ids.join(", ") + ")");
+        position = 0;
+        for (int productId : productIds) {
+            query.bindValue(position++, productId);
+            query.bindValue(position++, quantityText(soldMilli.value(productId)));
+        }
+        for (int productId : productIds) { query.bindValue(position++, productId); }
+        if (!query.exec()) { throw std::runtime_error(query.lastError().text().toStdString()); }
+
+        // Hourly rollup read by the analytics page
+        if (!SalesHistory::recordOrder(query, orderId, 1, totals.subtotal, totals.tax)) {
+            throw std::runtime_error(query.lastError().text().toStdString());
+        }
+
+        // Written with the sale, so other registers never miss a stock change
+        // that was committed, nor see one that was rolled back
+        if (!CatalogFeed::record(CatalogFeed::Product, CatalogFeed::Stock, productIds,
+                                 connectionName)) {
+            throw std::runtime_error("Cannot record the stock change for other registers.");
+        }
+
+        if (!db.commit()) { throw std::runtime_error(db.lastError().text().toStdString()); }
+
+        // Directly on the main thread, queued to it from a worker
+        QMetaObject::invokeMethod(QCoreApplication::instance(), [orderId, lines]() {
+            ProductionFeed::instance()->publish(orderId, lines);
+        });
+        return orderId;
+    } catch (const std::exception &e) {
+        db.rollback();
+        if (error) { *error = e.what(); }
+        qDebug() << "Checkout failed:" << e.what();
+        return -1;
+    }
+}
@@ -0,0 +1,53 @@
+#ifndef CHECKOUTSERVICE_H
+#define CHECKOUTSERVICE_H
+
+#include <QSqlDatabase>
+#include <QString>
+#include <QVector>
+
+#include "Money.h"
+#include "PricingEngine.h"
+
+// One product of a sale
+struct CheckoutLine {
+    int     productId = 0;
+    QString category;
+    qint64  quantityMilli = 0;
+    Money   unitPrice;
+    LinePrice price; // filled in by CheckoutService::price
+};
+
+struct CheckoutTotals {
+    Money discounts;
+    Money subtotal; // lines after discount
+    Money tax;
+    Money total;
+};
+
+// The one path a sale takes into the database, whether it was rung up on
+// the cashier page or submitted through the API.
+//
+// A sale is written in one transaction: the order, all of its lines in one
+// INSERT, all stock in one UPDATE, the hourly rollup and the catalog feed
+// row through which other registers hear about the stock change. Lines that
+// need preparing go to the production displays once it has committed.
+//
+// submit() may run on a worker thread given a connection opened there; the
+// production displays are then told from the main thread.
+class CheckoutService {
+  public:
+    // Prices every line as of minuteOfDay and totals them
+    static CheckoutTotals price(const PricingEngine &pricing, QVector<CheckoutLine> &lines,
+                                int minuteOfDay = PricingEngine::minuteOfDay());
+
+    // Totals lines that are already priced, tax at each category's rate
+    static CheckoutTotals totals(const PricingEngine &pricing,
+                                 const QVector<CheckoutLine> &lines);
+
+    // Returns the new OrderID, or -1 and the reason in error
+    static int submit(const QVector<CheckoutLine> &lines, const CheckoutTotals &totals,
+                      int userId, const QString &paymentMethod, QString *error = nullptr,
+                      const QString &connectionName = QSqlDatabase::defaultConnection);
+};
+
+#endif // CHECKOUTSERVICE_H
@@ -0,0 +1,146 @@
+#include "CredentialStore.h"
+
+#include "PasswordHash.h"
+
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QStandardPaths>
+#include <QDebug>
+
+#include <algorithm>
+
+static const quint32 CredentialsMagic   = 0x42504352; // "BPCR"
+static const quint16 CredentialsVersion = 1;
+
+static QString credentialsPath() {
+    return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) +
+           "/credentials.dat";
+}
+
+CredentialStore::CredentialStore(QObject *parent) : QObject(parent) {}
+
+CredentialStore *CredentialStore::instance() {
+    // Parented to the application so it is destroyed with it
+    static CredentialStore *store = new CredentialStore(QCoreApplication::instance());
+    return store;
+}
+
+bool CredentialStore::load() {
+    QFile file(credentialsPath());
+    if (!file.open(QIODevice::ReadOnly)) { return false; }
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_0);
+
+    quint32 magic   = 0;
+    quint16 version = 0;
+    qint32  count   = 0;
+    in >> magic >> version >> count;
+    if (magic != CredentialsMagic || version != CredentialsVersion) {
+        qDebug() << "Ignoring credentials file with unknown format";
+        return false;
+    }
+
+    byName.clear();
+    nameForId.clear();
+    for (int i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        Credential credential;
+        qint32     userId = -1;
+        in >> userId >> credential.username >> credential.role >> credential.status >>
+            credential.passwordHash >> credential.pinHash;
+        credential.userId = userId;
+        byName.insert(credential.username, credential);
+        nameForId.insert(credential.userId, credential.username);
+    }
+    return in.status() == QDataStream::Ok;
+}
+
+bool CredentialStore::refresh() {
+    QSqlQuery query;
+    query.setForwardOnly(true);
+    if (!query.exec("SELECT UserID, username, role, status, password, PinHash FROM users")) {
+        qDebug() << "Credential refresh failed:" << query.lastError().text();
+        return false;
+    }
+
+    QHash<QString, Credential> users;
+    QHash<int, QString>        names;
+    while (query.next()) {
+        Credential credential;
+        credential.userId   = query.value(0).toInt();
+        credential.username = query.value(1).toString();
+        credential.role     = query.value(2).toString();
+        credential.status   = query.value(3).toString();
+
+        // Plaintext never leaves the database
+        QString password = query.value(4).toString();
+        if (PasswordHash::isHashed(password)) { credential.passwordHash = password; }
+        credential.pinHash = query.value(5).toString();
+
+        users.insert(credential.username, credential);
+        names.insert(credential.userId, credential.username);
+    }
+
+    byName    = users;
+    nameForId = names;
+    return save();
+}
+
+Credential CredentialStore::find(const QString &username) const {
+    return byName.value(username);
+}
+
+Credential CredentialStore::find(int userId) const {
+    auto name = nameForId.constFind(userId);
+    return name == nameForId.constEnd() ? Credential() : byName.value(name.value());
+}
+
+QList<Credential> CredentialStore::usersWithPin() const {
+    QList<Credential> users;
+    for (const Credential &credential : byName) {
+        if (!credential.pinHash.isEmpty()) { users << credential; }
+    }
+    std::sort(users.begin(), users.end(), [](const Credential &a, const Credential &b) {
+        return a.username.compare(b.username, Qt::CaseInsensitive) < 0;
+    });
+    return users;
+}
+
+void CredentialStore::store(const Credential &credential) {
+    // A rename leaves the old name behind otherwise
+    QString previous = nameForId.value(credential.userId);
+    if (!previous.isEmpty() && previous != credential.username) { byName.remove(previous); }
+
+    byName.insert(credential.username, credential);
+    nameForId.insert(credential.userId, credential.username);
+    save();
+}
+
+bool CredentialStore::save() const {
+    QDir().mkpath(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation));
+    QSaveFile file(credentialsPath());
+    if (!file.open(QIODevice::WriteOnly)) {
+        qDebug() << "Cannot save credentials:" << file.errorString();
+        return false;
+    }
+    file.setPermissions(QFileDevice::ReadOwner | QFileDevice::WriteOwner);
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << CredentialsMagic << CredentialsVersion << qint32(byName.size());
+    for (const Credential &credential : byName) {
+        out << qint32(credential.userId) << credential.username << credential.role
+            << credential.status << credential.passwordHash << credential.pinHash;
+    }
+
+    if (!file.commit()) {
+        qDebug() << "Cannot save credentials:" << file.errorString();
+        return false;
+    }
+    return true;
+}
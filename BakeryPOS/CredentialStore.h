@@ -0,0 +1,52 @@
+#ifndef CREDENTIALSTORE_H
+#define CREDENTIALSTORE_H
+
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QString>
+
+struct Credential {
+    int     userId = -1;
+    QString username;
+    QString role;
+    QString status;
+    QString passwordHash; // empty until the stored password has been hashed
+    QString pinHash;      // empty when the user has no PIN
+
+    bool isValid() const { return userId >= 0; }
+};
+
+// Users, roles and password/PIN hashes kept on this register.
+//
+// Loaded from a local file at startup so a login is checked without going
+// to the database, and refreshed from the users table after each login.
+// Only hashes are written to the file; users whose password is still
+// plaintext in the database are listed without one and must log in
+// against the database once.
+class CredentialStore : public QObject {
+    Q_OBJECT
+
+  public:
+    static CredentialStore *instance();
+
+    bool load();
+    bool refresh();
+
+    Credential        find(const QString &username) const;
+    Credential        find(int userId) const;
+    QList<Credential> usersWithPin() const;
+
+    // Records a hash set or upgraded by this register
+    void store(const Credential &credential);
+
+  private:
+    explicit CredentialStore(QObject *parent = nullptr);
+
+    QHash<QString, Credential> byName;
+    QHash<int, QString>        nameForId;
+
+    bool save() const;
+};
+
+#endif // CREDENTIALSTORE_H
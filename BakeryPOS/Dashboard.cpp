@@ -2,24 +2,37 @@
 #include "EditProductForm.h"
 #include "EditUserForm.h"
 #include "EditCategoryForm.h"
+#include "ProductTransfer.h"
+#include "PinSwitchDialog.h"
+#include "CredentialStore.h"
+#include "ProcessMemory.h"
 #include "ui_Dashboard.h"
 
 #include "Utils.h"
 #include <login.h>
 
 #include <QSqlDatabase>
-#include <QSqlQueryModel>
+#include <QSqlError>
 #include <QString>
 
+#include <QApplication>
 #include <QButtonGroup>
+#include <QFileDialog>
+#include <QFutureWatcher>
 #include <QMessageBox>
+#include <QProgressDialog>
 #include <QPushButton>
+#include <QSettings>
+#include <QStatusBar>
+#include <QTimer>
+#include <QtConcurrent/QtConcurrentRun>
 
-dashboard::dashboard(QWidget *parent, int userId)
+dashboard::dashboard(QWidget *parent, int userId, const QString &role)
     : QMainWindow(parent)
     , ui(new Ui::dashboard)
     , currentUserId(userId)      // Match header order
-    , Model(new QSqlQueryModel(this))
+    , currentRole(role)
+    , Model(new LiveQueryModel(this))
 {
     ui->setupUi(this);
     
@@ -36,18 +49,38 @@ dashboard::dashboard(QWidget *parent, int userId)
     // Set base query
     BaseQuery = "SELECT * FROM products";  // Default query
 
+    if (currentRole.isEmpty()) {
+        currentRole = CredentialStore::instance()->find(userId).role;
+    }
+
+    // The feed's cursor is taken before any page loads the catalog
+    QSettings settings("BakeryPOS", "BakeryPOS");
+    catalogFeed = new CatalogFeed(this);
+    catalogFeed->setRetentionDays(settings.value("catalogFeed/retentionDays", 7).toInt());
+    catalogFeed->start(settings.value("catalogFeed/pollIntervalMs", 2000).toInt());
+
     // Setup UI and load data
     setupUI();
-    loadData();
+    applyRole();
     connectSignals();
+    setupInventoryMonitor();
+    setupSessionBar();
+    setupMemoryGauge();
 
     // Set window properties
     this->setWindowTitle("BakeryPOS - Dashboard");
+    loadData();
     this->showMaximized();
 }
 
 dashboard::~dashboard()
 {
+    // Imports and exports report to this dashboard; stop them first
+    if (importer) { importer->cancel(); }
+    if (exporter) { exporter->cancel(); }
+    importFuture.waitForFinished();
+    exportFuture.waitForFinished();
+
     // Clean up analytics resources
     if (analyticsForm) {
         delete analyticsForm;
@@ -60,10 +93,9 @@ dashboard::~dashboard()
         cashierForm = nullptr;
     }
     
-    // Clean up database connections
-    QString connectionName = QString("CashierConnection_%1").arg(currentUserId);
-    if (QSqlDatabase::contains(connectionName)) {
-        QSqlDatabase::removeDatabase(connectionName);
+    // Clean up database connections (named after the user who opened it)
+    if (!cashierConnectionName.isEmpty() && QSqlDatabase::contains(cashierConnectionName)) {
+        QSqlDatabase::removeDatabase(cashierConnectionName);
     }
     
     if (analyticsPageIndex != -1) {
@@ -73,41 +105,20 @@ dashboard::~dashboard()
         analyticsPageIndex = -1;
     }
 
+    // The order history form is owned by its page
+    if (orderHistoryPageIndex != -1) {
+        QWidget* widget = ui->MainDisplayStackedWidget->widget(orderHistoryPageIndex);
+        ui->MainDisplayStackedWidget->removeWidget(widget);
+        delete widget;
+        orderHistoryForm = nullptr;
+        orderHistoryPageIndex = -1;
+    }
+
     delete ui;
 }
 
 void dashboard::setupUI()
 {
-    // painting the table
-    ui->ProductPageTableView->setItemDelegate(
-        new CustomTableDelegate(ui->ProductPageTableView));
-    ui->UserPageTableView->setItemDelegate(
-        new CustomTableDelegate(ui->ProductPageTableView));
-
-    // Distribute columns based on content size
-    ui->ProductPageTableView->horizontalHeader()->setSectionResizeMode(
-        QHeaderView::Stretch);
-    // left-align header text, vertically centered
-    ui->ProductPageTableView->horizontalHeader()->setDefaultAlignment(
-        Qt::AlignLeft | Qt::AlignVCenter);
-    // Distribute columns based on content size
-    ui->UserPageTableView->horizontalHeader()->setSectionResizeMode(
-        QHeaderView::Stretch);
-    // left-align header text, vertically centered
-    ui->UserPageTableView->horizontalHeader()->setDefaultAlignment(
-        Qt::AlignLeft | Qt::AlignVCenter);
-
-    // Setup Category Table View
-    ui->CategoryPageTableView->setSelectionBehavior(QAbstractItemView::SelectRows);
-    ui->CategoryPageTableView->setSelectionMode(QAbstractItemView::SingleSelection);
-    ui->CategoryPageTableView->setEditTriggers(QAbstractItemView::NoEditTriggers);
-    ui->CategoryPageTableView->setItemDelegate(
-        new CustomTableDelegate(ui->CategoryPageTableView));
-    ui->CategoryPageTableView->horizontalHeader()->setSectionResizeMode(
-        QHeaderView::Stretch);
-    ui->CategoryPageTableView->horizontalHeader()->setDefaultAlignment(
-        Qt::AlignLeft | Qt::AlignVCenter);
-
     // Setup sidebar buttons
     QButtonGroup *SidebarGroup = new QButtonGroup(this);
     SidebarGroup->setExclusive(true);
@@ -117,21 +128,7 @@ void dashboard::setupUI()
     SidebarGroup->addButton(ui->ProductsButton);
     SidebarGroup->addButton(ui->CategoriesButton);
     SidebarGroup->addButton(ui->AnalyticsButton);
-
-    // Connect table header clicks
-    connect(ui->ProductPageTableView->horizontalHeader(),
-            &QHeaderView::sectionClicked, this,
-            &dashboard::OnProductHeaderSectionClicked);
-    connect(ui->UserPageTableView->horizontalHeader(),
-            &QHeaderView::sectionClicked, this,
-            &dashboard::OnUserHeaderSectionClicked);
-    connect(ui->CategoryPageTableView->horizontalHeader(),
-            &QHeaderView::sectionClicked,
-            this,
-            &dashboard::OnCategoryHeaderSectionClicked);
-
-    // Set initial page
-    ui->MainDisplayStackedWidget->setCurrentIndex(0);
+    SidebarGroup->addButton(ui->OrdersButton);
 
     // Debug output
     qDebug() << "MainDisplayStackedWidget setup:";
@@ -142,10 +139,223 @@ void dashboard::setupUI()
     }
 }
 
-void dashboard::refreshProductData() {
-    // Refresh the product data in the table
-    ApplyFiltersForProducts();
-    qDebug() << "Product data refreshed after edit";
+void dashboard::applyRole()
+{
+    // Pages outside the role's manifest are never built
+    ui->ProductsButton->setVisible(RolePages::canOpen(currentRole, RolePages::Products));
+    ui->UsersButton->setVisible(RolePages::canOpen(currentRole, RolePages::Users));
+    ui->CategoriesButton->setVisible(RolePages::canOpen(currentRole, RolePages::Categories));
+    ui->AnalyticsButton->setVisible(RolePages::canOpen(currentRole, RolePages::Analytics));
+    ui->OrdersButton->setVisible(RolePages::canOpen(currentRole, RolePages::Orders));
+    ui->InvoiceButton->setVisible(RolePages::canOpen(currentRole, RolePages::Invoice));
+}
+
+void dashboard::openPage(RolePages::Page page)
+{
+    switch (page) {
+    case RolePages::Products:
+        ui->ProductsButton->setChecked(true);
+        on_ProductsButton_clicked();
+        break;
+    case RolePages::Users:
+        ui->UsersButton->setChecked(true);
+        on_UsersButton_clicked();
+        break;
+    case RolePages::Categories:
+        ui->CategoriesButton->setChecked(true);
+        on_CategoriesButton_clicked();
+        break;
+    case RolePages::Analytics:
+        ui->AnalyticsButton->setChecked(true);
+        on_AnalyticsButton_clicked();
+        break;
+    case RolePages::Orders:
+        ui->OrdersButton->setChecked(true);
+        on_OrdersButton_clicked();
+        break;
+    case RolePages::Invoice:
+        ui->InvoiceButton->setChecked(true);
+        on_InvoiceButton_clicked();
+        break;
+    }
+}
+
+// Called first by every page's button; false when the role may not open it
+bool dashboard::enterPage(RolePages::Page page)
+{
+    if (!RolePages::canOpen(currentRole, page)) {
+        qDebug() << "Role" << currentRole << "cannot open page" << page;
+        return false;
+    }
+
+    if (!builtPages.contains(page)) {
+        buildPage(page);
+        builtPages.append(page);
+    }
+    currentPage = page;
+    return true;
+}
+
+// One-time setup of the pages from dashboard.ui; the analytics, order
+// history and invoice pages are created by their buttons instead
+void dashboard::buildPage(RolePages::Page page)
+{
+    switch (page) {
+    case RolePages::Products:
+        // painting the table
+        ui->ProductPageTableView->setItemDelegate(
+            new CustomTableDelegate(ui->ProductPageTableView));
+        // Distribute columns based on content size
+        ui->ProductPageTableView->horizontalHeader()->setSectionResizeMode(
+            QHeaderView::Stretch);
+        // left-align header text, vertically centered
+        ui->ProductPageTableView->horizontalHeader()->setDefaultAlignment(
+            Qt::AlignLeft | Qt::AlignVCenter);
+        connect(ui->ProductPageTableView->horizontalHeader(), &QHeaderView::sectionClicked,
+                this, &dashboard::OnProductHeaderSectionClicked);
+        break;
+
+    case RolePages::Users:
+        ui->UserPageTableView->setItemDelegate(
+            new CustomTableDelegate(ui->UserPageTableView));
+        // Distribute columns based on content size
+        ui->UserPageTableView->horizontalHeader()->setSectionResizeMode(
+            QHeaderView::Stretch);
+        // left-align header text, vertically centered
+        ui->UserPageTableView->horizontalHeader()->setDefaultAlignment(
+            Qt::AlignLeft | Qt::AlignVCenter);
+        connect(ui->UserPageTableView->horizontalHeader(), &QHeaderView::sectionClicked,
+                this, &dashboard::OnUserHeaderSectionClicked);
+        break;
+
+    case RolePages::Categories:
+        ui->CategoryPageTableView->setSelectionBehavior(QAbstractItemView::SelectRows);
+        ui->CategoryPageTableView->setSelectionMode(QAbstractItemView::SingleSelection);
+        ui->CategoryPageTableView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+        ui->CategoryPageTableView->setItemDelegate(
+            new CustomTableDelegate(ui->CategoryPageTableView));
+        ui->CategoryPageTableView->horizontalHeader()->setSectionResizeMode(
+            QHeaderView::Stretch);
+        ui->CategoryPageTableView->horizontalHeader()->setDefaultAlignment(
+            Qt::AlignLeft | Qt::AlignVCenter);
+        connect(ui->CategoryPageTableView->horizontalHeader(), &QHeaderView::sectionClicked,
+                this, &dashboard::OnCategoryHeaderSectionClicked);
+        break;
+
+    default:
+        break;
+    }
+}
+
+void dashboard::setupInventoryMonitor()
+{
+    inventoryMonitor = new InventoryMonitor(this);
+
+    QSettings settings("BakeryPOS", "BakeryPOS");
+    inventoryMonitor->setLowStockThreshold(
+        settings.value("inventory/lowStockThreshold", 5.0).toDouble());
+    inventoryMonitor->load();
+
+    // Product names are only needed when an alert fires
+    auto productName = [](int productId) {
+        QSqlQuery query;
+        query.prepare("SELECT Name FROM products WHERE ProductID = ?");
+        query.bindValue(0, productId);
+        return query.exec() && query.next() ? query.value(0).toString()
+                                            : QString("Product #%1").arg(productId);
+    };
+
+    connect(inventoryMonitor, &InventoryMonitor::lowStock, this,
+            [this, productName](int productId, double quantity) {
+                statusBar()->showMessage(
+                    QString("Low stock: %1 (%2 left)")
+                        .arg(productName(productId))
+                        .arg(quantity, 0, 'f', 2),
+                    10000);
+            });
+    connect(inventoryMonitor, &InventoryMonitor::outOfStock, this,
+            [this, productName](int productId) {
+                statusBar()->showMessage(
+                    QString("Out of stock: %1").arg(productName(productId)),
+                    10000);
+            });
+}
+
+void dashboard::setupSessionBar()
+{
+    signedInLabel = new QLabel(this);
+    QPushButton *switchButton = new QPushButton("Switch User", this);
+    statusBar()->addPermanentWidget(signedInLabel);
+    statusBar()->addPermanentWidget(switchButton);
+    connect(switchButton, &QPushButton::clicked, this, &dashboard::onSwitchUserClicked);
+
+    Credential user = CredentialStore::instance()->find(currentUserId);
+    signedInLabel->setText("Signed in as " +
+                           (user.isValid() ? user.username : QString("User #%1").arg(currentUserId)));
+
+    // Catch up on users and PINs changed elsewhere once the window is up
+    QTimer::singleShot(0, this, [this]() {
+        CredentialStore::instance()->refresh();
+        Credential user = CredentialStore::instance()->find(currentUserId);
+        if (user.isValid()) signedInLabel->setText("Signed in as " + user.username);
+    });
+}
+
+void dashboard::setupMemoryGauge()
+{
+    QSettings settings("BakeryPOS", "BakeryPOS");
+    if (!settings.value("diagnostics/memoryGauge", true).toBool()) return;
+
+    // Resident memory and live top-level widgets; a register left running
+    // all day should hold both flat
+    memoryLabel = new QLabel(this);
+    memoryLabel->setToolTip("Resident memory, and top-level windows shown or hidden");
+    statusBar()->addPermanentWidget(memoryLabel);
+
+    QTimer *timer = new QTimer(this);
+    connect(timer, &QTimer::timeout, this, &dashboard::updateMemoryGauge);
+    timer->start(settings.value("diagnostics/memoryGaugeSeconds", 5).toInt() * 1000);
+    updateMemoryGauge();
+}
+
+void dashboard::updateMemoryGauge()
+{
+    memoryLabel->setText(ProcessMemory::gaugeText(QApplication::topLevelWidgets().size()));
+}
+
+void dashboard::onSwitchUserClicked()
+{
+    // Users disabled or demoted elsewhere drop out of the list; offline the
+    // saved copy is used as is
+    CredentialStore::instance()->refresh();
+
+    PinSwitchDialog dialog(currentUserId, this);
+    if (dialog.exec() == QDialog::Accepted) {
+        switchUser(dialog.userId());
+    }
+}
+
+void dashboard::switchUser(int userId)
+{
+    // Only the user changes; pages, carts and loaded data stay as they are
+    Credential user = CredentialStore::instance()->find(userId);
+    currentUserId = userId;
+    currentRole = user.role;
+    if (cashierForm) cashierForm->setCurrentUserId(userId);
+    if (orderHistoryForm) {
+        orderHistoryForm->setCurrentUserId(userId);
+        orderHistoryForm->setCurrentRole(currentRole);
+    }
+
+    // The new role may not reach the page left open
+    applyRole();
+    if (!RolePages::canOpen(currentRole, currentPage)) {
+        openPage(RolePages::landingPage(currentRole));
+    }
+
+    signedInLabel->setText("Signed in as " + user.username);
+    statusBar()->showMessage("Switched to " + user.username, 5000);
+    qDebug() << "Switched user to ID:" << userId;
 }
 
 void dashboard::ApplyFiltersForProducts(const QString &SortColumn,
@@ -171,7 +381,7 @@ void dashboard::ApplyFiltersForProducts(const QString &SortColumn,
     }
 
     qDebug() << "Final query:" << Query;
-    Model->setQuery(Query);
+    Model->setQuery(Query, "ProductID");
     UpdateProductRecordCountLabel();
 }
 
@@ -198,7 +408,7 @@ void dashboard::ApplyFiltersForUsers(const QString &SortColumn,
     }
 
     qDebug() << "Final query:" << Query;
-    Model->setQuery(Query);
+    Model->setQuery(Query, "UserID");
     UpdateUserRecordCountLabel();
 }
 
@@ -281,12 +491,10 @@ void dashboard::on_EditProductButton_clicked() {
 
         // Create and show the edit form
         EditProductForm *editForm = new EditProductForm(this);
+        editForm->setAttribute(Qt::WA_DeleteOnClose);
         editForm->loadProductData(productId);
 
-        // Connect the productUpdated signal to refresh the table
-        connect(editForm, &EditProductForm::productUpdated, this,
-                &dashboard::refreshProductData);
-
+        // The table is patched through DomainEvents::productChanged
         editForm->show();
 
     } else {
@@ -417,11 +625,14 @@ void dashboard::on_DeleteProductButton_clicked() {
                 deleteQuery.bindValue(0, productId);
 
                 if (deleteQuery.exec()) {
+                    CatalogFeed::record(CatalogFeed::Product,
+                                        CatalogFeed::Delete, {productId});
+                    DomainEvents::instance()->publishProductChange(
+                        DomainEvents::Removed, {productId});
                     QMessageBox::information(
                         this, "Success",
                         QString("Product \"%1\" has been deleted successfully!")
                             .arg(productName));
-                    refreshProductData();
                 } else {
                     QMessageBox::critical(
                         this, "Database Error",
@@ -445,33 +656,184 @@ void dashboard::on_DeleteProductButton_clicked() {
 void dashboard::on_AddProductButton_clicked() {
     // Create a new EditProductForm for adding (without loading existing data)
     EditProductForm *addForm = new EditProductForm(this);
+    addForm->setAttribute(Qt::WA_DeleteOnClose);
     addForm->setWindowTitle("Add New Product");
 
-    // Connect the productUpdated signal to refresh the table
-    connect(addForm, &EditProductForm::productUpdated, this,
-            &dashboard::refreshProductData);
-
+    // The new row arrives through DomainEvents::productChanged
     addForm->show();
 }
 
+struct ExportResult {
+    int     rows = -1;
+    QString error;
+};
+
+// Runs work on a worker with its own copy of the default connection, as the
+// Z-report and the archiver do
+template <typename Result, typename Work>
+static QFuture<Result> runWithConnection(const QString &connectionName, Work work) {
+    return QtConcurrent::run([connectionName, work]() {
+        Result result;
+        {
+            QSqlDatabase db = QSqlDatabase::cloneDatabase(QSqlDatabase::defaultConnection,
+                                                          connectionName);
+            if (db.open()) {
+                result = work(db);
+                db.close();
+            } else {
+                result.error = db.lastError().text();
+            }
+        }
+        QSqlDatabase::removeDatabase(connectionName);
+        return result;
+    });
+}
+
+void dashboard::on_ImportProductsButton_clicked() {
+    if (importFuture.isRunning()) { return; }
+
+    QString path = QFileDialog::getOpenFileName(
+        this, "Import Products", QString(),
+        "Product files (*.csv *.jsonl *.ndjson *.json)");
+    if (path.isEmpty()) { return; }
+
+    // The worker shares the importer, so it outlives the dialog; closing the
+    // dashboard cancels the import and waits for it
+    QProgressDialog *progressDialog =
+        new QProgressDialog("Importing products...", "Cancel", 0, 1000, this);
+    progressDialog->setWindowModality(Qt::WindowModal);
+    progressDialog->setMinimumDuration(500);
+    progressDialog->setAutoClose(false);
+    progressDialog->setAutoReset(false);
+
+    importer = QSharedPointer<ProductImporter>(new ProductImporter, &QObject::deleteLater);
+    connect(importer.data(), &ProductImporter::progress, progressDialog,
+            [progressDialog](qint64 bytesRead, qint64 totalBytes, int rows) {
+                progressDialog->setLabelText(
+                    QString("Imported %1 products...").arg(rows));
+                if (totalBytes > 0) {
+                    progressDialog->setValue(int(bytesRead * 1000 / totalBytes));
+                }
+            });
+    connect(progressDialog, &QProgressDialog::canceled, importer.data(),
+            &ProductImporter::cancel);
+
+    auto *watcher = new QFutureWatcher<ProductImporter::Result>(progressDialog);
+    connect(watcher, &QFutureWatcher<ProductImporter::Result>::finished, this,
+            [this, watcher, progressDialog]() {
+                ProductImporter::Result result = watcher->result();
+                progressDialog->close();
+                progressDialog->deleteLater();
+                importer.reset();
+
+                QString summary = QString("Imported: %1\nRejected: %2")
+                                      .arg(result.imported)
+                                      .arg(result.rejected);
+                if (!result.rejections.isEmpty()) {
+                    summary += "\n\n" + result.rejections.mid(0, 10).join("\n");
+                }
+
+                if (!result.error.isEmpty()) {
+                    QMessageBox::critical(this, "Import Failed",
+                                          result.error + "\n\n" + summary);
+                } else if (result.aborted) {
+                    QMessageBox::warning(this, "Import Cancelled", summary);
+                } else {
+                    QMessageBox::information(this, "Import Complete", summary);
+                }
+
+                // Upserts don't report IDs, so every register reloads its catalog
+                if (result.imported > 0) {
+                    CatalogFeed::record(CatalogFeed::Product, CatalogFeed::Reload, {0});
+                    DomainEvents::instance()->publishCatalogReload();
+                }
+            });
+
+    QSharedPointer<ProductImporter> worker = importer;
+    QFuture<ProductImporter::Result> future = runWithConnection<ProductImporter::Result>(
+        "product_import", [worker, path](const QSqlDatabase &db) {
+            return worker->importFile(path, db);
+        });
+    importFuture = future;
+    watcher->setFuture(future);
+    progressDialog->show();
+}
+
+void dashboard::on_ExportProductsButton_clicked() {
+    if (exportFuture.isRunning()) { return; }
+
+    QString path = QFileDialog::getSaveFileName(
+        this, "Export Products", "products.csv",
+        "CSV (*.csv);;JSON Lines (*.jsonl);;JSON (*.json)");
+    if (path.isEmpty()) { return; }
+
+    // Streamed on a worker like the import, so the till keeps responding
+    QProgressDialog *progressDialog =
+        new QProgressDialog("Exporting products...", "Cancel", 0, 0, this);
+    progressDialog->setWindowModality(Qt::WindowModal);
+    progressDialog->setMinimumDuration(500);
+    progressDialog->setAutoClose(false);
+    progressDialog->setAutoReset(false);
+
+    exporter = QSharedPointer<ProductExporter>(new ProductExporter, &QObject::deleteLater);
+    connect(exporter.data(), &ProductExporter::progress, progressDialog,
+            [progressDialog](int rows) {
+                progressDialog->setLabelText(
+                    QString("Exported %1 products...").arg(rows));
+            });
+    connect(progressDialog, &QProgressDialog::canceled, exporter.data(),
+            &ProductExporter::cancel);
+
+    auto *watcher = new QFutureWatcher<ExportResult>(progressDialog);
+    connect(watcher, &QFutureWatcher<ExportResult>::finished, this,
+            [this, watcher, progressDialog, path]() {
+                ExportResult result = watcher->result();
+                progressDialog->close();
+                progressDialog->deleteLater();
+                exporter.reset();
+
+                if (result.rows < 0) {
+                    QMessageBox::critical(this, "Export Failed", result.error);
+                } else {
+                    QMessageBox::information(
+                        this, "Export Complete",
+                        QString("Exported %1 products to %2").arg(result.rows).arg(path));
+                }
+            });
+
+    QSharedPointer<ProductExporter> worker = exporter;
+    QFuture<ExportResult> future = runWithConnection<ExportResult>(
+        "product_export", [worker, path](const QSqlDatabase &db) {
+            ExportResult result;
+            result.rows = worker->exportFile(path, &result.error, db);
+            return result;
+        });
+    exportFuture = future;
+    watcher->setFuture(future);
+    progressDialog->show();
+}
+
 void dashboard::on_FilterRoleComboBox_currentIndexChanged() {
     CurrentCategoryFilter = ui->FilterRoleComboBox->currentText();
     ApplyFiltersForUsers();
 }
 
 void dashboard::on_UsersButton_clicked() {
+    if (!enterPage(RolePages::Users)) return;
     ui->MainDisplayStackedWidget->setCurrentIndex(3);
     this->BaseQuery = "SELECT * FROM users";
-    this->Model->setQuery(BaseQuery);
+    this->Model->setQuery(BaseQuery, "UserID");
     ui->UserPageTableView->setModel(Model);
     UpdateUserRecordCountLabel();
 }
 
 void dashboard::on_ProductsButton_clicked() {
+    if (!enterPage(RolePages::Products)) return;
     ui->MainDisplayStackedWidget->setCurrentIndex(0);
     this->BaseQuery = "SELECT * FROM products";
-    this->Model->setQuery(BaseQuery);
+    this->Model->setQuery(BaseQuery, "ProductID");
     ui->ProductPageTableView->setModel(Model);
+    UpdateProductRecordCountLabel();
 }
 
 void dashboard::on_SearchUserByNameLineEdit_returnPressed() {
@@ -481,6 +843,8 @@ void dashboard::on_SearchUserByNameLineEdit_returnPressed() {
 
 void dashboard::on_CategoriesButton_clicked()
 {
+    if (!enterPage(RolePages::Categories)) return;
+
     // Set correct index for CategoryManagementPage
     ui->MainDisplayStackedWidget->setCurrentIndex(6);
     
@@ -492,7 +856,7 @@ void dashboard::on_CategoriesButton_clicked()
     // Add debug output
     qDebug() << "Executing query:" << query;
     
-    Model->setQuery(query);
+    Model->setQuery(query, "ID");
     
     // Check for query errors
     if (Model->lastError().isValid()) {
@@ -542,7 +906,7 @@ void dashboard::ApplyFiltersForCategories(const QString &SortColumn, const QStri
         queryStr += " ORDER BY " + SortColumn + " " + SortOrder;
     }
     
-    Model->setQuery(queryStr);
+    Model->setQuery(queryStr, "ID");
     UpdateCategoryRecordCountLabel();  // Fixed: Changed from UpdateCategoryRecordCount to UpdateCategoryRecordCountLabel
 }
 
@@ -567,8 +931,11 @@ void dashboard::on_LogoutButton_clicked() {
     if (QMessageBox::question(this, "Confirm Logout",
                               "Are you sure you want to logout?") ==
         QMessageBox::Yes) {
+        // Both windows are freed when closed, so logging in and out all
+        // day does not pile up dashboards (and their API listeners)
         this->close();
         login *Lgn = new login();
+        Lgn->setAttribute(Qt::WA_DeleteOnClose);
         Lgn->show();
     }
 }
@@ -582,13 +949,8 @@ void dashboard::on_EditUserButton_clicked() {
         int userId = ui->UserPageTableView->model()->data(userIdIndex).toInt();
 
         EditUserForm *editForm = new EditUserForm(this);
+        editForm->setAttribute(Qt::WA_DeleteOnClose);
         editForm->loadUserData(userId);
-
-        connect(editForm, &EditUserForm::userUpdated, this, [this]() {
-            this->Model->setQuery(this->BaseQuery);
-            UpdateUserRecordCountLabel();
-        });
-
         editForm->show();
     } else {
         QMessageBox::warning(this, "No Selection", "Please select a user to edit.");
@@ -613,12 +975,11 @@ void dashboard::on_DeleteUserButton_clicked() {
 
         if (reply == QMessageBox::Yes) {
             QSqlQuery query;
-            query.prepare("DELETE FROM users WHERE id = ?");
+            query.prepare("DELETE FROM users WHERE UserID = ?");
             query.bindValue(0, userId);
 
             if (query.exec()) {
-                Model->setQuery(BaseQuery);
-                UpdateUserRecordCountLabel();
+                DomainEvents::instance()->publishUserChange(DomainEvents::Removed, {userId});
                 QMessageBox::information(this, "Success", "User deleted successfully.");
             } else {
                 QMessageBox::critical(this, "Error", 
@@ -632,26 +993,16 @@ void dashboard::on_DeleteUserButton_clicked() {
 
 void dashboard::on_AddUserButton_clicked() {
     EditUserForm *addForm = new EditUserForm(this);
+    addForm->setAttribute(Qt::WA_DeleteOnClose);
     addForm->setWindowTitle("Add New User");
-
-    connect(addForm, &EditUserForm::userUpdated, this, [this]() {
-        this->Model->setQuery(this->BaseQuery);
-        UpdateUserRecordCountLabel();
-    });
-
     addForm->show();
 }
 
 void dashboard::on_AddCategoryButton_clicked()
 {
     EditCategoryForm *addForm = new EditCategoryForm(this);
+    addForm->setAttribute(Qt::WA_DeleteOnClose);
     addForm->setWindowTitle("Add New Category");
-
-    connect(addForm, &EditCategoryForm::categoryUpdated, this, [this]() {
-        this->Model->setQuery("SELECT * FROM categories");
-        UpdateCategoryRecordCountLabel();
-    });
-
     addForm->show();
 }
 
@@ -665,13 +1016,8 @@ void dashboard::on_EditCategoryButton_clicked()
         int categoryId = ui->CategoryPageTableView->model()->data(categoryIdIndex).toInt();
 
         EditCategoryForm *editForm = new EditCategoryForm(this);
+        editForm->setAttribute(Qt::WA_DeleteOnClose);
         editForm->loadCategoryData(categoryId);
-
-        connect(editForm, &EditCategoryForm::categoryUpdated, this, [this]() {
-            this->Model->setQuery("SELECT * FROM categories");
-            UpdateCategoryRecordCountLabel();
-        });
-
         editForm->show();
     } else {
         QMessageBox::warning(this, "No Selection", "Please select a category to edit.");
@@ -701,8 +1047,9 @@ void dashboard::on_DeleteCategoryButton_clicked()
             query.bindValue(0, categoryId);
 
             if (query.exec()) {
-                Model->setQuery("SELECT * FROM categories");
-                UpdateCategoryRecordCountLabel();
+                CatalogFeed::record(CatalogFeed::Category, CatalogFeed::Delete, {categoryId});
+                DomainEvents::instance()->publishCategoryChange(DomainEvents::Removed,
+                                                                {categoryId});
                 QMessageBox::information(this, "Success", "Category deleted successfully.");
             } else {
                 QMessageBox::critical(this, "Error",
@@ -728,6 +1075,8 @@ void dashboard::on_SearchProductByNameLineEdit_returnPressed()
 
 void dashboard::on_AnalyticsButton_clicked()
 {
+    if (!enterPage(RolePages::Analytics)) return;
+
     if (!analyticsForm) {
         analyticsForm = new AnalyticsForm(this);
         QWidget* page = new QWidget(this);
@@ -743,6 +1092,24 @@ void dashboard::on_AnalyticsButton_clicked()
     ui->MainDisplayStackedWidget->setCurrentIndex(analyticsPageIndex);
 }
 
+void dashboard::on_OrdersButton_clicked()
+{
+    if (!enterPage(RolePages::Orders)) return;
+
+    if (!orderHistoryForm) {
+        QWidget* page = new QWidget(this);
+        orderHistoryForm = new OrderHistoryForm(page, getCurrentUserId(), currentRole);
+        QVBoxLayout* layout = new QVBoxLayout(page);
+        layout->setContentsMargins(0, 0, 0, 0);
+        layout->addWidget(orderHistoryForm);
+
+        orderHistoryPageIndex = ui->MainDisplayStackedWidget->addWidget(page);
+    }
+
+    ui->MainDisplayStackedWidget->setCurrentIndex(orderHistoryPageIndex);
+    setWindowTitle("BakeryPOS - Order History");
+}
+
 void dashboard::setupCashierPage()
 {
     if (!cashierForm) {
@@ -763,8 +1130,10 @@ void dashboard::setupCashierPage()
                 return;
             }
         }
+        cashierConnectionName = connectionName;
         
         cashierForm = new CashierForm(this, userId);
+        cashierForm->setInventoryMonitor(inventoryMonitor);
         
         QWidget* cashierPage = ui->MainDisplayStackedWidget->widget(9);
         if (!cashierPage->layout()) {
@@ -777,6 +1146,8 @@ void dashboard::setupCashierPage()
 
 void dashboard::on_InvoiceButton_clicked()
 {
+    if (!enterPage(RolePages::Invoice)) return;
+
     // Setup cashier page if not already done
     setupCashierPage();
     
@@ -787,31 +1158,9 @@ void dashboard::on_InvoiceButton_clicked()
 
 void dashboard::loadData()
 {
-    try {
-        // Initialize with products data first
-        Model->setQuery(BaseQuery);
-        
-        if (Model->lastError().isValid()) {
-            qDebug() << "Query error:" << Model->lastError().text();
-            return;
-        }
-        
-        // Set model for products table
-        ui->ProductPageTableView->setModel(Model);
-        
-        // Load initial data for tables
-        ApplyFiltersForProducts();
-        ApplyFiltersForUsers();
-        ApplyFiltersForCategories();
-        
-        // Update record count labels
-        UpdateProductRecordCountLabel();
-        UpdateUserRecordCountLabel();
-        UpdateCategoryRecordCountLabel();
-    }
-    catch (const std::exception& e) {
-        qDebug() << "Error in loadData:" << e.what();
-    }
+    // Only the page this role lands on is loaded now; the shared model is
+    // filled for the others when they are opened
+    openPage(RolePages::landingPage(currentRole));
 }
 
 // Keep only one implementation of getCurrentUserId
@@ -822,13 +1171,97 @@ int dashboard::getCurrentUserId() const
 
 void dashboard::connectSignals()
 {
-    // Connect table header clicks for sorting with correct table view names
-    connect(ui->ProductPageTableView->horizontalHeader(), &QHeaderView::sectionClicked,
-            this, &dashboard::OnProductHeaderSectionClicked);
-    
-    connect(ui->UserPageTableView->horizontalHeader(), &QHeaderView::sectionClicked,
-            this, &dashboard::OnUserHeaderSectionClicked);
-    
-    connect(ui->CategoryPageTableView->horizontalHeader(), &QHeaderView::sectionClicked,
-            this, &dashboard::OnCategoryHeaderSectionClicked);
+    // Table header clicks are connected as each page is built
+
+    // Edits anywhere in the app patch the visible table in place
+    DomainEvents *events = DomainEvents::instance();
+    connect(events, &DomainEvents::productChanged, this, &dashboard::OnProductChanged);
+    connect(events, &DomainEvents::userChanged, this, &dashboard::OnUserChanged);
+    connect(events, &DomainEvents::categoryChanged, this, &dashboard::OnCategoryChanged);
+    connect(events, &DomainEvents::catalogReloaded, this, &dashboard::OnCatalogReloaded);
+
+    // Edits and sales made on other registers arrive through catalogFeed,
+    // started by the constructor
+    QSettings settings("BakeryPOS", "BakeryPOS");
+
+    // Moves orders past the retention period out of the hot tables. Off
+    // unless configured; set archive/enabled on one register only, such as
+    // the back-office one, so tills never archive on their own.
+    if (settings.value("archive/enabled", false).toBool()) {
+        orderArchiver = new OrderArchiver(this);
+        orderArchiver->setKeepMonths(settings.value("archive/keepMonths", 24).toInt());
+        orderArchiver->setBatchSize(settings.value("archive/batchSize", 500).toInt());
+        orderArchiver->setPartitionOrders(
+            settings.value("archive/partitionOrders", false).toBool());
+        connect(orderArchiver, &OrderArchiver::finished, this, [](const ArchiveRun &run) {
+            if (!run.isValid()) {
+                qDebug() << "Order archiving failed:" << run.error;
+                return;
+            }
+            qDebug() << "Archived" << run.archived << "orders before" << run.cutoff
+                     << "- partitions added:" << run.partitionsAdded
+                     << "dropped:" << run.partitionsDropped;
+        });
+        orderArchiver->start(settings.value("archive/intervalHours", 24).toInt() * 3600 * 1000,
+                             5 * 60 * 1000);
+    }
+
+    // Sold lines that need preparing go to the production displays
+    if (settings.value("production/enabled", false).toBool()) {
+        ProductionFeed::instance()->start(
+            settings.value("production/serverName", "BakeryPOS-production").toString());
+    }
+
+    // Online orders and kiosks; off unless configured
+    if (settings.value("api/enabled", false).toBool()) {
+        apiServer = new ApiServer(settings.value("api/userId", currentUserId).toInt(), this);
+        apiServer->setToken(settings.value("api/token").toString());
+        apiServer->listen(QHostAddress(settings.value("api/bindAddress", "127.0.0.1").toString()),
+                          quint16(settings.value("api/port", 8470).toUInt()));
+    }
+}
+
+void dashboard::OnCatalogReloaded()
+{
+    if (inventoryMonitor) { inventoryMonitor->load(); }
+    if (Model->keyColumn() == "ProductID") { ApplyFiltersForProducts(); }
+}
+
+void dashboard::OnProductChanged(DomainEvents::ChangeType Type, const QList<int> &Ids)
+{
+    if (inventoryMonitor) { inventoryMonitor->refresh(Ids); }
+
+    // The shared model only holds products while the products page is shown
+    if (Model->keyColumn() != "ProductID") { return; }
+
+    if (Type == DomainEvents::Removed) {
+        Model->removeKeys(Ids);
+    } else {
+        Model->refreshKeys(Ids);
+    }
+    UpdateProductRecordCountLabel();
+}
+
+void dashboard::OnUserChanged(DomainEvents::ChangeType Type, const QList<int> &Ids)
+{
+    if (Model->keyColumn() != "UserID") { return; }
+
+    if (Type == DomainEvents::Removed) {
+        Model->removeKeys(Ids);
+    } else {
+        Model->refreshKeys(Ids);
+    }
+    UpdateUserRecordCountLabel();
+}
+
+void dashboard::OnCategoryChanged(DomainEvents::ChangeType Type, const QList<int> &Ids)
+{
+    if (Model->keyColumn() != "ID") { return; }
+
+    if (Type == DomainEvents::Removed) {
+        Model->removeKeys(Ids);
+    } else {
+        Model->refreshKeys(Ids);
+    }
+    UpdateCategoryRecordCountLabel();
 }
@@ -1,10 +1,23 @@
 #ifndef DASHBOARD_H
 #define DASHBOARD_H
 
+#include <QFuture>
+#include <QLabel>
 #include <QMainWindow>
+#include <QSharedPointer>
 #include <QTableView>
 #include "cashierform.h"
 #include "analyticsform.h"
+#include "OrderHistoryForm.h"
+#include "InventoryMonitor.h"
+#include "LiveQueryModel.h"
+#include "DomainEvents.h"
+#include "CatalogFeed.h"
+#include "OrderArchiver.h"
+#include "ApiServer.h"
+#include "ProductionFeed.h"
+#include "ProductTransfer.h"
+#include "RolePages.h"
 
 namespace Ui {
 class dashboard;
@@ -14,7 +27,8 @@ class dashboard : public QMainWindow {
     Q_OBJECT
 
   public:
-    explicit dashboard(QWidget *parent = nullptr, int userId = -1);
+    explicit dashboard(QWidget *parent = nullptr, int userId = -1,
+                       const QString &role = QString());
     ~dashboard();
 
   private slots:
@@ -23,6 +37,8 @@ class dashboard : public QMainWindow {
     void on_EditProductButton_clicked();
     void on_DeleteProductButton_clicked();
     void on_AddProductButton_clicked();
+    void on_ImportProductsButton_clicked();
+    void on_ExportProductsButton_clicked();
     void on_FilterRoleComboBox_currentIndexChanged();
     void on_UsersButton_clicked();
     void on_ProductsButton_clicked();
@@ -40,21 +56,43 @@ class dashboard : public QMainWindow {
     void OnProductHeaderSectionClicked(int LogicalIndex);
     void OnUserHeaderSectionClicked(int LogicalIndex);
     void OnCategoryHeaderSectionClicked(int LogicalIndex);
-    void refreshProductData();
     void UpdateCategoryRecordCountLabel();
     void on_AnalyticsButton_clicked();
+    void on_OrdersButton_clicked();
     void on_InvoiceButton_clicked();
+    void OnProductChanged(DomainEvents::ChangeType Type, const QList<int> &Ids);
+    void OnUserChanged(DomainEvents::ChangeType Type, const QList<int> &Ids);
+    void OnCategoryChanged(DomainEvents::ChangeType Type, const QList<int> &Ids);
+    void OnCatalogReloaded();
+    void onSwitchUserClicked();
+    void updateMemoryGauge();
 
   private:
     Ui::dashboard  *ui;
     int currentUserId;           // Move up
-    QSqlQueryModel *Model;       // Then Model
+    QString currentRole;         // decides which pages can be opened
+    LiveQueryModel *Model;       // Then Model
     QString         BaseQuery;
     QString         CurrentCategoryFilter;
     QString         CurrentSearchFilter;
     AnalyticsForm  *analyticsForm = nullptr;
     CashierForm* cashierForm = nullptr;  // Initialize to nullptr
     int analyticsPageIndex = -1;  // Track the analytics page index
+    OrderHistoryForm *orderHistoryForm = nullptr;
+    int orderHistoryPageIndex = -1;
+    InventoryMonitor *inventoryMonitor = nullptr;
+    CatalogFeed *catalogFeed = nullptr;
+    OrderArchiver *orderArchiver = nullptr;
+    ApiServer *apiServer = nullptr;
+    QSharedPointer<ProductImporter> importer; // shared with the worker while it runs
+    QSharedPointer<ProductExporter> exporter;
+    QFuture<void> importFuture;
+    QFuture<void> exportFuture;
+    QString cashierConnectionName;
+    QLabel *signedInLabel = nullptr;
+    QLabel *memoryLabel = nullptr;
+    QList<RolePages::Page> builtPages;
+    RolePages::Page currentPage = RolePages::Products;
 
     // Table pointers
     QTableView* productsTable;
@@ -79,6 +117,14 @@ class dashboard : public QMainWindow {
     void ApplyFiltersForCategories(const QString &SortColumn = QString(), 
                                  const QString &SortOrder = QString());
     void setupCashierPage();
+    void setupInventoryMonitor();
+    void setupSessionBar();
+    void setupMemoryGauge();
+    void switchUser(int userId);
+    void applyRole();
+    void openPage(RolePages::Page page);
+    bool enterPage(RolePages::Page page);
+    void buildPage(RolePages::Page page);
 };
 
 #endif // DASHBOARD_H
@@ -0,0 +1,255 @@
+#include "DemandForecast.h"
+
+#include <QHash>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QStringList>
+#include <QtConcurrent/QtConcurrentRun>
+#include <QDebug>
+
+#include <algorithm>
+#include <cmath>
+
+static const char *ForecastLock = "bakerypos_forecast";
+static const int   WriteBatch   = 500; // rows per INSERT when saving levels
+
+// One (product, weekday, hour) as a single integer
+static qint64 cellKey(int productId, int weekday, int hour) {
+    return (qint64(productId) * 8 + weekday) * 24 + hour;
+}
+
+struct ForecastCell {
+    double level        = 0;
+    int    observations = 0;
+    bool   changed      = false;
+};
+
+DemandForecast::DemandForecast(QObject *parent) : QObject(parent) {
+    connect(&watcher, &QFutureWatcher<BakeList>::finished, this,
+            [this]() { emit finished(watcher.result()); });
+}
+
+void DemandForecast::generate(const QDate &date) {
+    if (watcher.isRunning()) { return; }
+
+    const double alpha   = smoothing;
+    const int    safety  = safetyPercent;
+    const int    history = historyDays;
+    watcher.setFuture(QtConcurrent::run([date, alpha, safety, history]() {
+        const QString connectionName = "demand_forecast";
+        BakeList      list;
+        list.date = date;
+        {
+            QSqlDatabase db = QSqlDatabase::cloneDatabase(QSqlDatabase::defaultConnection,
+                                                          connectionName);
+            if (db.open()) {
+                QSqlQuery lock(db);
+                lock.prepare("SELECT GET_LOCK(?, 0)");
+                lock.bindValue(0, ForecastLock);
+                if (lock.exec() && lock.next() && lock.value(0).toInt() == 1) {
+                    // A failed update is reported rather than listing stale levels
+                    if (!update(connectionName, QDate::currentDate(), alpha, history, &list) &&
+                        list.error.isEmpty()) {
+                        list.error = "The forecast could not be updated";
+                    }
+
+                    lock.prepare("SELECT RELEASE_LOCK(?)");
+                    lock.bindValue(0, ForecastLock);
+                    lock.exec();
+                } else {
+                    qDebug() << "Forecast update skipped: another register holds the lock";
+                }
+                if (list.isValid()) { buildList(connectionName, date, safety, &list); }
+                db.close();
+            } else {
+                list.error = db.lastError().text();
+            }
+        }
+        QSqlDatabase::removeDatabase(connectionName);
+        return list;
+    }));
+}
+
+bool DemandForecast::update(const QString &connectionName, const QDate &today, double smoothing,
+                            int historyDays, BakeList *list) {
+    QSqlDatabase db = QSqlDatabase::database(connectionName);
+    QSqlQuery    query(db);
+    query.setForwardOnly(true);
+
+    // Carry on from the last closed day already folded in
+    QDate from = today.addDays(-historyDays);
+    if (!query.exec("SELECT ThroughDate FROM forecast_progress WHERE ID = 1")) {
+        list->error = query.lastError().text();
+        return false;
+    }
+    if (query.next()) { from = query.value(0).toDate().addDays(1); }
+    list->through = from.addDays(-1);
+    if (from >= today) { return true; } // today is still trading
+
+    QHash<qint64, ForecastCell> cells;
+    QVector<QVector<qint64>>    keysForWeekday(8);
+    if (!query.exec("SELECT ProductID, Weekday, Hour, Level, Observations FROM demand_forecast")) {
+        list->error = query.lastError().text();
+        return false;
+    }
+    while (query.next()) {
+        int    weekday = query.value(1).toInt();
+        qint64 key = cellKey(query.value(0).toInt(), weekday, query.value(2).toInt());
+        cells.insert(key, {query.value(3).toDouble(), query.value(4).toInt(), false});
+        keysForWeekday[weekday].append(key);
+    }
+
+    // A day's quantities are folded in once all of its rows have been read
+    QDate                 day;
+    QHash<qint64, double> sold;
+    auto                  applyDay = [&]() {
+        if (!day.isValid()) { return; }
+        const int weekday = day.dayOfWeek();
+
+        for (qint64 key : keysForWeekday.at(weekday)) {
+            ForecastCell &cell = cells[key];
+            double quantity = sold.take(key);
+            cell.level = smoothing * quantity + (1 - smoothing) * cell.level;
+            ++cell.observations;
+            cell.changed = true;
+        }
+
+        // First sale of a product in this hour of this weekday
+        for (auto it = sold.constBegin(); it != sold.constEnd(); ++it) {
+            cells.insert(it.key(), {it.value(), 1, true});
+            keysForWeekday[weekday].append(it.key());
+        }
+        sold.clear();
+        ++list->daysApplied;
+    };
+
+    // Refund lines are negative, so a returned sale cancels out
+    query.prepare("SELECT DATE(o.OrderDate), od.ProductID, HOUR(o.OrderDate), SUM(od.Quantity) "
+                  "FROM Orders o JOIN OrderDetails od ON od.OrderID = o.OrderID "
+                  "WHERE o.OrderDate >= ? AND o.OrderDate < ? "
+                  "GROUP BY DATE(o.OrderDate), od.ProductID, HOUR(o.OrderDate) "
+                  "ORDER BY DATE(o.OrderDate)");
+    query.bindValue(0, QDateTime(from, QTime(0, 0)));
+    query.bindValue(1, QDateTime(today, QTime(0, 0)));
+    if (!query.exec()) {
+        list->error = query.lastError().text();
+        return false;
+    }
+    while (query.next()) {
+        QDate rowDay = query.value(0).toDate();
+        if (rowDay != day) {
+            applyDay();
+            day = rowDay;
+        }
+        qint64 key = cellKey(query.value(1).toInt(), rowDay.dayOfWeek(), query.value(2).toInt());
+        sold[key] += qMax(0.0, query.value(3).toDouble());
+    }
+    applyDay();
+
+    // Levels and progress are saved together, so a day is never folded in twice
+    QVector<qint64> changed;
+    for (auto it = cells.constBegin(); it != cells.constEnd(); ++it) {
+        if (it.value().changed) { changed.append(it.key()); }
+    }
+
+    if (!db.transaction()) {
+        list->error = db.lastError().text();
+        return false;
+    }
+    for (int first = 0; first < changed.size(); first += WriteBatch) {
+        const int   count = qMin(WriteBatch, int(changed.size()) - first);
+        QStringList rows;
+        for (int i = 0; i < count; ++i) { rows << "(?, ?, ?, ?, ?)"; }
+
+        query.prepare("INSERT INTO demand_forecast (ProductID, Weekday, Hour, Level, "
+                      "Observations) VALUES " +
+                      rows.join(", ") +
+                      " ON DUPLICATE KEY UPDATE Level = VALUES(Level), "
+                      "Observations = VALUES(Observations)");
+        int position = 0;
+        for (int i = first; i < first + count; ++i) {
+            const qint64        key  = changed.at(i);
+            const ForecastCell &cell = cells.value(key);
+            query.bindValue(position++, int(key / 24 / 8));
+            query.bindValue(position++, int(key / 24 % 8));
+            query.bindValue(position++, int(key % 24));
+            query.bindValue(position++, cell.level);
+            query.bindValue(position++, cell.observations);
+        }
+        if (!query.exec()) {
+            list->error = query.lastError().text();
+            db.rollback();
+            return false;
+        }
+    }
+
+    list->through = today.addDays(-1);
+    query.prepare("INSERT INTO forecast_progress (ID, ThroughDate) VALUES (1, ?) "
+                  "ON DUPLICATE KEY UPDATE ThroughDate = VALUES(ThroughDate)");
+    query.bindValue(0, list->through);
+    if (!query.exec()) {
+        list->error = query.lastError().text();
+        db.rollback();
+        return false;
+    }
+    if (!db.commit()) {
+        list->error = db.lastError().text();
+        db.rollback();
+        return false;
+    }
+
+    qDebug() << "Forecast: folded in" << list->daysApplied << "days through" << list->through
+             << "," << changed.size() << "levels updated";
+    return true;
+}
+
+bool DemandForecast::buildList(const QString &connectionName, const QDate &date,
+                               int safetyPercent, BakeList *list) {
+    QSqlQuery query(QSqlDatabase::database(connectionName));
+    query.setForwardOnly(true);
+    query.prepare("SELECT f.ProductID, p.Name, f.Hour, f.Level "
+                  "FROM demand_forecast f JOIN products p ON p.ProductID = f.ProductID "
+                  "WHERE f.Weekday = ? AND p.status = 'Available' "
+                  "ORDER BY f.ProductID");
+    query.bindValue(0, date.dayOfWeek());
+    if (!query.exec()) {
+        list->error = query.lastError().text();
+        return false;
+    }
+
+    // Rows arrive by product; each product's hours add up to its day
+    double peakLevel = 0;
+    while (query.next()) {
+        int productId = query.value(0).toInt();
+        if (list->items.isEmpty() || list->items.last().productId != productId) {
+            BakeItem item;
+            item.productId = productId;
+            item.name      = query.value(1).toString();
+            list->items.append(item);
+            peakLevel = 0;
+        }
+
+        BakeItem &item  = list->items.last();
+        double    level = query.value(3).toDouble();
+        item.expected += level;
+        if (level > peakLevel) {
+            peakLevel     = level;
+            item.peakHour = query.value(2).toInt();
+        }
+    }
+
+    // The small allowance keeps float noise (2.0000001) from adding a unit
+    for (BakeItem &item : list->items) {
+        item.recommended = int(std::ceil(item.expected * (100 + safetyPercent) / 100.0 - 0.05));
+    }
+
+    // Nothing worth baking is left off
+    list->items.erase(std::remove_if(list->items.begin(), list->items.end(),
+                                     [](const BakeItem &item) { return item.recommended <= 0; }),
+                      list->items.end());
+    std::sort(list->items.begin(), list->items.end(), [](const BakeItem &a, const BakeItem &b) {
+        return a.expected > b.expected;
+    });
+    return true;
+}
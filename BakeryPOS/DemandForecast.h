@@ -0,0 +1,71 @@
+#ifndef DEMANDFORECAST_H
+#define DEMANDFORECAST_H
+
+#include <QDate>
+#include <QFutureWatcher>
+#include <QObject>
+#include <QString>
+#include <QVector>
+
+struct BakeItem {
+    int     productId = 0;
+    QString name;
+    double  expected    = 0; // units (kg for weighed products) over the day
+    int     recommended = 0; // expected plus the safety margin, rounded up
+    int     peakHour    = -1;
+};
+
+struct BakeList {
+    QDate             date;
+    QVector<BakeItem> items; // largest first
+    QDate             through;         // last closed day in the forecast
+    int               daysApplied = 0; // closed days folded in by this run
+    QString           error;
+
+    bool isValid() const { return error.isEmpty(); }
+};
+
+// Per-product demand by weekday and hour, and the bake list it gives.
+//
+// demand_forecast keeps an exponentially smoothed quantity for every
+// product, weekday and hour. A run folds in only the days closed since the
+// last one, read with one range query on OrderDate, so the work grows with
+// the new days rather than with the history. On a trading day every hour
+// of that weekday is updated, with zero where nothing sold, so demand that
+// stops fades out; days without any sales (closed) are skipped. The first
+// run starts historyDays back.
+//
+// Runs off the UI thread on its own connection. A named lock keeps two
+// registers from folding in the same days; the loser just reads the list.
+class DemandForecast : public QObject {
+    Q_OBJECT
+
+  public:
+    explicit DemandForecast(QObject *parent = nullptr);
+
+    void setSmoothing(double alpha) { smoothing = qBound(0.01, alpha, 1.0); }
+    void setSafetyPercent(int percent) { safetyPercent = qMax(0, percent); }
+    void setHistoryDays(int days) { historyDays = qMax(7, days); }
+
+    // Brings the forecast up to yesterday and builds the list for date.
+    // Ignored while a run is in progress.
+    void generate(const QDate &date);
+    bool isRunning() const { return watcher.isRunning(); }
+
+    // The steps generate() runs on the worker connection
+    static bool update(const QString &connectionName, const QDate &today, double smoothing,
+                       int historyDays, BakeList *list);
+    static bool buildList(const QString &connectionName, const QDate &date, int safetyPercent,
+                          BakeList *list);
+
+  signals:
+    void finished(const BakeList &list);
+
+  private:
+    QFutureWatcher<BakeList> watcher;
+    double                   smoothing     = 0.3;
+    int                      safetyPercent = 10;
+    int                      historyDays   = 365;
+};
+
+#endif // DEMANDFORECAST_H
@@ -0,0 +1,29 @@
+#include "DomainEvents.h"
+
+#include <QCoreApplication>
+
+DomainEvents::DomainEvents(QObject *parent) : QObject(parent) {}
+
+DomainEvents *DomainEvents::instance() {
+    // Parented to the application so it is destroyed with it
+    static DomainEvents *bus = new DomainEvents(QCoreApplication::instance());
+    return bus;
+}
+
+void DomainEvents::publishProductChange(ChangeType type,
+                                        const QList<int> &productIds) {
+    emit productChanged(type, productIds);
+}
+
+void DomainEvents::publishUserChange(ChangeType type, const QList<int> &userIds) {
+    emit userChanged(type, userIds);
+}
+
+void DomainEvents::publishCategoryChange(ChangeType        type,
+                                         const QList<int> &categoryIds) {
+    emit categoryChanged(type, categoryIds);
+}
+
+void DomainEvents::publishCatalogReload() {
+    emit catalogReloaded();
+}
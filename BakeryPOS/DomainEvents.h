@@ -0,0 +1,38 @@
+#ifndef DOMAINEVENTS_H
+#define DOMAINEVENTS_H
+
+#include <QList>
+#include <QObject>
+
+// Application-wide notification bus for catalog and user edits.
+//
+// Edit forms publish what they changed (with the affected row IDs) instead
+// of asking their owner to requery everything. Views subscribe and patch
+// only those rows.
+class DomainEvents : public QObject {
+    Q_OBJECT
+
+  public:
+    enum ChangeType { Inserted, Updated, Removed };
+    Q_ENUM(ChangeType)
+
+    static DomainEvents *instance();
+
+    void publishProductChange(ChangeType type, const QList<int> &productIds);
+    void publishUserChange(ChangeType type, const QList<int> &userIds);
+    void publishCategoryChange(ChangeType type, const QList<int> &categoryIds);
+    void publishCatalogReload();
+
+  signals:
+    void productChanged(DomainEvents::ChangeType type, const QList<int> &productIds);
+    void userChanged(DomainEvents::ChangeType type, const QList<int> &userIds);
+    void categoryChanged(DomainEvents::ChangeType type,
+                         const QList<int> &categoryIds);
+    // Too many products changed to list (e.g. a bulk import)
+    void catalogReloaded();
+
+  private:
+    explicit DomainEvents(QObject *parent = nullptr);
+};
+
+#endif // DOMAINEVENTS_H
@@ -1,5 +1,7 @@
 #include "EditProductForm.h"
 #include "ui_EditProductForm.h"
+#include "DomainEvents.h"
+#include "CatalogFeed.h"
 
 EditProductForm::EditProductForm(QWidget *parent)
     : QWidget(parent), ui(new Ui::EditProductForm), currentProductId(-1) {
@@ -49,6 +51,7 @@ void EditProductForm::setupValidation() {
     ui->ProductPricePerKgLineEdit->setValidator(priceValidator);
     ui->ProductPricePerPcsLineEdit->setValidator(priceValidator);
     ui->ProductStockQuantityLineEdit->setValidator(quantityValidator);
+    ui->ProductLowStockLineEdit->setValidator(quantityValidator);
 }
 
 void EditProductForm::updatePriceFieldsVisibility() {
@@ -76,7 +79,8 @@ void EditProductForm::loadProductData(int productId) {
 
     QSqlQuery query;
     query.prepare("SELECT Name, Category, PricePerKg, PricePerUnit, "
-                  "StockQuantity, UnitType FROM products WHERE ProductID = ?");
+                  "StockQuantity, UnitType, Barcode, LowStockThreshold FROM products "
+                  "WHERE ProductID = ?");
     query.bindValue(0, productId);
 
     if (query.exec() && query.next()) {
@@ -107,6 +111,13 @@ void EditProductForm::loadProductData(int productId) {
         ui->ProductStockQuantityLineEdit->setText(
             QString::number(query.value("StockQuantity").toDouble(), 'f', 2));
 
+        ui->ProductBarcodeLineEdit->setText(query.value("Barcode").toString());
+
+        // Empty means the register's default threshold applies
+        QVariant lowStock = query.value("LowStockThreshold");
+        ui->ProductLowStockLineEdit->setText(
+            lowStock.isNull() ? QString() : QString::number(lowStock.toDouble(), 'f', 2));
+
         // Note: UnitType is loaded but we don't display it in the form
         // It will be automatically determined based on which price fields are
         // filled
@@ -120,50 +131,41 @@ void EditProductForm::loadProductData(int productId) {
     }
 }
 
-bool EditProductForm::validateInput() {
-    // Check if name is empty
-    if (ui->ProductNameLineEdit->text().trimmed().isEmpty()) {
-        QMessageBox::warning(this, "Validation Error",
-                             "Product name cannot be empty.");
-        ui->ProductNameLineEdit->setFocus();
-        return false;
-    }
-
-    // Check if category is selected
-    if (categoryComboBox->currentText() == "Select Category") {
-        QMessageBox::warning(this, "Validation Error",
-                             "Please select a category.");
-        categoryComboBox->setFocus();
-        return false;
-    }
-
-    // Check if at least one price is provided
-    bool hasPricePerKg =
-        !ui->ProductPricePerKgLineEdit->text().trimmed().isEmpty();
-    bool hasPricePerUnit =
-        !ui->ProductPricePerPcsLineEdit->text().trimmed().isEmpty();
-
-    if (!hasPricePerKg && !hasPricePerUnit) {
-        QMessageBox::warning(
-            this, "Validation Error",
-            "Please provide at least one price (Per KG or Per Unit).");
-        return false;
-    }
-
-    // Check if stock quantity is provided
-    if (ui->ProductStockQuantityLineEdit->text().trimmed().isEmpty()) {
-        QMessageBox::warning(this, "Validation Error",
-                             "Stock quantity cannot be empty.");
-        ui->ProductStockQuantityLineEdit->setFocus();
-        return false;
-    }
+ProductRecord EditProductForm::currentRecord() const {
+    ProductRecord record;
+    record.name          = ui->ProductNameLineEdit->text().trimmed();
+    record.category      = categoryComboBox->currentText();
+    record.pricePerKg    = ui->ProductPricePerKgLineEdit->text().trimmed();
+    record.pricePerUnit  = ui->ProductPricePerPcsLineEdit->text().trimmed();
+    record.stockQuantity = ui->ProductStockQuantityLineEdit->text().trimmed();
+    record.barcode       = ui->ProductBarcodeLineEdit->text().trimmed();
+    return record;
+}
 
-    // Validate that stock quantity is not negative
-    double stockQuantity = ui->ProductStockQuantityLineEdit->text().toDouble();
-    if (stockQuantity < 0) {
-        QMessageBox::warning(this, "Validation Error",
-                             "Stock quantity cannot be negative.");
-        ui->ProductStockQuantityLineEdit->setFocus();
+bool EditProductForm::validateInput() {
+    // Field rules are shared with the bulk importer
+    QString              message;
+    ProductRecord::Field field = currentRecord().validate(&message);
+
+    if (field != ProductRecord::NoField) {
+        QMessageBox::warning(this, "Validation Error", message);
+
+        switch (field) {
+        case ProductRecord::NameField:
+            ui->ProductNameLineEdit->setFocus();
+            break;
+        case ProductRecord::CategoryField:
+            categoryComboBox->setFocus();
+            break;
+        case ProductRecord::StockField:
+            ui->ProductStockQuantityLineEdit->setFocus();
+            break;
+        case ProductRecord::BarcodeField:
+            ui->ProductBarcodeLineEdit->setFocus();
+            break;
+        default:
+            break;
+        }
         return false;
     }
 
@@ -185,6 +187,24 @@ bool EditProductForm::validateInput() {
         }
     }
 
+    // Barcodes are unique, so a code already on another product is refused
+    // here rather than by the constraint
+    QString barcode = ui->ProductBarcodeLineEdit->text().trimmed();
+    if (!barcode.isEmpty()) {
+        QSqlQuery checkQuery;
+        checkQuery.prepare("SELECT Name FROM products WHERE Barcode = ? AND ProductID <> ?");
+        checkQuery.bindValue(0, barcode);
+        checkQuery.bindValue(1, currentProductId);
+
+        if (checkQuery.exec() && checkQuery.next()) {
+            QMessageBox::warning(this, "Validation Error",
+                                 "This barcode is already assigned to " +
+                                     checkQuery.value(0).toString() + ".");
+            ui->ProductBarcodeLineEdit->setFocus();
+            return false;
+        }
+    }
+
     return true;
 }
 
@@ -203,63 +223,58 @@ void EditProductForm::on_SaveButton_clicked() {
         // Adding new product - include UnitType and let date_added and status
         // use defaults
         queryString = "INSERT INTO products (Name, Category, PricePerKg, "
-                      "PricePerUnit, StockQuantity, UnitType) "
-                      "VALUES (?, ?, ?, ?, ?, ?)";
+                      "PricePerUnit, StockQuantity, UnitType, Barcode, LowStockThreshold) "
+                      "VALUES (?, ?, ?, ?, ?, ?, ?, ?)";
     } else {
         // Updating existing product
         queryString =
             "UPDATE products SET Name = ?, Category = ?, PricePerKg = ?, "
-            "PricePerUnit = ?, StockQuantity = ?, UnitType = ? WHERE ProductID "
-            "= ?";
+            "PricePerUnit = ?, StockQuantity = ?, UnitType = ?, Barcode = ?, "
+            "LowStockThreshold = ? WHERE ProductID = ?";
     }
 
+    ProductRecord record = currentRecord();
+
     query.prepare(queryString);
-    query.bindValue(0, ui->ProductNameLineEdit->text().trimmed());
-    query.bindValue(1, categoryComboBox->currentText());
+    query.bindValue(0, record.name);
+    query.bindValue(1, record.category);
 
-    // Handle price per kg (can be NULL)
-    QString pricePerKgText = ui->ProductPricePerKgLineEdit->text().trimmed();
-    if (pricePerKgText.isEmpty()) {
-        query.bindValue(2, QVariant(QMetaType(QMetaType::Double)));
-    } else {
-        query.bindValue(2, pricePerKgText.toDouble());
-    }
+    // Empty price fields are stored as NULL
+    query.bindValue(2, record.pricePerKgValue());
+    query.bindValue(3, record.pricePerUnitValue());
 
-    // Handle price per unit (can be NULL)
-    QString pricePerUnitText = ui->ProductPricePerPcsLineEdit->text().trimmed();
-    if (pricePerUnitText.isEmpty()) {
-        query.bindValue(3, QVariant(QMetaType(QMetaType::Double)));
-    } else {
-        query.bindValue(3, pricePerUnitText.toDouble());
-    }
+    query.bindValue(4, record.stockQuantity.toDouble());
 
-    query.bindValue(4, ui->ProductStockQuantityLineEdit->text().toDouble());
-
-    // Determine unit type based on which price field is filled
-    // Your enum values are 'kg' and 'unit' (not 'pieces')
-    QString unitType = "unit"; // default
-    if (!pricePerKgText.isEmpty() && pricePerUnitText.isEmpty()) {
-        unitType = "kg";
-    } else if (pricePerKgText.isEmpty() && !pricePerUnitText.isEmpty()) {
-        unitType = "unit";
-    } else if (!pricePerKgText.isEmpty() && !pricePerUnitText.isEmpty()) {
-        // If both prices are provided, default to 'unit' since we can't use
-        // 'both'
-        unitType = "unit";
-    }
-    query.bindValue(5, unitType);
+    // Unit type is derived from which price field is filled
+    query.bindValue(5, record.unitType());
+
+    // An empty barcode is stored as NULL, which the unique key allows twice
+    query.bindValue(6, record.barcodeValue());
+
+    QString lowStock = ui->ProductLowStockLineEdit->text().trimmed();
+    query.bindValue(7, lowStock.isEmpty() ? QVariant(QMetaType(QMetaType::Double))
+                                          : QVariant(lowStock.toDouble()));
 
     if (currentProductId != -1) {
         // For update, bind the product ID
-        query.bindValue(6, currentProductId);
+        query.bindValue(8, currentProductId);
     }
 
     if (query.exec()) {
         QString successMessage;
         if (currentProductId == -1) {
             successMessage = "Product added successfully!";
+            int productId  = query.lastInsertId().toInt();
+            CatalogFeed::record(CatalogFeed::Product, CatalogFeed::Insert,
+                                {productId});
+            DomainEvents::instance()->publishProductChange(
+                DomainEvents::Inserted, {productId});
         } else {
             successMessage = "Product updated successfully!";
+            CatalogFeed::record(CatalogFeed::Product, CatalogFeed::Update,
+                                {currentProductId});
+            DomainEvents::instance()->publishProductChange(
+                DomainEvents::Updated, {currentProductId});
         }
 
         QMessageBox::information(this, "Success", successMessage);
@@ -294,5 +309,7 @@ void EditProductForm::clearForm() {
     ui->ProductPricePerKgLineEdit->clear();
     ui->ProductPricePerPcsLineEdit->clear();
     ui->ProductStockQuantityLineEdit->clear();
+    ui->ProductBarcodeLineEdit->clear();
+    ui->ProductLowStockLineEdit->clear();
     currentProductId = -1;
 }
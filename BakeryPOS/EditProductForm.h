@@ -9,6 +9,8 @@
 #include <QSqlQuery>
 #include <QWidget>
 
+#include "ProductRecord.h"
+
 QT_BEGIN_NAMESPACE
 namespace Ui {
 class EditProductForm;
@@ -40,6 +42,7 @@ class EditProductForm : public QWidget {
 
     void setupCategoryComboBox();
     void setupValidation();
+    ProductRecord currentRecord() const;
     bool validateInput();
     void clearForm();
     void updatePriceFieldsVisibility();
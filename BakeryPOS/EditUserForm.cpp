@@ -1,12 +1,17 @@
 #include "EditUserForm.h"
 #include "./ui_EditUserForm.h"  // Note the ./ prefix
+#include "DomainEvents.h"
+#include "CredentialStore.h"
+#include "PasswordHash.h"
 #include <QMessageBox>
+#include <QRegularExpression>
 #include <QSqlError>
 #include <QSqlQuery>
 
 EditUserForm::EditUserForm(QWidget *parent)
     : QDialog(parent)
     , ui(new Ui::EditUserForm)
+    , currentUserId(0)
 {
     ui->setupUi(this);
     setWindowTitle("Edit User");
@@ -16,6 +21,7 @@ EditUserForm::EditUserForm(QWidget *parent)
     ui->roleComboBox->addItem("Admin");
     ui->roleComboBox->addItem("Cashier");
     ui->roleComboBox->addItem("Manager");
+    ui->roleComboBox->addItem("Inventory Manager");
 
     // Setup status combo box with all possible statuses from your table
     ui->statusComboBox->clear();
@@ -54,6 +60,7 @@ void EditUserForm::on_saveButton_clicked()
     QString role = ui->roleComboBox->currentText();
     QString password = ui->passwordLineEdit->text();
     QString status = ui->statusComboBox->currentText();
+    QString pin = ui->pinLineEdit->text();
 
     // Validate input
     if (username.isEmpty()) {
@@ -66,6 +73,15 @@ void EditUserForm::on_saveButton_clicked()
         return;
     }
 
+    if (!pin.isEmpty() && !QRegularExpression("^\\d{4,8}$").match(pin).hasMatch()) {
+        QMessageBox::warning(this, "Validation Error", "PIN must be 4 to 8 digits");
+        return;
+    }
+
+    // Only salted hashes are stored; a blank field keeps the current value
+    QString passwordHash = password.isEmpty() ? QString() : PasswordHash::hash(password);
+    QString pinHash = pin.isEmpty() ? QString() : PasswordHash::hash(pin, PasswordHash::PinCost);
+
     QSqlQuery query;
     if (currentUserId > 0) {
         // Update existing user
@@ -79,7 +95,7 @@ void EditUserForm::on_saveButton_clicked()
             query.prepare("UPDATE users SET username = ?, role = ?, password = ?, status = ? WHERE UserID = ?");  // Changed 'id' to 'UserID'
             query.bindValue(0, username);
             query.bindValue(1, role);
-            query.bindValue(2, password);
+            query.bindValue(2, passwordHash);
             query.bindValue(3, status);
             query.bindValue(4, currentUserId);
         }
@@ -87,12 +103,32 @@ void EditUserForm::on_saveButton_clicked()
         // Insert new user
         query.prepare("INSERT INTO users (username, password, role, status, date) VALUES (?, ?, ?, ?, CURRENT_DATE)");
         query.bindValue(0, username);
-        query.bindValue(1, password);
+        query.bindValue(1, passwordHash);
         query.bindValue(2, role);
         query.bindValue(3, status);
     }
 
     if (query.exec()) {
+        int userId = currentUserId > 0 ? currentUserId : query.lastInsertId().toInt();
+
+        if (!pinHash.isEmpty()) {
+            QSqlQuery pinQuery;
+            pinQuery.prepare("UPDATE users SET PinHash = ? WHERE UserID = ?");
+            pinQuery.bindValue(0, pinHash);
+            pinQuery.bindValue(1, userId);
+            if (!pinQuery.exec()) {
+                QMessageBox::warning(this, "Error", "Failed to save PIN: " + pinQuery.lastError().text());
+            }
+        }
+
+        // Keep this register's login and PIN switch in step
+        CredentialStore::instance()->refresh();
+
+        if (currentUserId > 0) {
+            DomainEvents::instance()->publishUserChange(DomainEvents::Updated, {currentUserId});
+        } else {
+            DomainEvents::instance()->publishUserChange(DomainEvents::Inserted, {userId});
+        }
         emit userUpdated();
         accept();
     } else {
@@ -0,0 +1,241 @@
+#include "InventoryMonitor.h"
+
+#include <QBrush>
+#include <QColor>
+#include <QSet>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QStringList>
+#include <QDebug>
+
+InventoryMonitor::InventoryMonitor(QObject *parent) : QObject(parent) {}
+
+bool InventoryMonitor::load() {
+    QSqlQuery query;
+    query.setForwardOnly(true);
+    if (!query.exec("SELECT ProductID, StockQuantity, LowStockThreshold FROM products "
+                    "WHERE status = 'Available'")) {
+        qDebug() << "Inventory load failed:" << query.lastError().text();
+        return false;
+    }
+
+    entries.clear();
+    thresholds.clear();
+    while (query.next()) {
+        int    productId = query.value(0).toInt();
+        double quantity  = query.value(1).toDouble();
+        setThreshold(productId, query.value(2));
+        entries.insert(productId, Entry{quantity, levelFor(productId, quantity)});
+    }
+    return true;
+}
+
+bool InventoryMonitor::refresh(const QList<int> &productIds) {
+    if (productIds.isEmpty()) { return true; }
+
+    QStringList placeholders;
+    for (int i = 0; i < productIds.size(); ++i) { placeholders << "?"; }
+
+    QSqlQuery query;
+    query.prepare(QString("SELECT ProductID, StockQuantity, status, LowStockThreshold "
+                          "FROM products WHERE ProductID IN (%1)")
+                      .arg(placeholders.join(", ")));
+    for (int i = 0; i < productIds.size(); ++i) {
+        query.bindValue(i, productIds.at(i));
+    }
+
+    if (!query.exec()) {
+        qDebug() << "Inventory refresh failed:" << query.lastError().text();
+        return false;
+    }
+
+    QSet<int> seen;
+    while (query.next()) {
+        int productId = query.value(0).toInt();
+        if (query.value(2).toString() != "Available") { continue; }
+        seen.insert(productId);
+        setThreshold(productId, query.value(3));
+        update(productId, query.value(1).toDouble());
+    }
+
+    // Deleted or no longer for sale
+    for (int productId : productIds) {
+        if (!seen.contains(productId)) { removeProduct(productId); }
+    }
+    return true;
+}
+
+void InventoryMonitor::setLowStockThreshold(double quantity) {
+    defaultThreshold = quantity;
+}
+
+// NULL falls back to the default
+void InventoryMonitor::setThreshold(int productId, const QVariant &quantity) {
+    if (quantity.isNull()) {
+        thresholds.remove(productId);
+    } else {
+        thresholds.insert(productId, quantity.toDouble());
+    }
+}
+
+double InventoryMonitor::lowStockThreshold(int productId) const {
+    return thresholds.value(productId, defaultThreshold);
+}
+
+bool InventoryMonitor::contains(int productId) const {
+    return entries.contains(productId);
+}
+
+double InventoryMonitor::stock(int productId) const {
+    return entries.value(productId).stock;
+}
+
+InventoryMonitor::Level InventoryMonitor::level(int productId) const {
+    return entries.value(productId).level;
+}
+
+bool InventoryMonitor::isSoldOut(int productId) const {
+    auto it = entries.constFind(productId);
+    return it != entries.constEnd() && it->level == OutOfStock;
+}
+
+void InventoryMonitor::applySale(int productId, double quantity) {
+    auto it = entries.constFind(productId);
+    if (it == entries.constEnd()) { return; }
+    update(productId, it->stock - quantity);
+}
+
+void InventoryMonitor::applyStockLevel(int productId, double quantity) {
+    update(productId, quantity);
+}
+
+void InventoryMonitor::removeProduct(int productId) {
+    entries.remove(productId);
+    thresholds.remove(productId);
+}
+
+InventoryMonitor::Level InventoryMonitor::levelFor(int    productId,
+                                                   double quantity) const {
+    // Weighed items can end up with a few grams left; treat that as empty
+    if (quantity < 0.001) { return OutOfStock; }
+    if (quantity <= lowStockThreshold(productId)) { return LowStock; }
+    return InStock;
+}
+
+void InventoryMonitor::update(int productId, double quantity) {
+    Entry &entry    = entries[productId];
+    Level  previous = entry.level;
+
+    entry.stock = quantity;
+    entry.level = levelFor(productId, quantity);
+
+    emit stockChanged(productId, quantity);
+
+    if (entry.level == previous) { return; }
+
+    switch (entry.level) {
+    case OutOfStock:
+        emit outOfStock(productId);
+        break;
+    case LowStock:
+        if (previous == OutOfStock) { emit backInStock(productId); }
+        emit lowStock(productId, quantity);
+        break;
+    case InStock:
+        if (previous == OutOfStock) { emit backInStock(productId); }
+        break;
+    }
+}
+
+CatalogStockProxyModel::CatalogStockProxyModel(int idColumn, int stockColumn,
+                                               QObject *parent)
+    : QIdentityProxyModel(parent), idColumn(idColumn), stockColumn(stockColumn) {
+}
+
+void CatalogStockProxyModel::setInventoryMonitor(InventoryMonitor *newMonitor) {
+    if (monitor) { disconnect(monitor, nullptr, this, nullptr); }
+
+    monitor = newMonitor;
+    if (monitor) {
+        connect(monitor, &InventoryMonitor::stockChanged, this,
+                &CatalogStockProxyModel::onStockChanged);
+    }
+
+    rebuildRowIndex();
+    if (rowCount() > 0) {
+        emit dataChanged(index(0, 0), index(rowCount() - 1, columnCount() - 1));
+    }
+}
+
+void CatalogStockProxyModel::setSourceModel(QAbstractItemModel *model) {
+    if (sourceModel()) { disconnect(sourceModel(), nullptr, this, nullptr); }
+
+    QIdentityProxyModel::setSourceModel(model);
+
+    if (model) {
+        connect(model, &QAbstractItemModel::modelReset, this,
+                &CatalogStockProxyModel::rebuildRowIndex);
+        connect(model, &QAbstractItemModel::rowsInserted, this,
+                &CatalogStockProxyModel::rebuildRowIndex);
+        connect(model, &QAbstractItemModel::rowsRemoved, this,
+                &CatalogStockProxyModel::rebuildRowIndex);
+        // LiveQueryModel moves a row when its sort column changes
+        connect(model, &QAbstractItemModel::rowsMoved, this,
+                &CatalogStockProxyModel::rebuildRowIndex);
+        connect(model, &QAbstractItemModel::layoutChanged, this,
+                &CatalogStockProxyModel::rebuildRowIndex);
+    }
+    rebuildRowIndex();
+}
+
+QVariant CatalogStockProxyModel::data(const QModelIndex &index, int role) const {
+    if (monitor && index.isValid()) {
+        int productId = productIdAt(index.row());
+
+        if (role == Qt::DisplayRole && index.column() == stockColumn &&
+            monitor->contains(productId)) {
+            return monitor->stock(productId);
+        }
+
+        if (role == Qt::ForegroundRole) {
+            switch (monitor->level(productId)) {
+            case InventoryMonitor::OutOfStock:
+                return QBrush(QColor("#9e9e9e"));
+            case InventoryMonitor::LowStock:
+                return QBrush(QColor("#c0392b"));
+            default:
+                break;
+            }
+        }
+    }
+    return QIdentityProxyModel::data(index, role);
+}
+
+Qt::ItemFlags CatalogStockProxyModel::flags(const QModelIndex &index) const {
+    Qt::ItemFlags result = QIdentityProxyModel::flags(index);
+    if (monitor && index.isValid() && monitor->isSoldOut(productIdAt(index.row()))) {
+        result &= ~(Qt::ItemIsEnabled | Qt::ItemIsSelectable);
+    }
+    return result;
+}
+
+void CatalogStockProxyModel::onStockChanged(int productId) {
+    auto it = rowForProduct.constFind(productId);
+    if (it == rowForProduct.constEnd()) { return; }
+    emit dataChanged(index(*it, 0), index(*it, columnCount() - 1));
+}
+
+void CatalogStockProxyModel::rebuildRowIndex() {
+    rowForProduct.clear();
+    QAbstractItemModel *model = sourceModel();
+    if (!model) { return; }
+
+    for (int row = 0; row < model->rowCount(); ++row) {
+        rowForProduct.insert(productIdAt(row), row);
+    }
+}
+
+int CatalogStockProxyModel::productIdAt(int row) const {
+    QAbstractItemModel *model = sourceModel();
+    return model ? model->index(row, idColumn).data().toInt() : -1;
+}
@@ -0,0 +1,92 @@
+#ifndef INVENTORYMONITOR_H
+#define INVENTORYMONITOR_H
+
+#include <QHash>
+#include <QIdentityProxyModel>
+#include <QObject>
+
+// Keeps the stock level of every product in memory.
+//
+// The table is read once by load(); afterwards checkouts report what they
+// sold through applySale() and edits report the products they touched
+// through refresh(), so nothing has to re-read the products table to know
+// when an item runs low. Signals fire only when a product crosses a
+// threshold, not on every sale. A product's threshold is its
+// LowStockThreshold column, or the default when that is NULL.
+class InventoryMonitor : public QObject {
+    Q_OBJECT
+
+  public:
+    enum Level { InStock, LowStock, OutOfStock };
+
+    explicit InventoryMonitor(QObject *parent = nullptr);
+
+    bool load();
+    bool refresh(const QList<int> &productIds);
+
+    void   setLowStockThreshold(double quantity); // the default
+    double lowStockThreshold(int productId) const;
+
+    bool   contains(int productId) const;
+    double stock(int productId) const;
+    Level  level(int productId) const;
+    bool   isSoldOut(int productId) const;
+
+  public slots:
+    void applySale(int productId, double quantity);
+    void applyStockLevel(int productId, double quantity);
+    void removeProduct(int productId);
+
+  signals:
+    void stockChanged(int productId, double quantity);
+    void lowStock(int productId, double quantity);
+    void outOfStock(int productId);
+    void backInStock(int productId);
+
+  private:
+    struct Entry {
+        double stock = 0.0;
+        Level  level = InStock;
+    };
+
+    QHash<int, Entry>  entries;
+    QHash<int, double> thresholds; // per-product overrides
+    double             defaultThreshold = 5.0;
+
+    Level levelFor(int productId, double quantity) const;
+    void  update(int productId, double quantity);
+    void  setThreshold(int productId, const QVariant &quantity);
+};
+
+// Presents the cashier catalog with live stock levels from an
+// InventoryMonitor. Sold-out rows are greyed out and cannot be selected.
+// Rows keep the source model's numbering, so row indexes taken from the view
+// can still be used against the source model.
+class CatalogStockProxyModel : public QIdentityProxyModel {
+    Q_OBJECT
+
+  public:
+    CatalogStockProxyModel(int idColumn, int stockColumn,
+                           QObject *parent = nullptr);
+
+    void setInventoryMonitor(InventoryMonitor *monitor);
+    void setSourceModel(QAbstractItemModel *model) override;
+
+    QVariant      data(const QModelIndex &index,
+                       int                role = Qt::DisplayRole) const override;
+    Qt::ItemFlags flags(const QModelIndex &index) const override;
+
+  private slots:
+    void onStockChanged(int productId);
+    void rebuildRowIndex();
+
+  private:
+    int               idColumn;
+    int               stockColumn;
+    InventoryMonitor *monitor = nullptr;
+    QHash<int, int>   rowForProduct;
+
+    int productIdAt(int row) const;
+};
+
+#endif // INVENTORYMONITOR_H
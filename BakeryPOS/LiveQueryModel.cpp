@@ -0,0 +1,275 @@
+#include "LiveQueryModel.h"
+
+#include <QDateTime>
+#include <QRegularExpression>
+#include <QSet>
+#include <QSqlQuery>
+#include <QStringList>
+#include <QDebug>
+
+#include <algorithm>
+#include <functional>
+
+LiveQueryModel::LiveQueryModel(QObject *parent) : QAbstractTableModel(parent) {}
+
+void LiveQueryModel::setQuery(const QString &query, const QString &keyColumn) {
+    beginResetModel();
+
+    currentQuery     = query;
+    currentKeyColumn = keyColumn;
+    rows.clear();
+    headerOverrides.clear();
+    error = QSqlError();
+
+    QSqlQuery sql;
+    sql.setForwardOnly(true);
+    if (sql.exec(query)) {
+        columns  = sql.record();
+        keyIndex = keyColumn.isEmpty() ? -1 : columns.indexOf(keyColumn);
+
+        const int columnTotal = columns.count();
+        while (sql.next()) {
+            QVector<QVariant> row(columnTotal);
+            for (int i = 0; i < columnTotal; ++i) { row[i] = sql.value(i); }
+            rows.append(row);
+        }
+    } else {
+        error    = sql.lastError();
+        columns  = QSqlRecord();
+        keyIndex = -1;
+        qDebug() << "LiveQueryModel query failed:" << error.text();
+    }
+
+    parseOrderBy();
+    rebuildRowIndex();
+    endResetModel();
+}
+
+void LiveQueryModel::parseOrderBy() {
+    sortKeys.clear();
+
+    // The last ORDER BY outside parentheses, up to any LIMIT
+    static const QRegularExpression orderBy("\\bORDER\\s+BY\\b",
+                                            QRegularExpression::CaseInsensitiveOption);
+    int start = -1;
+    int depth = 0;
+    for (int i = 0; i < currentQuery.size(); ++i) {
+        QChar c = currentQuery.at(i);
+        if (c == '(') {
+            ++depth;
+        } else if (c == ')') {
+            --depth;
+        } else if (depth == 0 && (c == 'O' || c == 'o')) {
+            QRegularExpressionMatch match =
+                orderBy.match(currentQuery, i, QRegularExpression::NormalMatch,
+                              QRegularExpression::AnchorAtOffsetMatchOption);
+            if (match.hasMatch()) { start = match.capturedEnd(); }
+        }
+    }
+    if (start < 0) { return; }
+
+    QString clause = currentQuery.mid(start);
+    static const QRegularExpression limit("\\bLIMIT\\b.*$",
+                                          QRegularExpression::CaseInsensitiveOption |
+                                              QRegularExpression::DotMatchesEverythingOption);
+    clause.remove(limit);
+
+    // Plain (optionally qualified or quoted) column names only; anything
+    // else leaves the order unknown
+    static const QRegularExpression term(
+        "^\\s*(?:`?\\w+`?\\.)?`?(\\w+)`?(?:\\s+(ASC|DESC))?\\s*$",
+        QRegularExpression::CaseInsensitiveOption);
+    for (const QString &part : clause.split(',')) {
+        QRegularExpressionMatch match = term.match(part);
+        int column = match.hasMatch() ? columns.indexOf(match.captured(1)) : -1;
+        if (column < 0) {
+            sortKeys.clear();
+            return;
+        }
+        sortKeys.append({column, match.captured(2).compare("DESC", Qt::CaseInsensitive) == 0});
+    }
+}
+
+// Orders values roughly as MySQL does: NULL first, text without regard to
+// case, numbers and dates by value
+static int compareValues(const QVariant &a, const QVariant &b) {
+    if (a.isNull() || b.isNull()) { return int(b.isNull()) - int(a.isNull()); }
+
+    switch (a.typeId()) {
+    case QMetaType::QString:
+    case QMetaType::QByteArray:
+        return a.toString().compare(b.toString(), Qt::CaseInsensitive);
+    case QMetaType::QDate:
+    case QMetaType::QDateTime:
+    case QMetaType::QTime: {
+        QDateTime left  = a.toDateTime();
+        QDateTime right = b.toDateTime();
+        return left < right ? -1 : (right < left ? 1 : 0);
+    }
+    default: {
+        double left  = a.toDouble();
+        double right = b.toDouble();
+        return left < right ? -1 : (right < left ? 1 : 0);
+    }
+    }
+}
+
+bool LiveQueryModel::rowLess(const QVector<QVariant> &a, const QVector<QVariant> &b) const {
+    for (const auto &key : sortKeys) {
+        int order = compareValues(a.at(key.first), b.at(key.first));
+        if (order != 0) { return key.second ? order > 0 : order < 0; }
+    }
+    return false;
+}
+
+// Where row belongs among rows [first, last), after any equal rows
+int LiveQueryModel::insertPosition(const QVector<QVariant> &row, int first, int last) const {
+    auto less = [this](const QVector<QVariant> &a, const QVector<QVariant> &b) {
+        return rowLess(a, b);
+    };
+    return int(std::upper_bound(rows.begin() + first, rows.begin() + last, row, less) -
+               rows.begin());
+}
+
+void LiveQueryModel::refreshKeys(const QList<int> &keys) {
+    if (keys.isEmpty()) { return; }
+
+    if (keyIndex < 0) {
+        // No key to patch by; fall back to a full reload
+        setQuery(currentQuery, currentKeyColumn);
+        return;
+    }
+
+    QStringList placeholders;
+    for (int i = 0; i < keys.size(); ++i) { placeholders << "?"; }
+
+    QSqlQuery sql;
+    sql.prepare(QString("SELECT * FROM (%1) AS live_rows WHERE live_rows.`%2` "
+                        "IN (%3)")
+                    .arg(currentQuery, currentKeyColumn, placeholders.join(", ")));
+    for (int i = 0; i < keys.size(); ++i) { sql.bindValue(i, keys.at(i)); }
+
+    if (!sql.exec()) {
+        error = sql.lastError();
+        qDebug() << "LiveQueryModel refresh failed:" << error.text();
+        return;
+    }
+
+    const int columnTotal = columns.count();
+    QSet<int> seen;
+
+    while (sql.next()) {
+        QVector<QVariant> row(columnTotal);
+        for (int i = 0; i < columnTotal; ++i) { row[i] = sql.value(i); }
+
+        int key = row.at(keyIndex).toInt();
+        seen.insert(key);
+
+        int existing = rowForKey(key);
+        if (existing >= 0) {
+            rows[existing] = row;
+            emit dataChanged(index(existing, 0), index(existing, columnTotal - 1));
+
+            // A changed sort column moves the row; a move keeps the selection
+            bool before = existing > 0 && rowLess(row, rows.at(existing - 1));
+            bool after  = existing + 1 < rows.size() && rowLess(rows.at(existing + 1), row);
+            if (sortKeys.isEmpty() || (!before && !after)) { continue; }
+
+            int target = before ? insertPosition(row, 0, existing)
+                                : insertPosition(row, existing + 1, rows.size()) - 1;
+            beginMoveRows(QModelIndex(), existing, existing, QModelIndex(),
+                          target < existing ? target : target + 1);
+            rows.move(existing, target);
+            endMoveRows();
+            rebuildRowIndex();
+        } else {
+            int position = sortKeys.isEmpty() ? rows.size() : insertPosition(row, 0, rows.size());
+            beginInsertRows(QModelIndex(), position, position);
+            rows.insert(position, row);
+            if (position == rows.size() - 1) {
+                rowIndex.insert(key, position);
+            } else {
+                rebuildRowIndex();
+            }
+            endInsertRows();
+        }
+    }
+
+    // Keys that no longer match the query (deleted or filtered out)
+    QList<int> gone;
+    for (int key : keys) {
+        if (!seen.contains(key)) { gone << key; }
+    }
+    removeKeys(gone);
+}
+
+void LiveQueryModel::removeKeys(const QList<int> &keys) {
+    QList<int> doomed;
+    for (int key : keys) {
+        int row = rowForKey(key);
+        if (row >= 0) { doomed << row; }
+    }
+    if (doomed.isEmpty()) { return; }
+
+    // Remove from the bottom up so earlier row numbers stay valid
+    std::sort(doomed.begin(), doomed.end(), std::greater<int>());
+    for (int row : doomed) {
+        beginRemoveRows(QModelIndex(), row, row);
+        rows.remove(row);
+        endRemoveRows();
+    }
+    rebuildRowIndex();
+}
+
+int LiveQueryModel::rowCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : rows.size();
+}
+
+int LiveQueryModel::columnCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : columns.count();
+}
+
+QVariant LiveQueryModel::data(const QModelIndex &index, int role) const {
+    if (!index.isValid() || index.row() >= rows.size() ||
+        index.column() >= columns.count()) {
+        return QVariant();
+    }
+    if (role == Qt::DisplayRole || role == Qt::EditRole) {
+        return rows.at(index.row()).at(index.column());
+    }
+    return QVariant();
+}
+
+QVariant LiveQueryModel::headerData(int section, Qt::Orientation orientation,
+                                    int role) const {
+    if (orientation == Qt::Horizontal && role == Qt::DisplayRole) {
+        if (headerOverrides.contains(section)) {
+            return headerOverrides.value(section);
+        }
+        if (section >= 0 && section < columns.count()) {
+            return columns.fieldName(section);
+        }
+    }
+    return QAbstractTableModel::headerData(section, orientation, role);
+}
+
+bool LiveQueryModel::setHeaderData(int section, Qt::Orientation orientation,
+                                   const QVariant &value, int role) {
+    if (orientation != Qt::Horizontal || section < 0 ||
+        section >= columns.count() ||
+        (role != Qt::EditRole && role != Qt::DisplayRole)) {
+        return false;
+    }
+    headerOverrides.insert(section, value);
+    emit headerDataChanged(orientation, section, section);
+    return true;
+}
+
+void LiveQueryModel::rebuildRowIndex() {
+    rowIndex.clear();
+    if (keyIndex < 0) { return; }
+    rowIndex.reserve(rows.size());
+    for (int row = 0; row < rows.size(); ++row) {
+        rowIndex.insert(rows.at(row).at(keyIndex).toInt(), row);
+    }
+}
@@ -0,0 +1,64 @@
+#ifndef LIVEQUERYMODEL_H
+#define LIVEQUERYMODEL_H
+
+#include <QAbstractTableModel>
+#include <QHash>
+#include <QPair>
+#include <QSqlError>
+#include <QSqlRecord>
+#include <QVector>
+
+// Read-only SQL table model that can be patched row by row.
+//
+// setQuery() loads a result set like QSqlQueryModel does. When a key column
+// is given, refreshKeys() re-reads only the rows with the given keys
+// (through the same query, so filters still apply) and inserts, updates or
+// removes them in place. Views keep their scroll position and selection.
+//
+// Patched rows go where the query's trailing ORDER BY would put them, when
+// it names result columns: new rows are inserted at that position and rows
+// whose sort columns changed are moved. Other queries get new rows at the
+// end.
+class LiveQueryModel : public QAbstractTableModel {
+    Q_OBJECT
+
+  public:
+    explicit LiveQueryModel(QObject *parent = nullptr);
+
+    void setQuery(const QString &query, const QString &keyColumn = QString());
+    QString   query() const { return currentQuery; }
+    QString   keyColumn() const { return currentKeyColumn; }
+    QSqlError lastError() const { return error; }
+
+    void refreshKeys(const QList<int> &keys);
+    void removeKeys(const QList<int> &keys);
+    int  rowForKey(int key) const { return rowIndex.value(key, -1); }
+
+    int      rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int      columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index,
+                  int                role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation,
+                        int role = Qt::DisplayRole) const override;
+    bool     setHeaderData(int section, Qt::Orientation orientation,
+                           const QVariant &value,
+                           int             role = Qt::EditRole) override;
+
+  private:
+    QString                    currentQuery;
+    QString                    currentKeyColumn;
+    int                        keyIndex = -1;
+    QSqlRecord                 columns;
+    QVector<QVector<QVariant>> rows;
+    QHash<int, int>            rowIndex; // key -> row
+    QHash<int, QVariant>       headerOverrides;
+    QSqlError                  error;
+    QVector<QPair<int, bool>>  sortKeys; // ORDER BY as (result column, descending)
+
+    void rebuildRowIndex();
+    void parseOrderBy();
+    bool rowLess(const QVector<QVariant> &a, const QVector<QVariant> &b) const;
+    int  insertPosition(const QVector<QVariant> &row, int first, int last) const;
+};
+
+#endif // LIVEQUERYMODEL_H
@@ -0,0 +1,163 @@
+#ifndef MONEY_H
+#define MONEY_H
+
+#include <QString>
+#include <QVariant>
+#include <QtGlobal>
+
+#include <cmath>
+
+// Fixed-point currency amount in cents.
+//
+// All cart and report arithmetic is done on whole cents so totals never
+// drift, and amounts are only turned into text at the edge (labels, table
+// cells, receipts). Quantities are passed in thousandths so weighed items
+// (3 decimal kg) stay exact too.
+class Money {
+  public:
+    enum class Rounding { HalfUp, HalfEven, Down };
+
+    constexpr Money() = default;
+
+    static constexpr Money fromCents(qint64 cents) { return Money(cents); }
+    static Money           fromDouble(double amount) {
+        return Money(std::llround(amount * 100.0));
+    }
+    static Money fromVariant(const QVariant &value) {
+        return fromDouble(value.toDouble());
+    }
+
+    constexpr qint64 cents() const { return value; }
+    double           toDouble() const { return value / 100.0; }
+    constexpr bool   isZero() const { return value == 0; }
+
+    // Unit price times a quantity given in thousandths (1.250 kg -> 1250)
+    constexpr Money times(qint64                   quantityMilli,
+                          Rounding mode = Rounding::HalfUp) const {
+        return Money(divide(value * quantityMilli, 1000, mode));
+    }
+
+    // Amount times a rate in basis points (15% -> 1500)
+    constexpr Money percent(qint64                   basisPoints,
+                            Rounding mode = Rounding::HalfUp) const {
+        return Money(divide(value * basisPoints, 10000, mode));
+    }
+
+    constexpr Money operator+(Money other) const { return Money(value + other.value); }
+    constexpr Money operator-(Money other) const { return Money(value - other.value); }
+    constexpr Money operator-() const { return Money(-value); }
+    constexpr Money &operator+=(Money other) {
+        value += other.value;
+        return *this;
+    }
+    constexpr Money &operator-=(Money other) {
+        value -= other.value;
+        return *this;
+    }
+    constexpr bool operator==(Money other) const { return value == other.value; }
+    constexpr bool operator!=(Money other) const { return value != other.value; }
+    constexpr bool operator<(Money other) const { return value < other.value; }
+
+    // Sum of a contiguous run of cent values. Kept as a plain loop over
+    // integers so the compiler can vectorise it.
+    static Money sum(const qint64 *cents, qsizetype count) {
+        qint64 total = 0;
+        for (qsizetype i = 0; i < count; ++i) { total += cents[i]; }
+        return Money(total);
+    }
+
+    // Writes "$1234.56" (or "-$1234.56") into buffer without allocating.
+    // buffer must hold at least FormatBufferSize chars. Returns the length.
+    static constexpr int FormatBufferSize = 24;
+    int format(char *buffer, bool withSymbol = true) const {
+        char   digits[FormatBufferSize];
+        int    count     = 0;
+        qint64 magnitude = value < 0 ? -value : value;
+
+        // Cents first, then the whole part, written backwards
+        digits[count++] = char('0' + magnitude % 10);
+        magnitude /= 10;
+        digits[count++] = char('0' + magnitude % 10);
+        magnitude /= 10;
+        digits[count++] = '.';
+        do {
+            digits[count++] = char('0' + magnitude % 10);
+            magnitude /= 10;
+        } while (magnitude > 0);
+
+        int length = 0;
+        if (value < 0) { buffer[length++] = '-'; }
+        if (withSymbol) { buffer[length++] = '$'; }
+        while (count > 0) { buffer[length++] = digits[--count]; }
+        buffer[length] = '\0';
+        return length;
+    }
+
+    // "$12.34" for display
+    QString toString() const {
+        char buffer[FormatBufferSize];
+        int  length = format(buffer);
+        return QString::fromLatin1(buffer, length);
+    }
+
+    // "12.34" for binding to DECIMAL columns
+    QString toDecimalString() const {
+        char buffer[FormatBufferSize];
+        int  length = format(buffer, false);
+        return QString::fromLatin1(buffer, length);
+    }
+
+  private:
+    constexpr explicit Money(qint64 cents) : value(cents) {}
+
+    static constexpr qint64 divide(qint64 numerator, qint64 denominator,
+                                   Rounding mode) {
+        qint64 quotient  = numerator / denominator;
+        qint64 remainder = numerator % denominator;
+        if (remainder == 0 || mode == Rounding::Down) { return quotient; }
+
+        // Work on magnitudes so refunds round the same way as sales
+        qint64 twice = 2 * (remainder < 0 ? -remainder : remainder);
+        int    sign  = numerator < 0 ? -1 : 1;
+
+        if (twice > denominator ||
+            (twice == denominator &&
+             (mode == Rounding::HalfUp || quotient % 2 != 0))) {
+            return quotient + sign;
+        }
+        return quotient;
+    }
+
+    qint64 value = 0;
+};
+
+// Tax rule fixed at compile time: rate in basis points and rounding mode.
+template <int BasisPoints, Money::Rounding Mode = Money::Rounding::HalfUp>
+struct TaxRule {
+    static constexpr int             rate     = BasisPoints;
+    static constexpr Money::Rounding rounding = Mode;
+
+    static constexpr Money taxOn(Money net) { return net.percent(rate, rounding); }
+    static constexpr Money grossOf(Money net) { return net + taxOn(net); }
+    static constexpr double rateAsFraction() { return rate / 10000.0; }
+};
+
+// The one sales tax used by the cashier, receipts and analytics (15%)
+using SalesTax = TaxRule<1500>;
+
+static_assert(SalesTax::taxOn(Money::fromCents(1000)).cents() == 150,
+              "15% of $10.00 is $1.50");
+static_assert(SalesTax::taxOn(Money::fromCents(3)).cents() == 0,
+              "0.45 cents rounds down");
+static_assert(SalesTax::taxOn(Money::fromCents(10)).cents() == 2,
+              "1.5 cents rounds half up");
+static_assert(Money::fromCents(250).times(1500).cents() == 375,
+              "1.5 x $2.50 is $3.75");
+static_assert(Money::fromCents(-10).percent(1500).cents() == -2,
+              "negative amounts round symmetrically");
+
+inline qint64 quantityToMilli(double quantity) {
+    return std::llround(quantity * 1000.0);
+}
+
+#endif // MONEY_H
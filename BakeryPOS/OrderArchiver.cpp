@@ -0,0 +1,266 @@
+#include "OrderArchiver.h"
+
+#include <QRegularExpression>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QStringList>
+#include <QTimer>
+#include <QtConcurrent/QtConcurrentRun>
+#include <QDebug>
+
+static const char *ArchiveLock   = "bakerypos_archive";
+static const int   MonthsAhead   = 2;  // partitions kept ready for coming months
+static const int   MinKeepMonths = 13; // "This Year" analytics never reach the archive
+
+static QDate monthStart(const QDate &day) { return QDate(day.year(), day.month(), 1); }
+
+static QString partitionName(const QDate &month) { return "p" + month.toString("yyyyMM"); }
+
+static QString partitionDefinition(const QDate &month) {
+    return QString("PARTITION %1 VALUES LESS THAN ('%2')")
+        .arg(partitionName(month), month.addMonths(1).toString(Qt::ISODate));
+}
+
+// First day of the month a pYYYYMM partition holds; invalid for others
+static QDate partitionMonth(const QString &name) {
+    static const QRegularExpression monthly("^p(\\d{6})$");
+    QRegularExpressionMatch match = monthly.match(name);
+    return match.hasMatch() ? QDate::fromString(match.captured(1) + "01", "yyyyMMdd") : QDate();
+}
+
+static bool fail(ArchiveRun *run, const QString &step, const QSqlQuery &query) {
+    run->error = step + ": " + query.lastError().text();
+    qDebug() << "Order archiving failed:" << run->error;
+    return false;
+}
+
+static bool orderPartitions(QSqlQuery &query, QStringList *names, ArchiveRun *run) {
+    if (!query.exec("SELECT PARTITION_NAME FROM information_schema.PARTITIONS "
+                    "WHERE TABLE_SCHEMA = DATABASE() AND TABLE_NAME = 'Orders' "
+                    "AND PARTITION_NAME IS NOT NULL "
+                    "ORDER BY PARTITION_ORDINAL_POSITION")) {
+        return fail(run, "Reading partitions", query);
+    }
+    while (query.next()) { *names << query.value(0).toString(); }
+    return true;
+}
+
+OrderArchiver::OrderArchiver(QObject *parent) : QObject(parent), timer(new QTimer(this)) {
+    connect(timer, &QTimer::timeout, this, &OrderArchiver::runNow);
+    connect(&watcher, &QFutureWatcher<ArchiveRun>::finished, this,
+            [this]() { emit finished(watcher.result()); });
+}
+
+void OrderArchiver::setKeepMonths(int months) { keepMonths = qMax(MinKeepMonths, months); }
+
+void OrderArchiver::start(int intervalMs, int firstRunDelayMs) {
+    // The first run waits so it does not compete with startup
+    QTimer::singleShot(firstRunDelayMs, this, &OrderArchiver::runNow);
+    timer->start(intervalMs);
+}
+
+void OrderArchiver::stop() { timer->stop(); }
+
+void OrderArchiver::runNow() {
+    if (watcher.isRunning()) { return; }
+
+    // Whole months only, so emptied partitions can be dropped
+    const QDate cutoff    = monthStart(QDate::currentDate()).addMonths(-keepMonths);
+    const int   batch     = batchSize;
+    const bool  partition = partitionOrders;
+
+    watcher.setFuture(QtConcurrent::run([cutoff, batch, partition]() {
+        // Connections belong to the thread that opened them, so the worker
+        // gets its own copy of the default connection
+        const QString connectionName = "order_archiver";
+        ArchiveRun    run;
+        run.cutoff = cutoff;
+        {
+            QSqlDatabase db = QSqlDatabase::cloneDatabase(QSqlDatabase::defaultConnection,
+                                                          connectionName);
+            if (db.open()) {
+                QSqlQuery lock(db);
+                lock.prepare("SELECT GET_LOCK(?, 0)");
+                lock.bindValue(0, ArchiveLock);
+                if (lock.exec() && lock.next() && lock.value(0).toInt() == 1) {
+                    maintainPartitions(connectionName, partition, MonthsAhead, &run) &&
+                        archiveBefore(connectionName, cutoff, batch, &run) &&
+                        dropEmptyPartitions(connectionName, cutoff, &run);
+
+                    lock.prepare("SELECT RELEASE_LOCK(?)");
+                    lock.bindValue(0, ArchiveLock);
+                    lock.exec();
+                } else {
+                    qDebug() << "Order archiving skipped: another register holds the lock";
+                }
+                db.close();
+            } else {
+                run.error = db.lastError().text();
+            }
+        }
+        QSqlDatabase::removeDatabase(connectionName);
+        return run;
+    }));
+}
+
+bool OrderArchiver::maintainPartitions(const QString &connectionName, bool convert,
+                                       int monthsAhead, ArchiveRun *run) {
+    QSqlQuery   query(QSqlDatabase::database(connectionName));
+    QStringList names;
+    if (!orderPartitions(query, &names, run)) { return false; }
+
+    const QDate thisMonth = monthStart(QDate::currentDate());
+    const QDate lastMonth = thisMonth.addMonths(monthsAhead);
+    QStringList definitions;
+
+    if (names.isEmpty()) {
+        if (!convert) { return true; }
+
+        // One partition per month from the oldest order on
+        if (!query.exec("SELECT MIN(OrderDate) FROM Orders") || !query.next()) {
+            return fail(run, "Reading oldest order", query);
+        }
+        QDate first = query.value(0).isNull() ? thisMonth
+                                              : monthStart(query.value(0).toDate());
+        for (QDate month = first; month <= lastMonth; month = month.addMonths(1)) {
+            definitions << partitionDefinition(month);
+        }
+        definitions << "PARTITION pFuture VALUES LESS THAN (MAXVALUE)";
+
+        // Every unique key of a partitioned table has to include OrderDate
+        if (!query.exec("ALTER TABLE Orders DROP PRIMARY KEY, "
+                        "ADD PRIMARY KEY (OrderID, OrderDate)")) {
+            return fail(run, "Extending the Orders primary key", query);
+        }
+        if (!query.exec("ALTER TABLE Orders PARTITION BY RANGE COLUMNS(OrderDate) (" +
+                        definitions.join(", ") + ")")) {
+            return fail(run, "Partitioning Orders", query);
+        }
+        run->partitionsAdded += definitions.size() - 1;
+        qDebug() << "Partitioned Orders by month from" << first;
+        return true;
+    }
+
+    if (!names.contains("pFuture")) {
+        qDebug() << "Orders is partitioned by another scheme; leaving it alone";
+        return true;
+    }
+
+    QDate newest;
+    for (const QString &name : names) {
+        QDate month = partitionMonth(name);
+        if (month.isValid() && (!newest.isValid() || month > newest)) { newest = month; }
+    }
+
+    // Split the coming months off the catch-all partition, which is empty
+    // unless the registers were not run for a while
+    QDate next = newest.isValid() ? newest.addMonths(1) : thisMonth;
+    for (QDate month = next; month <= lastMonth; month = month.addMonths(1)) {
+        definitions << partitionDefinition(month);
+    }
+    if (definitions.isEmpty()) { return true; }
+    definitions << "PARTITION pFuture VALUES LESS THAN (MAXVALUE)";
+
+    if (!query.exec("ALTER TABLE Orders REORGANIZE PARTITION pFuture INTO (" +
+                    definitions.join(", ") + ")")) {
+        return fail(run, "Adding partitions", query);
+    }
+    run->partitionsAdded += definitions.size() - 1;
+    return true;
+}
+
+bool OrderArchiver::archiveBefore(const QString &connectionName, const QDate &cutoff,
+                                  int batchSize, ArchiveRun *run) {
+    QSqlDatabase db = QSqlDatabase::database(connectionName);
+    QSqlQuery    query(db);
+
+    // A batch per transaction keeps locks short while registers are selling
+    forever {
+        if (!db.transaction()) {
+            run->error = "Cannot start transaction: " + db.lastError().text();
+            return false;
+        }
+
+        query.prepare("SELECT OrderID FROM Orders WHERE OrderDate < ? "
+                      "ORDER BY OrderDate, OrderID LIMIT ? FOR UPDATE");
+        query.bindValue(0, cutoff.startOfDay());
+        query.bindValue(1, batchSize);
+        if (!query.exec()) {
+            db.rollback();
+            return fail(run, "Selecting orders to archive", query);
+        }
+
+        QStringList ids;
+        while (query.next()) { ids << query.value(0).toString(); }
+        if (ids.isEmpty()) {
+            db.rollback();
+            return true;
+        }
+
+        const QString inBatch = "(" + ids.join(", ") + ")";
+        const QStringList steps = {
+            // Product totals survive the move, a row per product and month
+            "INSERT INTO sales_product_monthly (MonthStart, ProductID, Quantity, NetCents) "
+            "SELECT DATE_FORMAT(o.OrderDate, '%Y-%m-01'), od.ProductID, SUM(od.Quantity), "
+            "ROUND(SUM(od.Quantity * od.Price - od.Discount) * 100) "
+            "FROM Orders o JOIN OrderDetails od ON od.OrderID = o.OrderID "
+            "WHERE o.OrderID IN " + inBatch + " "
+            "GROUP BY DATE_FORMAT(o.OrderDate, '%Y-%m-01'), od.ProductID "
+            "ON DUPLICATE KEY UPDATE Quantity = Quantity + VALUES(Quantity), "
+            "NetCents = NetCents + VALUES(NetCents)",
+
+            "INSERT INTO OrderDetails_archive (OrderID, ProductID, Quantity, Price, "
+            "Discount, PromotionID) "
+            "SELECT OrderID, ProductID, Quantity, Price, Discount, PromotionID "
+            "FROM OrderDetails "
+            "WHERE OrderID IN " + inBatch,
+
+            "INSERT INTO Orders_archive (OrderID, OrderDate, UserID, TotalAmount, "
+            "payment_method, RefundOf) "
+            "SELECT OrderID, OrderDate, UserID, TotalAmount, payment_method, RefundOf "
+            "FROM Orders WHERE OrderID IN " + inBatch,
+
+            "DELETE FROM OrderDetails WHERE OrderID IN " + inBatch,
+            "DELETE FROM Orders WHERE OrderID IN " + inBatch,
+        };
+
+        for (const QString &step : steps) {
+            if (!query.exec(step)) {
+                db.rollback();
+                return fail(run, "Archiving orders", query);
+            }
+        }
+
+        if (!db.commit()) {
+            run->error = "Cannot commit archived orders: " + db.lastError().text();
+            db.rollback();
+            return false;
+        }
+        run->archived += ids.size();
+    }
+}
+
+bool OrderArchiver::dropEmptyPartitions(const QString &connectionName, const QDate &cutoff,
+                                        ArchiveRun *run) {
+    QSqlQuery   query(QSqlDatabase::database(connectionName));
+    QStringList names;
+    if (!orderPartitions(query, &names, run)) { return false; }
+
+    for (const QString &name : names) {
+        // Only months that ended before the cutoff, and only once empty
+        QDate month = partitionMonth(name);
+        if (!month.isValid() || month.addMonths(1) > cutoff) { continue; }
+
+        if (!query.exec("SELECT 1 FROM Orders PARTITION (" + name + ") LIMIT 1")) {
+            return fail(run, "Checking partition " + name, query);
+        }
+        if (query.next()) { continue; }
+
+        if (!query.exec("ALTER TABLE Orders DROP PARTITION " + name)) {
+            return fail(run, "Dropping partition " + name, query);
+        }
+        ++run->partitionsDropped;
+    }
+    return true;
+}
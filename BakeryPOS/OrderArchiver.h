@@ -0,0 +1,74 @@
+#ifndef ORDERARCHIVER_H
+#define ORDERARCHIVER_H
+
+#include <QDate>
+#include <QFutureWatcher>
+#include <QObject>
+#include <QString>
+
+class QTimer;
+
+struct ArchiveRun {
+    QDate   cutoff;                // orders before this day were archived
+    int     archived          = 0; // orders moved
+    int     partitionsAdded   = 0;
+    int     partitionsDropped = 0;
+    QString error;
+
+    bool isValid() const { return error.isEmpty(); }
+};
+
+// Keeps Orders and OrderDetails down to recent history.
+//
+// Orders older than the retention period are moved, a batch per
+// transaction, into the compressed Orders_archive and OrderDetails_archive
+// tables. Their per-product totals are added to sales_product_monthly on
+// the way. Hourly totals are already in sales_hourly, so the analytics
+// chart and Z-reports are unaffected.
+//
+// When enabled, Orders is also range partitioned by month on OrderDate
+// (pYYYYMM partitions plus pFuture). Each run adds the coming months'
+// partitions and drops the emptied ones. OrderDetails has no date to
+// partition on and is kept small by archiving alone.
+//
+// Runs happen off the UI thread on their own connection. The dashboard
+// only creates an archiver when archive/enabled is set, which should be
+// on one register only. A named lock still makes sure only one register
+// archives at a time; the others skip.
+class OrderArchiver : public QObject {
+    Q_OBJECT
+
+  public:
+    explicit OrderArchiver(QObject *parent = nullptr);
+
+    void setKeepMonths(int months);
+    void setBatchSize(int orders) { batchSize = qMax(1, orders); }
+    void setPartitionOrders(bool enabled) { partitionOrders = enabled; }
+
+    void start(int intervalMs, int firstRunDelayMs);
+    void stop();
+    bool isRunning() const { return watcher.isRunning(); }
+
+    // The steps a run performs on the worker connection
+    static bool maintainPartitions(const QString &connectionName, bool convert,
+                                   int monthsAhead, ArchiveRun *run);
+    static bool archiveBefore(const QString &connectionName, const QDate &cutoff,
+                              int batchSize, ArchiveRun *run);
+    static bool dropEmptyPartitions(const QString &connectionName, const QDate &cutoff,
+                                    ArchiveRun *run);
+
+  public slots:
+    void runNow();
+
+  signals:
+    void finished(const ArchiveRun &run);
+
+  private:
+    QTimer                    *timer           = nullptr;
+    QFutureWatcher<ArchiveRun> watcher;
+    int                        keepMonths      = 24;
+    int                        batchSize       = 500;
+    bool                       partitionOrders = false;
+};
+
+#endif // ORDERARCHIVER_H
@@ -0,0 +1,449 @@
+#include "OrderHistoryForm.h"
+#include "Money.h"
+#include "ReceiptWidget.h"
+#include "Refunds.h"
+#include "RolePages.h"
+#include "PinSwitchDialog.h"
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QHeaderView>
+#include <QHBoxLayout>
+#include <QVBoxLayout>
+#include <QMessageBox>
+#include <QDialog>
+#include <QDialogButtonBox>
+#include <QTableWidget>
+#include <QDebug>
+
+#include <algorithm>
+
+namespace {
+// Page key of an order: OrderID in column 0, OrderDate in column 1
+const int OrderKeyRole = Qt::UserRole;
+const int LinesLoadedRole = Qt::UserRole + 1;
+}
+
+OrderHistoryForm::OrderHistoryForm(QWidget *parent, int userId, const QString &role)
+    : QWidget(parent)
+    , currentUserId(userId)
+{
+    setupUI();
+    setCurrentRole(role);
+}
+
+void OrderHistoryForm::setCurrentRole(const QString &role)
+{
+    currentRole = role;
+
+    QString hint = RolePages::canRefund(role) ? QString() : "Needs a manager's PIN";
+    refundButton->setToolTip(hint);
+    voidButton->setToolTip(hint);
+}
+
+int OrderHistoryForm::refundApprover()
+{
+    if (RolePages::canRefund(currentRole)) return currentUserId;
+
+    // The refund is recorded under the manager who approved it
+    PinSwitchDialog dialog(currentUserId, this, PinSwitchDialog::ManagerApproval);
+    return dialog.exec() == QDialog::Accepted ? dialog.userId() : -1;
+}
+
+void OrderHistoryForm::setupUI()
+{
+    QVBoxLayout *mainLayout = new QVBoxLayout(this);
+    mainLayout->setSpacing(10);
+    mainLayout->setContentsMargins(10, 10, 10, 10);
+
+    QLabel *title = new QLabel("Order History", this);
+    title->setStyleSheet("font-weight: bold; font-size: 14px; padding: 10px;");
+
+    // Filters
+    QHBoxLayout *filterLayout = new QHBoxLayout();
+    cashierComboBox = new QComboBox(this);
+    fromDateEdit = new QDateEdit(QDate::currentDate().addDays(-29), this);
+    toDateEdit = new QDateEdit(QDate::currentDate(), this);
+    fromDateEdit->setCalendarPopup(true);
+    toDateEdit->setCalendarPopup(true);
+    fromDateEdit->setDisplayFormat("yyyy-MM-dd");
+    toDateEdit->setDisplayFormat("yyyy-MM-dd");
+
+    // 0 means no limit
+    minAmountSpinBox = new QDoubleSpinBox(this);
+    maxAmountSpinBox = new QDoubleSpinBox(this);
+    for (QDoubleSpinBox* spinBox : {minAmountSpinBox, maxAmountSpinBox}) {
+        spinBox->setRange(0, 1000000);
+        spinBox->setDecimals(2);
+        spinBox->setPrefix("$");
+        spinBox->setSpecialValueText("Any");
+    }
+    searchButton = new QPushButton("Search", this);
+
+    filterLayout->addWidget(new QLabel("Cashier:", this));
+    filterLayout->addWidget(cashierComboBox);
+    filterLayout->addWidget(new QLabel("From:", this));
+    filterLayout->addWidget(fromDateEdit);
+    filterLayout->addWidget(new QLabel("To:", this));
+    filterLayout->addWidget(toDateEdit);
+    filterLayout->addWidget(new QLabel("Min:", this));
+    filterLayout->addWidget(minAmountSpinBox);
+    filterLayout->addWidget(new QLabel("Max:", this));
+    filterLayout->addWidget(maxAmountSpinBox);
+    filterLayout->addWidget(searchButton);
+    filterLayout->addStretch();
+
+    // Orders; lines appear as children once an order is expanded
+    ordersTree = new QTreeWidget(this);
+    ordersTree->setColumnCount(5);
+    ordersTree->setHeaderLabels({"Order #", "Date", "Cashier", "Payment", "Total"});
+    ordersTree->header()->setSectionResizeMode(QHeaderView::Stretch);
+    ordersTree->setAlternatingRowColors(true);
+    ordersTree->setUniformRowHeights(true);
+
+    // Pager
+    QHBoxLayout *pagerLayout = new QHBoxLayout();
+    newerButton = new QPushButton("< Newer", this);
+    olderButton = new QPushButton("Older >", this);
+    receiptButton = new QPushButton("View Receipt", this);
+    refundButton = new QPushButton("Refund...", this);
+    voidButton = new QPushButton("Void Order", this);
+    pageLabel = new QLabel(this);
+    pagerLayout->addWidget(newerButton);
+    pagerLayout->addWidget(pageLabel);
+    pagerLayout->addWidget(olderButton);
+    pagerLayout->addStretch();
+    pagerLayout->addWidget(receiptButton);
+    pagerLayout->addWidget(refundButton);
+    pagerLayout->addWidget(voidButton);
+
+    mainLayout->addWidget(title);
+    mainLayout->addLayout(filterLayout);
+    mainLayout->addWidget(ordersTree, 1);
+    mainLayout->addLayout(pagerLayout);
+
+    newerButton->setEnabled(false);
+    olderButton->setEnabled(false);
+
+    connect(searchButton, &QPushButton::clicked, this, &OrderHistoryForm::onSearchClicked);
+    connect(newerButton, &QPushButton::clicked, this, &OrderHistoryForm::onNewerClicked);
+    connect(olderButton, &QPushButton::clicked, this, &OrderHistoryForm::onOlderClicked);
+    connect(receiptButton, &QPushButton::clicked, this, &OrderHistoryForm::onReceiptClicked);
+    connect(refundButton, &QPushButton::clicked, this, &OrderHistoryForm::onRefundClicked);
+    connect(voidButton, &QPushButton::clicked, this, &OrderHistoryForm::onVoidClicked);
+    connect(ordersTree, &QTreeWidget::itemExpanded, this, &OrderHistoryForm::onOrderExpanded);
+}
+
+void OrderHistoryForm::showEvent(QShowEvent* event)
+{
+    QWidget::showEvent(event);
+
+    // Nothing is read until the page is first opened
+    if (!loadedOnce) {
+        loadedOnce = true;
+        loadCashiers();
+        loadPage(First);
+    }
+}
+
+void OrderHistoryForm::loadCashiers()
+{
+    cashierComboBox->clear();
+    cashierComboBox->addItem("All cashiers", -1);
+
+    QSqlQuery query;
+    if (!query.exec("SELECT UserID, username FROM users ORDER BY username")) {
+        qDebug() << "Cashier list query error:" << query.lastError().text();
+        return;
+    }
+    while (query.next()) {
+        cashierComboBox->addItem(query.value(1).toString(), query.value(0).toInt());
+    }
+}
+
+void OrderHistoryForm::loadPage(Direction direction)
+{
+    int userId = cashierComboBox->currentData().toInt();
+    double minAmount = minAmountSpinBox->value();
+    double maxAmount = maxAmountSpinBox->value();
+
+    // The page key is a range on (OrderDate, OrderID), so MySQL walks that
+    // index (or the cashier's) and stops after one page. A narrow amount
+    // range is read from the (TotalAmount, OrderDate, OrderID) index instead
+    // and only its matches are sorted; see 014_orders_amount_index.sql.
+    QString sql =
+        "SELECT o.OrderID, o.OrderDate, u.username, o.UserID, o.payment_method, o.TotalAmount "
+        "FROM Orders o "
+        "LEFT JOIN users u ON u.UserID = o.UserID "
+        "WHERE o.OrderDate >= :fromDate AND o.OrderDate < :toDate";
+    if (userId >= 0) {
+        sql += " AND o.UserID = :userId";
+    }
+    if (minAmount > 0) {
+        sql += " AND o.TotalAmount >= :minAmount";
+    }
+    if (maxAmount > 0) {
+        sql += " AND o.TotalAmount <= :maxAmount";
+    }
+    if (direction == Older) {
+        sql += " AND (o.OrderDate < :keyDate OR (o.OrderDate = :keyDateEq AND o.OrderID < :keyId))"
+               " ORDER BY o.OrderDate DESC, o.OrderID DESC";
+    } else if (direction == Newer) {
+        sql += " AND (o.OrderDate > :keyDate OR (o.OrderDate = :keyDateEq AND o.OrderID > :keyId))"
+               " ORDER BY o.OrderDate ASC, o.OrderID ASC";
+    } else {
+        sql += " ORDER BY o.OrderDate DESC, o.OrderID DESC";
+    }
+
+    // One extra row tells whether there is another page
+    sql += " LIMIT " + QString::number(PageSize + 1);
+
+    QSqlQuery query;
+    query.setForwardOnly(true);
+    query.prepare(sql);
+    query.bindValue(":fromDate", QDateTime(fromDateEdit->date(), QTime(0, 0)));
+    query.bindValue(":toDate", QDateTime(toDateEdit->date().addDays(1), QTime(0, 0)));
+    if (userId >= 0) {
+        query.bindValue(":userId", userId);
+    }
+    if (minAmount > 0) {
+        query.bindValue(":minAmount", Money::fromDouble(minAmount).toDecimalString());
+    }
+    if (maxAmount > 0) {
+        query.bindValue(":maxAmount", Money::fromDouble(maxAmount).toDecimalString());
+    }
+    if (direction == Older) {
+        query.bindValue(":keyDate", lastDate);
+        query.bindValue(":keyDateEq", lastDate);
+        query.bindValue(":keyId", lastOrderId);
+    } else if (direction == Newer) {
+        query.bindValue(":keyDate", firstDate);
+        query.bindValue(":keyDateEq", firstDate);
+        query.bindValue(":keyId", firstOrderId);
+    }
+
+    if (!query.exec()) {
+        qDebug() << "Order history query error:" << query.lastError().text();
+        QMessageBox::critical(this, "Error", "Failed to load orders: " + query.lastError().text());
+        return;
+    }
+
+    QList<QTreeWidgetItem*> items;
+    while (query.next()) {
+        QString cashier = query.value(2).toString();
+        if (cashier.isEmpty()) {
+            cashier = "User #" + query.value(3).toString();
+        }
+
+        QTreeWidgetItem* item = new QTreeWidgetItem({
+            query.value(0).toString(),
+            query.value(1).toDateTime().toString("yyyy-MM-dd hh:mm:ss"),
+            cashier,
+            query.value(4).toString(),
+            Money::fromVariant(query.value(5)).toString()});
+        item->setData(0, OrderKeyRole, query.value(0).toInt());
+        item->setData(1, OrderKeyRole, query.value(1).toDateTime());
+        item->setChildIndicatorPolicy(QTreeWidgetItem::ShowIndicator);
+        items.append(item);
+    }
+
+    bool hasMore = items.size() > PageSize;
+    if (hasMore) {
+        delete items.takeLast();
+    }
+    if (direction == Newer) {
+        std::reverse(items.begin(), items.end());
+    }
+
+    // Stepping past either end keeps the current page
+    if (items.isEmpty() && direction != First) {
+        if (direction == Older) olderButton->setEnabled(false);
+        if (direction == Newer) newerButton->setEnabled(false);
+        return;
+    }
+
+    ordersTree->clear();
+    ordersTree->addTopLevelItems(items);
+
+    switch (direction) {
+        case First:
+            page = 1;
+            newerButton->setEnabled(false);
+            olderButton->setEnabled(hasMore);
+            break;
+        case Older:
+            ++page;
+            newerButton->setEnabled(true);
+            olderButton->setEnabled(hasMore);
+            break;
+        case Newer:
+            page = qMax(1, page - 1);
+            newerButton->setEnabled(hasMore);
+            olderButton->setEnabled(true);
+            break;
+    }
+
+    if (!items.isEmpty()) {
+        firstOrderId = items.first()->data(0, OrderKeyRole).toInt();
+        firstDate = items.first()->data(1, OrderKeyRole).toDateTime();
+        lastOrderId = items.last()->data(0, OrderKeyRole).toInt();
+        lastDate = items.last()->data(1, OrderKeyRole).toDateTime();
+    }
+    pageLabel->setText(QString("Page %1").arg(page));
+}
+
+void OrderHistoryForm::onSearchClicked()
+{
+    loadPage(First);
+}
+
+void OrderHistoryForm::onNewerClicked()
+{
+    loadPage(Newer);
+}
+
+void OrderHistoryForm::onOlderClicked()
+{
+    loadPage(Older);
+}
+
+void OrderHistoryForm::onOrderExpanded(QTreeWidgetItem* item)
+{
+    if (item->parent() || item->data(0, LinesLoadedRole).toBool()) return;
+    item->setData(0, LinesLoadedRole, true);
+
+    // Lines are only read for the orders someone opens
+    Receipt receipt = Receipt::load(item->data(0, OrderKeyRole).toInt());
+    for (const ReceiptLine& line : receipt.lines) {
+        QTreeWidgetItem* child = new QTreeWidgetItem(item);
+        child->setText(0, line.name);
+        child->setText(1, QString("%1 x %2")
+                              .arg(QString::number(line.quantityMilli / 1000.0),
+                                   line.unitPrice.toString()));
+        child->setText(4, line.total.toString());
+    }
+    item->setChildIndicatorPolicy(QTreeWidgetItem::DontShowIndicatorWhenChildless);
+}
+
+int OrderHistoryForm::selectedOrderId()
+{
+    QTreeWidgetItem* item = ordersTree->currentItem();
+    if (!item) {
+        QMessageBox::warning(this, "Warning", "Please select an order.");
+        return -1;
+    }
+    if (item->parent()) {
+        item = item->parent();
+    }
+    return item->data(0, OrderKeyRole).toInt();
+}
+
+void OrderHistoryForm::onReceiptClicked()
+{
+    int orderId = selectedOrderId();
+    if (orderId < 0) return;
+
+    Receipt receipt = Receipt::load(orderId);
+    if (!receipt.isValid()) {
+        QMessageBox::warning(this, "Warning", "The order no longer exists.");
+        return;
+    }
+
+    ReceiptWidget::preview(receipt);
+}
+
+void OrderHistoryForm::onRefundClicked()
+{
+    int orderId = selectedOrderId();
+    if (orderId < 0) return;
+
+    QString error;
+    QVector<RefundableLine> lines = Refunds::refundable(orderId, &error);
+    if (!error.isEmpty()) {
+        QMessageBox::critical(this, "Error", "Failed to load the order: " + error);
+        return;
+    }
+
+    // One row per product with how much of it to take back
+    QDialog dialog(this);
+    dialog.setWindowTitle("Refund Order #" + QString::number(orderId));
+    dialog.setMinimumWidth(500);
+    QVBoxLayout* layout = new QVBoxLayout(&dialog);
+
+    QTableWidget* table = new QTableWidget(lines.size(), 4, &dialog);
+    table->setHorizontalHeaderLabels({"Product", "Sold", "Refunded", "Refund"});
+    table->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+
+    QList<QDoubleSpinBox*> spinBoxes;
+    for (int row = 0; row < lines.size(); ++row) {
+        const RefundableLine& line = lines.at(row);
+        table->setItem(row, 0, new QTableWidgetItem(line.name));
+        table->setItem(row, 1, new QTableWidgetItem(QString::number(line.soldMilli / 1000.0)));
+        table->setItem(row, 2, new QTableWidgetItem(QString::number(line.refundedMilli / 1000.0)));
+
+        QDoubleSpinBox* spinBox = new QDoubleSpinBox(table);
+        spinBox->setDecimals(line.soldMilli % 1000 == 0 ? 0 : 3);
+        spinBox->setRange(0, line.remainingMilli() / 1000.0);
+        spinBox->setEnabled(line.remainingMilli() > 0);
+        table->setCellWidget(row, 3, spinBox);
+        spinBoxes << spinBox;
+    }
+    layout->addWidget(table);
+
+    QDialogButtonBox* buttons =
+        new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, &dialog);
+    buttons->button(QDialogButtonBox::Ok)->setText("Refund");
+    connect(buttons, &QDialogButtonBox::accepted, &dialog, &QDialog::accept);
+    connect(buttons, &QDialogButtonBox::rejected, &dialog, &QDialog::reject);
+    layout->addWidget(buttons);
+
+    if (dialog.exec() != QDialog::Accepted) return;
+
+    QVector<RefundLine> refund;
+    for (int row = 0; row < lines.size(); ++row) {
+        qint64 quantity = quantityToMilli(spinBoxes.at(row)->value());
+        if (quantity > 0) {
+            refund.append({lines.at(row).productId, quantity});
+        }
+    }
+    if (refund.isEmpty()) return;
+
+    int approver = refundApprover();
+    if (approver < 0) return;
+
+    int refundId = Refunds::refund(orderId, refund, approver, &error);
+    if (refundId < 0) {
+        QMessageBox::critical(this, "Error", "Failed to refund: " + error);
+        return;
+    }
+
+    QMessageBox::information(this, "Refund",
+        QString("Refunded as order #%1.").arg(refundId));
+    loadPage(First);
+}
+
+void OrderHistoryForm::onVoidClicked()
+{
+    int orderId = selectedOrderId();
+    if (orderId < 0) return;
+
+    QMessageBox::StandardButton reply = QMessageBox::question(
+        this, "Void Order",
+        QString("Refund everything left on order #%1 and put it back in stock?").arg(orderId),
+        QMessageBox::Yes | QMessageBox::No);
+    if (reply != QMessageBox::Yes) return;
+
+    int approver = refundApprover();
+    if (approver < 0) return;
+
+    QString error;
+    int refundId = Refunds::voidOrder(orderId, approver, &error);
+    if (refundId < 0) {
+        QMessageBox::critical(this, "Error", "Failed to void the order: " + error);
+        return;
+    }
+
+    QMessageBox::information(this, "Void Order",
+        QString("Order #%1 voided as order #%2.").arg(orderId).arg(refundId));
+    loadPage(First);
+}
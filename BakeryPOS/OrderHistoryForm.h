@@ -0,0 +1,82 @@
+#ifndef ORDERHISTORYFORM_H
+#define ORDERHISTORYFORM_H
+
+#include <QWidget>
+#include <QComboBox>
+#include <QDateEdit>
+#include <QDateTime>
+#include <QDoubleSpinBox>
+#include <QLabel>
+#include <QPushButton>
+#include <QTreeWidget>
+
+// Past orders, newest first, a page at a time.
+//
+// Pages are keyset based: the next page starts after the last
+// (OrderDate, OrderID) shown rather than at an OFFSET, so any page costs
+// the same however deep it is. Lines are only read when an order is
+// expanded, and a receipt is rendered again from the stored order. Orders
+// can be refunded in part or voided from here (see Refunds) by a manager,
+// or by a cashier with a manager's PIN.
+class OrderHistoryForm : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit OrderHistoryForm(QWidget *parent = nullptr, int userId = -1,
+                              const QString &role = QString());
+
+    void setCurrentUserId(int userId) { currentUserId = userId; }
+    void setCurrentRole(const QString &role);
+
+protected:
+    void showEvent(QShowEvent* event) override;
+
+private slots:
+    void onSearchClicked();
+    void onNewerClicked();
+    void onOlderClicked();
+    void onOrderExpanded(QTreeWidgetItem* item);
+    void onReceiptClicked();
+    void onRefundClicked();
+    void onVoidClicked();
+
+private:
+    enum Direction { First, Older, Newer };
+
+    // Filters
+    QComboBox* cashierComboBox = nullptr;
+    QDateEdit* fromDateEdit = nullptr;
+    QDateEdit* toDateEdit = nullptr;
+    QDoubleSpinBox* minAmountSpinBox = nullptr;
+    QDoubleSpinBox* maxAmountSpinBox = nullptr;
+    QPushButton* searchButton = nullptr;
+
+    QTreeWidget* ordersTree = nullptr;
+    QPushButton* newerButton = nullptr;
+    QPushButton* olderButton = nullptr;
+    QPushButton* receiptButton = nullptr;
+    QPushButton* refundButton = nullptr;
+    QPushButton* voidButton = nullptr;
+    QLabel* pageLabel = nullptr;
+
+    // Keys of the first and last order on the current page
+    QDateTime firstDate;
+    int firstOrderId = 0;
+    QDateTime lastDate;
+    int lastOrderId = 0;
+    int page = 0;
+    bool loadedOnce = false;
+    int currentUserId;  // recorded on refunds
+    QString currentRole;
+
+    static constexpr int PageSize = 50;
+
+    void setupUI();
+    void loadCashiers();
+    void loadPage(Direction direction);
+    int selectedOrderId();
+    int refundApprover();
+};
+
+#endif // ORDERHISTORYFORM_H
@@ -0,0 +1,251 @@
+#include "OrderLineStore.h"
+
+#include <QElapsedTimer>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QtConcurrent/QtConcurrentMap>
+#include <QDebug>
+
+#include <algorithm>
+
+OrderLineStore::OrderLineStore(QObject *parent) : QObject(parent) {}
+
+int OrderLineStore::productCode(int productId, const QString &name) {
+    auto it = productCodeForId.constFind(productId);
+    if (it != productCodeForId.constEnd()) {
+        // Keep the current name if the product was renamed
+        if (!name.isEmpty() && productNames.at(it.value()) != name) {
+            productNames[it.value()] = name;
+        }
+        return it.value();
+    }
+
+    int code = productNames.size();
+    productNames.append(name.isEmpty() ? "Product #" + QString::number(productId) : name);
+    productCodeForId.insert(productId, code);
+    return code;
+}
+
+int OrderLineStore::categoryCode(const QString &name) {
+    QString key = name.isEmpty() ? QString("Uncategorized") : name;
+    auto    it  = categoryCodeForName.constFind(key);
+    if (it != categoryCodeForName.constEnd()) { return it.value(); }
+
+    int code = categoryNames.size();
+    categoryNames.append(key);
+    categoryCodeForName.insert(key, code);
+    return code;
+}
+
+bool OrderLineStore::refresh() {
+    QElapsedTimer timer;
+    timer.start();
+
+    QSqlQuery query;
+    query.setForwardOnly(true);
+    query.prepare("SELECT o.OrderID, o.OrderDate, od.ProductID, p.Name, p.Category, "
+                  "od.Quantity, od.Price, od.Discount "
+                  "FROM Orders o "
+                  "JOIN OrderDetails od ON od.OrderID = o.OrderID "
+                  "LEFT JOIN products p ON p.ProductID = od.ProductID "
+                  "WHERE o.OrderID > ? "
+                  "ORDER BY o.OrderID");
+    query.bindValue(0, qMax(0, loadedThrough - ReloadWindow));
+
+    if (!query.exec()) {
+        qDebug() << "Order line load failed:" << query.lastError().text();
+        return false;
+    }
+
+    const int firstNew = days.size();
+    while (query.next()) {
+        int orderId = query.value(0).toInt();
+        if (recentOrders.contains(orderId)) { continue; } // loaded last time
+
+        days.append(qint32(query.value(1).toDate().toJulianDay()));
+        orderIds.append(orderId);
+        const int product  = productCode(query.value(2).toInt(), query.value(3).toString());
+        const int category = categoryCode(query.value(4).toString());
+        productCodes.append(product);
+        categoryCodes.append(category);
+        categoryForProduct.resize(productNames.size());
+        categoryForProduct[product] = category;
+
+        qint64 quantity = quantityToMilli(query.value(5).toDouble());
+        quantities.append(quantity);
+        Money net = Money::fromVariant(query.value(6)).times(quantity) -
+                    Money::fromVariant(query.value(7));
+        lineCents.append(net.cents());
+    }
+
+    const int added = days.size() - firstNew;
+    if (added == 0) { return true; }
+
+    // Remember the orders inside the re-read window. New lines arrived in
+    // OrderID order, so they are at the tail of what was just appended.
+    for (int i = firstNew; i < days.size(); ++i) {
+        loadedThrough = qMax(loadedThrough, int(orderIds.at(i)));
+    }
+    const int threshold = loadedThrough - ReloadWindow;
+    for (auto it = recentOrders.begin(); it != recentOrders.end();) {
+        if (*it <= threshold) {
+            it = recentOrders.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    for (int i = days.size() - 1; i >= firstNew && orderIds.at(i) > threshold; --i) {
+        recentOrders.insert(orderIds.at(i));
+    }
+
+    qDebug() << "Order line store: +" << added << "lines," << days.size() << "total in"
+             << timer.elapsed() << "ms";
+    emit updated();
+    return true;
+}
+
+QVector<OrderLineStore::Partition> OrderLineStore::partitions() const {
+    const int count = days.size();
+    if (count < parallelThreshold) { return {{0, count}}; }
+
+    // Many more partitions than threads, so idle threads pick up the
+    // remaining work instead of waiting on one long slice
+    QVector<Partition> result;
+    int begin = 0;
+    while (begin < count) {
+        int end = qMin(begin + partitionLines, count);
+
+        // Never split an order, so distinct-order counts stay exact
+        while (end < count && orderIds.at(end) == orderIds.at(end - 1)) { ++end; }
+
+        result.append({begin, end});
+        begin = end;
+    }
+    return result;
+}
+
+Money OrderLineStore::revenue(const QDate &from, const QDate &to) const {
+    const qint32  lo    = qint32(from.toJulianDay());
+    const qint32  hi    = qint32(to.toJulianDay());
+    const qint32 *day   = days.constData();
+    const qint64 *cents = lineCents.constData();
+
+    auto sum = [=](const Partition &range) {
+        // Branch-free so the compiler can vectorise the loop
+        qint64 total = 0;
+        for (int i = range.begin; i < range.end; ++i) {
+            total += (day[i] >= lo) & (day[i] < hi) ? cents[i] : 0;
+        }
+        return total;
+    };
+
+    QVector<Partition> ranges = partitions();
+    if (ranges.size() == 1) { return Money::fromCents(sum(ranges.first())); }
+
+    qint64 total = QtConcurrent::blockingMappedReduced<qint64>(
+        &pool, ranges, sum, [](qint64 &result, qint64 partial) { result += partial; });
+    return Money::fromCents(total);
+}
+
+void OrderLineStore::accumulate(const Partition &range, const QVector<qint32> &codes,
+                                qint32 fromDay, qint32 toDay, bool countOrders,
+                                Partial &partial) const {
+    const qint32 *day      = days.constData();
+    const qint32 *order    = orderIds.constData();
+    const qint32 *code     = codes.constData();
+    const qint64 *quantity = quantities.constData();
+    const qint64 *cents    = lineCents.constData();
+
+    qint64 *quantitySum = partial.quantity.data();
+    qint64 *centsSum    = partial.cents.data();
+    int    *orderCount  = partial.orders.data();
+    char   *seen        = partial.seen.data();
+
+    // Last order counted per code, local to this partition
+    QVector<qint32> lastOrder(countOrders ? partial.seen.size() : 0, -1);
+
+    for (int i = range.begin; i < range.end; ++i) {
+        if (day[i] < fromDay || day[i] >= toDay) { continue; }
+        const int c = code[i];
+        quantitySum[c] += quantity[i];
+        centsSum[c] += cents[i];
+        seen[c] = 1;
+
+        // An order's lines are stored together (and partitions never split
+        // an order), so a change of order is a new distinct order for this code
+        if (countOrders && lastOrder[c] != order[i]) {
+            lastOrder[c] = order[i];
+            ++orderCount[c];
+        }
+    }
+}
+
+QVector<LineGroup> OrderLineStore::groupBy(const QVector<qint32> &codes, int codeCount,
+                                           const QDate &from, const QDate &to,
+                                           bool countOrders) const {
+    const qint32 lo = qint32(from.toJulianDay());
+    const qint32 hi = qint32(to.toJulianDay());
+
+    auto aggregate = [&](const Partition &range) {
+        // Dense accumulators indexed by dictionary code, one set per partition
+        Partial partial;
+        partial.quantity.fill(0, codeCount);
+        partial.cents.fill(0, codeCount);
+        partial.orders.fill(0, countOrders ? codeCount : 0);
+        partial.seen.fill(0, codeCount);
+        accumulate(range, codes, lo, hi, countOrders, partial);
+        return partial;
+    };
+
+    auto merge = [](Partial &result, const Partial &partial) {
+        if (result.seen.isEmpty()) {
+            result = partial;
+            return;
+        }
+        for (int c = 0; c < partial.seen.size(); ++c) {
+            result.quantity[c] += partial.quantity[c];
+            result.cents[c] += partial.cents[c];
+            result.seen[c] |= partial.seen[c];
+        }
+        for (int c = 0; c < partial.orders.size(); ++c) {
+            result.orders[c] += partial.orders[c];
+        }
+    };
+
+    QVector<Partition> ranges = partitions();
+    Partial            total;
+    if (ranges.size() == 1) {
+        total = aggregate(ranges.first());
+    } else {
+        total = QtConcurrent::blockingMappedReduced<Partial>(&pool, ranges, aggregate, merge);
+    }
+
+    QVector<LineGroup> groups;
+    for (int c = 0; c < codeCount; ++c) {
+        if (!total.seen.value(c)) { continue; }
+        LineGroup group;
+        group.code          = c;
+        group.quantityMilli = total.quantity[c];
+        group.revenue       = Money::fromCents(total.cents[c]);
+        group.orders        = countOrders ? total.orders[c] : 0;
+        groups.append(group);
+    }
+    return groups;
+}
+
+QVector<LineGroup> OrderLineStore::byProduct(const QDate &from, const QDate &to) const {
+    // Left in code order; callers rank only what they show
+    QVector<LineGroup> groups = groupBy(productCodes, productNames.size(), from, to, false);
+    for (LineGroup &group : groups) { group.name = productNames.at(group.code); }
+    return groups;
+}
+
+QVector<LineGroup> OrderLineStore::byCategory(const QDate &from, const QDate &to) const {
+    QVector<LineGroup> groups = groupBy(categoryCodes, categoryNames.size(), from, to, true);
+    for (LineGroup &group : groups) { group.name = categoryNames.at(group.code); }
+
+    std::sort(groups.begin(), groups.end(), [](const LineGroup &a, const LineGroup &b) {
+        return a.orders > b.orders;
+    });
+    return groups;
+}
@@ -0,0 +1,127 @@
+#ifndef ORDERLINESTORE_H
+#define ORDERLINESTORE_H
+
+#include <QDate>
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QThreadPool>
+#include <QVector>
+
+#include "Money.h"
+
+// Sales of one product or category over a range
+struct LineGroup {
+    int     code = -1; // dictionary code
+    QString name;
+    int     orders        = 0; // distinct orders (categories only)
+    qint64  quantityMilli = 0;
+    Money   revenue;
+};
+
+// Every order line held in memory as columns, for analytics scans.
+//
+// Each column is a contiguous array with one entry per line: day (Julian
+// day number), order ID, product and category codes, quantity in
+// thousandths and line total in cents. Product and category names are
+// dictionary encoded, so a group-by is a pass over small integers that adds
+// into a dense array indexed by code. Lines are appended incrementally by
+// OrderID; about 32 bytes are kept per line.
+//
+// Large scans are split into partitions on order boundaries. Each partition
+// is aggregated into its own arrays on a thread pool and the partial
+// results are added together. The sums are integers, so the result does
+// not depend on how the work was split or scheduled.
+class OrderLineStore : public QObject {
+    Q_OBJECT
+
+  public:
+    explicit OrderLineStore(QObject *parent = nullptr);
+
+    // Loads everything the first time, then only orders not seen yet
+    bool refresh();
+
+    int lineCount() const { return days.size(); }
+
+    // Worker threads for scans (defaults to one per core)
+    void setMaxThreads(int threads) { pool.setMaxThreadCount(threads); }
+    int  maxThreads() const { return pool.maxThreadCount(); }
+
+    // Scans of at least threshold lines are split into partitions of about
+    // partitionLines each (100000 and 32768 by default). Tests lower them
+    // to split a small store many ways.
+    void setPartitioning(int threshold, int partitionLines) {
+        parallelThreshold = qMax(0, threshold);
+        this->partitionLines = qMax(1, partitionLines);
+    }
+
+    // All ranges are [fromDay, toDay) in dates
+    Money              revenue(const QDate &from, const QDate &to) const;
+    QVector<LineGroup> byProduct(const QDate &from, const QDate &to) const; // unordered
+    QVector<LineGroup> byCategory(const QDate &from, const QDate &to) const;
+
+    QString productName(int code) const { return productNames.value(code); }
+    QString productCategory(int code) const {
+        return categoryNames.value(categoryForProduct.value(code));
+    }
+    QString categoryName(int code) const { return categoryNames.value(code); }
+
+  signals:
+    void updated();
+
+  private:
+    // Columns
+    QVector<qint32> days;
+    QVector<qint32> orderIds;
+    QVector<qint32> productCodes;
+    QVector<qint32> categoryCodes;
+    QVector<qint64> quantities; // thousandths
+    QVector<qint64> lineCents;
+
+    // Dictionaries
+    QVector<QString>    productNames;
+    QHash<int, int>     productCodeForId;
+    QVector<qint32>     categoryForProduct; // category of the latest line
+    QVector<QString>    categoryNames;
+    QHash<QString, int> categoryCodeForName;
+
+    // Orders from other registers can commit out of OrderID order, so a
+    // short window below the newest OrderID is re-read on every refresh
+    int       loadedThrough = 0;
+    QSet<int> recentOrders;
+    static constexpr int ReloadWindow = 64;
+
+    // Below this many lines a scan is not worth handing to other threads
+    int parallelThreshold = 100000;
+    int partitionLines    = 32768;
+
+    // Scans run here rather than on the global pool, so their size can be
+    // set without affecting anything else
+    mutable QThreadPool pool;
+
+    struct Partition {
+        int begin;
+        int end;
+    };
+    struct Partial {
+        QVector<qint64> quantity;
+        QVector<qint64> cents;
+        QVector<int>    orders;
+        QVector<char>   seen;
+    };
+
+    QVector<Partition> partitions() const;
+    void               accumulate(const Partition &range, const QVector<qint32> &codes,
+                                  qint32 fromDay, qint32 toDay, bool countOrders,
+                                  Partial &partial) const;
+
+    int productCode(int productId, const QString &name);
+    int categoryCode(const QString &name);
+
+    QVector<LineGroup> groupBy(const QVector<qint32> &codes, int codeCount,
+                               const QDate &from, const QDate &to,
+                               bool countOrders) const;
+};
+
+#endif // ORDERLINESTORE_H
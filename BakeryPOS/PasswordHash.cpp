@@ -0,0 +1,194 @@
+#include "PasswordHash.h"
+
+#include <QCryptographicHash>
+#include <QMessageAuthenticationCode>
+#include <QRandomGenerator>
+#include <QStringList>
+#include <QtEndian>
+
+#include <cstring>
+#include <vector>
+
+static constexpr int SaltBytes = 16;
+static constexpr int HashBytes = 32;
+static constexpr int BlockSize = 8; // r
+static constexpr int Lanes     = 1; // p
+
+// Stored parameters beyond these are rejected before hashing: hash() writes
+// r = 8, p = 1 and cost 12 or 14, and raising the cost later still fits.
+// At most 128 * r * 2^cost = 2 GiB of scratch memory.
+static constexpr int MaxCost      = 20;
+static constexpr int MaxBlockSize = 16;
+static constexpr int MaxLanes     = 4;
+static constexpr int MaxHashBytes = 64;
+
+static inline quint32 rotate(quint32 value, int bits) {
+    return (value << bits) | (value >> (32 - bits));
+}
+
+// Salsa20/8 core on one 64 byte block, in place
+static void salsa20_8(quint32 block[16]) {
+    quint32 x[16];
+    std::memcpy(x, block, sizeof(x));
+
+    for (int i = 0; i < 8; i += 2) {
+        // Columns
+        x[4] ^= rotate(x[0] + x[12], 7);   x[8] ^= rotate(x[4] + x[0], 9);
+        x[12] ^= rotate(x[8] + x[4], 13);  x[0] ^= rotate(x[12] + x[8], 18);
+        x[9] ^= rotate(x[5] + x[1], 7);    x[13] ^= rotate(x[9] + x[5], 9);
+        x[1] ^= rotate(x[13] + x[9], 13);  x[5] ^= rotate(x[1] + x[13], 18);
+        x[14] ^= rotate(x[10] + x[6], 7);  x[2] ^= rotate(x[14] + x[10], 9);
+        x[6] ^= rotate(x[2] + x[14], 13);  x[10] ^= rotate(x[6] + x[2], 18);
+        x[3] ^= rotate(x[15] + x[11], 7);  x[7] ^= rotate(x[3] + x[15], 9);
+        x[11] ^= rotate(x[7] + x[3], 13);  x[15] ^= rotate(x[11] + x[7], 18);
+
+        // Rows
+        x[1] ^= rotate(x[0] + x[3], 7);    x[2] ^= rotate(x[1] + x[0], 9);
+        x[3] ^= rotate(x[2] + x[1], 13);   x[0] ^= rotate(x[3] + x[2], 18);
+        x[6] ^= rotate(x[5] + x[4], 7);    x[7] ^= rotate(x[6] + x[5], 9);
+        x[4] ^= rotate(x[7] + x[6], 13);   x[5] ^= rotate(x[4] + x[7], 18);
+        x[11] ^= rotate(x[10] + x[9], 7);  x[8] ^= rotate(x[11] + x[10], 9);
+        x[9] ^= rotate(x[8] + x[11], 13);  x[10] ^= rotate(x[9] + x[8], 18);
+        x[12] ^= rotate(x[15] + x[14], 7); x[13] ^= rotate(x[12] + x[15], 9);
+        x[14] ^= rotate(x[13] + x[12], 13); x[15] ^= rotate(x[14] + x[13], 18);
+    }
+
+    for (int i = 0; i < 16; ++i) { block[i] += x[i]; }
+}
+
+// BlockMix over 2r blocks of 16 words: in -> out
+static void blockMix(const quint32 *in, quint32 *out, int r) {
+    quint32 x[16];
+    std::memcpy(x, in + (2 * r - 1) * 16, sizeof(x));
+
+    for (int i = 0; i < 2 * r; ++i) {
+        for (int j = 0; j < 16; ++j) { x[j] ^= in[i * 16 + j]; }
+        salsa20_8(x);
+
+        // Even blocks go to the first half, odd ones to the second
+        std::memcpy(out + ((i / 2) + (i % 2) * r) * 16, x, sizeof(x));
+    }
+}
+
+// ROMix on one lane of 32r words; v holds N lane copies, the memory-hard part
+static void roMix(quint32 *lane, int r, quint64 n, quint32 *v, quint32 *y) {
+    const int words = 32 * r;
+    quint32  *x     = lane;
+
+    for (quint64 i = 0; i < n; ++i) {
+        std::memcpy(v + i * words, x, words * sizeof(quint32));
+        blockMix(x, y, r);
+        std::memcpy(x, y, words * sizeof(quint32));
+    }
+    for (quint64 i = 0; i < n; ++i) {
+        quint64 j = x[(2 * r - 1) * 16] & (n - 1);
+        for (int k = 0; k < words; ++k) { x[k] ^= v[j * words + k]; }
+        blockMix(x, y, r);
+        std::memcpy(x, y, words * sizeof(quint32));
+    }
+}
+
+QByteArray PasswordHash::pbkdf2Sha256(const QByteArray &password, const QByteArray &salt,
+                                      int iterations, int length) {
+    QByteArray                 result;
+    QMessageAuthenticationCode mac(QCryptographicHash::Sha256, password);
+
+    for (quint32 block = 1; result.size() < length; ++block) {
+        char counter[4];
+        qToBigEndian(block, counter);
+
+        mac.reset();
+        mac.addData(salt);
+        mac.addData(counter, 4);
+        QByteArray u = mac.result();
+        QByteArray t = u;
+
+        for (int i = 1; i < iterations; ++i) {
+            mac.reset();
+            mac.addData(u);
+            u = mac.result();
+            for (int j = 0; j < t.size(); ++j) { t[j] = char(t[j] ^ u[j]); }
+        }
+        result += t;
+    }
+    result.truncate(length);
+    return result;
+}
+
+QByteArray PasswordHash::scrypt(const QByteArray &password, const QByteArray &salt, int cost,
+                                int r, int p, int length) {
+    const quint64 n     = quint64(1) << cost;
+    const int     words = 32 * r;
+
+    QByteArray bytes = pbkdf2Sha256(password, salt, 1, p * 128 * r);
+
+    // The mixing works on little-endian 32 bit words
+    std::vector<quint32> b(size_t(p) * words);
+    for (size_t i = 0; i < b.size(); ++i) {
+        b[i] = qFromLittleEndian<quint32>(bytes.constData() + i * 4);
+    }
+
+    std::vector<quint32> v(size_t(n) * words);
+    std::vector<quint32> y(words);
+    for (int lane = 0; lane < p; ++lane) {
+        roMix(b.data() + lane * words, r, n, v.data(), y.data());
+    }
+
+    for (size_t i = 0; i < b.size(); ++i) { qToLittleEndian(b[i], bytes.data() + i * 4); }
+    return pbkdf2Sha256(password, bytes, 1, length);
+}
+
+bool PasswordHash::constantTimeEquals(const QByteArray &a, const QByteArray &b) {
+    if (a.size() != b.size()) { return false; }
+    char difference = 0;
+    for (int i = 0; i < a.size(); ++i) { difference |= char(a[i] ^ b[i]); }
+    return difference == 0;
+}
+
+QString PasswordHash::hash(const QString &secret, int cost) {
+    QByteArray salt(SaltBytes, Qt::Uninitialized);
+    QRandomGenerator::system()->fillRange(reinterpret_cast<quint32 *>(salt.data()),
+                                          SaltBytes / int(sizeof(quint32)));
+
+    QByteArray key = scrypt(secret.toUtf8(), salt, cost, BlockSize, Lanes, HashBytes);
+    return QString("scrypt$%1$%2$%3$%4$%5")
+        .arg(cost)
+        .arg(BlockSize)
+        .arg(Lanes)
+        .arg(QString::fromLatin1(salt.toBase64()), QString::fromLatin1(key.toBase64()));
+}
+
+bool PasswordHash::isHashed(const QString &stored) { return stored.startsWith("scrypt$"); }
+
+bool PasswordHash::verify(const QString &secret, const QString &stored, bool *needsUpgrade,
+                          int cost) {
+    if (needsUpgrade) { *needsUpgrade = false; }
+
+    if (!isHashed(stored)) {
+        // Plaintext from before hashing; good for this one login
+        bool matches = !stored.isEmpty() && constantTimeEquals(secret.toUtf8(), stored.toUtf8());
+        if (needsUpgrade) { *needsUpgrade = matches; }
+        return matches;
+    }
+
+    QStringList parts = stored.split('$');
+    if (parts.size() != 6) { return false; }
+
+    bool ok         = false;
+    int  storedCost = parts.at(1).toInt(&ok);
+    if (!ok || storedCost < 1 || storedCost > MaxCost) { return false; }
+    int r = parts.at(2).toInt(&ok);
+    if (!ok || r < 1 || r > MaxBlockSize) { return false; }
+    int p = parts.at(3).toInt(&ok);
+    if (!ok || p < 1 || p > MaxLanes) { return false; }
+
+    QByteArray salt     = QByteArray::fromBase64(parts.at(4).toLatin1());
+    QByteArray expected = QByteArray::fromBase64(parts.at(5).toLatin1());
+    if (salt.isEmpty() || expected.isEmpty() || expected.size() > MaxHashBytes) { return false; }
+
+    bool matches = constantTimeEquals(scrypt(secret.toUtf8(), salt, storedCost, r, p,
+                                             expected.size()),
+                                      expected);
+    if (needsUpgrade) { *needsUpgrade = matches && storedCost < cost; }
+    return matches;
+}
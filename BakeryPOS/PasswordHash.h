@@ -0,0 +1,38 @@
+#ifndef PASSWORDHASH_H
+#define PASSWORDHASH_H
+
+#include <QByteArray>
+#include <QString>
+
+// Salted, memory-hard hashes for passwords and PINs (scrypt, RFC 7914).
+//
+// Stored as "scrypt$<log2 N>$<r>$<p>$<salt>$<hash>" with base64 salt and
+// hash, so the cost can be raised later without breaking existing rows.
+// With the password cost a check takes about 16 MiB and a noticeable
+// fraction of a second, so callers verify off the UI thread.
+class PasswordHash {
+  public:
+    static constexpr int PasswordCost = 14; // N = 16384, 16 MiB with r = 8
+    static constexpr int PinCost      = 12; // PINs are checked on every switch
+
+    static QString hash(const QString &secret, int cost = PasswordCost);
+
+    // Also accepts a plaintext value left from before hashing; needsUpgrade
+    // is then set (as it is for a hash weaker than cost) so the caller can
+    // store a fresh hash
+    static bool verify(const QString &secret, const QString &stored,
+                       bool *needsUpgrade = nullptr, int cost = PasswordCost);
+
+    static bool isHashed(const QString &stored);
+
+    // Compares without stopping at the first difference; for secrets such
+    // as API tokens too
+    static bool constantTimeEquals(const QByteArray &a, const QByteArray &b);
+
+    static QByteArray scrypt(const QByteArray &password, const QByteArray &salt,
+                             int cost, int r, int p, int length);
+    static QByteArray pbkdf2Sha256(const QByteArray &password, const QByteArray &salt,
+                                   int iterations, int length);
+};
+
+#endif // PASSWORDHASH_H
@@ -0,0 +1,139 @@
+#include "PinSwitchDialog.h"
+
+#include "PasswordHash.h"
+#include "RolePages.h"
+
+#include <QComboBox>
+#include <QDateTime>
+#include <QDialogButtonBox>
+#include <QFormLayout>
+#include <QHash>
+#include <QLabel>
+#include <QLineEdit>
+#include <QPushButton>
+#include <QRegularExpressionValidator>
+#include <QVBoxLayout>
+#include <QtConcurrent>
+
+namespace {
+// Wrong PINs per user, kept for the life of the app so that closing and
+// reopening the dialog does not start the count again
+struct PinFailures {
+    int       count = 0;
+    QDateTime lockedUntil;
+};
+
+QHash<int, PinFailures> &pinFailures() {
+    static QHash<int, PinFailures> failures;
+    return failures;
+}
+} // namespace
+
+PinSwitchDialog::PinSwitchDialog(int currentUserId, QWidget *parent, Purpose purpose)
+    : QDialog(parent) {
+    const bool approval = purpose == ManagerApproval;
+    setWindowTitle(approval ? "Manager Approval" : "Switch User");
+    setModal(true);
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    QFormLayout *form   = new QFormLayout();
+
+    userComboBox = new QComboBox(this);
+    for (const Credential &credential : CredentialStore::instance()->usersWithPin()) {
+        if (credential.status != "Active" || credential.userId == currentUserId) { continue; }
+        if (approval && !RolePages::canRefund(credential.role)) { continue; }
+        users << credential;
+        userComboBox->addItem(QString("%1 (%2)").arg(credential.username, credential.role));
+    }
+    form->addRow("User:", userComboBox);
+
+    pinLineEdit = new QLineEdit(this);
+    pinLineEdit->setEchoMode(QLineEdit::Password);
+    pinLineEdit->setMaxLength(8);
+    pinLineEdit->setValidator(
+        new QRegularExpressionValidator(QRegularExpression("\\d{0,8}"), pinLineEdit));
+    pinLineEdit->setPlaceholderText("PIN");
+    form->addRow("PIN:", pinLineEdit);
+    layout->addLayout(form);
+
+    errorLabel = new QLabel(this);
+    errorLabel->setStyleSheet("color: #c0392b;");
+    layout->addWidget(errorLabel);
+
+    QDialogButtonBox *buttons = new QDialogButtonBox(this);
+    switchButton = buttons->addButton(approval ? "Approve" : "Switch",
+                                      QDialogButtonBox::AcceptRole);
+    buttons->addButton(QDialogButtonBox::Cancel);
+    layout->addWidget(buttons);
+
+    if (users.isEmpty()) {
+        errorLabel->setText(approval ? "No manager has a PIN on this register."
+                                     : "No other user has a PIN on this register.");
+        userComboBox->setEnabled(false);
+        pinLineEdit->setEnabled(false);
+        switchButton->setEnabled(false);
+    }
+
+    // accepted() is left unconnected: the dialog closes once the PIN checks out
+    connect(switchButton, &QPushButton::clicked, this, &PinSwitchDialog::onSwitchClicked);
+    connect(pinLineEdit, &QLineEdit::returnPressed, this, &PinSwitchDialog::onSwitchClicked);
+    connect(buttons, &QDialogButtonBox::rejected, this, &QDialog::reject);
+    connect(&checkWatcher, &QFutureWatcher<bool>::finished, this,
+            &PinSwitchDialog::onCheckFinished);
+
+    pinLineEdit->setFocus();
+}
+
+void PinSwitchDialog::onSwitchClicked() {
+    int index = userComboBox->currentIndex();
+    if (checkWatcher.isRunning() || index < 0 || index >= users.size()) { return; }
+
+    QString pin = pinLineEdit->text();
+    if (pin.isEmpty()) { return; }
+    if (pin.size() < MinPinLength) {
+        errorLabel->setText(QString("A PIN has at least %1 digits.").arg(MinPinLength));
+        return;
+    }
+
+    QDateTime lockedUntil = pinFailures().value(users.at(index).userId).lockedUntil;
+    qint64    lockedFor   = QDateTime::currentDateTime().secsTo(lockedUntil);
+    if (lockedFor > 0) {
+        pinLineEdit->clear();
+        errorLabel->setText(
+            QString("Too many wrong PINs. Try again in %1 s.").arg(lockedFor));
+        return;
+    }
+
+    selected = users.at(index);
+    switchButton->setEnabled(false);
+    errorLabel->clear();
+
+    QString stored = selected.pinHash;
+    checkWatcher.setFuture(QtConcurrent::run([pin, stored]() {
+        return PasswordHash::verify(pin, stored, nullptr, PasswordHash::PinCost);
+    }));
+}
+
+void PinSwitchDialog::onCheckFinished() {
+    switchButton->setEnabled(true);
+
+    if (checkWatcher.result()) {
+        pinFailures().remove(selected.userId);
+        accept();
+        return;
+    }
+
+    PinFailures &failures = pinFailures()[selected.userId];
+    if (++failures.count >= MaxAttempts) {
+        failures.count       = 0;
+        failures.lockedUntil = QDateTime::currentDateTime().addSecs(LockoutSeconds);
+        errorLabel->setText(
+            QString("Too many wrong PINs. Locked for %1 minutes.").arg(LockoutSeconds / 60));
+    } else {
+        errorLabel->setText(QString("Wrong PIN. %1 attempts left.")
+                                .arg(MaxAttempts - failures.count));
+    }
+
+    selected = Credential();
+    pinLineEdit->clear();
+}
@@ -0,0 +1,54 @@
+#ifndef PINSWITCHDIALOG_H
+#define PINSWITCHDIALOG_H
+
+#include <QDialog>
+#include <QFutureWatcher>
+
+#include "CredentialStore.h"
+
+class QComboBox;
+class QLabel;
+class QLineEdit;
+class QPushButton;
+
+// Hands the register to another cashier with a short PIN.
+//
+// Users and PIN hashes come from CredentialStore, so a switch needs no
+// database round trip; the PIN is checked off the UI thread. The caller
+// keeps its dashboard and only swaps the user ID (see userId()). After
+// MaxAttempts wrong PINs in a row a user is locked out for LockoutSeconds.
+//
+// With ManagerApproval only managers and admins are offered, and userId()
+// is the manager who approved the action (e.g. a refund on a cashier's
+// register).
+class PinSwitchDialog : public QDialog {
+    Q_OBJECT
+
+  public:
+    enum Purpose { SwitchUser, ManagerApproval };
+
+    explicit PinSwitchDialog(int currentUserId, QWidget *parent = nullptr,
+                             Purpose purpose = SwitchUser);
+
+    int userId() const { return selected.userId; }
+
+    static constexpr int MinPinLength   = 4; // as enforced by EditUserForm
+    static constexpr int MaxAttempts    = 5;
+    static constexpr int LockoutSeconds = 300;
+
+  private slots:
+    void onSwitchClicked();
+    void onCheckFinished();
+
+  private:
+    QComboBox   *userComboBox = nullptr;
+    QLineEdit   *pinLineEdit  = nullptr;
+    QLabel      *errorLabel   = nullptr;
+    QPushButton *switchButton = nullptr;
+
+    QList<Credential>    users;
+    Credential           selected;
+    QFutureWatcher<bool> checkWatcher;
+};
+
+#endif // PINSWITCHDIALOG_H
@@ -0,0 +1,151 @@
+#include "PricingEngine.h"
+
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QDebug>
+
+bool PromotionRule::activeAt(int minuteOfDay) const {
+    // A window such as 22:00-02:00 runs past midnight
+    if (startMinute <= endMinute) { return minuteOfDay >= startMinute && minuteOfDay < endMinute; }
+    return minuteOfDay >= startMinute || minuteOfDay < endMinute;
+}
+
+Money PromotionRule::discountOn(Money unitPrice, qint64 quantityMilli) const {
+    if (kind == PercentOff) { return unitPrice.times(quantityMilli).percent(percentOff); }
+
+    // Only complete bundles are discounted; the rest is at the unit price
+    if (bundleQuantityMilli <= 0) { return Money(); }
+    qint64 bundles = quantityMilli / bundleQuantityMilli;
+    Money  saving  = unitPrice.times(bundleQuantityMilli) - bundlePrice;
+    return saving < Money() ? Money() : Money::fromCents(saving.cents() * bundles);
+}
+
+void TaxTotals::add(int basisPoints, Money net) {
+    for (auto &rate : byRate) {
+        if (rate.first == basisPoints) {
+            rate.second += net;
+            return;
+        }
+    }
+    byRate.append({basisPoints, net});
+}
+
+Money TaxTotals::tax() const {
+    Money total;
+    for (const auto &rate : byRate) {
+        total += rate.second.percent(rate.first, SalesTax::rounding);
+    }
+    return total;
+}
+
+int PricingEngine::minuteOfDay(const QTime &time) { return time.hour() * 60 + time.minute(); }
+
+bool PricingEngine::load(const QSqlDatabase &db) {
+    QSqlQuery query(db);
+    query.setForwardOnly(true);
+    if (!query.exec("SELECT PromotionID, Name, Kind, ProductID, Category, BundleQuantity, "
+                    "BundlePrice, PercentOff, StartTime, EndTime, ValidFrom, ValidTo "
+                    "FROM promotions WHERE Active = 1")) {
+        qDebug() << "Promotions load failed:" << query.lastError().text();
+        return false;
+    }
+
+    QVector<PromotionRule> loaded;
+    while (query.next()) {
+        PromotionRule rule;
+        rule.id                  = query.value(0).toInt();
+        rule.name                = query.value(1).toString();
+        rule.kind                = query.value(2).toString() == "bundle" ? PromotionRule::Bundle
+                                                                        : PromotionRule::PercentOff;
+        rule.productId           = query.value(3).toInt();
+        rule.category            = query.value(4).toString();
+        rule.bundleQuantityMilli = quantityToMilli(query.value(5).toDouble());
+        rule.bundlePrice         = Money::fromVariant(query.value(6));
+        rule.percentOff          = query.value(7).toInt();
+        if (!query.value(8).isNull()) { rule.startMinute = minuteOfDay(query.value(8).toTime()); }
+        if (!query.value(9).isNull()) { rule.endMinute = minuteOfDay(query.value(9).toTime()); }
+        rule.validFrom = query.value(10).toDate();
+        rule.validTo   = query.value(11).toDate();
+        loaded.append(rule);
+    }
+
+    if (!query.exec("SELECT Category, TaxBasisPoints FROM categories "
+                    "WHERE TaxBasisPoints IS NOT NULL")) {
+        qDebug() << "Category tax load failed:" << query.lastError().text();
+        return false;
+    }
+    QHash<QString, int> rates;
+    while (query.next()) { rates.insert(query.value(0).toString(), query.value(1).toInt()); }
+
+    setRules(loaded, QDate::currentDate());
+    setTaxRates(rates);
+    return true;
+}
+
+void PricingEngine::setRules(const QVector<PromotionRule> &all, const QDate &today) {
+    rules.clear();
+    rulesForProduct.clear();
+    rulesForCategory.clear();
+    storeWideRules.clear();
+
+    for (const PromotionRule &rule : all) {
+        if (rule.validFrom.isValid() && today < rule.validFrom) { continue; }
+        if (rule.validTo.isValid() && today > rule.validTo) { continue; }
+
+        const int index = rules.size();
+        rules.append(rule);
+        if (rule.productId > 0) {
+            rulesForProduct[rule.productId].append(index);
+        } else if (!rule.category.isEmpty()) {
+            rulesForCategory[rule.category].append(index);
+        } else {
+            storeWideRules.append(index);
+        }
+    }
+}
+
+void PricingEngine::setTaxRates(const QHash<QString, int> &basisPointsByCategory) {
+    taxForCategory = basisPointsByCategory;
+}
+
+LinePrice PricingEngine::price(int productId, const QString &category, Money unitPrice,
+                               qint64 quantityMilli, int minuteOfDay) const {
+    LinePrice line;
+    line.gross = unitPrice.times(quantityMilli);
+    if (rules.isEmpty()) { return line; }
+
+    auto consider = [&](int index) {
+        const PromotionRule &rule = rules.at(index);
+        if (!rule.activeAt(minuteOfDay)) { return; }
+
+        Money discount = rule.discountOn(unitPrice, quantityMilli);
+        if (line.discount < discount) {
+            line.discount    = discount;
+            line.promotionId = rule.id;
+        }
+    };
+
+    auto forProduct = rulesForProduct.constFind(productId);
+    if (forProduct != rulesForProduct.constEnd()) {
+        for (int index : *forProduct) { consider(index); }
+    }
+    auto forCategory = rulesForCategory.constFind(category);
+    if (forCategory != rulesForCategory.constEnd()) {
+        for (int index : *forCategory) { consider(index); }
+    }
+    for (int index : storeWideRules) { consider(index); }
+
+    if (line.gross < line.discount) { line.discount = line.gross; }
+    return line;
+}
+
+int PricingEngine::taxRate(const QString &category) const {
+    return taxForCategory.value(category, SalesTax::rate);
+}
+
+QString PricingEngine::promotionName(int promotionId) const {
+    for (const PromotionRule &rule : rules) {
+        if (rule.id == promotionId) { return rule.name; }
+    }
+    return QString();
+}
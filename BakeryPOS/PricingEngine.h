@@ -0,0 +1,86 @@
+#ifndef PRICINGENGINE_H
+#define PRICINGENGINE_H
+
+#include <QDate>
+#include <QHash>
+#include <QSqlDatabase>
+#include <QString>
+#include <QTime>
+#include <QVarLengthArray>
+#include <QVector>
+
+#include "Money.h"
+
+// One row of the promotions table
+struct PromotionRule {
+    enum Kind { Bundle, PercentOff };
+
+    int     id = 0;
+    QString name;
+    Kind    kind      = PercentOff;
+    int     productId = 0; // 0 when not tied to one product
+    QString category;      // empty when not tied to a category
+
+    qint64 bundleQuantityMilli = 0; // Bundle: this many (thousandths) ...
+    Money  bundlePrice;             // ... for this price
+    int    percentOff = 0;          // PercentOff: basis points
+
+    // Time of day it applies, [start, end) in minutes after midnight
+    int   startMinute = 0;
+    int   endMinute   = 24 * 60;
+    QDate validFrom; // null: no limit
+    QDate validTo;
+
+    bool  activeAt(int minuteOfDay) const;
+    Money discountOn(Money unitPrice, qint64 quantityMilli) const;
+};
+
+struct LinePrice {
+    Money gross;    // unit price times quantity
+    Money discount; // never more than gross
+    int   promotionId = 0;
+
+    Money net() const { return gross - discount; }
+};
+
+// Net amounts grouped by tax rate. Each rate's tax is rounded once, so a
+// cart with one rate is taxed exactly as with the single SalesTax before.
+class TaxTotals {
+  public:
+    void  add(int basisPoints, Money net);
+    Money tax() const;
+
+  private:
+    QVarLengthArray<QPair<int, Money>, 4> byRate;
+};
+
+// Prices cart lines against the active promotions and per-category tax.
+//
+// Rules valid today are compiled into lists by product, by category and
+// store-wide, so pricing a line only looks at the few rules that can apply
+// to it however many are active. The rule giving the largest discount
+// wins; promotions do not stack. Time-of-day windows are checked on each
+// call, so end-of-day markdowns start without a reload.
+class PricingEngine {
+  public:
+    bool load(const QSqlDatabase &db = QSqlDatabase::database());
+    void setRules(const QVector<PromotionRule> &rules, const QDate &today);
+    void setTaxRates(const QHash<QString, int> &basisPointsByCategory);
+
+    LinePrice price(int productId, const QString &category, Money unitPrice,
+                    qint64 quantityMilli, int minuteOfDay) const;
+    int       taxRate(const QString &category) const;
+    QString   promotionName(int promotionId) const;
+    int       ruleCount() const { return rules.size(); }
+
+    static int minuteOfDay(const QTime &time = QTime::currentTime());
+
+  private:
+    QVector<PromotionRule>              rules;
+    QHash<int, QVarLengthArray<int, 4>> rulesForProduct;
+    QHash<QString, QVector<int>>        rulesForCategory;
+    QVector<int>                        storeWideRules;
+    QHash<QString, int>                 taxForCategory;
+};
+
+#endif // PRICINGENGINE_H
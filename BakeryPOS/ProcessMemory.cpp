@@ -0,0 +1,75 @@
+#include "ProcessMemory.h"
+
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#include <psapi.h>
+#elif defined(Q_OS_MACOS)
+#include <mach/mach.h>
+#else
+#include <QFile>
+#endif
+
+#if defined(Q_OS_LINUX)
+// A "Name:   1234 kB" line of /proc/self/status
+static qint64 statusKilobytes(const QByteArray &name) {
+    QFile file("/proc/self/status");
+    if (!file.open(QIODevice::ReadOnly)) { return 0; }
+    while (!file.atEnd()) {
+        QByteArray line = file.readLine();
+        if (line.startsWith(name)) {
+            return line.mid(name.size()).simplified().split(' ').value(0).toLongLong();
+        }
+    }
+    return 0;
+}
+#endif
+
+qint64 ProcessMemory::residentBytes() {
+#if defined(Q_OS_WIN)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) { return 0; }
+    return qint64(counters.WorkingSetSize);
+#elif defined(Q_OS_MACOS)
+    mach_task_basic_info_data_t info;
+    mach_msg_type_number_t      count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, task_info_t(&info), &count) !=
+        KERN_SUCCESS) {
+        return 0;
+    }
+    return qint64(info.resident_size);
+#elif defined(Q_OS_LINUX)
+    return statusKilobytes("VmRSS:") * 1024;
+#else
+    return 0;
+#endif
+}
+
+qint64 ProcessMemory::peakResidentBytes() {
+#if defined(Q_OS_WIN)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) { return 0; }
+    return qint64(counters.PeakWorkingSetSize);
+#elif defined(Q_OS_MACOS)
+    mach_task_basic_info_data_t info;
+    mach_msg_type_number_t      count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, task_info_t(&info), &count) !=
+        KERN_SUCCESS) {
+        return 0;
+    }
+    return qint64(info.resident_size_max);
+#elif defined(Q_OS_LINUX)
+    return statusKilobytes("VmHWM:") * 1024;
+#else
+    return 0;
+#endif
+}
+
+QString ProcessMemory::gaugeText(int topLevelWindows) {
+    const double MiB      = 1024.0 * 1024.0;
+    const qint64 resident = residentBytes();
+    if (resident <= 0) { return QString("%1 windows").arg(topLevelWindows); }
+    return QString("Memory %1 MB (peak %2 MB), %3 windows")
+        .arg(resident / MiB, 0, 'f', 1)
+        .arg(peakResidentBytes() / MiB, 0, 'f', 1)
+        .arg(topLevelWindows);
+}
@@ -0,0 +1,20 @@
+#ifndef PROCESSMEMORY_H
+#define PROCESSMEMORY_H
+
+#include <QString>
+#include <QtGlobal>
+
+// Resident memory of this process as the OS counts it (working set on
+// Windows), for the memory gauge in the dashboard status bar. Both are 0
+// where the platform gives no figure.
+class ProcessMemory {
+  public:
+    static qint64 residentBytes();
+    static qint64 peakResidentBytes();
+
+    // The gauge's text: resident and peak memory, and the top-level
+    // windows alive (shown or hidden)
+    static QString gaugeText(int topLevelWindows);
+};
+
+#endif // PROCESSMEMORY_H
@@ -0,0 +1,50 @@
+#ifndef PRODUCTRANKING_H
+#define PRODUCTRANKING_H
+
+#include <QHash>
+#include <QString>
+
+#include "OrderLineStore.h"
+#include "TopK.h"
+
+// Every product ranking the analytics page shows, filled in one pass over
+// per-product totals: the best sellers by revenue for the sales table, the
+// best seller by quantity for the dashboard card and the best seller of
+// each category. Only the kept products are held, not the whole list.
+struct ProductRanking {
+    struct ByRevenue {
+        bool operator()(const LineGroup &a, const LineGroup &b) const {
+            return a.revenue < b.revenue || (a.revenue == b.revenue && b.name < a.name);
+        }
+    };
+    struct ByQuantity {
+        bool operator()(const LineGroup &a, const LineGroup &b) const {
+            return a.quantityMilli < b.quantityMilli ||
+                   (a.quantityMilli == b.quantityMilli && b.name < a.name);
+        }
+    };
+
+    explicit ProductRanking(int rows = 10) : byRevenue(rows), byQuantity(1) {}
+
+    void add(const LineGroup &product, const QString &category) {
+        byRevenue.offer(product);
+        byQuantity.offer(product);
+        auto best = bestInCategory.find(category);
+        if (best == bestInCategory.end()) {
+            best = bestInCategory.insert(category, TopK<LineGroup, ByQuantity>(1));
+        }
+        best->offer(product);
+
+        ++products;
+        revenue += product.revenue;
+    }
+
+    TopK<LineGroup, ByRevenue>                  byRevenue;
+    TopK<LineGroup, ByQuantity>                 byQuantity;
+    QHash<QString, TopK<LineGroup, ByQuantity>> bestInCategory;
+
+    int   products = 0;
+    Money revenue;
+};
+
+#endif // PRODUCTRANKING_H
@@ -0,0 +1,101 @@
+#include "ProductRecord.h"
+
+// Same bounds as the QDoubleValidators in EditProductForm::setupValidation
+static const double MaxFieldValue = 99999.99;
+
+static bool isValidAmount(const QString &text) {
+    bool   ok    = false;
+    double value = text.toDouble(&ok);
+    return ok && value >= 0.0 && value <= MaxFieldValue;
+}
+
+ProductRecord::Field ProductRecord::validate(QString *message) const {
+    auto fail = [message](Field field, const QString &text) {
+        if (message) { *message = text; }
+        return field;
+    };
+
+    // Check if name is empty
+    if (name.trimmed().isEmpty()) {
+        return fail(NameField, "Product name cannot be empty.");
+    }
+
+    // Check if category is selected
+    if (category.trimmed().isEmpty() || category == "Select Category") {
+        return fail(CategoryField, "Please select a category.");
+    }
+
+    // Check if at least one price is provided
+    bool hasPricePerKg   = !pricePerKg.trimmed().isEmpty();
+    bool hasPricePerUnit = !pricePerUnit.trimmed().isEmpty();
+
+    if (!hasPricePerKg && !hasPricePerUnit) {
+        return fail(PriceField,
+                    "Please provide at least one price (Per KG or Per Unit).");
+    }
+
+    if ((hasPricePerKg && !isValidAmount(pricePerKg.trimmed())) ||
+        (hasPricePerUnit && !isValidAmount(pricePerUnit.trimmed()))) {
+        return fail(PriceField, "Prices must be between 0.00 and 99999.99.");
+    }
+
+    // Check if stock quantity is provided
+    if (stockQuantity.trimmed().isEmpty()) {
+        return fail(StockField, "Stock quantity cannot be empty.");
+    }
+
+    // Validate that stock quantity is not negative
+    if (stockQuantity.trimmed().toDouble() < 0) {
+        return fail(StockField, "Stock quantity cannot be negative.");
+    }
+
+    if (!isValidAmount(stockQuantity.trimmed())) {
+        return fail(StockField,
+                    "Stock quantity must be between 0.00 and 99999.99.");
+    }
+
+    // Barcodes are optional; scanners send plain digits and letters
+    QString code = barcode.trimmed();
+    if (code.size() > 32 || code.contains(' ')) {
+        return fail(BarcodeField,
+                    "Barcode must be at most 32 characters without spaces.");
+    }
+
+    // 'Available' is sold; anything else keeps the product off the tills
+    if (status.trimmed().size() > 32) {
+        return fail(StatusField, "Status must be at most 32 characters.");
+    }
+
+    return NoField;
+}
+
+QVariant ProductRecord::pricePerKgValue() const {
+    QString text = pricePerKg.trimmed();
+    return text.isEmpty() ? QVariant(QMetaType(QMetaType::Double))
+                          : QVariant(text.toDouble());
+}
+
+QVariant ProductRecord::pricePerUnitValue() const {
+    QString text = pricePerUnit.trimmed();
+    return text.isEmpty() ? QVariant(QMetaType(QMetaType::Double))
+                          : QVariant(text.toDouble());
+}
+
+QVariant ProductRecord::barcodeValue() const {
+    QString text = barcode.trimmed();
+    return text.isEmpty() ? QVariant(QMetaType(QMetaType::QString)) : QVariant(text);
+}
+
+QVariant ProductRecord::statusValue() const {
+    QString text = status.trimmed();
+    return text.isEmpty() ? QVariant(QMetaType(QMetaType::QString)) : QVariant(text);
+}
+
+QString ProductRecord::unitType() const {
+    // Enum values in the products table are 'kg' and 'unit'. Only a product
+    // priced purely by weight is 'kg'; anything with a unit price is 'unit'.
+    if (!pricePerKg.trimmed().isEmpty() && pricePerUnit.trimmed().isEmpty()) {
+        return "kg";
+    }
+    return "unit";
+}
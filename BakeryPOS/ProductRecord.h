@@ -0,0 +1,37 @@
+#ifndef PRODUCTRECORD_H
+#define PRODUCTRECORD_H
+
+#include <QString>
+#include <QVariant>
+
+// Plain product row as typed into EditProductForm or read from an import
+// file. Fields are kept as text so both paths run exactly the same checks.
+struct ProductRecord {
+    enum Field { NoField, NameField, CategoryField, PriceField, StockField,
+                 BarcodeField, StatusField };
+
+    QString name;
+    QString category;
+    QString pricePerKg;   // empty = NULL
+    QString pricePerUnit; // empty = NULL
+    QString stockQuantity;
+    QString barcode;      // empty = NULL (no barcode/PLU)
+    QString status;       // empty = 'Available' when added, unchanged when updated
+
+    // Returns NoField when the record is valid, otherwise the first offending
+    // field with a user facing message in *message.
+    Field validate(QString *message = nullptr) const;
+
+    QVariant pricePerKgValue() const;
+    QVariant pricePerUnitValue() const;
+    QVariant barcodeValue() const;
+    QVariant statusValue() const;
+    QString  unitType() const;
+
+    // SQL for the price a product sells at: per kilo for weighed ('kg')
+    // products, otherwise per unit. Sold quantities are kg or units to match.
+    static constexpr const char *SellingPriceSql =
+        "IF(UnitType = 'kg', PricePerKg, PricePerUnit)";
+};
+
+#endif // PRODUCTRECORD_H
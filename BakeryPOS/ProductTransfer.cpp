@@ -0,0 +1,474 @@
+#include "ProductTransfer.h"
+
+#include <QFile>
+#include <QHash>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QTextStream>
+#include <QDebug>
+
+static const int MaxReportedRejections = 100;
+
+static const char *ExportColumns[] = {"Name",          "Category", "PricePerKg",
+                                      "PricePerUnit", "StockQuantity",
+                                      "UnitType",      "status",   "Barcode"};
+
+enum class FileFormat { Csv, JsonLines, JsonArray };
+
+static FileFormat formatOf(const QString &path) {
+    if (path.endsWith(".jsonl", Qt::CaseInsensitive) ||
+        path.endsWith(".ndjson", Qt::CaseInsensitive)) {
+        return FileFormat::JsonLines;
+    }
+    if (path.endsWith(".json", Qt::CaseInsensitive)) { return FileFormat::JsonArray; }
+    return FileFormat::Csv;
+}
+
+// Hands out the elements of a top-level JSON array one at a time, so the
+// whole array is never held in memory. Each element's text is parsed on its
+// own by the caller.
+class JsonArrayReader {
+  public:
+    explicit JsonArrayReader(QTextStream &in) : in(in) {}
+
+    // False at the end of the array, or with *error set if the file is not
+    // a JSON array
+    bool next(QString *element, QString *error) {
+        if (finished) { return false; }
+
+        QChar c = skipSpace();
+        if (!started) {
+            if (c != '[') { return fail(error, "The file is not a JSON array."); }
+            started = true;
+            c       = skipSpace();
+            if (c == ']') {
+                finished = true;
+                return false;
+            }
+        } else if (c == ']') {
+            finished = true;
+            return false;
+        } else if (c != ',') {
+            return fail(error, "Expected ',' or ']' between array elements.");
+        } else {
+            c = skipSpace();
+        }
+        if (c.isNull()) { return fail(error, "The JSON array is not closed."); }
+
+        // Up to the ',' or ']' that ends this element, outside any string
+        element->clear();
+        int  depth   = 0;
+        bool quoted  = false;
+        bool escaped = false;
+        for (; !c.isNull(); c = take()) {
+            if (quoted) {
+                if (escaped) {
+                    escaped = false;
+                } else if (c == '\\') {
+                    escaped = true;
+                } else if (c == '"') {
+                    quoted = false;
+                }
+            } else if (c == '"') {
+                quoted = true;
+            } else if (c == '{' || c == '[') {
+                ++depth;
+            } else if (c == '}' || c == ']') {
+                if (depth == 0) {
+                    pushBack(c);
+                    return true;
+                }
+                --depth;
+            } else if (c == ',' && depth == 0) {
+                pushBack(c);
+                return true;
+            }
+            *element += c;
+        }
+        return fail(error, "The JSON array is not closed.");
+    }
+
+  private:
+    QTextStream &in;
+    QString      buffer;
+    int          position = 0;
+    bool         started  = false;
+    bool         finished = false;
+
+    QChar take() {
+        if (position >= buffer.size()) {
+            buffer   = in.read(64 * 1024);
+            position = 0;
+            if (buffer.isEmpty()) { return QChar(); }
+        }
+        return buffer.at(position++);
+    }
+
+    // Only ever the character just taken, which is still in the buffer
+    void pushBack(QChar) { --position; }
+
+    QChar skipSpace() {
+        QChar c = take();
+        while (!c.isNull() && c.isSpace()) { c = take(); }
+        return c;
+    }
+
+    bool fail(QString *error, const QString &message) {
+        finished = true;
+        if (error) { *error = message; }
+        return false;
+    }
+};
+
+static void readJsonObject(const QJsonObject &object, ProductRecord &record) {
+    auto value = [&object](const char *key) {
+        QVariant v = object.value(key).toVariant();
+        return v.isNull() ? QString() : v.toString().trimmed();
+    };
+    record.name          = value("Name");
+    record.category      = value("Category");
+    record.pricePerKg    = value("PricePerKg");
+    record.pricePerUnit  = value("PricePerUnit");
+    record.stockQuantity = value("StockQuantity");
+    record.barcode       = value("Barcode");
+    record.status        = value("status");
+}
+
+// Splits one CSV record into fields. Returns false if a quoted field is still
+// open at the end of the text, in which case the caller appends the next
+// physical line and tries again.
+static bool splitCsvRecord(const QString &text, QStringList &fields) {
+    fields.clear();
+    QString field;
+    bool    quoted = false;
+
+    for (int i = 0; i < text.size(); ++i) {
+        QChar c = text.at(i);
+        if (quoted) {
+            if (c == '"') {
+                if (i + 1 < text.size() && text.at(i + 1) == '"') {
+                    field += '"';
+                    ++i;
+                } else {
+                    quoted = false;
+                }
+            } else {
+                field += c;
+            }
+        } else if (c == '"') {
+            quoted = true;
+        } else if (c == ',') {
+            fields << field;
+            field.clear();
+        } else {
+            field += c;
+        }
+    }
+
+    if (quoted) { return false; }
+    fields << field;
+    return true;
+}
+
+static QString csvField(const QString &value) {
+    if (value.contains(',') || value.contains('"') || value.contains('\n')) {
+        QString escaped = value;
+        escaped.replace("\"", "\"\"");
+        return "\"" + escaped + "\"";
+    }
+    return value;
+}
+
+static QString upsertSql(int rows, bool withStatus) {
+    QStringList values;
+    values.reserve(rows);
+    for (int i = 0; i < rows; ++i) {
+        values << (withStatus ? "(?, ?, ?, ?, ?, ?, ?, ?)" : "(?, ?, ?, ?, ?, ?, ?)");
+    }
+
+    // Requires the unique key on products.Name (migrations/002_products_name_unique.sql)
+    return QString("INSERT INTO products (Name, Category, PricePerKg, PricePerUnit, "
+                   "StockQuantity, UnitType, Barcode%1) VALUES ")
+               .arg(withStatus ? ", status" : "") +
+           values.join(", ") +
+           " ON DUPLICATE KEY UPDATE Category = VALUES(Category), "
+           "PricePerKg = VALUES(PricePerKg), "
+           "PricePerUnit = VALUES(PricePerUnit), "
+           "StockQuantity = VALUES(StockQuantity), "
+           "UnitType = VALUES(UnitType), "
+           // Files without a Barcode column keep the codes already assigned,
+           // and rows without a status keep theirs
+           "Barcode = COALESCE(VALUES(Barcode), Barcode)" +
+           (withStatus ? ", status = VALUES(status)" : "");
+}
+
+ProductImporter::ProductImporter(QObject *parent) : QObject(parent) {}
+
+void ProductImporter::setBatchSize(int rows) { batchSize = qMax(1, rows); }
+
+void ProductImporter::cancel() { cancelled.storeRelaxed(1); }
+
+ProductImporter::Result ProductImporter::importFile(const QString &path,
+                                                    const QSqlDatabase &db) {
+    Result result;
+    cancelled.storeRelaxed(0);
+    pending.clear();
+    pending.reserve(batchSize);
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        result.error = "Cannot open " + path + ": " + file.errorString();
+        return result;
+    }
+
+    const qint64     totalBytes = file.size();
+    const FileFormat format     = formatOf(path);
+    QTextStream      in(&file);
+
+    // Column positions for CSV, looked up by header name
+    QHash<QString, int> columns;
+    int                 lineNumber = 0;
+
+    if (format == FileFormat::Csv) {
+        QStringList header;
+        if (in.atEnd() || !splitCsvRecord(in.readLine(), header)) {
+            result.error = "The file has no CSV header row.";
+            return result;
+        }
+        ++lineNumber;
+        for (int i = 0; i < header.size(); ++i) {
+            columns.insert(header.at(i).trimmed().toLower(), i);
+        }
+        if (!columns.contains("name") || !columns.contains("category")) {
+            result.error = "The CSV header must contain Name and Category "
+                           "columns.";
+            return result;
+        }
+    }
+
+    auto column = [&columns](const QStringList &fields, const char *name) {
+        int index = columns.value(name, -1);
+        return index >= 0 && index < fields.size() ? fields.at(index).trimmed()
+                                                   : QString();
+    };
+
+    auto reject = [&result](const QString &where, const QString &message) {
+        ++result.rejected;
+        if (result.rejections.size() < MaxReportedRejections) {
+            result.rejections << where + ": " + message;
+        }
+    };
+
+    JsonArrayReader array(in);
+    QStringList     fields;
+    QString         element;
+    int             elementNumber = 0;
+
+    while (!cancelled.loadRelaxed()) {
+        ProductRecord record;
+        QString       where;
+
+        if (format == FileFormat::JsonArray) {
+            QString error;
+            if (!array.next(&element, &error)) {
+                if (!error.isEmpty()) { result.error = error; }
+                break;
+            }
+            where = QString("record %1").arg(++elementNumber);
+
+            QJsonParseError parseError;
+            QJsonDocument   doc = QJsonDocument::fromJson(element.toUtf8(), &parseError);
+            if (!doc.isObject()) {
+                reject(where, parseError.error == QJsonParseError::NoError
+                                  ? "not a JSON object"
+                                  : parseError.errorString());
+                continue;
+            }
+            readJsonObject(doc.object(), record);
+        } else {
+            if (in.atEnd()) { break; }
+            QString line = in.readLine();
+            where        = QString("line %1").arg(++lineNumber);
+
+            if (line.trimmed().isEmpty()) { continue; }
+
+            if (format == FileFormat::JsonLines) {
+                QJsonParseError parseError;
+                QJsonDocument   doc = QJsonDocument::fromJson(line.toUtf8(), &parseError);
+                if (!doc.isObject()) {
+                    reject(where, parseError.error == QJsonParseError::NoError
+                                      ? "not a JSON object"
+                                      : parseError.errorString());
+                    continue;
+                }
+                readJsonObject(doc.object(), record);
+            } else {
+                // A quoted field may span several physical lines
+                while (!splitCsvRecord(line, fields) && !in.atEnd()) {
+                    line += '\n' + in.readLine();
+                    ++lineNumber;
+                }
+                record.name          = column(fields, "name");
+                record.category      = column(fields, "category");
+                record.pricePerKg    = column(fields, "priceperkg");
+                record.pricePerUnit  = column(fields, "priceperunit");
+                record.stockQuantity = column(fields, "stockquantity");
+                record.barcode       = column(fields, "barcode");
+                record.status        = column(fields, "status");
+            }
+        }
+
+        addRecord(record, where, result);
+
+        if (pending.size() >= batchSize) {
+            if (!flushBatch(db, result)) { break; }
+            emit progress(file.pos(), totalBytes, result.imported);
+        }
+    }
+
+    if (cancelled.loadRelaxed()) {
+        result.aborted = true;
+    } else if (result.error.isEmpty() && !pending.isEmpty()) {
+        flushBatch(db, result);
+    }
+
+    emit progress(file.pos(), totalBytes, result.imported);
+    pending.clear();
+    return result;
+}
+
+void ProductImporter::addRecord(const ProductRecord &record, const QString &where,
+                                Result &result) {
+    QString message;
+    if (record.validate(&message) != ProductRecord::NoField) {
+        ++result.rejected;
+        if (result.rejections.size() < MaxReportedRejections) {
+            result.rejections << where + ": " + message;
+        }
+        return;
+    }
+
+    pending.append(record);
+}
+
+bool ProductImporter::flushBatch(const QSqlDatabase &db, Result &result) {
+    // Rows that name a status set it; the others keep what the product has
+    QVector<const ProductRecord *> withStatus;
+    QVector<const ProductRecord *> withoutStatus;
+    for (const ProductRecord &record : pending) {
+        (record.status.trimmed().isEmpty() ? withoutStatus : withStatus) << &record;
+    }
+
+    QSqlDatabase connection = db;
+    connection.transaction();
+
+    QSqlQuery query(db);
+    bool      ok = true;
+    for (bool statusColumn : {false, true}) {
+        const QVector<const ProductRecord *> &records = statusColumn ? withStatus : withoutStatus;
+        if (records.isEmpty() || !ok) { continue; }
+
+        query.prepare(upsertSql(records.size(), statusColumn));
+        int position = 0;
+        for (const ProductRecord *record : records) {
+            query.bindValue(position++, record->name.trimmed());
+            query.bindValue(position++, record->category.trimmed());
+            query.bindValue(position++, record->pricePerKgValue());
+            query.bindValue(position++, record->pricePerUnitValue());
+            query.bindValue(position++, record->stockQuantity.trimmed().toDouble());
+            query.bindValue(position++, record->unitType());
+            query.bindValue(position++, record->barcodeValue());
+            if (statusColumn) { query.bindValue(position++, record->statusValue()); }
+        }
+        ok = query.exec();
+    }
+
+    if (!ok || !connection.commit()) {
+        result.error = query.lastError().isValid() ? query.lastError().text()
+                                                   : connection.lastError().text();
+        connection.rollback();
+        qDebug() << "Product import batch failed:" << result.error;
+        return false;
+    }
+
+    result.imported += pending.size();
+    pending.clear();
+    return true;
+}
+
+ProductExporter::ProductExporter(QObject *parent) : QObject(parent) {}
+
+void ProductExporter::cancel() { cancelled.storeRelaxed(1); }
+
+int ProductExporter::exportFile(const QString &path, QString *error, const QSqlDatabase &db) {
+    cancelled.storeRelaxed(0);
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text |
+                   QIODevice::Truncate)) {
+        if (error) { *error = "Cannot write " + path + ": " + file.errorString(); }
+        return -1;
+    }
+
+    QSqlQuery query(db);
+    query.setForwardOnly(true);
+    if (!query.exec("SELECT Name, Category, PricePerKg, PricePerUnit, "
+                    "StockQuantity, UnitType, status, Barcode FROM products "
+                    "ORDER BY ProductID")) {
+        if (error) { *error = query.lastError().text(); }
+        return -1;
+    }
+
+    const FileFormat format      = formatOf(path);
+    const int        columnCount = int(sizeof(ExportColumns) / sizeof(*ExportColumns));
+    QTextStream      out(&file);
+
+    if (format == FileFormat::Csv) {
+        QStringList header;
+        for (const char *name : ExportColumns) { header << name; }
+        out << header.join(',') << '\n';
+    } else if (format == FileFormat::JsonArray) {
+        out << "[\n";
+    }
+
+    int rows = 0;
+    while (query.next()) {
+        if (cancelled.loadRelaxed()) {
+            file.remove();
+            if (error) { *error = "The export was cancelled."; }
+            return -1;
+        }
+
+        if (format != FileFormat::Csv) {
+            QJsonObject object;
+            for (int i = 0; i < columnCount; ++i) {
+                QVariant value = query.value(i);
+                object.insert(ExportColumns[i],
+                              value.isNull() ? QJsonValue()
+                                             : QJsonValue::fromVariant(value));
+            }
+            // One object per line in both JSON formats
+            if (format == FileFormat::JsonArray && rows > 0) { out << ",\n"; }
+            out << QJsonDocument(object).toJson(QJsonDocument::Compact);
+            if (format == FileFormat::JsonLines) { out << '\n'; }
+        } else {
+            for (int i = 0; i < columnCount; ++i) {
+                if (i > 0) { out << ','; }
+                QVariant value = query.value(i);
+                if (!value.isNull()) { out << csvField(value.toString()); }
+            }
+            out << '\n';
+        }
+
+        if (++rows % 1000 == 0) { emit progress(rows); }
+    }
+
+    if (format == FileFormat::JsonArray) { out << (rows > 0 ? "\n]\n" : "]\n"); }
+
+    out.flush();
+    emit progress(rows);
+    return rows;
+}
@@ -0,0 +1,80 @@
+#ifndef PRODUCTTRANSFER_H
+#define PRODUCTTRANSFER_H
+
+#include <QAtomicInt>
+#include <QObject>
+#include <QSqlDatabase>
+#include <QStringList>
+#include <QVector>
+
+#include "ProductRecord.h"
+
+// Bulk import/export of the products table.
+//
+// Files are read and written one record at a time, so memory use does not
+// depend on the catalog size. Three formats are supported, chosen by the
+// file extension: CSV with a header row (.csv), JSON Lines with one object
+// per line (.jsonl, .ndjson), and a JSON array of objects (.json). Objects
+// use the same keys as the CSV header. Imported rows are validated with
+// ProductRecord::validate and upserted by Name in batches, each batch in
+// its own transaction. importFile may run on a worker thread given that
+// thread's connection; cancel() is safe to call from any thread.
+class ProductImporter : public QObject {
+    Q_OBJECT
+
+  public:
+    struct Result {
+        int         imported = 0; // rows inserted or updated
+        int         rejected = 0; // rows that failed validation
+        bool        aborted  = false;
+        QString     error;        // set when a batch failed to commit
+        QStringList rejections;   // "line N: ..." or "record N: ...", capped at 100
+    };
+
+    explicit ProductImporter(QObject *parent = nullptr);
+
+    void   setBatchSize(int rows);
+    Result importFile(const QString &path,
+                      const QSqlDatabase &db = QSqlDatabase::database());
+
+  public slots:
+    void cancel();
+
+  signals:
+    void progress(qint64 bytesRead, qint64 totalBytes, int rowsImported);
+
+  private:
+    int        batchSize = 500;
+    QAtomicInt cancelled;
+
+    void addRecord(const ProductRecord &record, const QString &where, Result &result);
+    bool flushBatch(const QSqlDatabase &db, Result &result);
+
+    QVector<ProductRecord> pending;
+};
+
+// Like importFile, exportFile may run on a worker thread given that
+// thread's connection; cancel() is safe to call from any thread.
+class ProductExporter : public QObject {
+    Q_OBJECT
+
+  public:
+    explicit ProductExporter(QObject *parent = nullptr);
+
+    // Streams the whole products table to path. Returns the number of rows
+    // written, or -1 on error or cancel with the reason in *error; a
+    // cancelled export removes the partial file.
+    int exportFile(const QString &path, QString *error = nullptr,
+                   const QSqlDatabase &db = QSqlDatabase::database());
+
+  public slots:
+    void cancel();
+
+  signals:
+    void progress(int rowsWritten);
+
+  private:
+    QAtomicInt cancelled;
+};
+
+#endif // PRODUCTTRANSFER_H
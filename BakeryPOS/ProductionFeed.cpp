@@ -0,0 +1,209 @@
+#include "ProductionFeed.h"
+
+#include "CheckoutService.h"
+#include "DomainEvents.h"
+
+#include <QCoreApplication>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QStringList>
+#include <QDebug>
+
+#include <algorithm>
+
+static QJsonObject jobJson(const ProductionJob &job) {
+    return QJsonObject{{"orderId", job.orderId},
+                       {"productId", job.productId},
+                       {"name", job.name},
+                       {"quantity", job.quantityMilli / 1000.0},
+                       {"orderedAt", job.orderedAt.toString(Qt::ISODateWithMs)}};
+}
+
+ProductionFeed::ProductionFeed(QObject *parent) : QObject(parent) {
+    DomainEvents *events = DomainEvents::instance();
+    connect(events, &DomainEvents::productChanged, this,
+            [this](DomainEvents::ChangeType, const QList<int> &ids) {
+                if (isRunning()) { loadPrepRules(ids); }
+            });
+    connect(events, &DomainEvents::catalogReloaded, this, [this]() {
+        if (isRunning()) { loadPrepRules(); }
+    });
+}
+
+ProductionFeed *ProductionFeed::instance() {
+    // Parented to the application so it is destroyed with it
+    static ProductionFeed *feed = new ProductionFeed(QCoreApplication::instance());
+    return feed;
+}
+
+bool ProductionFeed::start(const QString &serverName) {
+    if (server) { return true; }
+
+    // A register that crashed leaves its socket file behind on Unix
+    QLocalServer::removeServer(serverName);
+
+    server = new QLocalServer(this);
+    if (!server->listen(serverName)) {
+        qDebug() << "Production feed cannot listen on" << serverName << ":"
+                 << server->errorString();
+        delete server;
+        server = nullptr;
+        return false;
+    }
+    connect(server, &QLocalServer::newConnection, this, &ProductionFeed::onNewConnection);
+
+    loadPrepRules();
+    qDebug() << "Production feed on" << server->fullServerName() << "for"
+             << prepFromMilli.size() << "products";
+    return true;
+}
+
+void ProductionFeed::stop() {
+    for (QLocalSocket *socket : subscribers) {
+        socket->disconnect(this);
+        socket->disconnectFromServer();
+        socket->deleteLater();
+    }
+    subscribers.clear();
+    delete server;
+    server = nullptr;
+}
+
+void ProductionFeed::loadPrepRules(const QList<int> &productIds) {
+    QSqlQuery query;
+    query.setForwardOnly(true);
+
+    QString sql = "SELECT ProductID, Name, PrepFromQuantity FROM products "
+                  "WHERE PrepFromQuantity IS NOT NULL";
+    if (!productIds.isEmpty()) {
+        // Only the changed products; any of them may have lost the flag
+        QStringList placeholders;
+        for (int productId : productIds) {
+            placeholders << "?";
+            prepFromMilli.remove(productId);
+            nameForProduct.remove(productId);
+        }
+        sql += " AND ProductID IN (" + placeholders.join(", ") + ")";
+    } else {
+        prepFromMilli.clear();
+        nameForProduct.clear();
+    }
+
+    query.prepare(sql);
+    for (int i = 0; i < productIds.size(); ++i) { query.bindValue(i, productIds.at(i)); }
+    if (!query.exec()) {
+        qDebug() << "Production rules load failed:" << query.lastError().text();
+        return;
+    }
+
+    while (query.next()) {
+        int productId = query.value(0).toInt();
+        nameForProduct.insert(productId, query.value(1).toString());
+        prepFromMilli.insert(productId, quantityToMilli(query.value(2).toDouble()));
+    }
+}
+
+void ProductionFeed::publish(int orderId, const QVector<CheckoutLine> &lines) {
+    if (!server) { return; }
+
+    const QDateTime now = QDateTime::currentDateTime();
+    for (const CheckoutLine &line : lines) {
+        auto rule = prepFromMilli.constFind(line.productId);
+        if (rule == prepFromMilli.constEnd() || line.quantityMilli < rule.value()) { continue; }
+
+        ProductionJob job;
+        job.orderId       = orderId;
+        job.productId     = line.productId;
+        job.name          = nameForProduct.value(line.productId);
+        job.quantityMilli = line.quantityMilli;
+        job.orderedAt     = now;
+
+        // Nobody is working through a queue this long; the oldest go first
+        if (openJobs.size() >= MaxOpenJobs) { openJobs.removeFirst(); }
+        openJobs.append(job);
+
+        QJsonObject message = jobJson(job);
+        message.insert("type", "job");
+        broadcast(message);
+    }
+}
+
+void ProductionFeed::cancelOrder(int orderId) {
+    if (!server) { return; }
+
+    int before = openJobs.size();
+    openJobs.erase(std::remove_if(openJobs.begin(), openJobs.end(),
+                                  [orderId](const ProductionJob &job) {
+                                      return job.orderId == orderId;
+                                  }),
+                   openJobs.end());
+    if (openJobs.size() != before) {
+        broadcast(QJsonObject{{"type", "cancel"}, {"orderId", orderId}});
+    }
+}
+
+void ProductionFeed::finishJob(int orderId, int productId) {
+    for (int i = 0; i < openJobs.size(); ++i) {
+        if (openJobs.at(i).orderId == orderId && openJobs.at(i).productId == productId) {
+            openJobs.remove(i);
+            broadcast(QJsonObject{{"type", "done"}, {"orderId", orderId},
+                                  {"productId", productId}});
+            return;
+        }
+    }
+}
+
+void ProductionFeed::onNewConnection() {
+    while (QLocalSocket *socket = server->nextPendingConnection()) {
+        subscribers.append(socket);
+        connect(socket, &QLocalSocket::readyRead, this, &ProductionFeed::onReadyRead);
+        connect(socket, &QLocalSocket::disconnected, this, [this, socket]() {
+            subscribers.removeOne(socket);
+            socket->deleteLater();
+        });
+
+        // A new display starts from the jobs still open
+        QJsonArray jobs;
+        for (const ProductionJob &job : openJobs) { jobs.append(jobJson(job)); }
+        QJsonObject snapshot{{"type", "snapshot"}, {"jobs", jobs},
+                             {"sentAt", QDateTime::currentMSecsSinceEpoch()}};
+        send(socket, QJsonDocument(snapshot).toJson(QJsonDocument::Compact) + '\n');
+    }
+}
+
+void ProductionFeed::onReadyRead() {
+    QLocalSocket *socket = qobject_cast<QLocalSocket *>(sender());
+    if (!socket) { return; }
+
+    while (socket->canReadLine()) {
+        QJsonObject message = QJsonDocument::fromJson(socket->readLine()).object();
+        if (message.value("type").toString() == "done") {
+            finishJob(message.value("orderId").toInt(), message.value("productId").toInt());
+        }
+    }
+}
+
+void ProductionFeed::broadcast(QJsonObject message) {
+    message.insert("sentAt", QDateTime::currentMSecsSinceEpoch());
+
+    // Serialised once; every socket queues the same bytes
+    const QByteArray line = QJsonDocument(message).toJson(QJsonDocument::Compact) + '\n';
+    const QList<QLocalSocket *> sockets = subscribers;
+    for (QLocalSocket *socket : sockets) { send(socket, line); }
+}
+
+void ProductionFeed::send(QLocalSocket *socket, const QByteArray &line) {
+    if (socket->bytesToWrite() > MaxBacklogBytes) {
+        qDebug() << "Dropping a production display that stopped reading";
+        subscribers.removeOne(socket);
+        socket->abort();
+        socket->deleteLater();
+        return;
+    }
+    socket->write(line);
+}
@@ -0,0 +1,81 @@
+#ifndef PRODUCTIONFEED_H
+#define PRODUCTIONFEED_H
+
+#include <QDateTime>
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QVector>
+
+class QJsonObject;
+class QLocalServer;
+class QLocalSocket;
+struct CheckoutLine;
+
+// One sold line waiting to be prepared
+struct ProductionJob {
+    int       orderId   = 0;
+    int       productId = 0;
+    QString   name;
+    qint64    quantityMilli = 0;
+    QDateTime orderedAt;
+};
+
+// Pushes sold lines that need preparing to production displays.
+//
+// Displays are separate processes connected to a local socket (named pipe
+// on Windows). Each message is one line of compact JSON:
+//
+//   {"type": "snapshot", "jobs": [...]}    on connect, the open jobs
+//   {"type": "job", ...}                   a line was sold
+//   {"type": "done", "orderId", "productId"}
+//   {"type": "cancel", "orderId"}          the order was voided
+//
+// and every message carries "sentAt" (ms since the epoch) so a display can
+// tell how late it is. A display marks a job finished by sending back
+// {"type": "done", "orderId": n, "productId": n}; every display sees it.
+//
+// A message is serialised once and the same bytes are queued on every
+// subscriber, so fan-out costs a write per socket. A display that stops
+// reading is dropped once too much is queued for it, rather than holding
+// memory for the others. Which products need preparing comes from
+// products.PrepFromQuantity, kept in step through DomainEvents. Each
+// register publishes its own sales.
+class ProductionFeed : public QObject {
+    Q_OBJECT
+
+  public:
+    static ProductionFeed *instance();
+
+    bool start(const QString &serverName);
+    void stop();
+    bool isRunning() const { return server != nullptr; }
+    int  subscriberCount() const { return subscribers.size(); }
+
+    // After an order is committed; does nothing unless started
+    void publish(int orderId, const QVector<CheckoutLine> &lines);
+    void cancelOrder(int orderId);
+
+  private slots:
+    void onNewConnection();
+    void onReadyRead();
+
+  private:
+    explicit ProductionFeed(QObject *parent = nullptr);
+
+    static constexpr int    MaxOpenJobs     = 500;
+    static constexpr qint64 MaxBacklogBytes = 1024 * 1024;
+
+    QLocalServer          *server = nullptr;
+    QList<QLocalSocket *>  subscribers;
+    QVector<ProductionJob> openJobs; // oldest first
+    QHash<int, QString>    nameForProduct;
+    QHash<int, qint64>     prepFromMilli; // products that go to the displays
+
+    void loadPrepRules(const QList<int> &productIds = {});
+    void broadcast(QJsonObject message);
+    void send(QLocalSocket *socket, const QByteArray &line);
+    void finishJob(int orderId, int productId);
+};
+
+#endif // PRODUCTIONFEED_H
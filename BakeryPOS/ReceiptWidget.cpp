@@ -0,0 +1,178 @@
+#include "ReceiptWidget.h"
+
+#include <QFrame>
+#include <QGridLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QPainter>
+#include <QPointer>
+#include <QPrintDialog>
+#include <QPrinter>
+#include <QPushButton>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QTableWidget>
+#include <QVBoxLayout>
+#include <QDebug>
+
+Receipt Receipt::load(int orderId, const QSqlDatabase &db) {
+    Receipt receipt;
+
+    QSqlQuery query(db);
+    query.prepare("SELECT o.OrderDate, o.UserID, u.username, o.payment_method, o.TotalAmount "
+                  "FROM Orders o LEFT JOIN users u ON u.UserID = o.UserID "
+                  "WHERE o.OrderID = ?");
+    query.bindValue(0, orderId);
+    if (!query.exec() || !query.next()) {
+        qDebug() << "Receipt for order" << orderId << "not found:" << query.lastError().text();
+        return receipt;
+    }
+
+    receipt.orderId       = orderId;
+    receipt.date          = query.value(0).toDateTime();
+    receipt.cashier       = query.value(2).toString();
+    receipt.paymentMethod = query.value(3).toString();
+    receipt.total         = Money::fromVariant(query.value(4));
+    if (receipt.cashier.isEmpty()) { receipt.cashier = "User #" + query.value(1).toString(); }
+
+    query.prepare("SELECT p.Name, od.ProductID, od.Quantity, od.Price, od.Discount, pr.Name "
+                  "FROM OrderDetails od LEFT JOIN products p ON p.ProductID = od.ProductID "
+                  "LEFT JOIN promotions pr ON pr.PromotionID = od.PromotionID "
+                  "WHERE od.OrderID = ?");
+    query.bindValue(0, orderId);
+    if (!query.exec()) {
+        qDebug() << "Receipt lines for order" << orderId << "failed:" << query.lastError().text();
+        return receipt;
+    }
+
+    while (query.next()) {
+        ReceiptLine line;
+        line.name = query.value(0).toString();
+        if (line.name.isEmpty()) { line.name = "Product #" + query.value(1).toString(); }
+        line.quantityMilli = quantityToMilli(query.value(2).toDouble());
+        line.unitPrice     = Money::fromVariant(query.value(3));
+        line.discount      = Money::fromVariant(query.value(4));
+        line.promotion     = query.value(5).toString();
+        line.total         = line.unitPrice.times(line.quantityMilli) - line.discount;
+        receipt.discounts += line.discount;
+        receipt.subtotal += line.total;
+        receipt.lines.append(line);
+    }
+    receipt.tax = receipt.total - receipt.subtotal;
+    return receipt;
+}
+
+ReceiptWidget::ReceiptWidget(QWidget *parent) : QWidget(parent) {
+    setMinimumWidth(400);
+
+    body                    = new QWidget(this);
+    QVBoxLayout *bodyLayout = new QVBoxLayout(body);
+    bodyLayout->setContentsMargins(0, 0, 0, 0);
+
+    // Header
+    QLabel *header = new QLabel("BakeryPOS Receipt", body);
+    header->setAlignment(Qt::AlignCenter);
+    QFont headerFont = header->font();
+    headerFont.setPointSize(16);
+    headerFont.setBold(true);
+    header->setFont(headerFont);
+    bodyLayout->addWidget(header);
+
+    // Order info
+    orderLabel   = new QLabel(body);
+    dateLabel    = new QLabel(body);
+    cashierLabel = new QLabel(body);
+    paymentLabel = new QLabel(body);
+    bodyLayout->addWidget(orderLabel);
+    bodyLayout->addWidget(dateLabel);
+    bodyLayout->addWidget(cashierLabel);
+    bodyLayout->addWidget(paymentLabel);
+
+    QFrame *line = new QFrame(body);
+    line->setFrameShape(QFrame::HLine);
+    line->setFrameShadow(QFrame::Sunken);
+    bodyLayout->addWidget(line);
+
+    items = new QTableWidget(body);
+    items->setColumnCount(4);
+    items->setHorizontalHeaderLabels({"Item", "Qty", "Price", "Total"});
+    items->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    items->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    bodyLayout->addWidget(items);
+
+    QGridLayout *totals = new QGridLayout();
+    discountLabel       = new QLabel(body);
+    subtotalLabel       = new QLabel(body);
+    taxLabel            = new QLabel(body);
+    totalLabel          = new QLabel(body);
+    totals->addWidget(new QLabel("Discounts:", body), 0, 0, Qt::AlignRight);
+    totals->addWidget(discountLabel, 0, 1, Qt::AlignRight);
+    totals->addWidget(new QLabel("Subtotal:", body), 1, 0, Qt::AlignRight);
+    totals->addWidget(subtotalLabel, 1, 1, Qt::AlignRight);
+    totals->addWidget(new QLabel("Tax:", body), 2, 0, Qt::AlignRight);
+    totals->addWidget(taxLabel, 2, 1, Qt::AlignRight);
+    totals->addWidget(new QLabel("Total:", body), 3, 0, Qt::AlignRight);
+    totals->addWidget(totalLabel, 3, 1, Qt::AlignRight);
+    bodyLayout->addLayout(totals);
+
+    QPushButton *printButton = new QPushButton("Print", this);
+    connect(printButton, &QPushButton::clicked, this, &ReceiptWidget::print);
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->addWidget(body);
+    layout->addWidget(printButton);
+}
+
+ReceiptWidget::~ReceiptWidget() { delete printer; }
+
+void ReceiptWidget::setReceipt(const Receipt &receipt) {
+    setWindowTitle("Invoice #" + QString::number(receipt.orderId));
+
+    orderLabel->setText("Order #: " + QString::number(receipt.orderId));
+    dateLabel->setText("Date: " + receipt.date.toString("yyyy-MM-dd hh:mm:ss"));
+    cashierLabel->setText("Cashier: " + receipt.cashier);
+    paymentLabel->setText("Payment: " + receipt.paymentMethod);
+
+    items->setRowCount(receipt.lines.size());
+    for (int row = 0; row < receipt.lines.size(); ++row) {
+        const ReceiptLine &line = receipt.lines.at(row);
+        QString name = line.name;
+        if (!line.discount.isZero()) {
+            name += QString(" (%1 -%2)")
+                        .arg(line.promotion.isEmpty() ? "Discount" : line.promotion,
+                             line.discount.toString());
+        }
+        items->setItem(row, 0, new QTableWidgetItem(name));
+        items->setItem(row, 1, new QTableWidgetItem(QString::number(line.quantityMilli / 1000.0)));
+        items->setItem(row, 2, new QTableWidgetItem(line.unitPrice.toString()));
+        items->setItem(row, 3, new QTableWidgetItem(line.total.toString()));
+    }
+
+    discountLabel->setText(receipt.discounts.toString());
+    subtotalLabel->setText(receipt.subtotal.toString());
+    taxLabel->setText(receipt.tax.toString());
+    totalLabel->setText(receipt.total.toString());
+}
+
+ReceiptWidget *ReceiptWidget::preview(const Receipt &receipt) {
+    static QPointer<ReceiptWidget> window;
+    if (!window) {
+        window = new ReceiptWidget(nullptr);
+        window->setAttribute(Qt::WA_DeleteOnClose);
+    }
+    window->setReceipt(receipt);
+    window->show();
+    window->raise();
+    window->activateWindow();
+    return window;
+}
+
+void ReceiptWidget::print() {
+    if (!printer) { printer = new QPrinter(QPrinter::HighResolution); }
+
+    QPrintDialog printDialog(printer, this);
+    if (printDialog.exec() == QDialog::Accepted) {
+        QPainter painter(printer);
+        body->render(&painter);
+    }
+}
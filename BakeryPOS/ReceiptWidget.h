@@ -0,0 +1,75 @@
+#ifndef RECEIPTWIDGET_H
+#define RECEIPTWIDGET_H
+
+#include <QDateTime>
+#include <QSqlDatabase>
+#include <QString>
+#include <QVector>
+#include <QWidget>
+
+#include "Money.h"
+
+class QLabel;
+class QPrinter;
+class QTableWidget;
+
+struct ReceiptLine {
+    QString name;
+    qint64  quantityMilli = 0;
+    Money   unitPrice;
+    Money   discount;
+    QString promotion; // name of the promotion behind the discount
+    Money   total;     // after discount
+};
+
+// A stored order as printed on its receipt
+struct Receipt {
+    int       orderId = -1;
+    QDateTime date;
+    QString   cashier;
+    QString   paymentMethod;
+
+    QVector<ReceiptLine> lines;
+    Money                discounts;
+    Money                subtotal;
+    Money                tax; // what was paid on top of the lines
+    Money                total;
+
+    bool isValid() const { return orderId >= 0; }
+
+    // Reads an order and its lines back; invalid if it does not exist
+    static Receipt load(int orderId, const QSqlDatabase &db = QSqlDatabase::database());
+};
+
+// Renders a receipt; used at checkout and to reprint past orders
+class ReceiptWidget : public QWidget {
+    Q_OBJECT
+
+  public:
+    explicit ReceiptWidget(QWidget *parent = nullptr);
+    ~ReceiptWidget();
+
+    void setReceipt(const Receipt &receipt);
+
+    // Shows receipt in the one preview window shared by the till and the
+    // order history, creating it if it was closed. Closing frees it.
+    static ReceiptWidget *preview(const Receipt &receipt);
+
+  public slots:
+    void print();
+
+  private:
+    QWidget      *body = nullptr; // everything except the Print button
+    QLabel       *orderLabel = nullptr;
+    QLabel       *dateLabel = nullptr;
+    QLabel       *cashierLabel = nullptr;
+    QLabel       *paymentLabel = nullptr;
+    QTableWidget *items = nullptr;
+    QLabel       *discountLabel = nullptr;
+    QLabel       *subtotalLabel = nullptr;
+    QLabel       *taxLabel = nullptr;
+    QLabel       *totalLabel = nullptr;
+    QPrinter     *printer = nullptr;
+};
+
+#endif // RECEIPTWIDGET_H
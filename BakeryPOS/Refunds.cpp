@@ -0,0 +1,241 @@
+#include "Refunds.h"
+
+#include "CatalogFeed.h"
+#include "DomainEvents.h"
+#include "ProductionFeed.h"
+#include "RolePages.h"
+#include "SalesHistory.h"
+
+#include <QHash>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QStringList>
+#include <QDebug>
+
+#include <stdexcept>
+
+static QString quantityText(qint64 quantityMilli) {
+    return QString::number(quantityMilli / 1000.0, 'f', 3);
+}
+
+// Sold and already refunded quantities per product of orderId
+static QVector<RefundableLine> loadLines(QSqlQuery &query, int orderId) {
+    QVector<RefundableLine> lines;
+    QHash<int, int>         indexForProduct;
+
+    query.prepare("SELECT od.ProductID, p.Name, MAX(od.Price), SUM(od.Quantity), "
+                  "SUM(od.Discount) "
+                  "FROM OrderDetails od "
+                  "LEFT JOIN products p ON p.ProductID = od.ProductID "
+                  "WHERE od.OrderID = ? "
+                  "GROUP BY od.ProductID, p.Name");
+    query.bindValue(0, orderId);
+    if (!query.exec()) { throw std::runtime_error(query.lastError().text().toStdString()); }
+
+    while (query.next()) {
+        RefundableLine line;
+        line.productId = query.value(0).toInt();
+        line.name      = query.value(1).toString();
+        if (line.name.isEmpty()) { line.name = "Product #" + QString::number(line.productId); }
+        line.unitPrice = Money::fromVariant(query.value(2));
+        line.soldMilli = quantityToMilli(query.value(3).toDouble());
+        line.discount  = Money::fromVariant(query.value(4));
+        indexForProduct.insert(line.productId, lines.size());
+        lines.append(line);
+    }
+
+    // Refund lines are negative
+    query.prepare("SELECT r.ProductID, -SUM(r.Quantity), -SUM(r.Discount) "
+                  "FROM Orders ro JOIN OrderDetails r ON r.OrderID = ro.OrderID "
+                  "WHERE ro.RefundOf = ? "
+                  "GROUP BY r.ProductID");
+    query.bindValue(0, orderId);
+    if (!query.exec()) { throw std::runtime_error(query.lastError().text().toStdString()); }
+
+    while (query.next()) {
+        int index = indexForProduct.value(query.value(0).toInt(), -1);
+        if (index < 0) { continue; }
+        lines[index].refundedMilli    = quantityToMilli(query.value(1).toDouble());
+        lines[index].refundedDiscount = Money::fromVariant(query.value(2));
+    }
+    return lines;
+}
+
+QVector<RefundableLine> Refunds::refundable(int orderId, QString *error) {
+    try {
+        QSqlQuery query;
+        return loadLines(query, orderId);
+    } catch (const std::exception &e) {
+        if (error) { *error = e.what(); }
+        return {};
+    }
+}
+
+int Refunds::refund(int orderId, const QVector<RefundLine> &lines, int userId,
+                    QString *error) {
+    QSqlDatabase db = QSqlDatabase::database();
+    db.transaction();
+
+    try {
+        QSqlQuery query;
+
+        // Checked against the users table, not the register's cached roles
+        query.prepare("SELECT role, status FROM users WHERE UserID = ?");
+        query.bindValue(0, userId);
+        if (!query.exec()) { throw std::runtime_error(query.lastError().text().toStdString()); }
+        if (!query.next() || query.value(1).toString() != "Active" ||
+            !RolePages::canRefund(query.value(0).toString())) {
+            throw std::runtime_error("Refunds must be authorised by a manager.");
+        }
+
+        // Locks the original so two registers cannot refund the same items
+        query.prepare("SELECT TotalAmount, payment_method, RefundOf FROM Orders "
+                      "WHERE OrderID = ? FOR UPDATE");
+        query.bindValue(0, orderId);
+        if (!query.exec()) { throw std::runtime_error(query.lastError().text().toStdString()); }
+        if (!query.next()) { throw std::runtime_error("The order does not exist."); }
+
+        Money   originalTotal = Money::fromVariant(query.value(0));
+        QString payment       = query.value(1).toString();
+        if (!query.value(2).isNull() || originalTotal < Money()) {
+            throw std::runtime_error("A refund cannot be refunded.");
+        }
+
+        QVector<RefundableLine> available = loadLines(query, orderId);
+        QHash<int, int>         indexForProduct;
+        for (int i = 0; i < available.size(); ++i) {
+            indexForProduct.insert(available.at(i).productId, i);
+        }
+
+        // Requested quantities per product, checked against what is left
+        QHash<int, qint64> requested;
+        QList<int>         productIds;
+        for (const RefundLine &line : lines) {
+            if (line.quantityMilli <= 0) { continue; }
+            if (!indexForProduct.contains(line.productId)) {
+                throw std::runtime_error("A product is not part of this order.");
+            }
+            if (!requested.contains(line.productId)) { productIds << line.productId; }
+            requested[line.productId] += line.quantityMilli;
+        }
+        if (productIds.isEmpty()) { throw std::runtime_error("Nothing to refund."); }
+
+        Money             net;
+        Money             orderNet;
+        QHash<int, Money> refundDiscount;
+        bool              refundsEverything = true;
+        for (const RefundableLine &line : available) {
+            orderNet += line.unitPrice.times(line.soldMilli) - line.discount;
+            qint64 quantity = requested.value(line.productId);
+            if (quantity > line.remainingMilli()) {
+                throw std::runtime_error(
+                    QString("Only %1 of %2 can still be refunded.")
+                        .arg(quantityText(line.remainingMilli()), line.name)
+                        .toStdString());
+            }
+            if (quantity > 0) { refundDiscount.insert(line.productId, line.discountFor(quantity)); }
+            net += line.unitPrice.times(quantity) - refundDiscount.value(line.productId);
+            if (quantity < line.remainingMilli()) { refundsEverything = false; }
+        }
+
+        // Tax comes back at the order's own rate, which mixes the category
+        // rates it was sold at. The last refund takes back exactly what was
+        // paid, so the refunds of an order never add up to a cent more or
+        // less than its total.
+        Money total = net + SalesTax::taxOn(net);
+        if (!orderNet.isZero()) {
+            Money orderTax = originalTotal - orderNet;
+            total = net + Money::fromCents((orderTax.cents() * net.cents() + orderNet.cents() / 2) /
+                                           orderNet.cents());
+        }
+        if (refundsEverything) {
+            query.prepare("SELECT COALESCE(SUM(TotalAmount), 0) FROM Orders WHERE RefundOf = ?");
+            query.bindValue(0, orderId);
+            if (!query.exec() || !query.next()) {
+                throw std::runtime_error(query.lastError().text().toStdString());
+            }
+            total = originalTotal + Money::fromVariant(query.value(0));
+        }
+        Money tax = total - net;
+
+        query.prepare("INSERT INTO Orders (OrderDate, UserID, TotalAmount, payment_method, RefundOf) "
+                      "VALUES (NOW(), ?, ?, ?, ?)");
+        query.bindValue(0, userId);
+        query.bindValue(1, (-total).toDecimalString());
+        query.bindValue(2, payment);
+        query.bindValue(3, orderId);
+        if (!query.exec()) { throw std::runtime_error(query.lastError().text().toStdString()); }
+
+        int refundId = query.lastInsertId().toInt();
+
+        // All lines in one INSERT and all stock in one UPDATE
+        QStringList rows;
+        QStringList cases;
+        QStringList ids;
+        for (int i = 0; i < productIds.size(); ++i) {
+            rows << "(?, ?, ?, ?, ?)";
+            cases << "WHEN ? THEN ?";
+            ids << "?";
+        }
+
+        query.prepare("INSERT INTO OrderDetails (OrderID, ProductID, Quantity, Price, Discount) "
+                      "VALUES " + rows.join(", "));
+        int position = 0;
+        for (int productId : productIds) {
+            query.bindValue(position++, refundId);
+            query.bindValue(position++, productId);
+            query.bindValue(position++, quantityText(-requested.value(productId)));
+            query.bindValue(position++,
+                            available.at(indexForProduct.value(productId)).unitPrice.toDecimalString());
+            query.bindValue(position++, (-refundDiscount.value(productId)).toDecimalString());
+        }
+        if (!query.exec()) { throw std::runtime_error(query.lastError().text().toStdString()); }
+
+        query.prepare("UPDATE products SET StockQuantity = StockQuantity + CASE ProductID " +
+                      cases.join(" ") + " END WHERE ProductID IN (" + ids.join(", ") + ")");
+        position = 0;
+        for (int productId : productIds) {
+            query.bindValue(position++, productId);
+            query.bindValue(position++, quantityText(requested.value(productId)));
+        }
+        for (int productId : productIds) { query.bindValue(position++, productId); }
+        if (!query.exec()) { throw std::runtime_error(query.lastError().text().toStdString()); }
+
+        // Not a new order, but its money comes off the hour it was refunded in
+        if (!SalesHistory::recordOrder(query, refundId, 0, -net, -tax)) {
+            throw std::runtime_error(query.lastError().text().toStdString());
+        }
+
+        if (!db.commit()) { throw std::runtime_error(db.lastError().text().toStdString()); }
+
+        // Stock went up: tell this process directly and the others through the feed
+        CatalogFeed::record(CatalogFeed::Product, CatalogFeed::Stock, productIds);
+        DomainEvents::instance()->publishProductChange(DomainEvents::Updated, productIds);
+
+        // Nothing left of the order to prepare
+        if (refundsEverything) { ProductionFeed::instance()->cancelOrder(orderId); }
+
+        qDebug() << "Refund" << refundId << "of order" << orderId << ":" << total.toString();
+        return refundId;
+    } catch (const std::exception &e) {
+        db.rollback();
+        if (error) { *error = e.what(); }
+        qDebug() << "Refund of order" << orderId << "failed:" << e.what();
+        return -1;
+    }
+}
+
+int Refunds::voidOrder(int orderId, int userId, QString *error) {
+    QVector<RefundableLine> available = refundable(orderId, error);
+
+    QVector<RefundLine> lines;
+    for (const RefundableLine &line : available) {
+        if (line.remainingMilli() > 0) { lines.append({line.productId, line.remainingMilli()}); }
+    }
+    if (lines.isEmpty()) {
+        if (error && error->isEmpty()) { *error = "The order has already been refunded."; }
+        return -1;
+    }
+    return refund(orderId, lines, userId, error);
+}
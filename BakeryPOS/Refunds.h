@@ -0,0 +1,57 @@
+#ifndef REFUNDS_H
+#define REFUNDS_H
+
+#include <QString>
+#include <QVector>
+
+#include "Money.h"
+
+// One product of an order and how much of it can still be returned
+struct RefundableLine {
+    int     productId = 0;
+    QString name;
+    Money   unitPrice;
+    qint64  soldMilli     = 0;
+    qint64  refundedMilli = 0;
+    Money   discount;         // promotion discount on everything sold
+    Money   refundedDiscount; // of which already given back
+
+    qint64 remainingMilli() const { return soldMilli - refundedMilli; }
+
+    // The discount share of quantityMilli; the last of it takes the rest
+    Money discountFor(qint64 quantityMilli) const {
+        if (quantityMilli >= remainingMilli()) { return discount - refundedDiscount; }
+        if (soldMilli <= 0) { return Money(); }
+        return Money::fromCents((discount.cents() * quantityMilli + soldMilli / 2) / soldMilli);
+    }
+};
+
+struct RefundLine {
+    int    productId     = 0;
+    qint64 quantityMilli = 0;
+};
+
+// Refunds and voids of stored orders.
+//
+// A refund is an order of its own (Orders.RefundOf points at the original)
+// with negative lines at the original prices (less their share of any
+// promotion discount) and a negative total. In the
+// same transaction the stock of every returned product is put back with one
+// UPDATE and the refund is taken off the hourly sales rollup, so inventory,
+// the analytics page and the Z-report agree without editing products by
+// hand or recomputing anything.
+class Refunds {
+  public:
+    // What each product of orderId can still be refunded
+    static QVector<RefundableLine> refundable(int orderId, QString *error = nullptr);
+
+    // Returns the refund's OrderID, or -1 and the reason in error. userId
+    // is who authorised it and must be an active manager or admin.
+    static int refund(int orderId, const QVector<RefundLine> &lines, int userId,
+                      QString *error = nullptr);
+
+    // Refunds everything not refunded yet
+    static int voidOrder(int orderId, int userId, QString *error = nullptr);
+};
+
+#endif // REFUNDS_H
@@ -0,0 +1,30 @@
+#include "RolePages.h"
+
+#include <QHash>
+
+QList<RolePages::Page> RolePages::pagesFor(const QString &role) {
+    // Roles as offered in EditUserForm and the user page's role filter
+    static const QHash<QString, QList<Page>> manifest = {
+        {"admin", {Products, Users, Categories, Analytics, Orders, Invoice}},
+        {"manager", {Products, Categories, Analytics, Orders, Invoice}},
+        {"cashier", {Invoice, Orders}},
+        // Looks after stock and the catalog; does not sell
+        {"inventory manager", {Products, Categories, Orders}},
+    };
+
+    // An unknown role can still sell
+    return manifest.value(role.trimmed().toLower(), {Invoice});
+}
+
+bool RolePages::canOpen(const QString &role, Page page) {
+    return pagesFor(role).contains(page);
+}
+
+RolePages::Page RolePages::landingPage(const QString &role) {
+    return pagesFor(role).constFirst();
+}
+
+bool RolePages::canRefund(const QString &role) {
+    QString key = role.trimmed().toLower();
+    return key == "admin" || key == "manager";
+}
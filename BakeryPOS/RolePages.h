@@ -0,0 +1,25 @@
+#ifndef ROLEPAGES_H
+#define ROLEPAGES_H
+
+#include <QList>
+#include <QString>
+
+// Which dashboard pages each user role can open.
+//
+// The dashboard shows a sidebar button only for these pages and builds and
+// loads a page the first time it is opened, so a cashier's register never
+// reads the user or category tables. The first page listed is the one a
+// role lands on after login or a user switch.
+class RolePages {
+  public:
+    enum Page { Products, Users, Categories, Analytics, Orders, Invoice };
+
+    static QList<Page> pagesFor(const QString &role);
+    static bool        canOpen(const QString &role, Page page);
+    static Page        landingPage(const QString &role);
+
+    // Refunds and voids need a manager or an admin (see Refunds::refund)
+    static bool canRefund(const QString &role);
+};
+
+#endif // ROLEPAGES_H
@@ -0,0 +1,130 @@
+#include "SalesChart.h"
+
+#include <QMouseEvent>
+#include <QPainter>
+#include <QPainterPath>
+#include <QToolTip>
+
+#include <algorithm>
+
+SalesChart::SalesChart(QWidget *parent) : QWidget(parent) {
+    setMouseTracking(true);
+    setMinimumHeight(180);
+}
+
+void SalesChart::setSeries(const SalesSeries &currentSeries,
+                           SalesHistory::Bucket seriesBucket,
+                           const SalesSeries &priorSeries) {
+    current = currentSeries;
+    prior   = priorSeries;
+    bucket  = seriesBucket;
+    update();
+}
+
+QRect SalesChart::plotArea() const {
+    // Room for the axis labels
+    return rect().adjusted(60, 10, -10, -25);
+}
+
+QString SalesChart::bucketLabel(const QDateTime &start) const {
+    switch (bucket) {
+    case SalesHistory::Hour: return start.toString("MM-dd hh:00");
+    case SalesHistory::Day: return start.toString("yyyy-MM-dd");
+    case SalesHistory::Week: return "Week of " + start.toString("yyyy-MM-dd");
+    }
+    return start.toString();
+}
+
+void SalesChart::paintEvent(QPaintEvent *) {
+    QPainter painter(this);
+    painter.fillRect(rect(), Qt::white);
+
+    const QRect area = plotArea();
+    const int   count = current.points.size();
+    if (count == 0 || area.width() <= 0 || area.height() <= 0) {
+        painter.setPen(QColor("#7f8c8d"));
+        painter.drawText(rect(), Qt::AlignCenter, "No sales in this range");
+        return;
+    }
+
+    qint64 maxCents = 1;
+    for (const SalesPoint &point : current.points) {
+        maxCents = std::max(maxCents, point.gross().cents());
+    }
+    for (const SalesPoint &point : prior.points) {
+        maxCents = std::max(maxCents, point.gross().cents());
+    }
+
+    auto yFor = [&](qint64 cents) {
+        return area.bottom() - int(double(cents) / maxCents * area.height());
+    };
+
+    // Axes and the top value
+    painter.setPen(QColor("#bdc3c7"));
+    painter.drawLine(area.bottomLeft(), area.bottomRight());
+    painter.drawLine(area.bottomLeft(), area.topLeft());
+    painter.setPen(QColor("#2c3e50"));
+    painter.drawText(QRect(0, area.top() - 6, area.left() - 6, 14),
+                     Qt::AlignRight | Qt::AlignVCenter,
+                     Money::fromCents(maxCents).toString());
+    painter.drawText(QRect(0, area.bottom() - 7, area.left() - 6, 14),
+                     Qt::AlignRight | Qt::AlignVCenter, "$0");
+
+    // Bars for the selected range
+    const double slot = double(area.width()) / count;
+    const int    gap  = slot > 4 ? 1 : 0;
+    for (int i = 0; i < count; ++i) {
+        qint64 cents = current.points.at(i).gross().cents();
+        if (cents <= 0) { continue; }
+        int x = area.left() + int(i * slot);
+        int w = std::max(1, int((i + 1) * slot) - int(i * slot) - gap);
+        int y = yFor(cents);
+        painter.fillRect(QRect(x, y, w, area.bottom() - y), QColor("#27ae60"));
+    }
+
+    // Prior period as a line over the same slots
+    if (!prior.points.isEmpty()) {
+        QPainterPath path;
+        int          points = std::min(count, int(prior.points.size()));
+        for (int i = 0; i < points; ++i) {
+            QPointF p(area.left() + (i + 0.5) * slot,
+                      yFor(prior.points.at(i).gross().cents()));
+            if (i == 0) {
+                path.moveTo(p);
+            } else {
+                path.lineTo(p);
+            }
+        }
+        painter.setRenderHint(QPainter::Antialiasing);
+        painter.setPen(QPen(QColor("#e67e22"), 2));
+        painter.drawPath(path);
+    }
+
+    // First and last bucket under the axis
+    painter.setPen(QColor("#2c3e50"));
+    QRect labels(area.left(), area.bottom() + 4, area.width(), 18);
+    painter.drawText(labels, Qt::AlignLeft, bucketLabel(current.points.first().start));
+    painter.drawText(labels, Qt::AlignRight, bucketLabel(current.points.last().start));
+}
+
+void SalesChart::mouseMoveEvent(QMouseEvent *event) {
+    const QRect area = plotArea();
+    const int   count = current.points.size();
+    if (count == 0 || !area.contains(event->position().toPoint())) {
+        QToolTip::hideText();
+        return;
+    }
+
+    int i = std::clamp(int((event->position().x() - area.left()) * count / area.width()), 0,
+                       count - 1);
+    const SalesPoint &point = current.points.at(i);
+
+    QString text = QString("%1\nOrders: %2\nSales: %3")
+                       .arg(bucketLabel(point.start))
+                       .arg(point.orders)
+                       .arg(point.gross().toString());
+    if (i < prior.points.size()) {
+        text += "\nPrior: " + prior.points.at(i).gross().toString();
+    }
+    QToolTip::showText(event->globalPosition().toPoint(), text, this);
+}
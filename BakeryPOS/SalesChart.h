@@ -0,0 +1,34 @@
+#ifndef SALESCHART_H
+#define SALESCHART_H
+
+#include <QWidget>
+
+#include "SalesHistory.h"
+
+// Bar chart of a sales series with an optional prior-period line.
+// Painted directly; no chart module needed.
+class SalesChart : public QWidget {
+    Q_OBJECT
+
+  public:
+    explicit SalesChart(QWidget *parent = nullptr);
+
+    void setSeries(const SalesSeries &current, SalesHistory::Bucket bucket,
+                   const SalesSeries &prior = SalesSeries());
+
+    QSize sizeHint() const override { return QSize(600, 220); }
+
+  protected:
+    void paintEvent(QPaintEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+
+  private:
+    SalesSeries          current;
+    SalesSeries          prior;
+    SalesHistory::Bucket bucket = SalesHistory::Day;
+
+    QRect   plotArea() const;
+    QString bucketLabel(const QDateTime &start) const;
+};
+
+#endif // SALESCHART_H
@@ -0,0 +1,147 @@
+#include "SalesHistory.h"
+
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QDebug>
+
+#include <algorithm>
+
+SalesHistory::SalesHistory(QObject *parent) : QObject(parent) {}
+
+qint64 SalesHistory::hourKey(const QDateTime &time) {
+    return time.date().toJulianDay() * 24 + time.time().hour();
+}
+
+QDateTime SalesHistory::hourStart(qint64 key) {
+    return QDateTime(QDate::fromJulianDay(key / 24), QTime(int(key % 24), 0));
+}
+
+qint64 SalesHistory::bucketKey(qint64 hour, Bucket bucket) {
+    switch (bucket) {
+    case Hour: return hour;
+    case Day: return hour / 24;
+    case Week: return hour / (24 * 7); // Julian day 0 is a Monday
+    }
+    return hour;
+}
+
+qint64 SalesHistory::bucketStartHour(qint64 key, Bucket bucket) {
+    return key * bucketHours(bucket);
+}
+
+qint64 SalesHistory::bucketHours(Bucket bucket) {
+    switch (bucket) {
+    case Hour: return 1;
+    case Day: return 24;
+    case Week: return 24 * 7;
+    }
+    return 1;
+}
+
+QDate SalesHistory::firstDate() const {
+    return hours.isEmpty() ? QDate() : QDate::fromJulianDay(hours.first() / 24);
+}
+
+bool SalesHistory::refresh() {
+    QSqlQuery query;
+    query.setForwardOnly(true);
+
+    // The newest loaded hour may still be filling up, so it is read again
+    if (hours.isEmpty()) {
+        query.prepare("SELECT BucketStart, Orders, NetCents, TaxCents "
+                      "FROM sales_hourly ORDER BY BucketStart");
+    } else {
+        query.prepare("SELECT BucketStart, Orders, NetCents, TaxCents "
+                      "FROM sales_hourly WHERE BucketStart >= ? ORDER BY BucketStart");
+        query.bindValue(0, hourStart(hours.last()));
+    }
+
+    if (!query.exec()) {
+        qDebug() << "Sales history refresh failed:" << query.lastError().text();
+        return false;
+    }
+
+    bool changed = false;
+    while (query.next()) {
+        qint64 key = hourKey(query.value(0).toDateTime());
+        qint32 orderCount = query.value(1).toInt();
+        qint64 net = query.value(2).toLongLong();
+        qint64 tax = query.value(3).toLongLong();
+
+        // Almost always an append or an update of the last hour
+        int index = hours.size();
+        if (!hours.isEmpty() && key <= hours.last()) {
+            index = int(std::lower_bound(hours.cbegin(), hours.cend(), key) - hours.cbegin());
+        }
+
+        if (index < hours.size() && hours.at(index) == key) {
+            if (orders.at(index) == orderCount && netCents.at(index) == net &&
+                taxCents.at(index) == tax) {
+                continue;
+            }
+            orders[index]   = orderCount;
+            netCents[index] = net;
+            taxCents[index] = tax;
+        } else {
+            hours.insert(index, key);
+            orders.insert(index, orderCount);
+            netCents.insert(index, net);
+            taxCents.insert(index, tax);
+        }
+        changed = true;
+    }
+
+    if (changed) { emit updated(); }
+    return true;
+}
+
+SalesSeries SalesHistory::series(const QDateTime &from, const QDateTime &to,
+                                 Bucket bucket) const {
+    SalesSeries result;
+
+    qint64 fromHour = hourKey(from);
+    qint64 toHour   = hourKey(to);
+    if (to.time().minute() != 0 || to.time().second() != 0) { ++toHour; }
+    if (toHour <= fromHour) { return result; }
+
+    qint64 firstBucket = bucketKey(fromHour, bucket);
+    qint64 lastBucket  = bucketKey(toHour - 1, bucket);
+
+    result.points.resize(int(lastBucket - firstBucket + 1));
+    for (int i = 0; i < result.points.size(); ++i) {
+        result.points[i].start = hourStart(bucketStartHour(firstBucket + i, bucket));
+    }
+
+    auto begin = std::lower_bound(hours.cbegin(), hours.cend(), fromHour);
+    auto end   = std::lower_bound(begin, hours.cend(), toHour);
+
+    for (int i = int(begin - hours.cbegin()); i < int(end - hours.cbegin()); ++i) {
+        SalesPoint &point = result.points[int(bucketKey(hours.at(i), bucket) - firstBucket)];
+        point.orders += orders.at(i);
+        point.net += Money::fromCents(netCents.at(i));
+        point.tax += Money::fromCents(taxCents.at(i));
+    }
+
+    for (const SalesPoint &point : result.points) {
+        result.orders += point.orders;
+        result.net += point.net;
+        result.tax += point.tax;
+    }
+    return result;
+}
+
+bool SalesHistory::recordOrder(QSqlQuery &query, int orderId, int orderDelta,
+                               Money net, Money tax) {
+    // Bucketed by the order's own timestamp, in the caller's transaction
+    query.prepare("INSERT INTO sales_hourly (BucketStart, Orders, NetCents, TaxCents) "
+                  "SELECT DATE_FORMAT(OrderDate, '%Y-%m-%d %H:00:00'), ?, ?, ? "
+                  "FROM Orders WHERE OrderID = ? "
+                  "ON DUPLICATE KEY UPDATE Orders = Orders + VALUES(Orders), "
+                  "NetCents = NetCents + VALUES(NetCents), "
+                  "TaxCents = TaxCents + VALUES(TaxCents)");
+    query.bindValue(0, orderDelta);
+    query.bindValue(1, net.cents());
+    query.bindValue(2, tax.cents());
+    query.bindValue(3, orderId);
+    return query.exec();
+}
@@ -0,0 +1,81 @@
+#ifndef SALESHISTORY_H
+#define SALESHISTORY_H
+
+#include <QDate>
+#include <QDateTime>
+#include <QObject>
+#include <QVector>
+
+#include "Money.h"
+
+class QSqlQuery;
+
+struct SalesPoint {
+    QDateTime start; // beginning of the bucket
+    int       orders = 0;
+    Money     net;
+    Money     tax;
+
+    Money gross() const { return net + tax; }
+};
+
+struct SalesSeries {
+    QVector<SalesPoint> points;
+    int                 orders = 0;
+    Money               net;
+    Money               tax;
+
+    Money gross() const { return net + tax; }
+};
+
+// Hourly sales history held in memory for interactive analytics.
+//
+// Checkout adds each order to the sales_hourly rollup table
+// (see migrations/005_sales_hourly.sql); this class loads that table once into
+// parallel arrays sorted by hour and afterwards only reads hours from the
+// last loaded one onward. Any date range is answered by a binary search and
+// a scan over the hours it covers, regrouped into hour, day or week
+// buckets, without touching the database.
+class SalesHistory : public QObject {
+    Q_OBJECT
+
+  public:
+    enum Bucket { Hour, Day, Week };
+    Q_ENUM(Bucket)
+
+    explicit SalesHistory(QObject *parent = nullptr);
+
+    // Loads everything the first time, then only new or changed hours
+    bool refresh();
+
+    // [from, to) split into buckets; empty buckets are included
+    SalesSeries series(const QDateTime &from, const QDateTime &to,
+                       Bucket bucket) const;
+
+    int   hoursLoaded() const { return hours.size(); }
+    QDate firstDate() const;
+
+    // Adds an order (negative amounts for refunds) to the rollup. Call
+    // inside the checkout transaction, after the Orders row is written.
+    static bool recordOrder(QSqlQuery &query, int orderId, int orderDelta,
+                            Money net, Money tax);
+
+  signals:
+    void updated();
+
+  private:
+    // Column arrays, one entry per hour with sales, sorted by hour.
+    // An hour is julianDay * 24 + hourOfDay (local time, no DST gaps).
+    QVector<qint64> hours;
+    QVector<qint32> orders;
+    QVector<qint64> netCents;
+    QVector<qint64> taxCents;
+
+    static qint64    hourKey(const QDateTime &time);
+    static QDateTime hourStart(qint64 key);
+    static qint64    bucketKey(qint64 hour, Bucket bucket);
+    static qint64    bucketStartHour(qint64 bucketKey, Bucket bucket);
+    static qint64    bucketHours(Bucket bucket);
+};
+
+#endif // SALESHISTORY_H
@@ -0,0 +1,163 @@
+#include "ScaleReader.h"
+
+#include <QFile>
+#include <QRegularExpression>
+#include <QSerialPort>
+#include <QThread>
+#include <QTimer>
+#include <QDebug>
+
+#include <cmath>
+
+bool ScaleReading::parse(const QByteArray &line, ScaleReading *reading) {
+    static const QRegularExpression weightPattern(
+        "([+-]?)\\s*(\\d+(?:\\.\\d+)?)\\s*(kg|g|lb)?",
+        QRegularExpression::CaseInsensitiveOption);
+
+    QString text = QString::fromLatin1(line).trimmed();
+    if (text.isEmpty()) { return false; }
+
+    ScaleReading result;
+    if (text.startsWith("ST", Qt::CaseInsensitive)) {
+        result.status = Stable;
+    } else if (text.startsWith("US", Qt::CaseInsensitive)) {
+        result.status = Unstable;
+    } else if (text.startsWith("OL", Qt::CaseInsensitive)) {
+        result.status = Overload;
+        *reading      = result;
+        return true;
+    }
+
+    QRegularExpressionMatch match = weightPattern.match(text);
+    if (!match.hasMatch()) { return false; }
+
+    double value = match.captured(2).toDouble();
+    if (match.captured(1) == "-") { value = -value; }
+
+    // No unit means kilograms, like the cashier's quantity box
+    QString unit  = match.captured(3).toLower();
+    double  grams = value * 1000.0;
+    if (unit == "g") {
+        grams = value;
+    } else if (unit == "lb") {
+        grams = value * 453.59237;
+    }
+
+    result.grams = std::llround(grams);
+    *reading     = result;
+    return true;
+}
+
+ScaleWorker::ScaleWorker(const QString &device, int baudRate, QObject *parent)
+    : QObject(parent), device(device), baudRate(baudRate) {}
+
+void ScaleWorker::start() {
+    // Created here so they belong to the scale thread
+    if (device.startsWith("sim:")) {
+        QFile file(device.mid(4));
+        if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+            emit errorOccurred("Cannot open simulated scale " + file.fileName());
+            return;
+        }
+        while (!file.atEnd()) {
+            QByteArray line = file.readLine().trimmed();
+            if (!line.isEmpty()) { simLines << line; }
+        }
+        if (simLines.isEmpty()) {
+            emit errorOccurred("Simulated scale file is empty");
+            return;
+        }
+
+        simTimer = new QTimer(this);
+        connect(simTimer, &QTimer::timeout, this, &ScaleWorker::readSimulated);
+        simTimer->start(simIntervalMs);
+        qDebug() << "Scale simulator replaying" << simLines.size() << "lines";
+        return;
+    }
+
+    port = new QSerialPort(device, this);
+    port->setBaudRate(baudRate);
+    port->setDataBits(QSerialPort::Data8);
+    port->setParity(QSerialPort::NoParity);
+    port->setStopBits(QSerialPort::OneStop);
+    port->setFlowControl(QSerialPort::NoFlowControl);
+
+    if (!port->open(QIODevice::ReadOnly)) {
+        emit errorOccurred("Cannot open scale " + device + ": " + port->errorString());
+        return;
+    }
+    connect(port, &QSerialPort::readyRead, this, &ScaleWorker::readSerial);
+    qDebug() << "Scale connected on" << device;
+}
+
+void ScaleWorker::readSerial() {
+    pending += port->readAll();
+
+    // Scales end lines with CR, LF or both; empty pieces are skipped
+    int start = 0;
+    for (int i = 0; i < pending.size(); ++i) {
+        if (pending.at(i) == '\r' || pending.at(i) == '\n') {
+            handleLine(pending.mid(start, i - start));
+            start = i + 1;
+        }
+    }
+    pending.remove(0, start);
+
+    // Guard against a device that never sends a line end
+    if (pending.size() > 256) { pending.clear(); }
+}
+
+void ScaleWorker::readSimulated() {
+    handleLine(simLines.at(simPosition));
+    simPosition = (simPosition + 1) % simLines.size();
+}
+
+void ScaleWorker::handleLine(const QByteArray &line) {
+    ScaleReading reading;
+    if (ScaleReading::parse(line, &reading)) { handleReading(reading); }
+}
+
+void ScaleWorker::handleReading(const ScaleReading &reading) {
+    if (reading.status == ScaleReading::Overload) {
+        candidate = -1;
+        emit errorOccurred("Scale overload");
+        return;
+    }
+
+    bool moved = candidate < 0 || qAbs(reading.grams - candidate) > toleranceGrams;
+    if (moved || reading.status == ScaleReading::Unstable) {
+        // Only a real change of load re-arms the stable report
+        if (moved) { reported = false; }
+        candidate = reading.grams;
+        candidateSince.restart();
+        emit weightChanged(reading.grams, false);
+        return;
+    }
+
+    bool settled = candidateSince.elapsed() >= stableMs;
+    emit weightChanged(reading.grams, settled);
+
+    if (settled && !reported && reading.grams > toleranceGrams) {
+        reported = true;
+        emit stableWeight(reading.grams);
+    }
+}
+
+ScaleReader::ScaleReader(const QString &device, int baudRate, QObject *parent)
+    : QObject(parent), thread(new QThread(this)),
+      worker(new ScaleWorker(device, baudRate)) {
+    worker->moveToThread(thread);
+    connect(thread, &QThread::started, worker, &ScaleWorker::start);
+    connect(thread, &QThread::finished, worker, &QObject::deleteLater);
+
+    connect(worker, &ScaleWorker::weightChanged, this, &ScaleReader::weightChanged);
+    connect(worker, &ScaleWorker::stableWeight, this, &ScaleReader::stableWeight);
+    connect(worker, &ScaleWorker::errorOccurred, this, &ScaleReader::errorOccurred);
+}
+
+ScaleReader::~ScaleReader() {
+    thread->quit();
+    thread->wait();
+}
+
+void ScaleReader::start() { thread->start(); }
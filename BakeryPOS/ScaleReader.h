@@ -0,0 +1,98 @@
+#ifndef SCALEREADER_H
+#define SCALEREADER_H
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QObject>
+#include <QStringList>
+
+class QSerialPort;
+class QThread;
+class QTimer;
+
+// One line of scale output, e.g. "ST,GS,+  1.234kg" or "US,GS,  0.98 kg".
+// Most counter scales in continuous mode send something of this shape: an
+// optional ST (stable) / US (unstable) / OL (overload) header followed by a
+// signed number and a unit.
+struct ScaleReading {
+    enum Status { Unknown, Stable, Unstable, Overload };
+
+    Status status = Unknown;
+    qint64 grams  = 0;
+
+    static bool parse(const QByteArray &line, ScaleReading *reading);
+};
+
+// Runs on the scale thread; use ScaleReader from the GUI side.
+class ScaleWorker : public QObject {
+    Q_OBJECT
+
+  public:
+    ScaleWorker(const QString &device, int baudRate, QObject *parent = nullptr);
+
+    // Tuning; set before the thread starts
+    int stableMs       = 300; // how long a weight must hold still
+    int toleranceGrams = 2;   // jitter ignored while holding still
+    int simIntervalMs  = 100; // line rate of the simulated device
+
+  public slots:
+    void start();
+
+  signals:
+    void weightChanged(qint64 grams, bool stable);
+    void stableWeight(qint64 grams);
+    void errorOccurred(const QString &message);
+
+  private slots:
+    void readSerial();
+    void readSimulated();
+
+  private:
+    QString           device;
+    int               baudRate;
+    QSerialPort      *port     = nullptr;
+    QTimer           *simTimer = nullptr;
+    QList<QByteArray> simLines;
+    int               simPosition = 0;
+    QByteArray        pending;
+
+    qint64            candidate = -1;
+    QElapsedTimer     candidateSince;
+    bool              reported = false;
+
+    void handleLine(const QByteArray &line);
+    void handleReading(const ScaleReading &reading);
+};
+
+// Streams weights from a counter scale on a background thread.
+//
+// The device is a serial port name (/dev/ttyUSB0, COM3, or a pty for
+// testing), or "sim:<file>" to replay scale output lines from a text file
+// in a loop. weightChanged() follows every reading for display;
+// stableWeight() fires once each time a non-zero weight settles, and not
+// again until the load changes or is lifted.
+class ScaleReader : public QObject {
+    Q_OBJECT
+
+  public:
+    explicit ScaleReader(const QString &device, int baudRate = 9600,
+                         QObject *parent = nullptr);
+    ~ScaleReader();
+
+    // Call before start()
+    void setStableMs(int milliseconds) { worker->stableMs = milliseconds; }
+    void setToleranceGrams(int grams) { worker->toleranceGrams = grams; }
+
+    void start();
+
+  signals:
+    void weightChanged(qint64 grams, bool stable);
+    void stableWeight(qint64 grams);
+    void errorOccurred(const QString &message);
+
+  private:
+    QThread     *thread;
+    ScaleWorker *worker;
+};
+
+#endif // SCALEREADER_H
@@ -0,0 +1,135 @@
+#include "SchemaMigrator.h"
+
+#include <QDir>
+#include <QFile>
+#include <QRegularExpression>
+#include <QSet>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QDebug>
+
+#include <algorithm>
+
+static const char *MigrationLock = "bakerypos_schema";
+
+// MySQL errors for a change that is already in place
+static bool alreadyApplied(const QSqlError &error) {
+    static const QSet<QString> codes = {
+        "1050", // table already exists
+        "1060", // duplicate column name
+        "1061", // duplicate key name
+    };
+    return codes.contains(error.nativeErrorCode());
+}
+
+static bool fail(QString *error, const QString &reason) {
+    qDebug() << "Schema migration failed:" << reason;
+    if (error) { *error = reason; }
+    return false;
+}
+
+QList<SchemaMigrator::Migration> SchemaMigrator::migrations() {
+    static const QRegularExpression fileName("^(\\d+)_(\\w+)\\.sql$");
+
+    QList<Migration> list;
+
+    QDir dir(":/migrations");
+    for (const QString &file : dir.entryList(QStringList() << "*.sql", QDir::Files)) {
+        QRegularExpressionMatch match = fileName.match(file);
+        if (!match.hasMatch()) {
+            qDebug() << "Ignoring migration with unexpected name:" << file;
+            continue;
+        }
+
+        Migration migration;
+        migration.version = match.captured(1).toInt();
+        migration.name    = match.captured(2);
+        migration.path    = dir.filePath(file);
+        list << migration;
+    }
+
+    std::sort(list.begin(), list.end(), [](const Migration &a, const Migration &b) {
+        return a.version < b.version;
+    });
+    return list;
+}
+
+QStringList SchemaMigrator::statements(const QString &script) {
+    // Comments are whole lines; statements end with a semicolon
+    QStringList lines;
+    for (const QString &line : script.split('\n')) {
+        if (!line.trimmed().startsWith("--")) { lines << line; }
+    }
+
+    QStringList list;
+    for (const QString &statement : lines.join('\n').split(';')) {
+        if (!statement.trimmed().isEmpty()) { list << statement.trimmed(); }
+    }
+    return list;
+}
+
+static bool applyPending(const QSqlDatabase &db, QString *error) {
+    QSqlQuery query(db);
+
+    QSet<int> applied;
+    if (!query.exec("SELECT Version FROM schema_version")) {
+        return fail(error, "Cannot read schema_version: " + query.lastError().text());
+    }
+    while (query.next()) { applied.insert(query.value(0).toInt()); }
+
+    for (const SchemaMigrator::Migration &migration : SchemaMigrator::migrations()) {
+        if (applied.contains(migration.version)) { continue; }
+
+        QString label =
+            QString("%1_%2").arg(migration.version, 3, 10, QChar('0')).arg(migration.name);
+
+        QFile file(migration.path);
+        if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+            return fail(error, "Cannot read migration " + label);
+        }
+
+        // MySQL commits DDL as it goes, so a failed migration is retried
+        // from its first statement on the next start
+        QString script = QString::fromUtf8(file.readAll());
+        for (const QString &statement : SchemaMigrator::statements(script)) {
+            if (query.exec(statement)) { continue; }
+            if (alreadyApplied(query.lastError())) {
+                qDebug() << "Migration" << label << "skipped:" << query.lastError().text();
+                continue;
+            }
+            return fail(error, "Migration " + label + " failed: " + query.lastError().text());
+        }
+
+        query.prepare("INSERT INTO schema_version (Version, Name) VALUES (?, ?)");
+        query.bindValue(0, migration.version);
+        query.bindValue(1, migration.name);
+        if (!query.exec()) {
+            return fail(error, "Cannot record migration " + label + ": " + query.lastError().text());
+        }
+        qDebug() << "Applied migration" << label;
+    }
+    return true;
+}
+
+bool SchemaMigrator::migrate(const QSqlDatabase &db, QString *error) {
+    QSqlQuery query(db);
+    if (!query.exec("CREATE TABLE IF NOT EXISTS schema_version ("
+                    "Version INT PRIMARY KEY, "
+                    "Name VARCHAR(128) NOT NULL, "
+                    "AppliedAt DATETIME NOT NULL DEFAULT CURRENT_TIMESTAMP)")) {
+        return fail(error, "Cannot create schema_version: " + query.lastError().text());
+    }
+
+    query.prepare("SELECT GET_LOCK(?, 30)");
+    query.bindValue(0, MigrationLock);
+    if (!query.exec() || !query.next() || query.value(0).toInt() != 1) {
+        return fail(error, "Another register is still updating the database schema");
+    }
+
+    bool ok = applyPending(db, error);
+
+    query.prepare("SELECT RELEASE_LOCK(?)");
+    query.bindValue(0, MigrationLock);
+    query.exec();
+    return ok;
+}
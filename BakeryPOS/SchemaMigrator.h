@@ -0,0 +1,35 @@
+#ifndef SCHEMAMIGRATOR_H
+#define SCHEMAMIGRATOR_H
+
+#include <QList>
+#include <QSqlDatabase>
+#include <QString>
+#include <QStringList>
+
+// Brings the database schema up to date at startup.
+//
+// Migrations are the numbered files in migrations/ (NNN_name.sql), built
+// into the binary through migrations/migrations.qrc and applied in order
+// of their number. schema_version records each one applied, so a till only
+// runs what it has not seen. Statements run one at a time; one that finds
+// its table, column or index already there (databases patched by hand from
+// the old sql/ snippets) counts as applied. A named lock keeps tills that
+// start together from migrating at the same time.
+class SchemaMigrator {
+  public:
+    struct Migration {
+        int     version = 0;
+        QString name;
+        QString path;
+    };
+
+    static QList<Migration> migrations();
+
+    // Returns false with the failing migration and the reason in error
+    static bool migrate(const QSqlDatabase &db = QSqlDatabase::database(),
+                        QString *error = nullptr);
+
+    static QStringList statements(const QString &script);
+};
+
+#endif // SCHEMAMIGRATOR_H
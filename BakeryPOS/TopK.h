@@ -0,0 +1,196 @@
+#ifndef TOPK_H
+#define TOPK_H
+
+#include <QHash>
+#include <QVector>
+#include <QtGlobal>
+
+#include <algorithm>
+#include <functional>
+
+// Keeps the k largest items offered, by Less, in O(k) memory.
+//
+// A min-heap of the best k so far: an item that is not larger than the
+// smallest kept one is dropped straight away, otherwise it replaces it.
+// Offering n items costs O(n log k) instead of sorting all n.
+template <typename T, typename Less = std::less<T>>
+class TopK {
+  public:
+    explicit TopK(int k = 10, Less less = Less()) : capacity(qMax(1, k)), less(less) {}
+
+    void offer(const T &item) {
+        if (heap.size() < capacity) {
+            heap.append(item);
+            std::push_heap(heap.begin(), heap.end(), greater());
+        } else if (less(heap.first(), item)) {
+            std::pop_heap(heap.begin(), heap.end(), greater());
+            heap.last() = item;
+            std::push_heap(heap.begin(), heap.end(), greater());
+        }
+    }
+
+    // Kept items, largest first
+    QVector<T> ranked() const {
+        QVector<T> result = heap;
+        std::sort(result.begin(), result.end(),
+                  [this](const T &a, const T &b) { return less(b, a); });
+        return result;
+    }
+
+    bool isEmpty() const { return heap.isEmpty(); }
+    int  size() const { return heap.size(); }
+    int  k() const { return capacity; }
+    void clear() { heap.clear(); }
+
+  private:
+    int        capacity;
+    Less       less;
+    QVector<T> heap; // smallest kept item first
+
+    auto greater() const {
+        return [this](const T &a, const T &b) { return less(b, a); };
+    }
+};
+
+// Approximate running totals for any number of keys in fixed memory.
+//
+// Each of depth rows adds the delta into one of width counters picked by a
+// per-row hash. Deltas must not be negative: collisions then only ever add,
+// so the smallest of a key's counters is an upper bound on its true total
+// and is usually exact when width is well above the number of heavy keys.
+class CountMinSketch {
+  public:
+    explicit CountMinSketch(int width = 2048, int depth = 4)
+        : width(qMax(1, width)), depth(qMax(1, depth)), counters(this->width * this->depth, 0) {}
+
+    template <typename Key>
+    void add(const Key &key, qint64 delta) {
+        for (int row = 0; row < depth; ++row) { counters[index(key, row)] += delta; }
+    }
+
+    template <typename Key>
+    qint64 estimate(const Key &key) const {
+        qint64 result = counters.at(index(key, 0));
+        for (int row = 1; row < depth; ++row) {
+            result = qMin(result, counters.at(index(key, row)));
+        }
+        return result;
+    }
+
+  private:
+    int             width;
+    int             depth;
+    QVector<qint64> counters;
+
+    template <typename Key>
+    int index(const Key &key, int row) const {
+        // Odd seeds so every row hashes differently
+        return row * width + int(qHash(key, size_t(2 * row + 1) * 0x9e3779b9u) % uint(width));
+    }
+};
+
+// The k heaviest keys of a stream of (key, delta) pairs.
+//
+// Totals are kept exactly while there are at most exactLimit distinct keys.
+// Past that the totals move into a count-min sketch and only the k current
+// leaders are tracked, so memory stays bounded however many keys the
+// stream has; rankings may then be slightly off for keys whose estimates
+// are inflated by collisions.
+//
+// Negative deltas (refunds) are allowed. Once sketching they are summed
+// exactly per key, apart from the sketch, and taken off its estimate, so an
+// estimate is still never below the true total. They should be rare: each
+// key refunded costs an entry.
+template <typename Key>
+class HeavyHitters {
+  public:
+    struct Entry {
+        Key    key;
+        qint64 weight = 0;
+    };
+
+    explicit HeavyHitters(int k = 10, int exactLimit = 4096)
+        : capacity(qMax(1, k)), exactLimit(qMax(capacity, exactLimit)) {}
+
+    void add(const Key &key, qint64 delta) {
+        if (!sketching) {
+            exact[key] += delta;
+            if (exact.size() > exactLimit) { startSketching(); }
+            return;
+        }
+        if (delta < 0) {
+            refunded[key] -= delta;
+        } else {
+            sketch.add(key, delta);
+        }
+        track(key, estimate(key));
+    }
+
+    // Heaviest first; ties broken by key so the order is stable
+    QVector<Entry> ranked() const {
+        TopK<Entry, Lighter> top(capacity);
+        if (sketching) {
+            for (const Entry &entry : leaders) { top.offer(entry); }
+        } else {
+            for (auto it = exact.constBegin(); it != exact.constEnd(); ++it) {
+                top.offer({it.key(), it.value()});
+            }
+        }
+        return top.ranked();
+    }
+
+    bool isApproximate() const { return sketching; }
+
+  private:
+    struct Lighter {
+        bool operator()(const Entry &a, const Entry &b) const {
+            return a.weight < b.weight || (a.weight == b.weight && b.key < a.key);
+        }
+    };
+
+    int  capacity;
+    int  exactLimit;
+    bool sketching = false;
+
+    QHash<Key, qint64> exact;
+    CountMinSketch     sketch;
+    QHash<Key, qint64> refunded; // negative deltas once sketching, as positive totals
+    QVector<Entry>     leaders;  // at most k, with their latest estimates
+
+    qint64 estimate(const Key &key) const {
+        return sketch.estimate(key) - refunded.value(key);
+    }
+
+    void startSketching() {
+        sketching = true;
+        for (auto it = exact.constBegin(); it != exact.constEnd(); ++it) {
+            if (it.value() < 0) {
+                refunded.insert(it.key(), -it.value());
+            } else {
+                sketch.add(it.key(), it.value());
+            }
+        }
+        for (auto it = exact.constBegin(); it != exact.constEnd(); ++it) {
+            track(it.key(), estimate(it.key()));
+        }
+        exact.clear();
+        exact.squeeze();
+    }
+
+    void track(const Key &key, qint64 estimate) {
+        for (Entry &entry : leaders) {
+            if (entry.key == key) {
+                entry.weight = estimate;
+                return;
+            }
+        }
+        if (leaders.size() < capacity) {
+            leaders.append({key, estimate});
+            return;
+        }
+        auto lightest = std::min_element(leaders.begin(), leaders.end(), Lighter());
+        if (Lighter()(*lightest, Entry{key, estimate})) { *lightest = {key, estimate}; }
+    }
+};
+
+#endif // TOPK_H
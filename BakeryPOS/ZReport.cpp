@@ -0,0 +1,289 @@
+#include "ZReport.h"
+
+#include <QDir>
+#include <QFile>
+#include <QHash>
+#include <QPageSize>
+#include <QPdfWriter>
+#include <QSettings>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QStandardPaths>
+#include <QTextDocument>
+#include <QTextStream>
+#include <QtConcurrent/QtConcurrentRun>
+#include <QDebug>
+
+ZReportGenerator::ZReportGenerator(QObject *parent) : QObject(parent) {
+    connect(&watcher, &QFutureWatcher<ZReport>::finished, this,
+            [this]() { emit finished(watcher.result()); });
+}
+
+QString ZReportGenerator::defaultArchiveDir() {
+    QSettings settings("BakeryPOS", "BakeryPOS");
+    return settings
+        .value("reports/archiveDir",
+               QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) +
+                   "/zreports")
+        .toString();
+}
+
+void ZReportGenerator::generate(const QDate &day, const QString &archiveDir) {
+    if (watcher.isRunning()) { return; }
+
+    watcher.setFuture(QtConcurrent::run([day, archiveDir]() {
+        // Connections belong to the thread that opened them, so the worker
+        // gets its own copy of the default connection
+        const QString connectionName = "zreport_" + day.toString("yyyyMMdd");
+        ZReport       report;
+        {
+            QSqlDatabase db = QSqlDatabase::cloneDatabase(
+                QSqlDatabase::defaultConnection, connectionName);
+            if (db.open()) {
+                report = build(day, connectionName);
+                db.close();
+            } else {
+                report.businessDate = day;
+                report.error        = db.lastError().text();
+            }
+        }
+        QSqlDatabase::removeDatabase(connectionName);
+
+        if (!report.isValid()) { return report; }
+
+        QDir().mkpath(archiveDir);
+        QString base = archiveDir + "/Z-" + day.toString("yyyy-MM-dd");
+        QString error;
+        if (!writeCsv(report, base + ".csv", &error) ||
+            !writePdf(report, base + ".pdf", &error)) {
+            report.error = error;
+            return report;
+        }
+        report.csvPath = base + ".csv";
+        report.pdfPath = base + ".pdf";
+        return report;
+    }));
+}
+
+ZReport ZReportGenerator::build(const QDate &day, const QString &connectionName) {
+    ZReport report;
+    report.businessDate = day;
+    report.generatedAt  = QDateTime::currentDateTime();
+
+    QSqlQuery query(QSqlDatabase::database(connectionName));
+    query.setForwardOnly(true);
+
+    // A range on OrderDate (not DATE(OrderDate)) so an index can be used
+    query.prepare("SELECT o.OrderID, o.OrderDate, o.UserID, u.username, "
+                  "o.payment_method, o.TotalAmount, od.Quantity, od.Price, "
+                  "p.Category, p.Name, od.Discount "
+                  "FROM Orders o "
+                  "LEFT JOIN OrderDetails od ON od.OrderID = o.OrderID "
+                  "LEFT JOIN products p ON p.ProductID = od.ProductID "
+                  "LEFT JOIN users u ON u.UserID = o.UserID "
+                  "WHERE o.OrderDate >= ? AND o.OrderDate < ? "
+                  "ORDER BY o.OrderID");
+    query.bindValue(0, QDateTime(day, QTime(0, 0)));
+    query.bindValue(1, QDateTime(day.addDays(1), QTime(0, 0)));
+
+    if (!query.exec()) {
+        report.error = query.lastError().text();
+        qDebug() << "Z-report query failed:" << report.error;
+        return report;
+    }
+
+    // State of the order being read; everything else is a running total
+    int     currentOrder = -1;
+    Money   orderNet;
+    Money   orderTotal;
+    QString cashier;
+    QString payment;
+    int     hour = 0;
+
+    QHash<QString, int> lastOrderInCategory;
+
+    // Lines arrive by order, not by product, so sellers are ranked as they stream
+    HeavyHitters<QString> sellers(5);
+
+    auto finishOrder = [&]() {
+        if (currentOrder < 0) { return; }
+
+        // Tax is what the customer paid on top of the lines
+        Money tax = orderTotal - orderNet;
+        if (orderTotal < Money()) {
+            ++report.voids;
+            report.voidAmount += orderTotal;
+        }
+
+        for (ZReportTotals *totals :
+             {&report.overall, &report.byCashier[cashier],
+              &report.byPayment[payment], &report.byHour[hour]}) {
+            ++totals->orders;
+            totals->net += orderNet;
+            totals->tax += tax;
+        }
+    };
+
+    while (query.next()) {
+        int orderId = query.value(0).toInt();
+        if (orderId != currentOrder) {
+            finishOrder();
+            currentOrder = orderId;
+            orderNet     = Money();
+            orderTotal   = Money::fromVariant(query.value(5));
+            hour         = query.value(1).toDateTime().time().hour();
+            cashier      = query.value(3).toString();
+            if (cashier.isEmpty()) { cashier = "User #" + query.value(2).toString(); }
+            payment = query.value(4).toString();
+            if (payment.isEmpty()) { payment = "Unknown"; }
+        }
+
+        // Orders without lines still count towards their totals
+        if (query.value(6).isNull()) { continue; }
+
+        qint64 quantity = quantityToMilli(query.value(6).toDouble());
+        Money  line     = Money::fromVariant(query.value(7)).times(quantity) -
+                     Money::fromVariant(query.value(10));
+        orderNet += line;
+        ++report.lines;
+
+        QString category = query.value(8).toString();
+        if (category.isEmpty()) { category = "Uncategorized"; }
+
+        ZReportTotals &totals = report.byCategory[category];
+        totals.net += line;
+        if (lastOrderInCategory.value(category, -1) != orderId) {
+            lastOrderInCategory.insert(category, orderId);
+            ++totals.orders;
+        }
+
+        // Refund lines have negative quantities and count against the product
+        QString product = query.value(9).toString();
+        sellers.add(product.isEmpty() ? QString("Unknown product") : product, quantity);
+    }
+    finishOrder();
+    report.topSellers = sellers.ranked();
+
+    qDebug() << "Z-report for" << day << ":" << report.overall.orders << "orders,"
+             << report.lines << "lines";
+    return report;
+}
+
+static void writeCsvSection(QTextStream &out, const char *section,
+                            const QString &key, const ZReportTotals &totals) {
+    QString name = key;
+    if (name.contains(',') || name.contains('"')) {
+        name = "\"" + name.replace("\"", "\"\"") + "\"";
+    }
+    out << section << ',' << name << ',' << totals.orders << ','
+        << totals.net.toDecimalString() << ',' << totals.tax.toDecimalString()
+        << ',' << totals.gross().toDecimalString() << '\n';
+}
+
+bool ZReportGenerator::writeCsv(const ZReport &report, const QString &path,
+                                QString *error) {
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Truncate)) {
+        if (error) { *error = "Cannot write " + path + ": " + file.errorString(); }
+        return false;
+    }
+
+    QTextStream out(&file);
+    out << "section,key,orders,net,tax,gross\n";
+    writeCsvSection(out, "total", report.businessDate.toString(Qt::ISODate),
+                    report.overall);
+    for (auto it = report.byCashier.constBegin(); it != report.byCashier.constEnd(); ++it) {
+        writeCsvSection(out, "cashier", it.key(), it.value());
+    }
+    for (auto it = report.byPayment.constBegin(); it != report.byPayment.constEnd(); ++it) {
+        writeCsvSection(out, "payment", it.key(), it.value());
+    }
+    for (auto it = report.byCategory.constBegin(); it != report.byCategory.constEnd(); ++it) {
+        writeCsvSection(out, "category", it.key(), it.value());
+    }
+    for (int hour = 0; hour < 24; ++hour) {
+        if (report.byHour[hour].orders == 0) { continue; }
+        writeCsvSection(out, "hour", QString("%1:00").arg(hour, 2, 10, QChar('0')),
+                        report.byHour[hour]);
+    }
+    out << "voids," << report.voids << ",," << report.voidAmount.toDecimalString()
+        << ",,\n";
+
+    out.flush();
+    if (file.error() != QFile::NoError) {
+        if (error) { *error = file.errorString(); }
+        return false;
+    }
+    return true;
+}
+
+static QString htmlSection(const QString &title, const QMap<QString, ZReportTotals> &groups,
+                           bool withTax = true) {
+    QString html = "<h3>" + title.toHtmlEscaped() + "</h3><table width='100%' "
+                   "cellspacing='0' cellpadding='3' border='1'><tr><th align='left'>" +
+                   title.toHtmlEscaped() + "</th><th>Orders</th><th>Net</th>";
+    if (withTax) { html += "<th>Tax</th><th>Gross</th>"; }
+    html += "</tr>";
+
+    for (auto it = groups.constBegin(); it != groups.constEnd(); ++it) {
+        const ZReportTotals &totals = it.value();
+        html += "<tr><td>" + it.key().toHtmlEscaped() + "</td><td align='right'>" +
+                QString::number(totals.orders) + "</td><td align='right'>" +
+                totals.net.toString() + "</td>";
+        if (withTax) {
+            html += "<td align='right'>" + totals.tax.toString() +
+                    "</td><td align='right'>" + totals.gross().toString() + "</td>";
+        }
+        html += "</tr>";
+    }
+    return html + "</table>";
+}
+
+bool ZReportGenerator::writePdf(const ZReport &report, const QString &path,
+                                QString *error) {
+    QMap<QString, ZReportTotals> hours;
+    for (int hour = 0; hour < 24; ++hour) {
+        if (report.byHour[hour].orders == 0) { continue; }
+        hours.insert(QString("%1:00").arg(hour, 2, 10, QChar('0')), report.byHour[hour]);
+    }
+
+    QString sellers = "<h3>Top Sellers</h3><table width='100%' cellspacing='0' "
+                      "cellpadding='3' border='1'><tr><th align='left'>Product</th>"
+                      "<th>Quantity</th></tr>";
+    for (const auto &seller : report.topSellers) {
+        sellers += "<tr><td>" + seller.key.toHtmlEscaped() + "</td><td align='right'>" +
+                   QString::number(seller.weight / 1000.0) + "</td></tr>";
+    }
+    sellers += "</table>";
+
+    QString html =
+        "<h1>Bakery POS - Z Report</h1>"
+        "<p>Business day: " + report.businessDate.toString("yyyy-MM-dd") +
+        "<br>Generated: " + report.generatedAt.toString("yyyy-MM-dd hh:mm:ss") +
+        "</p><p>Orders: " + QString::number(report.overall.orders) +
+        "<br>Lines: " + QString::number(report.lines) +
+        "<br>Net sales: " + report.overall.net.toString() +
+        "<br>Tax: " + report.overall.tax.toString() +
+        "<br><b>Gross: " + report.overall.gross().toString() + "</b>" +
+        "<br>Voids/refunds: " + QString::number(report.voids) + " (" +
+        report.voidAmount.toString() + ")</p>" +
+        htmlSection("Cashier", report.byCashier) +
+        htmlSection("Payment Method", report.byPayment) +
+        htmlSection("Category", report.byCategory, false) +
+        htmlSection("Hour", hours) + sellers;
+
+    QPdfWriter writer(path);
+    writer.setPageSize(QPageSize(QPageSize::A4));
+    writer.setTitle("Z Report " + report.businessDate.toString("yyyy-MM-dd"));
+
+    QTextDocument document;
+    document.setHtml(html);
+    document.print(&writer);
+
+    if (!QFile::exists(path)) {
+        if (error) { *error = "Cannot write " + path; }
+        return false;
+    }
+    return true;
+}
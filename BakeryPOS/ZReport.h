@@ -0,0 +1,86 @@
+#ifndef ZREPORT_H
+#define ZREPORT_H
+
+#include <QDate>
+#include <QDateTime>
+#include <QFutureWatcher>
+#include <QMap>
+#include <QObject>
+#include <QString>
+#include <QVector>
+
+#include <array>
+
+#include "Money.h"
+#include "TopK.h"
+
+struct ZReportTotals {
+    int   orders = 0;
+    Money net; // line totals before tax
+    Money tax;
+
+    Money gross() const { return net + tax; }
+};
+
+// End-of-day (Z) report for one business day.
+//
+// Groups are keyed by cashier, payment method and category, so the size of
+// the report depends on how many of those exist and not on how many orders
+// were taken.
+struct ZReport {
+    QDate     businessDate;
+    QDateTime generatedAt;
+
+    ZReportTotals overall;
+    int           lines = 0;
+    int           voids = 0; // orders with a negative total (refunds)
+    Money         voidAmount;
+
+    QMap<QString, ZReportTotals>  byCashier;
+    QMap<QString, ZReportTotals>  byPayment;
+    QMap<QString, ZReportTotals>  byCategory; // tax is not split by category
+    std::array<ZReportTotals, 24> byHour;
+
+    // Best sellers by quantity (thousandths), heaviest first
+    QVector<HeavyHitters<QString>::Entry> topSellers;
+
+    QString error;
+    QString csvPath;
+    QString pdfPath;
+
+    bool isValid() const { return error.isEmpty(); }
+};
+
+// Builds and archives Z-reports off the UI thread.
+//
+// The day's orders are read in one forward-only pass (joined with their
+// lines, ordered by OrderID) on a separate database connection, and every
+// group is accumulated as rows stream by. The result is written as CSV and
+// PDF into the archive directory.
+class ZReportGenerator : public QObject {
+    Q_OBJECT
+
+  public:
+    explicit ZReportGenerator(QObject *parent = nullptr);
+
+    // Starts generating the report for day. Ignored while one is running.
+    void generate(const QDate &day, const QString &archiveDir);
+    bool isRunning() const { return watcher.isRunning(); }
+
+    static QString defaultArchiveDir();
+
+    // The steps generate() runs on the worker thread
+    static ZReport build(const QDate &day, const QString &connectionName);
+    static bool    writeCsv(const ZReport &report, const QString &path,
+                            QString *error);
+    static bool    writePdf(const ZReport &report, const QString &path,
+                            QString *error);
+
+  signals:
+    void finished(const ZReport &report);
+
+  private:
+    QFutureWatcher<ZReport> watcher;
+};
+
+#endif // ZREPORT_H
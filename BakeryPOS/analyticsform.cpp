@@ -1,8 +1,16 @@
 #include "analyticsform.h"
+#include "Money.h"
+#include "ZReport.h"
+#include "SalesHistory.h"
+#include "SalesChart.h"
+#include "DemandForecast.h"
 #include <QSqlError>
 #include <QHeaderView>
 #include <QTimer>
 #include <QDebug>
+#include <QMessageBox>
+#include <QElapsedTimer>
+#include <QSettings>
 
 AnalyticsForm::AnalyticsForm(QWidget *parent)
     : QWidget(parent)
@@ -44,6 +52,8 @@ void AnalyticsForm::setupUI()
     headerLayout->addWidget(periodLabel);
     headerLayout->addWidget(periodComboBox);
     headerLayout->addStretch();
+    zReportButton = new QPushButton("Close Day (Z-Report)", this);
+    headerLayout->addWidget(zReportButton);
 
     // Stats cards
     QHBoxLayout *cardsLayout = new QHBoxLayout();
@@ -62,12 +72,51 @@ void AnalyticsForm::setupUI()
     cardsLayout->addWidget(topProductCard);
     cardsLayout->addStretch();  // Add stretch at the end to keep cards left-aligned
 
+    // Sales over time: any date range, bucketed, against the prior period
+    QHBoxLayout *seriesControls = new QHBoxLayout();
+    fromDateEdit = new QDateEdit(QDate::currentDate().addDays(-29), this);
+    toDateEdit = new QDateEdit(QDate::currentDate(), this);
+    fromDateEdit->setCalendarPopup(true);
+    toDateEdit->setCalendarPopup(true);
+    fromDateEdit->setDisplayFormat("yyyy-MM-dd");
+    toDateEdit->setDisplayFormat("yyyy-MM-dd");
+    bucketComboBox = new QComboBox(this);
+    bucketComboBox->addItems({"By Hour", "By Day", "By Week"});
+    bucketComboBox->setCurrentIndex(SalesHistory::Day);
+    compareCheckBox = new QCheckBox("Compare with prior period", this);
+    compareCheckBox->setChecked(true);
+    seriesControls->addWidget(new QLabel("From:", this));
+    seriesControls->addWidget(fromDateEdit);
+    seriesControls->addWidget(new QLabel("To:", this));
+    seriesControls->addWidget(toDateEdit);
+    seriesControls->addWidget(bucketComboBox);
+    seriesControls->addWidget(compareCheckBox);
+    seriesControls->addStretch();
+
+    QLabel *seriesTitle = new QLabel("Sales Over Time", this);
+    seriesTitle->setStyleSheet("font-weight: bold; font-size: 14px; padding: 10px;");
+    seriesSummaryLabel = new QLabel(this);
+    salesChart = new SalesChart(this);
+    salesHistory = new SalesHistory(this);
+
+    // Optional: keep every order line in memory and group there instead of in MySQL
+    QSettings settings("BakeryPOS", "BakeryPOS");
+    if (settings.value("analytics/inMemoryStore", false).toBool()) {
+        lineStore = new OrderLineStore(this);
+
+        // 0 keeps one scan thread per core
+        int threads = settings.value("analytics/scanThreads", 0).toInt();
+        if (threads > 0) {
+            lineStore->setMaxThreads(threads);
+        }
+    }
+
     // Tables section
     QGridLayout *tablesLayout = new QGridLayout();
     tablesLayout->setSpacing(10);
 
     // Sales table setup
-    QLabel *salesTitle = new QLabel("Sales by Product", this);
+    QLabel *salesTitle = new QLabel("Top Products by Revenue", this);
     salesTitle->setStyleSheet("font-weight: bold; font-size: 14px; padding: 10px;");
     salesTable = new QTableWidget(this);
     salesTable->setColumnCount(3);
@@ -79,28 +128,58 @@ void AnalyticsForm::setupUI()
     QLabel *categoryTitle = new QLabel("Sales by Category", this);
     categoryTitle->setStyleSheet("font-weight: bold; font-size: 14px; padding: 10px;");
     categoryTable = new QTableWidget(this);
-    categoryTable->setColumnCount(2);
-    categoryTable->setHorizontalHeaderLabels({"Category", "Total Sales"});
+    categoryTable->setColumnCount(3);
+    categoryTable->setHorizontalHeaderLabels({"Category", "Total Sales", "Best Seller"});
     categoryTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
     categoryTable->setAlternatingRowColors(true);
 
+    // Bake list setup
+    QLabel *bakeTitle = new QLabel("Bake List", this);
+    bakeTitle->setStyleSheet("font-weight: bold; font-size: 14px; padding: 10px;");
+    QHBoxLayout *bakeControls = new QHBoxLayout();
+    bakeDateEdit = new QDateEdit(QDate::currentDate().addDays(1), this);
+    bakeDateEdit->setCalendarPopup(true);
+    bakeDateEdit->setDisplayFormat("ddd yyyy-MM-dd");
+    bakeListButton = new QPushButton("Update Forecast", this);
+    bakeSummaryLabel = new QLabel(this);
+    bakeControls->addWidget(new QLabel("For:", this));
+    bakeControls->addWidget(bakeDateEdit);
+    bakeControls->addWidget(bakeListButton);
+    bakeControls->addWidget(bakeSummaryLabel);
+    bakeControls->addStretch();
+    bakeTable = new QTableWidget(this);
+    bakeTable->setColumnCount(4);
+    bakeTable->setHorizontalHeaderLabels({"Product", "Expected", "Bake", "Busiest Hour"});
+    bakeTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    bakeTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    bakeTable->setAlternatingRowColors(true);
+
     // Add tables to layout
     tablesLayout->addWidget(salesTitle, 0, 0);
     tablesLayout->addWidget(salesTable, 1, 0);
     tablesLayout->addWidget(categoryTitle, 0, 1);
     tablesLayout->addWidget(categoryTable, 1, 1);
+    tablesLayout->addWidget(bakeTitle, 2, 0, 1, 2);
+    tablesLayout->addLayout(bakeControls, 3, 0, 1, 2);
+    tablesLayout->addWidget(bakeTable, 4, 0, 1, 2);
 
     // Add all layouts to main layout
     mainLayout->addLayout(headerLayout);
     mainLayout->addLayout(cardsLayout);
+    mainLayout->addWidget(seriesTitle);
+    mainLayout->addLayout(seriesControls);
+    mainLayout->addWidget(salesChart, 1);
+    mainLayout->addWidget(seriesSummaryLabel);
     mainLayout->addLayout(tablesLayout, 1);  // Give tables more vertical space
 
     // Connect signals
     connectSignals();
+    applyPeriodPreset(periodComboBox->currentIndex());
 
     // Set some reasonable default sizes
     salesTable->setMinimumHeight(200);
     categoryTable->setMinimumHeight(200);
+    bakeTable->setMinimumHeight(200);
 }
 
 QFrame* AnalyticsForm::createStatsCard(const QString &title, const QString &value)
@@ -151,97 +230,104 @@ void AnalyticsForm::updateStats()
     if (avgOrderCard) avgOrderCard->setText("$0.00");
     if (topProductCard) topProductCard->setText("-");
 
-    // Then update with new data
+    // Then update with new data; the history only reads hours it has not seen
+    salesHistory->refresh();
+    if (lineStore) {
+        lineStore->refresh();
+    }
+    loadRanking();
     loadSalesData();
     loadCategoryData();
     updateDashboardCards();
 }
 
-void AnalyticsForm::loadSalesData()
+void AnalyticsForm::loadRanking()
 {
+    QElapsedTimer timer;
+    timer.start();
+
+    // One pass over per-product totals feeds every ranking on the page
+    QSettings settings("BakeryPOS", "BakeryPOS");
+    ranking = ProductRanking(settings.value("analytics/topRows", 10).toInt());
+
+    if (lineStore) {
+        QDate from, to;
+        periodRange(&from, &to);
+        const QVector<LineGroup> products = lineStore->byProduct(from, to);
+        for (const LineGroup& product : products) {
+            ranking.add(product, lineStore->productCategory(product.code));
+        }
+        qDebug() << "Product ranking (memory," << lineStore->lineCount() << "lines,"
+                 << lineStore->maxThreads() << "threads) in" << timer.elapsed() << "ms";
+        return;
+    }
+
     QSqlQuery query;
+    query.setForwardOnly(true);
 
     try {
-        QString periodCondition;
-        switch(periodComboBox->currentIndex()) {
-            case 0: // Today
-                periodCondition = "DATE(o.OrderDate) = CURRENT_DATE";
-                break;
-            case 1: // This Week
-                periodCondition = "YEARWEEK(o.OrderDate) = YEARWEEK(CURRENT_DATE)";
-                break;
-            case 2: // This Month
-                periodCondition = "MONTH(o.OrderDate) = MONTH(CURRENT_DATE)";
-                break;
-            case 3: // This Year
-                periodCondition = "YEAR(o.OrderDate) = YEAR(CURRENT_DATE)";
-                break;
-        }
+        QString periodCondition = periodSql();
 
-        // Fixed query to match actual database structure
+        // No ORDER BY: only the top rows are kept, by the ranking
         QString salesQuery = QString(
-            "SELECT p.Name, SUM(od.Quantity) as TotalQty, "
-            "SUM(od.Quantity * od.Price) as Revenue "
+            "SELECT p.Name, p.Category, SUM(od.Quantity) as TotalQty, "
+            "SUM(od.Quantity * od.Price - od.Discount) as Revenue "
             "FROM OrderDetails od "
             "JOIN Orders o ON od.OrderID = o.OrderID "
             "JOIN products p ON od.ProductID = p.ProductID "
             "WHERE %1 "
-            "GROUP BY p.ProductID, p.Name "
-            "ORDER BY Revenue DESC").arg(periodCondition);
-
-        qDebug() << "Executing sales query:" << salesQuery;
+            "GROUP BY p.ProductID, p.Name, p.Category").arg(periodCondition);
 
         if (!query.exec(salesQuery)) {
             throw std::runtime_error(query.lastError().text().toStdString());
         }
 
-        salesTable->setRowCount(0);
-        double totalRevenue = 0;
-        int totalOrders = 0;
-
         while(query.next()) {
-            int row = salesTable->rowCount();
-            salesTable->insertRow(row);
-            salesTable->setItem(row, 0, new QTableWidgetItem(query.value(0).toString()));
-            salesTable->setItem(row, 1, new QTableWidgetItem(query.value(1).toString()));
-
-            double revenue = query.value(2).toDouble();
-            totalRevenue += revenue;
-            totalOrders++;
+            LineGroup product;
+            product.name = query.value(0).toString();
+            product.quantityMilli = quantityToMilli(query.value(2).toDouble());
+            product.revenue = Money::fromVariant(query.value(3));
 
-            salesTable->setItem(row, 2, new QTableWidgetItem(formatCurrency(revenue)));
-        }
-
-        if (totalRevenueCard) {
-            totalRevenueCard->setText(formatCurrency(totalRevenue));
-        }
-        if (totalOrdersCard) {
-            totalOrdersCard->setText(QString::number(totalOrders));
+            QString category = query.value(1).toString();
+            ranking.add(product, category.isEmpty() ? QString("Uncategorized") : category);
         }
 
+        qDebug() << "Product ranking (SQL) in" << timer.elapsed() << "ms";
     } catch (const std::exception& e) {
-        qDebug() << "Error in loadSalesData:" << e.what();
+        qDebug() << "Error in loadRanking:" << e.what();
+    }
+}
+
+void AnalyticsForm::loadSalesData()
+{
+    const QVector<LineGroup> products = ranking.byRevenue.ranked();
+
+    salesTable->setRowCount(products.size());
+    for (int row = 0; row < products.size(); ++row) {
+        const LineGroup& product = products.at(row);
+        salesTable->setItem(row, 0, new QTableWidgetItem(product.name));
+        salesTable->setItem(row, 1, new QTableWidgetItem(QString::number(product.quantityMilli / 1000.0)));
+        salesTable->setItem(row, 2, new QTableWidgetItem(product.revenue.toString()));
+    }
+
+    // Totals still cover every product, not just the rows shown
+    if (totalRevenueCard) {
+        totalRevenueCard->setText(ranking.revenue.toString());
+    }
+    if (totalOrdersCard) {
+        totalOrdersCard->setText(QString::number(ranking.products));
     }
 }
 
 void AnalyticsForm::loadCategoryData()
 {
+    if (lineStore) {
+        loadCategoryDataFromStore();
+        return;
+    }
+
     try {
-        QString periodCondition;
-        switch(periodComboBox->currentIndex()) {
-            case 0: // Today
-                periodCondition = "DATE(o.OrderDate) = CURRENT_DATE";
-                break;
-            case 1: // This Week
-                periodCondition = "YEARWEEK(o.OrderDate) = YEARWEEK(CURRENT_DATE)";
-                break;
-            case 2: // This Month
-                periodCondition = "MONTH(o.OrderDate) = MONTH(CURRENT_DATE)";
-                break;
-            case 3: // This Year
-                periodCondition = "YEAR(o.OrderDate) = YEAR(CURRENT_DATE)";
-                break;
-        }
+        QString periodCondition = periodSql();
 
         // Fixed category query
         QString categoryQuery = QString(
@@ -265,6 +351,7 @@ void AnalyticsForm::loadCategoryData()
             categoryTable->insertRow(row);
             categoryTable->setItem(row, 0, new QTableWidgetItem(query.value(0).toString()));
             categoryTable->setItem(row, 1, new QTableWidgetItem(query.value(1).toString()));
+            categoryTable->setItem(row, 2, new QTableWidgetItem(bestSellerIn(query.value(0).toString())));
         }
 
     } catch (const std::exception& e) {
@@ -272,55 +359,149 @@ void AnalyticsForm::loadCategoryData()
     }
 }
 
+void AnalyticsForm::periodRange(QDate* from, QDate* to) const
+{
+    // Same periods as the SQL conditions; weeks start on Sunday like YEARWEEK()
+    QDate today = QDate::currentDate();
+    switch (periodComboBox->currentIndex()) {
+        case 1: // This Week
+            *from = today.addDays(-(today.dayOfWeek() % 7));
+            *to = from->addDays(7);
+            break;
+        case 2: // This Month
+            *from = QDate(today.year(), today.month(), 1);
+            *to = from->addMonths(1);
+            break;
+        case 3: // This Year
+            *from = QDate(today.year(), 1, 1);
+            *to = from->addYears(1);
+            break;
+        default: // Today
+            *from = today;
+            *to = today.addDays(1);
+            break;
+    }
+}
+
+QString AnalyticsForm::periodSql() const
+{
+    // A plain range on OrderDate, so the OrderDate index (and the monthly
+    // partitions when Orders is partitioned) limit the scan to the period
+    QDate from, to;
+    periodRange(&from, &to);
+    return QString("o.OrderDate >= '%1' AND o.OrderDate < '%2'")
+        .arg(from.toString(Qt::ISODate), to.toString(Qt::ISODate));
+}
+
+void AnalyticsForm::loadCategoryDataFromStore()
+{
+    QDate from, to;
+    periodRange(&from, &to);
+    QVector<LineGroup> categories = lineStore->byCategory(from, to);
+
+    categoryTable->setRowCount(categories.size());
+    for (int row = 0; row < categories.size(); ++row) {
+        categoryTable->setItem(row, 0, new QTableWidgetItem(categories.at(row).name));
+        categoryTable->setItem(row, 1, new QTableWidgetItem(QString::number(categories.at(row).orders)));
+        categoryTable->setItem(row, 2, new QTableWidgetItem(bestSellerIn(categories.at(row).name)));
+    }
+}
+
+QString AnalyticsForm::bestSellerIn(const QString& category) const
+{
+    auto best = ranking.bestInCategory.constFind(category);
+    if (best == ranking.bestInCategory.constEnd() || best->isEmpty()) {
+        return "-";
+    }
+    return best->ranked().first().name;
+}
+
 void AnalyticsForm::onPeriodComboBoxChanged(int)
 {
     updateStats();
 }
 
-AnalyticsForm::~AnalyticsForm()
+void AnalyticsForm::onZReportClicked()
 {
-    // No ui member to delete
+    QMessageBox::StandardButton reply = QMessageBox::question(
+        this, "Close Day",
+        "Generate the Z-report for " + QDate::currentDate().toString("yyyy-MM-dd") + "?",
+        QMessageBox::Yes | QMessageBox::No);
+    if (reply != QMessageBox::Yes) return;
+
+    zReportButton->setEnabled(false);
+    zReportButton->setText("Generating Z-Report...");
+    zReportGenerator->generate(QDate::currentDate(), ZReportGenerator::defaultArchiveDir());
 }
 
-void AnalyticsForm::updateDashboardCards()
+void AnalyticsForm::onZReportFinished(const ZReport& report)
 {
-    QSqlQuery query;
-    QString periodCondition;
+    zReportButton->setEnabled(true);
+    zReportButton->setText("Close Day (Z-Report)");
 
-    // Get period condition
-    switch(periodComboBox->currentIndex()) {
-        case 0: // Today
-            periodCondition = "DATE(o.OrderDate) = CURRENT_DATE";
-            break;
-        case 1: // This Week
-            periodCondition = "YEARWEEK(o.OrderDate) = YEARWEEK(CURRENT_DATE)";
-            break;
-        case 2: // This Month
-            periodCondition = "MONTH(o.OrderDate) = MONTH(CURRENT_DATE)";
-            break;
-        case 3: // This Year
-            periodCondition = "YEAR(o.OrderDate) = YEAR(CURRENT_DATE)";
-            break;
+    if (!report.isValid()) {
+        QMessageBox::critical(this, "Error", "Failed to generate Z-report: " + report.error);
+        return;
+    }
+
+    QMessageBox::information(this, "Z-Report",
+        QString("Orders: %1\nNet: %2\nTax: %3\nGross: %4\n\nSaved to:\n%5\n%6")
+            .arg(report.overall.orders)
+            .arg(report.overall.net.toString(), report.overall.tax.toString(),
+                 report.overall.gross().toString(), report.csvPath, report.pdfPath));
+}
+
+void AnalyticsForm::updateBakeList()
+{
+    if (forecast->isRunning()) return;
+
+    bakeListButton->setEnabled(false);
+    bakeSummaryLabel->setText("Updating forecast...");
+    forecast->generate(bakeDateEdit->date());
+}
+
+void AnalyticsForm::onBakeListFinished(const BakeList& list)
+{
+    bakeListButton->setEnabled(true);
+    if (!list.isValid()) {
+        bakeSummaryLabel->setText("Forecast failed: " + list.error);
+        qDebug() << "Forecast failed:" << list.error;
+        return;
     }
 
-    // Updated top product query with period condition
-    QString topProductQuery = QString(
-        "SELECT p.Name, SUM(od.Quantity) as Qty "
-        "FROM OrderDetails od "
-        "JOIN products p ON od.ProductID = p.ProductID "
-        "JOIN Orders o ON od.OrderID = o.OrderID "
-        "WHERE %1 "
-        "GROUP BY p.ProductID, p.Name "
-        "ORDER BY Qty DESC "
-        "LIMIT 1").arg(periodCondition);
-
-    if (!query.exec(topProductQuery)) {
-        qDebug() << "Top product query error:" << query.lastError().text();
+    // The date may have been changed while the run was going
+    if (list.date != bakeDateEdit->date()) {
+        updateBakeList();
         return;
     }
 
-    if (query.next() && topProductCard) {
-        topProductCard->setText(query.value(0).toString());
+    bakeTable->setRowCount(list.items.size());
+    for (int row = 0; row < list.items.size(); ++row) {
+        const BakeItem& item = list.items.at(row);
+        bakeTable->setItem(row, 0, new QTableWidgetItem(item.name));
+        bakeTable->setItem(row, 1, new QTableWidgetItem(QString::number(item.expected, 'f', 1)));
+        bakeTable->setItem(row, 2, new QTableWidgetItem(QString::number(item.recommended)));
+        bakeTable->setItem(row, 3, new QTableWidgetItem(
+            item.peakHour < 0 ? QString("-") : QString("%1:00").arg(item.peakHour, 2, 10, QChar('0'))));
+    }
+    bakeSummaryLabel->setText(list.items.isEmpty()
+        ? QString("No sales history for this weekday yet")
+        : QString("Based on sales through %1").arg(list.through.toString("yyyy-MM-dd")));
+}
+
+AnalyticsForm::~AnalyticsForm()
+{
+    // No ui member to delete
+}
+
+void AnalyticsForm::updateDashboardCards()
+{
+    QSqlQuery query;
+    QString periodCondition = periodSql();
+
+    // Best seller comes from the same pass as the sales table
+    if (!ranking.byQuantity.isEmpty() && topProductCard) {
+        topProductCard->setText(ranking.byQuantity.ranked().first().name);
     }
 
     // Updated average order query with period condition
@@ -344,19 +525,122 @@ void AnalyticsForm::connectSignals()
 {
     // Update stats whenever period changes
     connect(periodComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged),
-            this, [this](int) {
+            this, [this](int index) {
+                applyPeriodPreset(index);
                 updateStats();
             });
 
+    // Range changes are answered from memory
+    connect(fromDateEdit, &QDateEdit::dateChanged, this, &AnalyticsForm::updateSeries);
+    connect(toDateEdit, &QDateEdit::dateChanged, this, &AnalyticsForm::updateSeries);
+    connect(bucketComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &AnalyticsForm::updateSeries);
+    connect(compareCheckBox, &QCheckBox::toggled, this, &AnalyticsForm::updateSeries);
+    connect(salesHistory, &SalesHistory::updated, this, &AnalyticsForm::updateSeries);
+
+    // End-of-day report runs in the background
+    zReportGenerator = new ZReportGenerator(this);
+    connect(zReportButton, &QPushButton::clicked, this, &AnalyticsForm::onZReportClicked);
+    connect(zReportGenerator, &ZReportGenerator::finished, this, &AnalyticsForm::onZReportFinished);
+
+    // Forecast is brought up to date and the list built in the background
+    QSettings settings("BakeryPOS", "BakeryPOS");
+    forecast = new DemandForecast(this);
+    forecast->setSmoothing(settings.value("forecast/smoothing", 0.3).toDouble());
+    forecast->setSafetyPercent(settings.value("forecast/safetyPercent", 10).toInt());
+    forecast->setHistoryDays(settings.value("forecast/historyDays", 365).toInt());
+    connect(forecast, &DemandForecast::finished, this, &AnalyticsForm::onBakeListFinished);
+    connect(bakeListButton, &QPushButton::clicked, this, &AnalyticsForm::updateBakeList);
+    connect(bakeDateEdit, &QDateEdit::dateChanged, this, &AnalyticsForm::updateBakeList);
+
     // Set up a timer for periodic updates (every 30 seconds)
     QTimer *updateTimer = new QTimer(this);
     connect(updateTimer, &QTimer::timeout, this, &AnalyticsForm::updateStats);
     updateTimer->start(30000); // 30 seconds
 }
 
+void AnalyticsForm::applyPeriodPreset(int index)
+{
+    // The quick periods fill in the range; the dates can then be adjusted
+    QDate today = QDate::currentDate();
+    QDate from = today;
+    SalesHistory::Bucket bucket = SalesHistory::Hour;
+
+    switch (index) {
+        case 1: // This Week
+            from = today.addDays(1 - today.dayOfWeek());
+            bucket = SalesHistory::Day;
+            break;
+        case 2: // This Month
+            from = QDate(today.year(), today.month(), 1);
+            bucket = SalesHistory::Day;
+            break;
+        case 3: // This Year
+            from = QDate(today.year(), 1, 1);
+            bucket = SalesHistory::Week;
+            break;
+    }
+
+    const QSignalBlocker fromBlocker(fromDateEdit);
+    const QSignalBlocker toBlocker(toDateEdit);
+    const QSignalBlocker bucketBlocker(bucketComboBox);
+    fromDateEdit->setDate(from);
+    toDateEdit->setDate(today);
+    bucketComboBox->setCurrentIndex(bucket);
+    updateSeries();
+}
+
+void AnalyticsForm::updateSeries()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    QDate fromDate = fromDateEdit->date();
+    QDate toDate = toDateEdit->date();
+    if (toDate < fromDate) {
+        seriesSummaryLabel->setText("The end date is before the start date.");
+        salesChart->setSeries(SalesSeries(), SalesHistory::Day);
+        return;
+    }
+
+    // Whole days, end date included
+    QDateTime from(fromDate, QTime(0, 0));
+    QDateTime to(toDate.addDays(1), QTime(0, 0));
+    auto bucket = SalesHistory::Bucket(bucketComboBox->currentIndex());
+
+    // Hourly buckets over long ranges are unreadable; fall back to days
+    if (bucket == SalesHistory::Hour && fromDate.daysTo(toDate) > 31) {
+        bucket = SalesHistory::Day;
+    }
+
+    SalesSeries current = salesHistory->series(from, to, bucket);
+    SalesSeries prior;
+    QString summary = QString("Orders: %1   Net: %2   Tax: %3   Gross: %4")
+                          .arg(current.orders)
+                          .arg(current.net.toString(), current.tax.toString(),
+                               current.gross().toString());
+
+    if (compareCheckBox->isChecked()) {
+        // The same length of time immediately before
+        qint64 days = fromDate.daysTo(toDate) + 1;
+        prior = salesHistory->series(from.addDays(-days), from, bucket);
+
+        qint64 before = prior.gross().cents();
+        qint64 now = current.gross().cents();
+        QString change = before == 0 ? QString("n/a")
+                                     : QString("%1%2%").arg(now >= before ? "+" : "")
+                                           .arg((now - before) * 100.0 / before, 0, 'f', 1);
+        summary += QString("   Prior period: %1 (%2)").arg(prior.gross().toString(), change);
+    }
+
+    salesChart->setSeries(current, bucket, prior);
+    seriesSummaryLabel->setText(summary);
+    qDebug() << "Sales series for" << fromDate << "-" << toDate << "in" << timer.elapsed() << "ms";
+}
+
 QString AnalyticsForm::formatCurrency(double amount)
 {
-    return QString("$%1").arg(amount, 0, 'f', 2);
+    return Money::fromDouble(amount).toString();
 }
 
 
@@ -387,6 +671,12 @@ void AnalyticsForm::showEvent(QShowEvent* event)
     // Refresh data when form becomes visible
     updateStats();
     updatePeriodText();
+
+    // The forecast only changes as days close; the button updates it later
+    if (!bakeListLoaded) {
+        bakeListLoaded = true;
+        updateBakeList();
+    }
 }
 
 void AnalyticsForm::hideEvent(QHideEvent* event)
@@ -9,6 +9,17 @@
 #include <QVBoxLayout>
 #include <QTimer>
 #include <QSqlQuery>
+#include <QDateEdit>
+#include <QCheckBox>
+
+#include "ProductRanking.h"
+
+class ZReportGenerator;
+class DemandForecast;
+struct BakeList;
+class SalesHistory;
+class SalesChart;
+struct ZReport;
 
 class AnalyticsForm : public QWidget
 {
@@ -26,6 +37,11 @@ protected:
 private slots:
     void updateStats();
     void onPeriodComboBoxChanged(int index);
+    void onZReportClicked();
+    void onZReportFinished(const ZReport& report);
+    void onBakeListFinished(const BakeList& list);
+    void updateBakeList();
+    void updateSeries();
 
 private:
     // UI Elements
@@ -37,19 +53,43 @@ private:
     QLabel* avgOrderCard = nullptr;
     QLabel* topProductCard = nullptr;
     QTimer* updateTimer = nullptr;
+    QPushButton* zReportButton = nullptr;
+    ZReportGenerator* zReportGenerator = nullptr;
+
+    // Sales over time
+    QDateEdit* fromDateEdit = nullptr;
+    QDateEdit* toDateEdit = nullptr;
+    QComboBox* bucketComboBox = nullptr;
+    QCheckBox* compareCheckBox = nullptr;
+    QLabel* seriesSummaryLabel = nullptr;
+    SalesChart* salesChart = nullptr;
+    SalesHistory* salesHistory = nullptr;
+    OrderLineStore* lineStore = nullptr;  // only when analytics/inMemoryStore is set
+    ProductRanking ranking;
+
+    // Bake list from the demand forecast
+    QDateEdit* bakeDateEdit = nullptr;
+    QPushButton* bakeListButton = nullptr;
+    QTableWidget* bakeTable = nullptr;
+    QLabel* bakeSummaryLabel = nullptr;
+    DemandForecast* forecast = nullptr;
+    bool bakeListLoaded = false;
 
     // Helper functions
     void setupUI();
     void connectSignals();
+    void loadRanking();
     void loadSalesData();
     void loadCategoryData();
+    void loadCategoryDataFromStore();
+    QString bestSellerIn(const QString& category) const;
+    void periodRange(QDate* from, QDate* to) const;
+    QString periodSql() const;
     void updateDashboardCards();
     void updatePeriodText();
+    void applyPeriodPreset(int index);
     QString formatCurrency(double amount);
     QFrame* createStatsCard(const QString& title, const QString& value);
-
-    // Constants
-    const double TAX_RATE = 0.15; // 15% tax rate
 };
 
 #endif // ANALYTICSFORM_H
\ No newline at end of file
@@ -1,15 +1,37 @@
 #include "cashierform.h"
+#include "CatalogSearchProxyModel.h"
+#include "InventoryMonitor.h"
+#include "LiveQueryModel.h"
+#include "DomainEvents.h"
+#include "Money.h"
+#include "BarcodeScanner.h"
+#include "ScaleReader.h"
+#include "ReceiptWidget.h"
+#include "CheckoutService.h"
+#include "ProductRecord.h"
 #include <QMessageBox>
 #include <QSqlError>
 #include <QDateTime>
 #include <QDebug>
+#include <QApplication>
+#include <QSettings>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QTimer>
+#include <QVarLengthArray>
+#include <QGridLayout>
 
 CashierForm::CashierForm(QWidget *parent, int userId) : QWidget(parent)
 {
     currentUserId = userId;
     setupUI();
     loadProducts();
+    reloadPricing();
     connectSignals();
+    restoreParkedCarts();
 }
 
 void CashierForm::setupUI()
@@ -43,47 +65,58 @@ void CashierForm::setupUI()
     addItemLayout->addWidget(quantitySpinBox);
     addItemLayout->addWidget(addItemButton);
     addItemLayout->addStretch();
+    scanStatusLabel = new QLabel(this);
+    addItemLayout->addWidget(scanStatusLabel);
+    scaleLabel = new QLabel(this);
+    scaleLabel->hide();
+    addItemLayout->addWidget(scaleLabel);
 
     productLayout->addWidget(searchBox);
     productLayout->addWidget(productsTable);
     productLayout->addLayout(addItemLayout);
 
-    // Cart section
-    cartTable = new QTableWidget(this);
-    cartTable->setColumnCount(5);
-    cartTable->setHorizontalHeaderLabels({"Product", "Quantity", "Unit Price", "Total", "ProductID"});
-    cartTable->setSelectionBehavior(QAbstractItemView::SelectRows);
-    cartTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
-    cartTable->hideColumn(4); // Hide ProductID column
-    cartTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    // Cart section: one tab per customer, switching just changes the page
+    cartTabs = new QTabWidget(this);
+    cartTabs->setTabsClosable(true);
+    setActiveCart(addCart());
+
+    // Parked carts are written to disk shortly after each change
+    parkTimer = new QTimer(this);
+    parkTimer->setSingleShot(true);
+    parkTimer->setInterval(500);
 
     // Cart buttons
     QHBoxLayout* cartButtonsLayout = new QHBoxLayout();
     removeItemButton = new QPushButton("Remove Selected", this);
     clearCartButton = new QPushButton("Clear Cart", this);
+    parkCartButton = new QPushButton("Park && New Cart", this);
     cartButtonsLayout->addWidget(removeItemButton);
     cartButtonsLayout->addWidget(clearCartButton);
+    cartButtonsLayout->addWidget(parkCartButton);
     cartButtonsLayout->addStretch();
 
     // Totals section
     QGridLayout* totalsLayout = new QGridLayout();
+    discountLabel = new QLabel("$0.00", this);
     subtotalLabel = new QLabel("$0.00", this);
     taxLabel = new QLabel("$0.00", this);
     totalLabel = new QLabel("$0.00", this);
     
-    totalsLayout->addWidget(new QLabel("Subtotal:"), 0, 0);
-    totalsLayout->addWidget(subtotalLabel, 0, 1);
-    totalsLayout->addWidget(new QLabel("Tax:"), 1, 0);
-    totalsLayout->addWidget(taxLabel, 1, 1);
-    totalsLayout->addWidget(new QLabel("Total:"), 2, 0);
-    totalsLayout->addWidget(totalLabel, 2, 1);
+    totalsLayout->addWidget(new QLabel("Discounts:"), 0, 0);
+    totalsLayout->addWidget(discountLabel, 0, 1);
+    totalsLayout->addWidget(new QLabel("Subtotal:"), 1, 0);
+    totalsLayout->addWidget(subtotalLabel, 1, 1);
+    totalsLayout->addWidget(new QLabel("Tax:"), 2, 0);
+    totalsLayout->addWidget(taxLabel, 2, 1);
+    totalsLayout->addWidget(new QLabel("Total:"), 3, 0);
+    totalsLayout->addWidget(totalLabel, 3, 1);
     
     checkoutButton = new QPushButton("Checkout", this);
     checkoutButton->setStyleSheet("QPushButton { background-color: #27ae60; color: white; padding: 10px; }");
 
     // Add everything to main layout
     mainLayout->addLayout(productLayout);
-    mainLayout->addWidget(cartTable);
+    mainLayout->addWidget(cartTabs);
     mainLayout->addLayout(cartButtonsLayout);
     mainLayout->addLayout(totalsLayout);
     mainLayout->addWidget(checkoutButton);
@@ -91,14 +124,39 @@ void CashierForm::setupUI()
 
 void CashierForm::loadProducts()
 {
-    productsModel = new QSqlQueryModel(this);
+    // Loaded once; afterwards patched from DomainEvents/CatalogFeed
+    productsModel = new LiveQueryModel(this);
+    reloadProducts();
+
+    // Stock column shows live levels; sold-out products are disabled
+    catalogModel = new CatalogStockProxyModel(0, 5, this);
+    catalogModel->setSourceModel(productsModel);
+
+    // Searching filters the in-memory rows; no requery per keystroke
+    searchModel = new CatalogSearchProxyModel(this);
+    searchModel->setSourceModel(catalogModel);
+
+    productsTable->setModel(searchModel);
+    productsTable->hideColumn(0); // Hide ID column
+    productsTable->hideColumn(6); // Barcodes are for the scanner only
+
+    // Scans resolve against the loaded catalog, never the database
+    barcodeIndex = new BarcodeIndex(productsModel, 0, 6, this);
+    
+    // Adjust column widths
+    productsTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+}
+
+void CashierForm::reloadProducts()
+{
     productsModel->setQuery(
-        "SELECT ProductID, Name, Category, PricePerUnit, UnitType, StockQuantity "
-        "FROM products "
-        "WHERE status = 'Available' "
-        "ORDER BY Name"
+        QString("SELECT ProductID, Name, Category, %1 AS Price, UnitType, StockQuantity, "
+                "Barcode FROM products "
+                "WHERE status = 'Available' "
+                "ORDER BY Name").arg(ProductRecord::SellingPriceSql),
+        "ProductID"
     );
-    
+
     // Set headers
     productsModel->setHeaderData(0, Qt::Horizontal, "ID");
     productsModel->setHeaderData(1, Qt::Horizontal, "Product");
@@ -106,12 +164,30 @@ void CashierForm::loadProducts()
     productsModel->setHeaderData(3, Qt::Horizontal, "Price");
     productsModel->setHeaderData(4, Qt::Horizontal, "Unit");
     productsModel->setHeaderData(5, Qt::Horizontal, "Stock");
-    
-    productsTable->setModel(productsModel);
-    productsTable->hideColumn(0); // Hide ID column
-    
-    // Adjust column widths
-    productsTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    productsModel->setHeaderData(6, Qt::Horizontal, "Barcode");
+}
+
+QVariant CashierForm::catalogValue(int viewRow, int column) const
+{
+    QAbstractItemModel* model = productsTable->model();
+    return model->data(model->index(viewRow, column));
+}
+
+void CashierForm::setInventoryMonitor(InventoryMonitor* monitor)
+{
+    inventoryMonitor = monitor;
+    catalogModel->setInventoryMonitor(monitor);
+
+    // Drop the current selection if it just sold out on another sale
+    if (monitor) {
+        connect(monitor, &InventoryMonitor::outOfStock, this, [this](int productId) {
+            QModelIndex current = productsTable->currentIndex();
+            if (current.isValid() && catalogValue(current.row(), 0).toInt() == productId) {
+                productsTable->clearSelection();
+                productsTable->setCurrentIndex(QModelIndex());
+            }
+        });
+    }
 }
 
 void CashierForm::connectSignals()
@@ -120,18 +196,35 @@ void CashierForm::connectSignals()
     connect(removeItemButton, &QPushButton::clicked, this, &CashierForm::onRemoveItemClicked);
     connect(clearCartButton, &QPushButton::clicked, this, &CashierForm::onClearCartClicked);
     connect(checkoutButton, &QPushButton::clicked, this, &CashierForm::onCheckoutClicked);
+    connect(parkCartButton, &QPushButton::clicked, this, &CashierForm::onParkCartClicked);
+    connect(cartTabs, &QTabWidget::currentChanged, this, &CashierForm::onCartTabChanged);
+    connect(cartTabs, &QTabWidget::tabCloseRequested, this, &CashierForm::onCartTabCloseRequested);
+    connect(parkTimer, &QTimer::timeout, this, &CashierForm::saveParkedCarts);
     connect(searchBox, &QLineEdit::textChanged, this, [this](const QString& text) {
-        QString filter = text.trimmed();
-        QString query = QString(
-            "SELECT ProductID, Name, Category, PricePerUnit, UnitType, StockQuantity "
-            "FROM products "
-            "WHERE status = 'Available' "
-            "AND (Name LIKE '%%1%' OR Category LIKE '%%1%') "
-            "ORDER BY Name"
-        ).arg(filter);
-        
-        productsModel->setQuery(query);
+        searchModel->setSearchText(text.trimmed());
     });
+
+    // Price/availability edits here or on other registers patch single rows
+    DomainEvents* events = DomainEvents::instance();
+    connect(events, &DomainEvents::productChanged, this,
+            [this](DomainEvents::ChangeType type, const QList<int>& ids) {
+        if (type == DomainEvents::Removed) {
+            productsModel->removeKeys(ids);
+        } else {
+            productsModel->refreshKeys(ids);
+        }
+    });
+    connect(events, &DomainEvents::catalogReloaded, this, &CashierForm::reloadProducts);
+    connect(events, &DomainEvents::catalogReloaded, this, &CashierForm::reloadPricing);
+
+    // Scanner bursts anywhere on this page go straight to the cart
+    QSettings settings("BakeryPOS", "BakeryPOS");
+    scanFilter = new BarcodeWedgeFilter(this, this);
+    scanFilter->setBurstGap(settings.value("scanner/burstGapMs", 40).toInt());
+    scanFilter->setMinimumLength(settings.value("scanner/minimumLength", 4).toInt());
+    connect(scanFilter, &BarcodeWedgeFilter::scanned, this, &CashierForm::onBarcodeScanned);
+
+    setupScale();
     
     connect(productsTable->selectionModel(), &QItemSelectionModel::selectionChanged,
             this, &CashierForm::onProductSelectionChanged);
@@ -146,43 +239,52 @@ void CashierForm::onAddItemClicked()
     }
 
     int row = current.row();
-    int productId = productsModel->data(productsModel->index(row, 0)).toInt();
-    QString productName = productsModel->data(productsModel->index(row, 1)).toString();
-    double unitPrice = productsModel->data(productsModel->index(row, 3)).toDouble();
-    double quantity = quantitySpinBox->value();
+    int productId = catalogValue(row, 0).toInt();
+    QString productName = catalogValue(row, 1).toString();
+    Money unitPrice = Money::fromVariant(catalogValue(row, 3));
+    qint64 quantity = quantityToMilli(quantitySpinBox->value());
 
     if (quantity <= 0) {
         QMessageBox::warning(this, "Warning", "Please enter a valid quantity.");
         return;
     }
 
-    double total = quantity * unitPrice;
+    if (inventoryMonitor && inventoryMonitor->isSoldOut(productId)) {
+        QMessageBox::warning(this, "Warning", productName + " is out of stock.");
+        return;
+    }
 
-    // Check if product already exists in cart
-    for (int row = 0; row < cartTable->rowCount(); ++row) {
-        if (cartTable->item(row, 4)->text().toInt() == productId) {
-            // Update quantity and total instead of adding new row
-            double currentQty = cartTable->item(row, 1)->text().toDouble();
-            double newQty = currentQty + quantity;
-            double newTotal = newQty * unitPrice;
-            
-            cartTable->item(row, 1)->setText(QString::number(newQty, 'f', 2));
-            cartTable->item(row, 3)->setText(formatCurrency(newTotal));
-            
-            updateTotals();
-            quantitySpinBox->setValue(1.0);
-            return;
-        }
+    addToCart(productId, productName, unitPrice, quantity);
+    quantitySpinBox->setValue(1.0);
+}
+
+void CashierForm::addToCart(int productId, const QString& name, Money unitPrice, qint64 quantityMilli,
+                            Money labelPrice)
+{
+    // Product already in cart: update quantity and total instead of adding a row
+    QTableWidgetItem* existing = activeCart->itemForProduct.value(productId);
+    if (existing) {
+        int row = existing->row();
+        if (!labelPrice.isZero()) addLabelled(row, quantityMilli, labelPrice);
+        setCartQuantity(row, cartQuantity(row) + quantityMilli);
+        updateTotals();
+        return;
     }
 
     // Add new row if product not in cart
     int cartRow = cartTable->rowCount();
     cartTable->insertRow(cartRow);
     
-    QTableWidgetItem* nameItem = new QTableWidgetItem(productName);
-    QTableWidgetItem* qtyItem = new QTableWidgetItem(QString::number(quantity, 'f', 2));
+    // Amounts are kept as cents in CartValueRole; the text is display only
+    QTableWidgetItem* nameItem = new QTableWidgetItem(name);
+    int catalogRow = productsModel->rowForKey(productId);
+    if (catalogRow >= 0) {
+        nameItem->setData(CategoryRole, productsModel->data(productsModel->index(catalogRow, 2)));
+    }
+    QTableWidgetItem* qtyItem = new QTableWidgetItem();
     QTableWidgetItem* priceItem = new QTableWidgetItem(formatCurrency(unitPrice));
-    QTableWidgetItem* totalItem = new QTableWidgetItem(formatCurrency(total));
+    priceItem->setData(CartValueRole, unitPrice.cents());
+    QTableWidgetItem* totalItem = new QTableWidgetItem();
     QTableWidgetItem* idItem = new QTableWidgetItem(QString::number(productId));
 
     cartTable->setItem(cartRow, 0, nameItem);
@@ -190,24 +292,164 @@ void CashierForm::onAddItemClicked()
     cartTable->setItem(cartRow, 2, priceItem);
     cartTable->setItem(cartRow, 3, totalItem);
     cartTable->setItem(cartRow, 4, idItem);
+    activeCart->itemForProduct.insert(productId, idItem);
+    if (!labelPrice.isZero()) addLabelled(cartRow, quantityMilli, labelPrice);
+    setCartQuantity(cartRow, quantityMilli);
 
-    // Update totals and reset quantity
     updateTotals();
-    quantitySpinBox->setValue(1.0);
 
     // Debug output
     qDebug() << "Added product to cart:";
     qDebug() << "Product ID:" << productId;
-    qDebug() << "Name:" << productName;
-    qDebug() << "Quantity:" << quantity;
-    qDebug() << "Unit Price:" << unitPrice;
-    qDebug() << "Total:" << total;
+    qDebug() << "Name:" << name;
+    qDebug() << "Quantity:" << quantityMilli / 1000.0;
+    qDebug() << "Unit Price:" << unitPrice.toString();
+}
+
+void CashierForm::addLabelled(int row, qint64 quantityMilli, Money labelPrice)
+{
+    QTableWidgetItem* totalItem = cartTable->item(row, 3);
+    totalItem->setData(LabelQuantityRole,
+                       totalItem->data(LabelQuantityRole).toLongLong() + quantityMilli);
+    totalItem->setData(LabelPriceRole,
+                       totalItem->data(LabelPriceRole).toLongLong() + labelPrice.cents());
+}
+
+void CashierForm::onBarcodeScanned(const QString& code)
+{
+    BarcodeMatch match = barcodeIndex->match(code);
+    int row = match.isValid() ? productsModel->rowForKey(match.productId) : -1;
+    if (row < 0) {
+        QApplication::beep();
+        scanStatusLabel->setText("Unknown barcode: " + code);
+        qDebug() << "Unknown barcode:" << code;
+        return;
+    }
+
+    auto value = [this, row](int column) {
+        return productsModel->data(productsModel->index(row, column));
+    };
+    QString productName = value(1).toString();
+    Money unitPrice = Money::fromVariant(value(3));
+    bool weighed = value(4).toString() == "kg";
+
+    // Scale labels only make sense for products sold by the kilo
+    if (match.kind != BarcodeMatch::Plain && !weighed) {
+        QApplication::beep();
+        scanStatusLabel->setText(productName + " is not sold by weight: " + code);
+        return;
+    }
+
+    if (inventoryMonitor && inventoryMonitor->isSoldOut(match.productId)) {
+        QApplication::beep();
+        scanStatusLabel->setText(productName + " is out of stock");
+        return;
+    }
+
+    // Plain codes add one unit; scale labels carry the weight or the price
+    qint64 quantity = 1000;
+    Money labelPrice;
+    if (match.kind == BarcodeMatch::Weight) {
+        quantity = match.value;  // grams are thousandths of a kg
+    } else if (match.kind == BarcodeMatch::Price) {
+        if (unitPrice.isZero()) {
+            QApplication::beep();
+            scanStatusLabel->setText(productName + " has no price per kg");
+            return;
+        }
+        // The printed price is what is charged. The weight is only recorded,
+        // rounded up so that weight times the kilo price is never under it.
+        labelPrice = Money::fromCents(match.value);
+        quantity = (match.value * 1000 + unitPrice.cents() - 1) / unitPrice.cents();
+    }
+
+    if (quantity <= 0) {
+        QApplication::beep();
+        scanStatusLabel->setText("Invalid label: " + code);
+        return;
+    }
+
+    addToCart(match.productId, productName, unitPrice, quantity, labelPrice);
+    scanStatusLabel->setText("Scanned " + productName);
+}
+
+qint64 CashierForm::cartQuantity(int row) const
+{
+    return cartTable->item(row, 1)->data(CartValueRole).toLongLong();
+}
+
+Money CashierForm::cartUnitPrice(int row) const
+{
+    return Money::fromCents(cartTable->item(row, 2)->data(CartValueRole).toLongLong());
+}
+
+Money CashierForm::cartLineTotal(int row) const
+{
+    return Money::fromCents(cartTable->item(row, 3)->data(CartValueRole).toLongLong());
+}
+
+Money CashierForm::cartDiscount(int row) const
+{
+    return Money::fromCents(cartTable->item(row, 3)->data(DiscountRole).toLongLong());
+}
+
+int CashierForm::cartPromotion(int row) const
+{
+    return cartTable->item(row, 3)->data(PromotionRole).toInt();
+}
+
+QString CashierForm::cartCategory(int row) const
+{
+    return cartTable->item(row, 0)->data(CategoryRole).toString();
+}
+
+void CashierForm::setCartQuantity(int row, qint64 quantityMilli)
+{
+    // Keep the 2-decimal look unless a weighed quantity needs the third place
+    QTableWidgetItem* qtyItem = cartTable->item(row, 1);
+    qtyItem->setText(QString::number(quantityMilli / 1000.0, 'f', quantityMilli % 10 ? 3 : 2));
+    qtyItem->setData(CartValueRole, quantityMilli);
+
+    // Price-labelled packs keep their printed price unless the quantity drops
+    // below what the labels covered
+    QTableWidgetItem* totalItem = cartTable->item(row, 3);
+    qint64 labelledMilli = totalItem->data(LabelQuantityRole).toLongLong();
+    Money labelled = Money::fromCents(totalItem->data(LabelPriceRole).toLongLong());
+    if (quantityMilli < labelledMilli) {
+        labelledMilli = 0;
+        labelled = Money();
+        totalItem->setData(LabelQuantityRole, QVariant());
+        totalItem->setData(LabelPriceRole, QVariant());
+    }
+
+    // Only this line is repriced; the rest of the cart is left as it is.
+    // Promotions apply to the part not sold at a printed price.
+    int productId = cartTable->item(row, 4)->text().toInt();
+    LinePrice line = pricing.price(productId, cartCategory(row), cartUnitPrice(row),
+                                   quantityMilli - labelledMilli, PricingEngine::minuteOfDay());
+    if (labelledMilli > 0) {
+        // Stored as the full quantity at the unit price, less the difference
+        // to the printed price, so the order's revenue equals the labels
+        Money net = line.net() + labelled;
+        line.gross = cartUnitPrice(row).times(quantityMilli);
+        line.discount = line.gross - net;
+    }
+
+    totalItem->setText(formatCurrency(line.net()));
+    totalItem->setData(CartValueRole, line.net().cents());
+    totalItem->setData(DiscountRole, line.discount.cents());
+    totalItem->setData(PromotionRole, line.promotionId);
+    totalItem->setToolTip(line.promotionId
+                              ? QString("%1: -%2").arg(pricing.promotionName(line.promotionId),
+                                                       formatCurrency(line.discount))
+                              : QString());
 }
 
 void CashierForm::onRemoveItemClicked()
 {
     int currentRow = cartTable->currentRow();
     if (currentRow >= 0) {
+        activeCart->itemForProduct.remove(cartTable->item(currentRow, 4)->text().toInt());
         cartTable->removeRow(currentRow);
         updateTotals();
     }
@@ -231,187 +473,420 @@ void CashierForm::onCheckoutClicked()
                                 QMessageBox::Yes | QMessageBox::No);
 
     if (reply == QMessageBox::Yes) {
+        // Markdowns may have started or ended while the cart was open
+        repriceCart();
         if (saveOrder()) {
             QMessageBox::information(this, "Success", "Order completed successfully!");
             clearCart();
+
+            // A served customer's cart goes away if others are waiting
+            if (carts.size() > 1) {
+                closeCart(carts.indexOf(activeCart));
+            }
         }
     }
 }
 
 void CashierForm::updateTotals()
 {
-    double subtotal = calculateSubtotal();
-    double tax = subtotal * TAX_RATE;
-    double total = subtotal + tax;
+    Money subtotal = calculateSubtotal();
+    Money tax = calculateTax();
+    Money total = subtotal + tax;
+
+    Money discounts;
+    for (int row = 0; row < cartTable->rowCount(); ++row) {
+        discounts += cartDiscount(row);
+    }
 
+    discountLabel->setText(discounts.isZero() ? formatCurrency(discounts)
+                                              : "-" + formatCurrency(discounts));
     subtotalLabel->setText(formatCurrency(subtotal));
     taxLabel->setText(formatCurrency(tax));
     totalLabel->setText(formatCurrency(total));
+
+    parkTimer->start();
+}
+
+Money CashierForm::calculateSubtotal()
+{
+    // Gather the line totals into one contiguous run and sum them as integers
+    QVarLengthArray<qint64, 64> lineTotals(cartTable->rowCount());
+    for (int row = 0; row < cartTable->rowCount(); ++row) {
+        lineTotals[row] = cartLineTotal(row).cents();
+    }
+    return Money::sum(lineTotals.constData(), lineTotals.size());
+}
+
+Money CashierForm::calculateTax()
+{
+    // Each category's rate applies to its discounted lines
+    TaxTotals totals;
+    for (int row = 0; row < cartTable->rowCount(); ++row) {
+        totals.add(pricing.taxRate(cartCategory(row)), cartLineTotal(row));
+    }
+    return totals.tax();
 }
 
-double CashierForm::calculateSubtotal()
+void CashierForm::reloadPricing()
 {
-    double subtotal = 0.0;
+    pricing.load();
+    pricingDate = QDate::currentDate();
+    // Parked carts pick up the new rules when resumed
+    for (Cart* cart : carts) {
+        if (cart != activeCart && cart->table->rowCount() > 0) cart->needsCheck = true;
+    }
+    if (activeCart && cartTable->rowCount() > 0) {
+        repriceCart();
+        updateTotals();
+    }
+}
+
+void CashierForm::repriceCart()
+{
+    // Rules are compiled for one day's date range
+    if (pricingDate != QDate::currentDate()) {
+        pricing.load();
+        pricingDate = QDate::currentDate();
+    }
     for (int row = 0; row < cartTable->rowCount(); ++row) {
-        subtotal += cartTable->item(row, 3)->text().remove("$").toDouble();
+        setCartQuantity(row, cartQuantity(row));
     }
-    return subtotal;
 }
 
 void CashierForm::clearCart()
 {
     cartTable->setRowCount(0);
+    activeCart->itemForProduct.clear();
     updateTotals();
 }
 
-QString CashierForm::formatCurrency(double amount)
+QTableWidget* CashierForm::createCartTable()
 {
-    return QString("$%1").arg(amount, 0, 'f', 2);
+    QTableWidget* table = new QTableWidget(this);
+    table->setColumnCount(5);
+    table->setHorizontalHeaderLabels({"Product", "Quantity", "Unit Price", "Total", "ProductID"});
+    table->setSelectionBehavior(QAbstractItemView::SelectRows);
+    table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    table->hideColumn(4); // Hide ProductID column
+    table->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    return table;
 }
 
-bool CashierForm::saveOrder()
+CashierForm::Cart* CashierForm::addCart()
 {
-    if (cartTable->rowCount() == 0) return false;
+    Cart* cart = new Cart;
+    cart->table = createCartTable();
+    carts.append(cart);
+    cartTabs->addTab(cart->table, QString("Cart %1").arg(nextCartNumber++));
+    return cart;
+}
 
-    QSqlDatabase::database().transaction();
+void CashierForm::setActiveCart(Cart* cart)
+{
+    // Everything else works on cartTable, so switching is a pointer swap
+    activeCart = cart;
+    cartTable = cart->table;
+}
 
-    try {
-        QSqlQuery query;
-        double subtotal = calculateSubtotal();
-        double tax = subtotal * TAX_RATE;
-        double total = subtotal + tax;
+void CashierForm::onParkCartClicked()
+{
+    if (cartTable->rowCount() == 0) {
+        QMessageBox::warning(this, "Warning", "The current cart is empty.");
+        return;
+    }
 
-        // Create new order - match column names from database
-        query.prepare("INSERT INTO Orders (OrderDate, UserID, TotalAmount, payment_method) "
-                     "VALUES (NOW(), :userId, :total, 'Cash')");
-        query.bindValue(":userId", currentUserId);
-        query.bindValue(":total", total);
-        
-        if (!query.exec()) {
-            throw std::runtime_error(query.lastError().text().toStdString());
-        }
+    Cart* cart = addCart();
+    cartTabs->setCurrentWidget(cart->table);
+}
 
-        int orderId = query.lastInsertId().toInt();
+void CashierForm::onCartTabChanged(int index)
+{
+    if (index < 0 || index >= carts.size()) return;
 
-        // Add order details
-        for (int row = 0; row < cartTable->rowCount(); ++row) {
-            query.prepare("INSERT INTO OrderDetails (OrderID, ProductID, Quantity, Price) "
-                        "VALUES (:orderId, :productId, :quantity, :price)");
-                        
-            int productId = cartTable->item(row, 4)->text().toInt();
-            double quantity = cartTable->item(row, 1)->text().toDouble();
-            double unitPrice = cartTable->item(row, 2)->text().remove("$").toDouble();
+    // Leaving a cart parks it; prices may change before it is resumed
+    if (activeCart && activeCart != carts.at(index) && activeCart->table->rowCount() > 0) {
+        activeCart->needsCheck = true;
+    }
 
-            query.bindValue(":orderId", orderId);
-            query.bindValue(":productId", productId);
-            query.bindValue(":quantity", quantity);
-            query.bindValue(":price", unitPrice);
+    setActiveCart(carts.at(index));
+    if (activeCart->needsCheck) {
+        revalidateCart(activeCart);
+    }
+    updateTotals();
+}
 
-            if (!query.exec()) {
-                throw std::runtime_error(query.lastError().text().toStdString());
-            }
+void CashierForm::onCartTabCloseRequested(int index)
+{
+    Cart* cart = carts.at(index);
+    if (cart->table->rowCount() > 0) {
+        QMessageBox::StandardButton reply = QMessageBox::question(
+            this, "Close Cart", "Discard the items in " + cartTabs->tabText(index) + "?",
+            QMessageBox::Yes | QMessageBox::No);
+        if (reply != QMessageBox::Yes) return;
+    }
 
-            // Update product stock
-            query.prepare("UPDATE products SET StockQuantity = StockQuantity - :qty "
-                        "WHERE ProductID = :pid");
-            query.bindValue(":qty", quantity);
-            query.bindValue(":pid", productId);
-            
-            if (!query.exec()) {
-                throw std::runtime_error(query.lastError().text().toStdString());
-            }
+    // There is always one cart to sell into
+    if (carts.size() == 1) {
+        clearCart();
+        return;
+    }
+    closeCart(index);
+}
+
+void CashierForm::closeCart(int index)
+{
+    Cart* cart = carts.takeAt(index);
+    cartTabs->removeTab(index);
+
+    if (activeCart == cart) {
+        activeCart = nullptr;
+        onCartTabChanged(cartTabs->currentIndex());
+    }
+
+    cart->table->deleteLater();
+    delete cart;
+    parkTimer->start();
+}
+
+void CashierForm::revalidateCart(Cart* cart)
+{
+    // Only called for the active cart, so the cart helpers apply to it
+    QTableWidget* table = cart->table;
+    if (table->rowCount() == 0) {
+        cart->needsCheck = false;
+        return;
+    }
+
+    QStringList placeholders;
+    for (int row = 0; row < table->rowCount(); ++row) {
+        placeholders << "?";
+    }
+
+    // One query for the whole cart, priced as the catalog is (per kg for
+    // weighed products)
+    QSqlQuery query;
+    query.prepare(QString("SELECT ProductID, %1, StockQuantity FROM products "
+                          "WHERE status = 'Available' AND ProductID IN (%2)")
+                      .arg(ProductRecord::SellingPriceSql, placeholders.join(", ")));
+    for (int row = 0; row < table->rowCount(); ++row) {
+        query.bindValue(row, table->item(row, 4)->text().toInt());
+    }
+
+    if (!query.exec()) {
+        qDebug() << "Cart check failed:" << query.lastError().text();
+        return;
+    }
+
+    struct Current { Money price; double stock; };
+    QHash<int, Current> current;
+    while (query.next()) {
+        current.insert(query.value(0).toInt(),
+                       {Money::fromVariant(query.value(1)), query.value(2).toDouble()});
+    }
+
+    QStringList changes;
+    for (int row = table->rowCount() - 1; row >= 0; --row) {
+        int productId = table->item(row, 4)->text().toInt();
+        QString name = table->item(row, 0)->text();
+
+        auto it = current.constFind(productId);
+        if (it == current.constEnd()) {
+            changes << name + " is no longer available and was removed.";
+            cart->itemForProduct.remove(productId);
+            table->removeRow(row);
+            continue;
         }
 
-        QSqlDatabase::database().commit();
-        
-        // Show invoice after successful save
-        showInvoice(orderId, subtotal, tax, total);
-        clearCart();
-        return true;
+        if (it->price != cartUnitPrice(row)) {
+            changes << QString("%1 now costs %2 (was %3).")
+                           .arg(name, formatCurrency(it->price), formatCurrency(cartUnitPrice(row)));
+            table->item(row, 2)->setText(formatCurrency(it->price));
+            table->item(row, 2)->setData(CartValueRole, it->price.cents());
+        }
+
+        if (it->stock < cartQuantity(row) / 1000.0) {
+            changes << QString("Only %1 of %2 left in stock.").arg(it->stock).arg(name);
+        }
     }
-    catch (const std::exception& e) {
-        QSqlDatabase::database().rollback();
-        QMessageBox::critical(this, "Error", QString("Failed to save order: %1").arg(e.what()));
-        return false;
+
+    // Prices and promotions may both have changed while it was parked
+    repriceCart();
+
+    cart->needsCheck = false;
+    if (!changes.isEmpty()) {
+        QMessageBox::information(this, "Cart Updated", changes.join("\n"));
     }
 }
 
-void CashierForm::showInvoice(int orderId, double subtotal, double tax, double total)
+// Parked carts file: magic, version, cart count, then for each cart its
+// line count and (ProductID, name, unit price cents, quantity thousandths,
+// price-labelled thousandths, label cents). Version 1 files lack the last two.
+static const quint32 ParkedCartsMagic = 0x42504b43; // "BPKC"
+static const quint16 ParkedCartsVersion = 2;
+
+QString CashierForm::parkedCartsPath() const
 {
-    QWidget* invoice = new QWidget(nullptr, Qt::Window);
-    invoice->setWindowTitle("Invoice #" + QString::number(orderId));
-    invoice->setMinimumWidth(400);
+    return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) +
+           "/parked_carts.dat";
+}
 
-    QVBoxLayout* layout = new QVBoxLayout(invoice);
+void CashierForm::saveParkedCarts()
+{
+    parkTimer->stop();
 
-    // Header
-    QLabel* header = new QLabel("BakeryPOS Receipt");
-    header->setAlignment(Qt::AlignCenter);
-    QFont headerFont = header->font();
-    headerFont.setPointSize(16);
-    headerFont.setBold(true);
-    header->setFont(headerFont);
-    layout->addWidget(header);
+    QList<Cart*> parked;
+    for (Cart* cart : carts) {
+        if (cart->table->rowCount() > 0) parked << cart;
+    }
 
-    // Order info
-    layout->addWidget(new QLabel("Order #: " + QString::number(orderId)));
-    layout->addWidget(new QLabel("Date: " + QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss")));
-    layout->addWidget(new QLabel("Cashier ID: " + QString::number(currentUserId)));
+    QString path = parkedCartsPath();
+    if (parked.isEmpty()) {
+        QFile::remove(path);
+        return;
+    }
 
-    // Separator
-    QFrame* line = new QFrame();
-    line->setFrameShape(QFrame::HLine);
-    line->setFrameShadow(QFrame::Sunken);
-    layout->addWidget(line);
+    QDir().mkpath(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation));
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qDebug() << "Cannot save parked carts:" << file.errorString();
+        return;
+    }
 
-    // Items table
-    QTableWidget* items = new QTableWidget();
-    items->setColumnCount(4);
-    items->setHorizontalHeaderLabels({"Item", "Qty", "Price", "Total"});
-    items->setRowCount(cartTable->rowCount());
-    items->setEditTriggers(QAbstractItemView::NoEditTriggers);
-    
-    for (int row = 0; row < cartTable->rowCount(); ++row) {
-        items->setItem(row, 0, new QTableWidgetItem(cartTable->item(row, 0)->text()));
-        items->setItem(row, 1, new QTableWidgetItem(cartTable->item(row, 1)->text()));
-        items->setItem(row, 2, new QTableWidgetItem(cartTable->item(row, 2)->text()));
-        items->setItem(row, 3, new QTableWidgetItem(cartTable->item(row, 3)->text()));
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << ParkedCartsMagic << ParkedCartsVersion << qint32(parked.size());
+
+    for (Cart* cart : parked) {
+        QTableWidget* table = cart->table;
+        out << qint32(table->rowCount());
+        for (int row = 0; row < table->rowCount(); ++row) {
+            out << qint32(table->item(row, 4)->text().toInt())
+                << table->item(row, 0)->text()
+                << qint64(table->item(row, 2)->data(CartValueRole).toLongLong())
+                << qint64(table->item(row, 1)->data(CartValueRole).toLongLong())
+                << qint64(table->item(row, 3)->data(LabelQuantityRole).toLongLong())
+                << qint64(table->item(row, 3)->data(LabelPriceRole).toLongLong());
+        }
     }
-    
-    items->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
-    layout->addWidget(items);
-
-    // Totals
-    QGridLayout* totals = new QGridLayout();
-    totals->addWidget(new QLabel("Subtotal:"), 0, 0, Qt::AlignRight);
-    totals->addWidget(new QLabel(formatCurrency(subtotal)), 0, 1, Qt::AlignRight);
-    totals->addWidget(new QLabel("Tax:"), 1, 0, Qt::AlignRight);
-    totals->addWidget(new QLabel(formatCurrency(tax)), 1, 1, Qt::AlignRight);
-    totals->addWidget(new QLabel("Total:"), 2, 0, Qt::AlignRight);
-    totals->addWidget(new QLabel(formatCurrency(total)), 2, 1, Qt::AlignRight);
-    layout->addLayout(totals);
-
-    // Print button
-    QPushButton* printButton = new QPushButton("Print");
-    connect(printButton, &QPushButton::clicked, this, [this, invoice]() {
-        printInvoice(invoice);
-    });
-    layout->addWidget(printButton);
 
-    invoice->show();
+    // Written to a temporary file and renamed, so a crash never leaves half a file
+    if (!file.commit()) {
+        qDebug() << "Cannot save parked carts:" << file.errorString();
+    }
+}
+
+void CashierForm::restoreParkedCarts()
+{
+    QFile file(parkedCartsPath());
+    if (!file.open(QIODevice::ReadOnly)) return;
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_0);
+
+    quint32 magic = 0;
+    quint16 version = 0;
+    qint32 cartCount = 0;
+    in >> magic >> version >> cartCount;
+    if (magic != ParkedCartsMagic || version < 1 || version > ParkedCartsVersion) {
+        qDebug() << "Ignoring parked carts file with unknown format";
+        return;
+    }
+
+    const QSignalBlocker blocker(cartTabs);
+    Cart* first = activeCart;
+
+    for (int c = 0; c < cartCount && in.status() == QDataStream::Ok; ++c) {
+        qint32 lineCount = 0;
+        in >> lineCount;
+
+        setActiveCart(c == 0 ? first : addCart());
+        for (int l = 0; l < lineCount; ++l) {
+            qint32 productId;
+            QString name;
+            qint64 unitCents, quantityMilli;
+            qint64 labelledMilli = 0, labelCents = 0;
+            in >> productId >> name >> unitCents >> quantityMilli;
+            if (version >= 2) in >> labelledMilli >> labelCents;
+            if (in.status() != QDataStream::Ok) break;
+            addToCart(productId, name, Money::fromCents(unitCents), quantityMilli);
+            if (labelledMilli > 0) {
+                int row = activeCart->itemForProduct.value(productId)->row();
+                addLabelled(row, labelledMilli, Money::fromCents(labelCents));
+                setCartQuantity(row, cartQuantity(row));
+            }
+        }
+        activeCart->needsCheck = true;
+    }
+
+    if (in.status() != QDataStream::Ok) {
+        qDebug() << "Parked carts file is truncated; restored what could be read";
+    }
+    qDebug() << "Restored" << carts.size() << "parked carts";
+
+    // Resume the first cart; the others are checked when switched to
+    setActiveCart(first);
+    cartTabs->setCurrentIndex(0);
+    revalidateCart(first);
+    updateTotals();
+}
+
+QString CashierForm::formatCurrency(Money amount)
+{
+    return amount.toString();
 }
 
-void CashierForm::printInvoice(QWidget* invoice)
+QVector<CheckoutLine> CashierForm::cartLines() const
 {
-    if (!printer) {
-        printer = new QPrinter(QPrinter::HighResolution);
+    // Already priced as the rows were changed
+    QVector<CheckoutLine> lines;
+    lines.reserve(cartTable->rowCount());
+    for (int row = 0; row < cartTable->rowCount(); ++row) {
+        CheckoutLine line;
+        line.productId = cartTable->item(row, 4)->text().toInt();
+        line.category = cartCategory(row);
+        line.quantityMilli = cartQuantity(row);
+        line.unitPrice = cartUnitPrice(row);
+        line.price.gross = line.unitPrice.times(line.quantityMilli);
+        line.price.discount = cartDiscount(row);
+        line.price.promotionId = cartPromotion(row);
+        lines.append(line);
     }
+    return lines;
+}
 
-    QPrintDialog printDialog(printer, this);
-    if (printDialog.exec() == QDialog::Accepted) {
-        QPainter painter(printer);
-        invoice->render(&painter);
+bool CashierForm::saveOrder()
+{
+    if (cartTable->rowCount() == 0) return false;
+
+    // The same path as orders submitted through the API
+    QVector<CheckoutLine> lines = cartLines();
+    QString error;
+    int orderId = CheckoutService::submit(lines, CheckoutService::totals(pricing, lines),
+                                          currentUserId, "Cash", &error);
+    if (orderId < 0) {
+        QMessageBox::critical(this, "Error", QString("Failed to save order: %1").arg(error));
+        return false;
     }
+
+    // Stock alerts fire here without a requery; other registers hear
+    // about the sale through the change feed
+    if (inventoryMonitor) {
+        for (const CheckoutLine& line : lines) {
+            inventoryMonitor->applySale(line.productId, line.quantityMilli / 1000.0);
+        }
+    }
+
+    // Show invoice after successful save
+    showInvoice(orderId);
+    clearCart();
+    return true;
+}
+
+void CashierForm::showInvoice(int orderId)
+{
+    // Rendered from the stored order, so a reprint from the history matches.
+    // Every sale reuses the one preview window instead of opening another.
+    ReceiptWidget::preview(Receipt::load(orderId));
 }
 
 void CashierForm::onProductSelectionChanged()
@@ -419,11 +894,10 @@ void CashierForm::onProductSelectionChanged()
     QModelIndex current = productsTable->currentIndex();
     if (current.isValid()) {
         int row = current.row();
-        QString category = productsModel->data(productsModel->index(row, 2)).toString();
-        QString unitType = productsModel->data(productsModel->index(row, 4)).toString();
+        QString unitType = catalogValue(row, 4).toString();
         
         // Adjust quantity spinner based on category
-        if (category == "Sweet") {
+        if (isWeighedProduct(row)) {
             quantitySpinBox->setSuffix(" kg");
             quantitySpinBox->setDecimals(3);
             quantitySpinBox->setSingleStep(0.100);
@@ -441,13 +915,82 @@ void CashierForm::onProductSelectionChanged()
     }
 }
 
+bool CashierForm::isWeighedProduct(int viewRow) const
+{
+    // Products with only a kilo price are sold by weight; their catalog
+    // price column holds PricePerKg
+    return catalogValue(viewRow, 4).toString() == "kg";
+}
+
+void CashierForm::setupScale()
+{
+    // e.g. /dev/ttyUSB0, COM3, or sim:/path/to/scale_sample.txt
+    QSettings settings("BakeryPOS", "BakeryPOS");
+    QString device = settings.value("scale/device").toString();
+    if (device.isEmpty()) return;
+
+    scaleAutoAdd = settings.value("scale/autoAdd", true).toBool();
+    scaleReader = new ScaleReader(device, settings.value("scale/baudRate", 9600).toInt(), this);
+    scaleReader->setStableMs(settings.value("scale/stableMs", 300).toInt());
+    scaleReader->setToleranceGrams(settings.value("scale/toleranceGrams", 2).toInt());
+
+    connect(scaleReader, &ScaleReader::weightChanged, this, &CashierForm::onScaleWeightChanged);
+    connect(scaleReader, &ScaleReader::stableWeight, this, &CashierForm::onStableWeight);
+    connect(scaleReader, &ScaleReader::errorOccurred, this, [this](const QString& message) {
+        scaleLabel->setText("Scale: " + message);
+        qDebug() << "Scale error:" << message;
+    });
+
+    scaleLabel->setText("Scale: --");
+    scaleLabel->show();
+    scaleReader->start();
+}
+
+void CashierForm::onScaleWeightChanged(qint64 grams, bool stable)
+{
+    scaleLabel->setText(QString("Scale: %1 kg%2")
+                            .arg(grams / 1000.0, 0, 'f', 3)
+                            .arg(stable ? "" : " ~"));
+}
+
+void CashierForm::onStableWeight(qint64 grams)
+{
+    QModelIndex current = productsTable->currentIndex();
+    if (!current.isValid() || !isWeighedProduct(current.row())) return;
+
+    int row = current.row();
+    int productId = catalogValue(row, 0).toInt();
+    QString productName = catalogValue(row, 1).toString();
+
+    if (!scaleAutoAdd) {
+        quantitySpinBox->setValue(grams / 1000.0);
+        return;
+    }
+
+    if (inventoryMonitor && inventoryMonitor->isSoldOut(productId)) {
+        scanStatusLabel->setText(productName + " is out of stock");
+        return;
+    }
+
+    Money pricePerKg = Money::fromVariant(catalogValue(row, 3));
+    if (pricePerKg.isZero()) {
+        QApplication::beep();
+        scanStatusLabel->setText(productName + " has no price per kg");
+        return;
+    }
+
+    // The settled weight goes into the cart as is (grams = thousandths of a kg)
+    addToCart(productId, productName, pricePerKg, grams);
+    scanStatusLabel->setText(QString("Weighed %1 kg of %2").arg(grams / 1000.0, 0, 'f', 3).arg(productName));
+}
+
 CashierForm::~CashierForm()
 {
-    // Clean up printer if it exists
-    if (printer) {
-        delete printer;
-        printer = nullptr;
+    // Flush a pending save so parked carts survive closing the app
+    if (parkTimer->isActive()) {
+        saveParkedCarts();
     }
+    qDeleteAll(carts);
 
     // Clean up model if it exists
     if (productsModel) {
@@ -13,10 +13,21 @@
 #include <QSqlQueryModel>  // Add this
 #include <QTableView>      // Add this
 #include <QDoubleSpinBox>
-#include <QPrinter>
-#include <QPrintDialog>
-#include <QPainter>
 #include <QDateTime>
+#include <QHash>
+#include <QTabWidget>
+
+#include "Money.h"
+#include "PricingEngine.h"
+
+class InventoryMonitor;
+class BarcodeIndex;
+class BarcodeWedgeFilter;
+class ScaleReader;
+class CatalogStockProxyModel;
+class CatalogSearchProxyModel;
+class LiveQueryModel;
+struct CheckoutLine;
 
 class CashierForm : public QWidget
 {
@@ -27,13 +38,26 @@ public:
     explicit CashierForm(QWidget *parent = nullptr, int userId = -1);
     ~CashierForm();
 
+    void setInventoryMonitor(InventoryMonitor* monitor);
+
+    // Cashier switch; the carts in progress stay where they are
+    void setCurrentUserId(int userId) { currentUserId = userId; }
+
 private slots:
     void onAddItemClicked();
     void onRemoveItemClicked();
     void onClearCartClicked();
     void onCheckoutClicked();
     void onProductSelectionChanged();  // Add this
+    void onBarcodeScanned(const QString& code);
+    void onScaleWeightChanged(qint64 grams, bool stable);
+    void onStableWeight(qint64 grams);
     void updateTotals();
+    void reloadProducts();
+    void onParkCartClicked();
+    void onCartTabChanged(int index);
+    void onCartTabCloseRequested(int index);
+    void saveParkedCarts();
 
 private:
     // UI Elements
@@ -41,27 +65,83 @@ private:
     QPushButton* addItemButton;
     QPushButton* removeItemButton;
     QPushButton* clearCartButton;
+    QPushButton* parkCartButton;
     QPushButton* checkoutButton;
-    QTableWidget* cartTable;
+    QTableWidget* cartTable;  // the active cart's table
+    QLabel* discountLabel;
     QLabel* subtotalLabel;
     QLabel* taxLabel;
     QLabel* totalLabel;
     QTableView* productsTable;
-    QSqlQueryModel* productsModel;
+    LiveQueryModel* productsModel;
+    CatalogStockProxyModel* catalogModel = nullptr;
+    CatalogSearchProxyModel* searchModel = nullptr;
+    InventoryMonitor* inventoryMonitor = nullptr;
     QLineEdit* searchBox;
-    QPrinter* printer = nullptr;
+    QLabel* scanStatusLabel;
+    BarcodeIndex* barcodeIndex = nullptr;
+    BarcodeWedgeFilter* scanFilter = nullptr;
+    ScaleReader* scaleReader = nullptr;
+    QLabel* scaleLabel;
+    bool scaleAutoAdd = true;
+
+    // One per customer; only the active one is shown and edited
+    struct Cart {
+        QTableWidget* table = nullptr;
+        QHash<int, QTableWidgetItem*> itemForProduct;  // ProductID -> its row's ID cell
+        bool needsCheck = false;  // parked or restored; recheck prices on resume
+    };
+    QTabWidget* cartTabs;
+    QList<Cart*> carts;  // same order as the tabs
+    Cart* activeCart = nullptr;
+    QTimer* parkTimer;
+    int nextCartNumber = 1;
+
+    // Promotions and per-category tax, compiled once per day or catalog reload
+    PricingEngine pricing;
+    QDate pricingDate;
 
     // Helper methods
     void setupUI();
+    QTableWidget* createCartTable();
+    Cart* addCart();
+    void setActiveCart(Cart* cart);
+    void closeCart(int index);
+    void restoreParkedCarts();
+    void revalidateCart(Cart* cart);
+    QString parkedCartsPath() const;
+    void setupScale();
+    bool isWeighedProduct(int viewRow) const;
     void loadProducts();
+    QVariant catalogValue(int viewRow, int column) const;
     void connectSignals();
-    double calculateSubtotal();
-    QString formatCurrency(double amount);
+    Money calculateSubtotal();
+    Money calculateTax();
+    void reloadPricing();
+    void repriceCart();
+    QString formatCurrency(Money amount);
+    qint64 cartQuantity(int row) const;  // thousandths
+    Money cartUnitPrice(int row) const;
+    Money cartLineTotal(int row) const;  // after discount
+    Money cartDiscount(int row) const;
+    int cartPromotion(int row) const;
+    QString cartCategory(int row) const;
+    void setCartQuantity(int row, qint64 quantityMilli);
+    void addToCart(int productId, const QString& name, Money unitPrice, qint64 quantityMilli,
+                   Money labelPrice = Money());
+    void addLabelled(int row, qint64 quantityMilli, Money labelPrice);
     void clearCart();
+    QVector<CheckoutLine> cartLines() const;
     bool saveOrder();
-    void showInvoice(int orderId, double subtotal, double tax, double total);
-    void printInvoice(QWidget* invoice);
-    const double TAX_RATE = 0.15;
+    void showInvoice(int orderId);
+
+    // Cart cells keep exact values here (cents, quantity in thousandths)
+    static constexpr int CartValueRole = Qt::UserRole;
+    static constexpr int CategoryRole = Qt::UserRole + 1;   // on the name cell
+    static constexpr int DiscountRole = Qt::UserRole + 2;   // on the total cell, cents
+    static constexpr int PromotionRole = Qt::UserRole + 3;  // on the total cell
+    static constexpr int LabelQuantityRole = Qt::UserRole + 4; // on the total cell, thousandths
+    static constexpr int LabelPriceRole = Qt::UserRole + 5;    // on the total cell, cents
 
     // ...existing members...
     int currentUserId;
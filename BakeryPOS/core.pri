@@ -0,0 +1,62 @@
+# Application logic without widgets: money, pricing and checkout, catalog
+# sync, refunds, analytics stores, forecasting and schema migrations.
+# Included by BakeryPOS.pro and by the tools under tools/, so the same code
+# can be driven without the GUI.
+
+QT += core sql network concurrent
+
+CONFIG += c++17
+
+INCLUDEPATH += $$PWD
+DEPENDPATH += $$PWD
+
+SOURCES += \
+    $$PWD/CatalogFeed.cpp \
+    $$PWD/CatalogSearchProxyModel.cpp \
+    $$PWD/CheckoutService.cpp \
+    $$PWD/CredentialStore.cpp \
+    $$PWD/DemandForecast.cpp \
+    $$PWD/DomainEvents.cpp \
+    $$PWD/LiveQueryModel.cpp \
+    $$PWD/OrderArchiver.cpp \
+    $$PWD/OrderLineStore.cpp \
+    $$PWD/PasswordHash.cpp \
+    $$PWD/PricingEngine.cpp \
+    $$PWD/ProcessMemory.cpp \
+    $$PWD/ProductionFeed.cpp \
+    $$PWD/ProductRecord.cpp \
+    $$PWD/ProductTransfer.cpp \
+    $$PWD/Refunds.cpp \
+    $$PWD/RolePages.cpp \
+    $$PWD/SalesHistory.cpp \
+    $$PWD/SchemaMigrator.cpp
+
+HEADERS += \
+    $$PWD/CatalogFeed.h \
+    $$PWD/CatalogSearchProxyModel.h \
+    $$PWD/CheckoutService.h \
+    $$PWD/CredentialStore.h \
+    $$PWD/DemandForecast.h \
+    $$PWD/DomainEvents.h \
+    $$PWD/LiveQueryModel.h \
+    $$PWD/Money.h \
+    $$PWD/OrderArchiver.h \
+    $$PWD/OrderLineStore.h \
+    $$PWD/PasswordHash.h \
+    $$PWD/PricingEngine.h \
+    $$PWD/ProcessMemory.h \
+    $$PWD/ProductionFeed.h \
+    $$PWD/ProductRanking.h \
+    $$PWD/ProductRecord.h \
+    $$PWD/ProductTransfer.h \
+    $$PWD/Refunds.h \
+    $$PWD/RolePages.h \
+    $$PWD/SalesHistory.h \
+    $$PWD/SchemaMigrator.h \
+    $$PWD/TopK.h
+
+# GetProcessMemoryInfo (ProcessMemory.cpp)
+win32: LIBS += -lpsapi
+
+RESOURCES += \
+    $$PWD/migrations/migrations.qrc
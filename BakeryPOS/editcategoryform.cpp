@@ -1,10 +1,12 @@
 #include "editcategoryform.h"
 #include "ui_editcategoryform.h"
+#include "DomainEvents.h"
+#include "CatalogFeed.h"
 #include <QMessageBox>
 #include <QSqlError>
 
 EditCategoryForm::EditCategoryForm(QWidget *parent)
-    : QDialog(parent), ui(new Ui::EditCategoryForm)
+    : QDialog(parent), ui(new Ui::EditCategoryForm), currentCategoryId(0)
 {
     ui->setupUi(this);
     setWindowTitle("Edit Category");
@@ -47,6 +49,16 @@ void EditCategoryForm::on_saveButton_clicked()
     }
 
     if (query.exec()) {
+        if (currentCategoryId > 0) {
+            CatalogFeed::record(CatalogFeed::Category, CatalogFeed::Update, {currentCategoryId});
+            DomainEvents::instance()->publishCategoryChange(DomainEvents::Updated,
+                                                            {currentCategoryId});
+        } else {
+            int categoryId = query.lastInsertId().toInt();
+            CatalogFeed::record(CatalogFeed::Category, CatalogFeed::Insert, {categoryId});
+            DomainEvents::instance()->publishCategoryChange(DomainEvents::Inserted,
+                                                            {categoryId});
+        }
         emit categoryUpdated();
         accept();
     } else {
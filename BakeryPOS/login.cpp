@@ -1,7 +1,10 @@
 #include "login.h"
 #include "ui_login.h"
 #include "dashboard.h"
+#include "PasswordHash.h"
+#include "SchemaMigrator.h"
 #include <QMessageBox>
+#include <QtConcurrent>
 #include <QSqlDatabase>
 #include <QSqlQuery>
 #include <QSqlError>
@@ -24,7 +27,25 @@ login::login(QWidget *parent)
     if (!db.open()) {
         QMessageBox::critical(this, "Database Error",
                               "Error connecting to database: " + db.lastError().text());
+    } else {
+        // Every till brings the schema up to date before anyone logs in. The
+        // code expects the new schema, so nobody can log in until it is.
+        QString error;
+        if (!SchemaMigrator::migrate(db, &error)) {
+            QMessageBox::critical(this, "Database Error",
+                                  "The database schema could not be updated, so BakeryPOS "
+                                  "cannot be used on this register.\n\n" + error +
+                                  "\n\nFix the database and restart the application.");
+            ui->btnLogin->setEnabled(false);
+            ui->btnLogin->setText("Schema update failed");
+            ui->btnLogin->setToolTip(error);
+        }
     }
+
+    // Users and hashes saved by the last session on this register
+    CredentialStore::instance()->load();
+    connect(&checkWatcher, &QFutureWatcher<LoginCheck>::finished,
+            this, &login::onCheckFinished);
 }
 
 login::~login()
@@ -44,33 +65,122 @@ void login::on_checkBox_stateChanged(int state)
 
 void login::on_btnLogin_clicked()
 {
+    if (checkWatcher.isRunning() || !ui->btnLogin->isEnabled()) return;
+
     QString username = ui->usernameLineEdit->text();
-    QString password = ui->passwordLineEdit->text();
 
+    // Role, status and password come from the database whenever it can be
+    // reached, so a user disabled or demoted on another register is refused
+    // here too. This register's copy is only used when it is offline.
+    bool found = false;
+    QSqlDatabase db = QSqlDatabase::database();
+    pendingFromCache = !(db.isOpen() || db.open()) || !loadFromDatabase(username, &found);
+
+    if (pendingFromCache) {
+        pending = CredentialStore::instance()->find(username);
+        if (!pending.isValid() || pending.passwordHash.isEmpty()) {
+            QMessageBox::critical(this, "Login Failed",
+                                  "The database cannot be reached and this register has "
+                                  "no saved login for " + username + ".");
+            return;
+        }
+    } else if (!found) {
+        QMessageBox::warning(this, "Login Failed",
+                           "Invalid username or password");
+        return;
+    }
+
+    if (pending.status != "Active") {
+        QMessageBox::warning(this, "Login Failed",
+                             "This account is not active. Ask an admin to enable it.");
+        return;
+    }
+
+    startCheck(ui->passwordLineEdit->text());
+}
+
+bool login::loadFromDatabase(const QString& username, bool* found)
+{
     QSqlQuery query;
-    query.prepare("SELECT * FROM users WHERE username = ? AND password = ?");
+    query.prepare("SELECT UserID, username, role, status, password, PinHash "
+                  "FROM users WHERE username = ?");
     query.bindValue(0, username);
-    query.bindValue(1, password);
-
-    if (query.exec()) {
-        if (query.next()) {
-            // Login successful
-            int userId = query.value("UserID").toInt();
-            qDebug() << "User logged in with ID:" << userId; // Debug output
-            
-            dashboard* dash = new dashboard(nullptr, userId);
-            dash->show();
-            this->close();
-        } else {
-            // Login failed
-            QMessageBox::warning(this, "Login Failed",
-                               "Invalid username or password");
-        }
-    } else {
-        QMessageBox::critical(this, "Query Error",
-                            "Database query failed: " + query.lastError().text());
+
+    *found = false;
+    if (!query.exec()) {
+        qDebug() << "User lookup failed, using saved logins:" << query.lastError().text();
+        return false;
     }
+    if (!query.next()) return true;
+
+    *found = true;
+
+    pending.userId = query.value(0).toInt();
+    pending.username = query.value(1).toString();
+    pending.role = query.value(2).toString();
+    pending.status = query.value(3).toString();
+    pending.passwordHash = query.value(4).toString();  // may still be plaintext
+    pending.pinHash = query.value(5).toString();
+    return true;
 }
 
+void login::startCheck(const QString& password)
+{
+    ui->btnLogin->setEnabled(false);
+    ui->btnLogin->setText("Signing in...");
+
+    // Hashing is deliberately slow, so it runs off the UI thread
+    QString stored = pending.passwordHash;
+    checkWatcher.setFuture(QtConcurrent::run([password, stored]() {
+        LoginCheck check;
+        bool upgrade = false;
+        check.ok = PasswordHash::verify(password, stored, &upgrade);
+        if (check.ok && upgrade) {
+            check.upgradedHash = PasswordHash::hash(password);
+        }
+        return check;
+    }));
+}
+
+void login::onCheckFinished()
+{
+    LoginCheck check = checkWatcher.result();
+
+    if (!check.ok) {
+        ui->btnLogin->setEnabled(true);
+        ui->btnLogin->setText("Login");
+        QMessageBox::warning(this, "Login Failed",
+                           "Invalid username or password");
+        return;
+    }
+
+    finishCheck(check);
 
+    qDebug() << "User logged in with ID:" << pending.userId; // Debug output
 
+    // Freed on logout, with everything it owns
+    dashboard* dash = new dashboard(nullptr, pending.userId, pending.role);
+    dash->setAttribute(Qt::WA_DeleteOnClose);
+    dash->show();
+    this->close();
+}
+
+void login::finishCheck(const LoginCheck& check)
+{
+    // Plaintext or a weaker hash is replaced on the first good login
+    if (!check.upgradedHash.isEmpty() && !pendingFromCache) {
+        QSqlQuery query;
+        query.prepare("UPDATE users SET password = ? WHERE UserID = ?");
+        query.bindValue(0, check.upgradedHash);
+        query.bindValue(1, pending.userId);
+        if (query.exec()) {
+            pending.passwordHash = check.upgradedHash;
+        } else {
+            qDebug() << "Could not upgrade password hash:" << query.lastError().text();
+        }
+    }
+
+    if (PasswordHash::isHashed(pending.passwordHash)) {
+        CredentialStore::instance()->store(pending);
+    }
+}
@@ -2,10 +2,13 @@
 #define LOGIN_H
 
 #include <QDialog>
+#include <QFutureWatcher>
 #include <QSqlDatabase>
 #include <QSqlQuery>
 #include <QSqlError>
 
+#include "CredentialStore.h"
+
 namespace Ui {
 class login;
 }
@@ -22,9 +25,24 @@ private slots:
     void on_checkBox_stateChanged(int state);
 
     void on_btnLogin_clicked();
+    void onCheckFinished();
 
 private:
+    struct LoginCheck {
+        bool ok = false;
+        QString upgradedHash;  // set when the stored value was plaintext or weaker
+    };
+
     Ui::login *ui;
+    QFutureWatcher<LoginCheck> checkWatcher;
+    Credential pending;         // user being checked
+    bool pendingFromCache = false;  // offline: checked against the saved copy
+
+    // False if the database could not be queried; found says whether the
+    // user exists
+    bool loadFromDatabase(const QString& username, bool* found);
+    void startCheck(const QString& password);
+    void finishCheck(const LoginCheck& check);
 };
 
 #endif // LOGIN_H
@@ -6,6 +6,8 @@
 int main(int argc, char *argv[]) {
 
     QApplication App(argc, argv);
+    App.setOrganizationName("BakeryPOS");
+    App.setApplicationName("BakeryPOS");
 
     // Loading and setting the font
     int ID = QFontDatabase::addApplicationFont(":/fonts/Poppins-Medium.ttf");
@@ -0,0 +1,43 @@
+-- The tables the application was first written against. Existing
+-- databases already have them; this creates them on a new till.
+CREATE TABLE IF NOT EXISTS users (
+    UserID   INT AUTO_INCREMENT PRIMARY KEY,
+    username VARCHAR(64)  NOT NULL,
+    password VARCHAR(255) NOT NULL,
+    role     VARCHAR(32)  NOT NULL,
+    status   VARCHAR(32)  NOT NULL DEFAULT 'Active',
+    date     DATE NULL
+);
+
+CREATE TABLE IF NOT EXISTS categories (
+    ID       INT AUTO_INCREMENT PRIMARY KEY,
+    Category VARCHAR(64) NOT NULL,
+    Date     DATE NULL
+);
+
+CREATE TABLE IF NOT EXISTS products (
+    ProductID     INT AUTO_INCREMENT PRIMARY KEY,
+    Name          VARCHAR(128) NOT NULL,
+    Category      VARCHAR(64)  NULL,
+    PricePerKg    DECIMAL(10, 2) NULL,
+    PricePerUnit  DECIMAL(10, 2) NULL,
+    StockQuantity DECIMAL(10, 3) NOT NULL DEFAULT 0,
+    UnitType      VARCHAR(16)  NOT NULL,
+    date_added    DATETIME NOT NULL DEFAULT CURRENT_TIMESTAMP,
+    status        VARCHAR(32)  NOT NULL DEFAULT 'Available'
+);
+
+CREATE TABLE IF NOT EXISTS Orders (
+    OrderID        INT AUTO_INCREMENT PRIMARY KEY,
+    OrderDate      DATETIME NOT NULL,
+    UserID         INT NOT NULL,
+    TotalAmount    DECIMAL(10, 2) NOT NULL,
+    payment_method VARCHAR(32) NULL
+);
+
+CREATE TABLE IF NOT EXISTS OrderDetails (
+    OrderID   INT NOT NULL,
+    ProductID INT NOT NULL,
+    Quantity  DECIMAL(10, 3) NOT NULL,
+    Price     DECIMAL(10, 2) NOT NULL
+);
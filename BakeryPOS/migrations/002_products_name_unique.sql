@@ -0,0 +1,16 @@
+-- Product names are the natural key used by the bulk importer
+-- (INSERT ... ON DUPLICATE KEY UPDATE in ProductTransfer.cpp).
+--
+-- Databases from before this migration may hold the same name more than
+-- once. The oldest product keeps the name; the others get their ID added,
+-- e.g. "Croissant (#412)", so nothing is deleted and order history still
+-- points at the same rows. Rename them by hand afterwards if needed.
+UPDATE products p
+JOIN (SELECT Name, MIN(ProductID) AS KeepID
+      FROM products
+      GROUP BY Name
+      HAVING COUNT(*) > 1) duplicates
+  ON duplicates.Name = p.Name AND p.ProductID <> duplicates.KeepID
+SET p.Name = CONCAT(LEFT(p.Name, 128 - 16), ' (#', p.ProductID, ')');
+
+ALTER TABLE products ADD UNIQUE KEY uq_products_name (Name);
@@ -0,0 +1,12 @@
+-- Change feed read by every register (see CatalogFeed.cpp).
+-- Registers remember the last ChangeID they applied; rows older than the
+-- retention period and below every live cursor are pruned (see 016).
+CREATE TABLE IF NOT EXISTS catalog_changes (
+    ChangeID   BIGINT AUTO_INCREMENT PRIMARY KEY,
+    Entity     ENUM('product', 'category') NOT NULL,
+    EntityID   INT NOT NULL,
+    ChangeType ENUM('insert', 'update', 'delete', 'stock', 'reload') NOT NULL,
+    Source     CHAR(38) NOT NULL,
+    ChangedAt  DATETIME NOT NULL DEFAULT CURRENT_TIMESTAMP,
+    INDEX idx_catalog_changes_changed_at (ChangedAt)
+);
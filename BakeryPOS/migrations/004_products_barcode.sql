@@ -0,0 +1,6 @@
+-- Barcode or PLU for scan-to-cart (see BarcodeScanner.cpp).
+-- Packaged goods hold their full EAN/UPC. Weighed items hold the 5 digit
+-- PLU printed inside scale labels (21PPPPP... weight, 22PPPPP... price).
+-- Codes can be assigned in bulk through the product import (Barcode column).
+ALTER TABLE products ADD COLUMN Barcode VARCHAR(32) NULL;
+ALTER TABLE products ADD UNIQUE KEY uq_products_barcode (Barcode);
@@ -0,0 +1,6 @@
+-- Indexes behind the order history page (see OrderHistoryForm.cpp).
+-- Pages are read newest first by (OrderDate, OrderID); filtering by cashier
+-- walks the second index instead. Lines are fetched one order at a time.
+CREATE INDEX idx_orders_date_id ON Orders (OrderDate, OrderID);
+CREATE INDEX idx_orders_user_date_id ON Orders (UserID, OrderDate, OrderID);
+CREATE INDEX idx_orderdetails_order ON OrderDetails (OrderID);
@@ -0,0 +1,4 @@
+-- Refunds and voids (see Refunds.cpp). A refund is an order with negative
+-- lines and total that points back at the order it refunds.
+ALTER TABLE Orders ADD COLUMN RefundOf INT NULL;
+ALTER TABLE Orders ADD INDEX idx_orders_refund_of (RefundOf);
@@ -0,0 +1,4 @@
+-- Hashed passwords and switch PINs (see PasswordHash.cpp). Existing
+-- plaintext passwords are replaced by a hash on each user's next login.
+ALTER TABLE users MODIFY password VARCHAR(255) NOT NULL;
+ALTER TABLE users ADD COLUMN PinHash VARCHAR(255) NULL;
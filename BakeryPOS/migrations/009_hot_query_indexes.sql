@@ -0,0 +1,12 @@
+-- Indexes for the queries run on every till. Orders(OrderDate) and
+-- Orders(UserID, OrderDate) are the leading columns of the two indexes in
+-- 006_orders_history.sql, as is OrderDetails(OrderID).
+
+-- Cashier catalog and low stock checks: WHERE status = 'Available' ORDER BY Name
+CREATE INDEX idx_products_status_name ON products (status, Name);
+
+-- Category filter on the products page and analytics by category
+CREATE INDEX idx_products_category ON products (Category);
+
+-- Product sales totals and refunds by product
+CREATE INDEX idx_orderdetails_product ON OrderDetails (ProductID);
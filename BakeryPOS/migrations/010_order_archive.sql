@@ -0,0 +1,29 @@
+-- Cold order history (see OrderArchiver.cpp). Orders older than the
+-- retention period are moved here with their lines, compressed, and
+-- their product totals are added to sales_product_monthly. Hourly totals
+-- were already added to sales_hourly when each order was taken.
+CREATE TABLE IF NOT EXISTS Orders_archive (
+    OrderID        INT PRIMARY KEY,
+    OrderDate      DATETIME NOT NULL,
+    UserID         INT NOT NULL,
+    TotalAmount    DECIMAL(10, 2) NOT NULL,
+    payment_method VARCHAR(32) NULL,
+    RefundOf       INT NULL,
+    INDEX idx_orders_archive_date (OrderDate)
+) ROW_FORMAT = COMPRESSED;
+
+CREATE TABLE IF NOT EXISTS OrderDetails_archive (
+    OrderID   INT NOT NULL,
+    ProductID INT NOT NULL,
+    Quantity  DECIMAL(10, 3) NOT NULL,
+    Price     DECIMAL(10, 2) NOT NULL,
+    INDEX idx_orderdetails_archive_order (OrderID)
+) ROW_FORMAT = COMPRESSED;
+
+CREATE TABLE IF NOT EXISTS sales_product_monthly (
+    MonthStart DATE NOT NULL,
+    ProductID  INT NOT NULL,
+    Quantity   DECIMAL(14, 3) NOT NULL DEFAULT 0,
+    NetCents   BIGINT NOT NULL DEFAULT 0,
+    PRIMARY KEY (MonthStart, ProductID)
+);
@@ -0,0 +1,30 @@
+-- Promotions and per-category tax (see PricingEngine.cpp).
+-- A promotion is tied to a product, a category, or (neither set) the
+-- whole store. Bundle: BundleQuantity units for BundlePrice. Percent:
+-- PercentOff basis points (3000 = 30%). StartTime/EndTime limit it to a
+-- time of day, e.g. 18:00-21:00 for end-of-day markdowns.
+CREATE TABLE IF NOT EXISTS promotions (
+    PromotionID    INT AUTO_INCREMENT PRIMARY KEY,
+    Name           VARCHAR(64) NOT NULL,
+    Kind           ENUM('bundle', 'percent') NOT NULL,
+    ProductID      INT NULL,
+    Category       VARCHAR(64) NULL,
+    BundleQuantity DECIMAL(10, 3) NULL,
+    BundlePrice    DECIMAL(10, 2) NULL,
+    PercentOff     INT NULL,
+    StartTime      TIME NULL,
+    EndTime        TIME NULL,
+    ValidFrom      DATE NULL,
+    ValidTo        DATE NULL,
+    Active         TINYINT(1) NOT NULL DEFAULT 1
+);
+
+-- NULL keeps the standard rate (SalesTax in Money.h)
+ALTER TABLE categories ADD COLUMN TaxBasisPoints INT NULL;
+
+-- Discount is the line's total discount, so a line is worth
+-- Quantity * Price - Discount
+ALTER TABLE OrderDetails ADD COLUMN Discount DECIMAL(10, 2) NOT NULL DEFAULT 0;
+ALTER TABLE OrderDetails ADD COLUMN PromotionID INT NULL;
+ALTER TABLE OrderDetails_archive ADD COLUMN Discount DECIMAL(10, 2) NOT NULL DEFAULT 0;
+ALTER TABLE OrderDetails_archive ADD COLUMN PromotionID INT NULL;
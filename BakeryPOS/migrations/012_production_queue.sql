@@ -0,0 +1,4 @@
+-- Which products go to the production display when sold (see
+-- ProductionFeed.cpp). NULL: never; 0: every sale (custom cakes);
+-- otherwise lines of at least this quantity (large trays).
+ALTER TABLE products ADD COLUMN PrepFromQuantity DECIMAL(10, 3) NULL;
@@ -0,0 +1,17 @@
+-- Demand forecast behind the analytics bake list (see DemandForecast.cpp).
+-- Level is the exponentially smoothed quantity of a product sold in one
+-- hour of one weekday (1 = Monday). forecast_progress remembers the last
+-- closed day folded in, so each run only reads the days since.
+CREATE TABLE IF NOT EXISTS demand_forecast (
+    ProductID    INT     NOT NULL,
+    Weekday      TINYINT NOT NULL,
+    Hour         TINYINT NOT NULL,
+    Level        DOUBLE  NOT NULL,
+    Observations INT     NOT NULL,
+    PRIMARY KEY (ProductID, Weekday, Hour)
+);
+
+CREATE TABLE IF NOT EXISTS forecast_progress (
+    ID          TINYINT PRIMARY KEY,
+    ThroughDate DATE NOT NULL
+);
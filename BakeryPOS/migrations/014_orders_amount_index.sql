@@ -0,0 +1,6 @@
+-- Amount filter on the order history page (see OrderHistoryForm.cpp).
+-- A narrow amount range, such as looking up a receipt by its total, is
+-- read from this index and only the matching orders are sorted; the date
+-- and OrderID columns let the date range be checked without reading rows.
+-- Wide ranges are left to idx_orders_date_id from 006_orders_history.sql.
+CREATE INDEX idx_orders_amount_date_id ON Orders (TotalAmount, OrderDate, OrderID);
@@ -0,0 +1,3 @@
+-- Per-product low stock level for InventoryMonitor (InventoryMonitor.cpp).
+-- NULL uses the register's inventory/lowStockThreshold setting.
+ALTER TABLE products ADD COLUMN LowStockThreshold DECIMAL(10, 3) NULL;
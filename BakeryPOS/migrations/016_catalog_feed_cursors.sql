@@ -0,0 +1,10 @@
+-- Where each running register has read catalog_changes up to (see
+-- CatalogFeed.cpp). Registers report their cursor about once a minute;
+-- old catalog_changes rows are deleted only below the lowest cursor
+-- reported within the retention period.
+CREATE TABLE IF NOT EXISTS catalog_feed_cursors (
+    Source       CHAR(38) NOT NULL PRIMARY KEY,
+    LastChangeID BIGINT   NOT NULL,
+    SeenAt       DATETIME NOT NULL DEFAULT CURRENT_TIMESTAMP,
+    INDEX idx_catalog_feed_cursors_seen_at (SeenAt)
+);
@@ -0,0 +1,201 @@
+#include "ApiServer.h"
+#include "TestDatabase.h"
+#include "TestSuite.h"
+
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFutureWatcher>
+#include <QSqlQuery>
+#include <QTcpSocket>
+#include <QTest>
+#include <QThreadPool>
+#include <QtConcurrent/QtConcurrentMap>
+
+#include <algorithm>
+
+struct LoadResult {
+    int             ok     = 0;
+    int             failed = 0;
+    QVector<qint64> latencies; // microseconds, one per request
+};
+
+// Status of the next response on socket, or -1 if none came in time.
+// Bytes read past it stay in buffer.
+static int readResponse(QTcpSocket &socket, QByteArray &buffer) {
+    for (;;) {
+        const int headerEnd = buffer.indexOf("\r\n\r\n");
+        if (headerEnd >= 0) {
+            const QList<QByteArray> lines  = buffer.left(headerEnd).split('\n');
+            qint64                  length = 0;
+            for (const QByteArray &line : lines) {
+                if (line.toLower().startsWith("content-length:")) {
+                    length = line.mid(15).trimmed().toLongLong();
+                }
+            }
+            if (buffer.size() >= headerEnd + 4 + length) {
+                buffer.remove(0, headerEnd + 4 + length);
+                return lines.first().split(' ').value(1).toInt();
+            }
+        }
+        if (!socket.waitForReadyRead(10000)) { return -1; }
+        buffer += socket.readAll();
+    }
+}
+
+// One kiosk: a keep-alive connection sending count requests, each after the
+// previous answer. Runs on a pool thread with blocking socket calls.
+static LoadResult runClient(quint16 port, const QByteArray &request, int count) {
+    LoadResult result;
+    QTcpSocket socket;
+    socket.connectToHost(QHostAddress::LocalHost, port);
+    if (!socket.waitForConnected(5000)) {
+        result.failed = count;
+        return result;
+    }
+
+    QByteArray    buffer;
+    QElapsedTimer timer;
+    for (int i = 0; i < count; ++i) {
+        timer.start();
+        socket.write(request);
+        const int status = readResponse(socket, buffer);
+        result.latencies << timer.nsecsElapsed() / 1000;
+        if (status < 0) {
+            result.failed += count - i;
+            break;
+        }
+        if (status == 200 || status == 201) {
+            ++result.ok;
+        } else {
+            ++result.failed;
+        }
+    }
+    return result;
+}
+
+static QByteArray httpRequest(const QByteArray &method, const QByteArray &path,
+                              const QByteArray &body = QByteArray()) {
+    QByteArray request = method + " " + path + " HTTP/1.1\r\nHost: localhost\r\n";
+    if (!body.isEmpty()) {
+        request += "Content-Type: application/json\r\nContent-Length: " +
+                   QByteArray::number(body.size()) + "\r\n";
+    }
+    return request + "\r\n" + body;
+}
+
+// Requests per second and latency of the HTTP API, with 1 and 8 kiosks
+// hammering one endpoint each. The server runs on this thread's event
+// loop as it does in the till; the clients run on their own threads.
+class ApiLoadTest : public QObject {
+    Q_OBJECT
+
+  private slots:
+    void initTestCase();
+    void load_data();
+    void load();
+
+  private:
+    ApiServer *server = nullptr;
+    QString    barcode;
+    QList<int> productIds;
+};
+
+void ApiLoadTest::initTestCase() {
+    QString error;
+    if (!TestDatabase::open(&error)) { QSKIP(qPrintable(error)); }
+
+    QSqlQuery query("SELECT ProductID, Barcode FROM products "
+                    "WHERE status = 'Available' AND UnitType = 'unit' AND Barcode IS NOT NULL "
+                    "ORDER BY StockQuantity DESC LIMIT 5");
+    while (query.next()) {
+        productIds << query.value(0).toInt();
+        barcode = query.value(1).toString();
+    }
+    QCOMPARE(productIds.size(), 5);
+
+    QVERIFY(query.exec("SELECT MIN(UserID) FROM users") && query.next());
+    server = new ApiServer(query.value(0).toInt(), this);
+    QVERIFY(server->listen(QHostAddress::LocalHost, 0));
+}
+
+void ApiLoadTest::load_data() {
+    QTest::addColumn<QByteArray>("request");
+    QTest::addColumn<int>("clients");
+    QTest::addColumn<int>("requestsPerClient");
+
+    QByteArray lines;
+    for (int productId : productIds) {
+        lines += (lines.isEmpty() ? "" : ", ") +
+                 QByteArray("{\"productId\": ") + QByteArray::number(productId) +
+                 ", \"quantity\": 2}";
+    }
+    const QByteArray cart = "{\"lines\": [" + lines + "]}";
+
+    QByteArray batch;
+    for (int i = 0; i < 10; ++i) {
+        batch += (batch.isEmpty() ? "" : ", ") +
+                 QByteArray("{\"method\": \"POST\", \"path\": \"/api/cart/price\", \"body\": ") +
+                 cart + "}";
+    }
+
+    const QList<QPair<QByteArray, QPair<QByteArray, int>>> endpoints = {
+        {"health", {httpRequest("GET", "/api/health"), 2000}},
+        {"product by barcode",
+         {httpRequest("GET", "/api/products?barcode=" + barcode.toUtf8()), 2000}},
+        {"whole catalog", {httpRequest("GET", "/api/products"), 50}},
+        {"price cart", {httpRequest("POST", "/api/cart/price", cart), 1000}},
+        {"batch of 10 prices", {httpRequest("POST", "/api/batch", "[" + batch + "]"), 200}},
+        {"submit order", {httpRequest("POST", "/api/orders", cart), 50}},
+    };
+    for (const auto &endpoint : endpoints) {
+        for (int clients : {1, 8}) {
+            QTest::addRow("%s, %d clients", endpoint.first.constData(), clients)
+                << endpoint.second.first << clients << endpoint.second.second / clients;
+        }
+    }
+}
+
+void ApiLoadTest::load() {
+    QFETCH(QByteArray, request);
+    QFETCH(int, clients);
+    QFETCH(int, requestsPerClient);
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(clients);
+    const quint16 port = server->port();
+
+    QElapsedTimer timer;
+    timer.start();
+    QFutureWatcher<LoadResult> watcher;
+    QEventLoop                 loop;
+    connect(&watcher, &QFutureWatcherBase::finished, &loop, &QEventLoop::quit);
+    watcher.setFuture(QtConcurrent::mapped(&pool, QVector<int>(clients), [=](int) {
+        return runClient(port, request, requestsPerClient);
+    }));
+    loop.exec();
+    const qint64 elapsed = timer.elapsed();
+
+    LoadResult total;
+    for (const LoadResult &client : watcher.future().results()) {
+        total.ok += client.ok;
+        total.failed += client.failed;
+        total.latencies += client.latencies;
+    }
+    QVERIFY(!total.latencies.isEmpty());
+    std::sort(total.latencies.begin(), total.latencies.end());
+    auto percentile = [&total](int p) {
+        return total.latencies.at((total.latencies.size() - 1) * p / 100) / 1000.0;
+    };
+
+    const int requests = total.ok + total.failed;
+    qInfo("%d requests in %lld ms: %.0f requests/s, latency p50 %.2f ms, p99 %.2f ms, "
+          "max %.2f ms",
+          requests, elapsed, requests * 1000.0 / qMax<qint64>(1, elapsed), percentile(50),
+          percentile(99), percentile(100));
+    QTest::setBenchmarkResult(qreal(elapsed) / requests, QTest::WalltimeMilliseconds);
+    QCOMPARE(total.failed, 0);
+}
+
+BAKERYPOS_TEST(ApiLoadTest)
+
+#include "bench_apiload.moc"
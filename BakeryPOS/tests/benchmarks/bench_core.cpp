@@ -0,0 +1,179 @@
+#include "CatalogSearchProxyModel.h"
+#include "CheckoutService.h"
+#include "InventoryMonitor.h"
+#include "LiveQueryModel.h"
+#include "OrderLineStore.h"
+#include "ProductRecord.h"
+#include "SalesHistory.h"
+#include "TestDatabase.h"
+#include "TestSuite.h"
+
+#include <QHeaderView>
+#include <QPixmap>
+#include <QSqlQuery>
+#include <QTableView>
+#include <QTest>
+
+// The register's everyday paths over the seeded database: loading,
+// searching and drawing the catalog table, pricing a cart, checking it out
+// and the analytics page's scans.
+class CoreBenchmark : public QObject {
+    Q_OBJECT
+
+  private slots:
+    void initTestCase();
+    void loadCatalogTable();
+    void searchCatalog_data();
+    void searchCatalog();
+    void renderCatalogTable_data();
+    void renderCatalogTable();
+    void priceCart();
+    void checkout();
+    void salesSeries();
+    void categoryScan();
+
+  private:
+    QString               catalogQuery;
+    QVector<CheckoutLine> cart;
+    int                   userId = 0;
+    PricingEngine         pricing;
+    OrderLineStore        store;
+    SalesHistory          history;
+    InventoryMonitor      monitor;
+};
+
+void CoreBenchmark::initTestCase() {
+    QString error;
+    if (!TestDatabase::open(&error)) { QSKIP(qPrintable(error)); }
+
+    // The cashier page's catalog (CashierForm::reloadProducts)
+    catalogQuery = QString("SELECT ProductID, Name, Category, %1 AS Price, UnitType, "
+                           "StockQuantity, Barcode FROM products "
+                           "WHERE status = 'Available' ORDER BY Name")
+                       .arg(ProductRecord::SellingPriceSql);
+
+    // A ten line basket
+    QSqlQuery query("SELECT ProductID, Category, PricePerUnit FROM products "
+                    "WHERE UnitType = 'unit' ORDER BY ProductID LIMIT 10");
+    while (query.next()) {
+        CheckoutLine line;
+        line.productId     = query.value(0).toInt();
+        line.category      = query.value(1).toString();
+        line.unitPrice     = Money::fromVariant(query.value(2));
+        line.quantityMilli = 1000;
+        cart << line;
+    }
+    QVERIFY(query.exec("SELECT MIN(UserID) FROM users") && query.next());
+    userId = query.value(0).toInt();
+
+    QVERIFY(pricing.load());
+    QVERIFY(store.refresh());
+    QVERIFY(history.refresh());
+    QVERIFY(monitor.load());
+}
+
+void CoreBenchmark::loadCatalogTable() {
+    LiveQueryModel model;
+    QBENCHMARK { model.setQuery(catalogQuery, "ProductID"); }
+    QVERIFY(model.rowCount() >= TestDatabase::plan().products);
+}
+
+void CoreBenchmark::searchCatalog_data() {
+    QTest::addColumn<QString>("text");
+    QTest::newRow("flavor") << "Almond";
+    QTest::newRow("category") << "Sweet";
+    QTest::newRow("rare") << "Pistachio Macaron";
+}
+
+// What typing in the cashier's search box costs: a pass over the
+// in-memory catalog through the cashier's own proxies, no query
+void CoreBenchmark::searchCatalog() {
+    QFETCH(QString, text);
+
+    LiveQueryModel model;
+    model.setQuery(catalogQuery, "ProductID");
+    CatalogStockProxyModel stock(0, 5);
+    stock.setSourceModel(&model);
+    stock.setInventoryMonitor(&monitor);
+    CatalogSearchProxyModel search;
+    search.setSourceModel(&stock);
+
+    QBENCHMARK {
+        search.setSearchText(QString());
+        search.setSearchText(text);
+    }
+    QVERIFY(search.rowCount() > 0);
+}
+
+void CoreBenchmark::renderCatalogTable_data() {
+    QTest::addColumn<bool>("scrolled");
+    QTest::newRow("top") << false;
+    QTest::newRow("bottom") << true;
+}
+
+// Painting a screenful of the cashier's products table, set up as
+// CashierForm does; stock colours and flags come from the monitor
+void CoreBenchmark::renderCatalogTable() {
+    QFETCH(bool, scrolled);
+
+    LiveQueryModel model;
+    model.setQuery(catalogQuery, "ProductID");
+    CatalogStockProxyModel stock(0, 5);
+    stock.setSourceModel(&model);
+    stock.setInventoryMonitor(&monitor);
+    CatalogSearchProxyModel search;
+    search.setSourceModel(&stock);
+
+    QTableView view;
+    view.setSelectionBehavior(QAbstractItemView::SelectRows);
+    view.verticalHeader()->hide();
+    view.setAlternatingRowColors(true);
+    view.setModel(&search);
+    view.hideColumn(0);
+    view.hideColumn(6);
+    view.horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    view.resize(1280, 800);
+    view.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&view));
+    if (scrolled) { view.scrollToBottom(); }
+
+    QPixmap frame;
+    QBENCHMARK { frame = view.viewport()->grab(); }
+    QVERIFY(!frame.isNull());
+}
+
+void CoreBenchmark::priceCart() {
+    QVector<CheckoutLine> lines = cart;
+    CheckoutTotals        totals;
+    QBENCHMARK { totals = CheckoutService::price(pricing, lines); }
+    QVERIFY(!totals.total.isZero());
+}
+
+void CoreBenchmark::checkout() {
+    QVector<CheckoutLine> lines   = cart;
+    CheckoutTotals        totals  = CheckoutService::price(pricing, lines);
+    QString               error;
+    int                   orderId = -1;
+    QBENCHMARK { orderId = CheckoutService::submit(lines, totals, userId, "Cash", &error); }
+    QVERIFY2(orderId > 0, qPrintable(error));
+}
+
+void CoreBenchmark::salesSeries() {
+    const QDateTime from = TestDatabase::firstDay().startOfDay();
+    const QDateTime to   = TestDatabase::lastDay().addDays(1).startOfDay();
+    SalesSeries     series;
+    QBENCHMARK { series = history.series(from, to, SalesHistory::Day); }
+    QVERIFY(series.orders > 0);
+}
+
+void CoreBenchmark::categoryScan() {
+    const QDate        from = TestDatabase::firstDay();
+    const QDate        to   = TestDatabase::lastDay().addDays(1);
+    QVector<LineGroup> groups;
+    QBENCHMARK { groups = store.byCategory(from, to); }
+    QVERIFY(!groups.isEmpty());
+}
+
+BAKERYPOS_TEST(CoreBenchmark)
+
+#include "bench_core.moc"
@@ -0,0 +1,98 @@
+#include "ProductTransfer.h"
+#include "TestDatabase.h"
+#include "TestSuite.h"
+
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTest>
+#include <QTextStream>
+
+static const int ImportRows = 100000;
+
+// Bulk import and export of 100k products. The rows are their own
+// products, kept off the tills by their status; the first run inserts
+// them and later runs time the update path of the same upsert.
+class ImportBenchmark : public QObject {
+    Q_OBJECT
+
+  private slots:
+    void initTestCase();
+    void importFile_data();
+    void importFile();
+    void exportFile();
+
+  private:
+    QTemporaryDir directory;
+
+    QString path(const QString &name) const { return directory.filePath(name); }
+};
+
+void ImportBenchmark::initTestCase() {
+    QString error;
+    if (!TestDatabase::open(&error)) { QSKIP(qPrintable(error)); }
+    QVERIFY(directory.isValid());
+
+    // The same rows as CSV and as a JSON array, written line by line
+    QFile csvFile(path("products.csv"));
+    QFile jsonFile(path("products.json"));
+    QVERIFY(csvFile.open(QIODevice::WriteOnly | QIODevice::Text));
+    QVERIFY(jsonFile.open(QIODevice::WriteOnly | QIODevice::Text));
+    QTextStream csv(&csvFile);
+    QTextStream json(&jsonFile);
+
+    csv << "Name,Category,PricePerKg,PricePerUnit,StockQuantity,UnitType,status\n";
+    json << "[\n";
+    for (int i = 1; i <= ImportRows; ++i) {
+        const QString name     = QString("Import Benchmark %1").arg(i, 6, 10, QChar('0'));
+        const bool    weighed  = i % 10 == 0;
+        const QString price    = QString::number(1 + i % 40) + ".50";
+        const QString perKg    = weighed ? price : QString();
+        const QString perUnit  = weighed ? QString() : price;
+        const QString stock    = QString::number(i % 500);
+        const QString unitType = weighed ? "kg" : "unit";
+
+        csv << name << ",Bread," << perKg << ',' << perUnit << ',' << stock << ',' << unitType
+            << ",Benchmark\n";
+        json << "{\"Name\": \"" << name << "\", \"Category\": \"Bread\", \"PricePerKg\": \""
+             << perKg << "\", \"PricePerUnit\": \"" << perUnit << "\", \"StockQuantity\": \""
+             << stock << "\", \"UnitType\": \"" << unitType << "\", \"status\": \"Benchmark\"}"
+             << (i < ImportRows ? ",\n" : "\n");
+    }
+    json << "]\n";
+}
+
+void ImportBenchmark::importFile_data() {
+    QTest::addColumn<QString>("file");
+    QTest::addColumn<int>("batchSize");
+
+    QTest::newRow("csv, 100 rows a batch") << "products.csv" << 100;
+    QTest::newRow("csv, 500 rows a batch") << "products.csv" << 500;
+    QTest::newRow("csv, 2000 rows a batch") << "products.csv" << 2000;
+    QTest::newRow("json array, 500 rows a batch") << "products.json" << 500;
+}
+
+void ImportBenchmark::importFile() {
+    QFETCH(QString, file);
+    QFETCH(int, batchSize);
+
+    ProductImporter         importer;
+    ProductImporter::Result result;
+    importer.setBatchSize(batchSize);
+    QBENCHMARK_ONCE { result = importer.importFile(path(file)); }
+
+    QVERIFY2(result.error.isEmpty(), qPrintable(result.error));
+    QCOMPARE(result.rejected, 0);
+    QCOMPARE(result.imported, ImportRows);
+}
+
+void ImportBenchmark::exportFile() {
+    ProductExporter exporter;
+    QString         error;
+    int             rows = -1;
+    QBENCHMARK_ONCE { rows = exporter.exportFile(path("export.csv"), &error); }
+    QVERIFY2(rows >= ImportRows, qPrintable(error));
+}
+
+BAKERYPOS_TEST(ImportBenchmark)
+
+#include "bench_import.moc"
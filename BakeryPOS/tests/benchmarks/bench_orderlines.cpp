@@ -0,0 +1,162 @@
+#include "OrderLineStore.h"
+#include "ProductRanking.h"
+#include "TestDatabase.h"
+#include "TestSuite.h"
+
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QTest>
+
+// The analytics page's aggregations two ways: scans over the columnar
+// OrderLineStore and the SQL the page runs without it (AnalyticsForm::
+// loadRanking and loadCategoryData). Each is timed over the last month
+// and the last year of seeded orders.
+class OrderLineBenchmark : public QObject {
+    Q_OBJECT
+
+  private slots:
+    void initTestCase();
+    void load();
+    void productRanking_data() { ranges(); }
+    void productRanking();
+    void categoryOrders_data() { ranges(); }
+    void categoryOrders();
+    void revenue_data() { ranges(); }
+    void revenue();
+
+  private:
+    OrderLineStore store;
+
+    void ranges();
+    bool exec(QSqlQuery &query, const QString &sql, const QDate &from, const QDate &to);
+};
+
+void OrderLineBenchmark::initTestCase() {
+    QString error;
+    if (!TestDatabase::open(&error)) { QSKIP(qPrintable(error)); }
+    QVERIFY(store.refresh());
+}
+
+void OrderLineBenchmark::ranges() {
+    QTest::addColumn<bool>("columnar");
+    QTest::addColumn<int>("days");
+
+    QTest::newRow("columnar, month") << true << 30;
+    QTest::newRow("sql, month") << false << 30;
+    QTest::newRow("columnar, year") << true << 365;
+    QTest::newRow("sql, year") << false << 365;
+}
+
+bool OrderLineBenchmark::exec(QSqlQuery &query, const QString &sql, const QDate &from,
+                              const QDate &to) {
+    query.setForwardOnly(true);
+    query.prepare(sql);
+    query.bindValue(0, from.startOfDay());
+    query.bindValue(1, to.startOfDay());
+    return query.exec();
+}
+
+// The one-off cost the columnar scans are paid for with
+void OrderLineBenchmark::load() {
+    int lines = 0;
+    QBENCHMARK_ONCE {
+        OrderLineStore fresh;
+        fresh.refresh();
+        lines = fresh.lineCount();
+    }
+    QCOMPARE(lines, store.lineCount());
+}
+
+void OrderLineBenchmark::productRanking() {
+    QFETCH(bool, columnar);
+    QFETCH(int, days);
+    const QDate to   = TestDatabase::lastDay().addDays(1);
+    const QDate from = to.addDays(-days);
+
+    ProductRanking ranking;
+    if (columnar) {
+        QBENCHMARK {
+            ranking = ProductRanking();
+            for (const LineGroup &product : store.byProduct(from, to)) {
+                ranking.add(product, store.productCategory(product.code));
+            }
+        }
+    } else {
+        QSqlQuery query;
+        QBENCHMARK {
+            ranking = ProductRanking();
+            QVERIFY2(exec(query,
+                          "SELECT p.Name, p.Category, SUM(od.Quantity), "
+                          "SUM(od.Quantity * od.Price - od.Discount) "
+                          "FROM OrderDetails od JOIN Orders o ON od.OrderID = o.OrderID "
+                          "JOIN products p ON od.ProductID = p.ProductID "
+                          "WHERE o.OrderDate >= ? AND o.OrderDate < ? "
+                          "GROUP BY p.ProductID, p.Name, p.Category",
+                          from, to),
+                     qPrintable(query.lastError().text()));
+            while (query.next()) {
+                LineGroup product;
+                product.name          = query.value(0).toString();
+                product.quantityMilli = quantityToMilli(query.value(2).toDouble());
+                product.revenue       = Money::fromVariant(query.value(3));
+                ranking.add(product, query.value(1).toString());
+            }
+        }
+    }
+    QVERIFY(ranking.products > 0);
+}
+
+void OrderLineBenchmark::categoryOrders() {
+    QFETCH(bool, columnar);
+    QFETCH(int, days);
+    const QDate to   = TestDatabase::lastDay().addDays(1);
+    const QDate from = to.addDays(-days);
+
+    int categories = 0;
+    if (columnar) {
+        QBENCHMARK { categories = store.byCategory(from, to).size(); }
+    } else {
+        QSqlQuery query;
+        QBENCHMARK {
+            categories = 0;
+            QVERIFY2(exec(query,
+                          "SELECT p.Category, COUNT(DISTINCT o.OrderID) "
+                          "FROM OrderDetails od JOIN Orders o ON o.OrderID = od.OrderID "
+                          "JOIN products p ON p.ProductID = od.ProductID "
+                          "WHERE o.OrderDate >= ? AND o.OrderDate < ? GROUP BY p.Category",
+                          from, to),
+                     qPrintable(query.lastError().text()));
+            while (query.next()) { ++categories; }
+        }
+    }
+    QVERIFY(categories > 0);
+}
+
+void OrderLineBenchmark::revenue() {
+    QFETCH(bool, columnar);
+    QFETCH(int, days);
+    const QDate to   = TestDatabase::lastDay().addDays(1);
+    const QDate from = to.addDays(-days);
+
+    Money total;
+    if (columnar) {
+        QBENCHMARK { total = store.revenue(from, to); }
+    } else {
+        QSqlQuery query;
+        QBENCHMARK {
+            QVERIFY2(exec(query,
+                          "SELECT SUM(ROUND(od.Quantity * od.Price, 2) - od.Discount) "
+                          "FROM OrderDetails od JOIN Orders o ON o.OrderID = od.OrderID "
+                          "WHERE o.OrderDate >= ? AND o.OrderDate < ?",
+                          from, to) &&
+                         query.next(),
+                     qPrintable(query.lastError().text()));
+            total = Money::fromVariant(query.value(0));
+        }
+    }
+    QVERIFY(!total.isZero());
+}
+
+BAKERYPOS_TEST(OrderLineBenchmark)
+
+#include "bench_orderlines.moc"
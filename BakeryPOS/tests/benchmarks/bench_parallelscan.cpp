@@ -0,0 +1,69 @@
+#include "OrderLineStore.h"
+#include "TestDatabase.h"
+#include "TestSuite.h"
+
+#include <QTest>
+#include <QThread>
+
+// Throughput of the analytics scans against the number of threads, from
+// one up to twice the cores. The partitions are made small enough that
+// every thread has work on the seeded year; lines per second are the
+// store's line count over the time reported.
+class ParallelScanBenchmark : public QObject {
+    Q_OBJECT
+
+  private slots:
+    void initTestCase();
+    void byProduct_data() { threadCounts(); }
+    void byProduct();
+    void byCategory_data() { threadCounts(); }
+    void byCategory();
+
+  private:
+    OrderLineStore store;
+
+    void threadCounts();
+};
+
+void ParallelScanBenchmark::initTestCase() {
+    QString error;
+    if (!TestDatabase::open(&error)) { QSKIP(qPrintable(error)); }
+    QVERIFY(store.refresh());
+    store.setPartitioning(0, 8192);
+    qInfo("%d order lines, %d cores", store.lineCount(), QThread::idealThreadCount());
+}
+
+void ParallelScanBenchmark::threadCounts() {
+    QTest::addColumn<int>("threads");
+    const int cores = QThread::idealThreadCount();
+    for (int threads = 1; threads < 2 * cores; threads *= 2) {
+        QTest::addRow("%d threads", threads) << threads;
+    }
+    QTest::addRow("%d threads", 2 * cores) << 2 * cores;
+}
+
+void ParallelScanBenchmark::byProduct() {
+    QFETCH(int, threads);
+    store.setMaxThreads(threads);
+
+    const QDate        from = TestDatabase::firstDay();
+    const QDate        to   = TestDatabase::lastDay().addDays(1);
+    QVector<LineGroup> groups;
+    QBENCHMARK { groups = store.byProduct(from, to); }
+    QVERIFY(!groups.isEmpty());
+}
+
+void ParallelScanBenchmark::byCategory() {
+    QFETCH(int, threads);
+    store.setMaxThreads(threads);
+
+    const QDate        from = TestDatabase::firstDay();
+    const QDate        to   = TestDatabase::lastDay().addDays(1);
+    QVector<LineGroup> groups;
+    QBENCHMARK { groups = store.byCategory(from, to); }
+    QVERIFY(!groups.isEmpty());
+}
+
+BAKERYPOS_TEST(ParallelScanBenchmark)
+
+#include "bench_parallelscan.moc"
@@ -0,0 +1,114 @@
+#include "CheckoutService.h"
+#include "PricingEngine.h"
+#include "TestSuite.h"
+
+#include <QRandomGenerator>
+#include <QTest>
+
+static const QStringList Categories = {"Bread", "Pastry", "Cake",    "Cookie",
+                                       "Sweet", "Savory", "Beverage"};
+static const int         Products   = 10000;
+
+// Made-up promotions for a 10k product catalog: most tied to a product,
+// some to a category and a few store-wide, half of them time windowed
+static QVector<PromotionRule> promotions(int count) {
+    QRandomGenerator       random(45);
+    QVector<PromotionRule> rules;
+    for (int i = 1; i <= count; ++i) {
+        PromotionRule rule;
+        rule.id   = i;
+        rule.name = QString("Promotion %1").arg(i);
+        int scope = random.bounded(100);
+        if (scope < 70) {
+            rule.productId = 1 + random.bounded(Products);
+        } else if (scope < 95) {
+            rule.category = Categories.at(random.bounded(Categories.size()));
+        }
+        if (random.bounded(2)) {
+            rule.kind                = PromotionRule::Bundle;
+            rule.bundleQuantityMilli = 1000 * (2 + random.bounded(4));
+            rule.bundlePrice         = Money::fromCents(100 + random.bounded(900));
+        } else {
+            rule.percentOff = 500 + random.bounded(4500);
+        }
+        if (random.bounded(2)) {
+            rule.startMinute = 60 * (6 + random.bounded(14));
+            rule.endMinute   = rule.startMinute + 120;
+        }
+        rules << rule;
+    }
+    return rules;
+}
+
+// Pricing one scanned line, and repricing a whole cart, against hundreds
+// of active promotions. The engine compiles them by product and category,
+// so the cost should barely move from 0 to 1000 rules.
+class PricingBenchmark : public QObject {
+    Q_OBJECT
+
+  private slots:
+    void priceLine_data() { ruleCounts(); }
+    void priceLine();
+    void priceCart_data() { ruleCounts(); }
+    void priceCart();
+    void compile_data() { ruleCounts(); }
+    void compile();
+
+  private:
+    void ruleCounts();
+};
+
+void PricingBenchmark::ruleCounts() {
+    QTest::addColumn<int>("rules");
+    for (int rules : {0, 10, 100, 500, 1000}) { QTest::addRow("%d rules", rules) << rules; }
+}
+
+// One scan: the line for a product with its own promotions
+void PricingBenchmark::priceLine() {
+    QFETCH(int, rules);
+    const QVector<PromotionRule> active = promotions(rules);
+    PricingEngine                pricing;
+    pricing.setRules(active, QDate(2025, 6, 1));
+
+    const int productId = active.isEmpty() ? 1 : qMax(1, active.first().productId);
+    LinePrice price;
+    QBENCHMARK {
+        price = pricing.price(productId, "Bread", Money::fromCents(350), 3000, 17 * 60);
+    }
+    QVERIFY(!price.gross.isZero());
+}
+
+// A 30 line cart, repriced in full as on a resume or a clock tick
+void PricingBenchmark::priceCart() {
+    QFETCH(int, rules);
+    PricingEngine pricing;
+    pricing.setRules(promotions(rules), QDate(2025, 6, 1));
+    pricing.setTaxRates({{"Beverage", 500}});
+
+    QVector<CheckoutLine> lines;
+    for (int i = 0; i < 30; ++i) {
+        CheckoutLine line;
+        line.productId     = 1 + (i * 331) % Products;
+        line.category      = Categories.at(i % Categories.size());
+        line.unitPrice     = Money::fromCents(150 + 25 * i);
+        line.quantityMilli = 1000 + 250 * (i % 5);
+        lines << line;
+    }
+
+    CheckoutTotals totals;
+    QBENCHMARK { totals = CheckoutService::price(pricing, lines, 17 * 60); }
+    QVERIFY(!totals.total.isZero());
+}
+
+// What a promotions edit costs the till
+void PricingBenchmark::compile() {
+    QFETCH(int, rules);
+    const QVector<PromotionRule> active = promotions(rules);
+    PricingEngine                pricing;
+    QBENCHMARK { pricing.setRules(active, QDate(2025, 6, 1)); }
+    QCOMPARE(pricing.ruleCount(), rules);
+}
+
+BAKERYPOS_TEST(PricingBenchmark)
+
+#include "bench_pricing.moc"
@@ -0,0 +1,141 @@
+#include "BarcodeScanner.h"
+#include "LiveQueryModel.h"
+#include "TestDatabase.h"
+#include "TestSuite.h"
+
+#include <QKeyEvent>
+#include <QLineEdit>
+#include <QTest>
+#include <QVBoxLayout>
+#include <QWidget>
+
+static const int ScansPerRound = 1000;
+
+// 12 digits plus their EAN-13 check digit
+static QString withCheckDigit(const QString &digits) {
+    int sum = 0;
+    for (int i = 0; i < 12; ++i) { sum += digits.at(i).digitValue() * (i % 2 ? 3 : 1); }
+    return digits + QString::number((10 - sum % 10) % 10);
+}
+
+// Scan to product: the index lookup alone, then the whole keyboard-wedge
+// path from key presses to scanned(). Each round is 1000 scans, so scans
+// per second are a million over the milliseconds reported.
+//
+// Weighed products get a 5 digit PLU from their ID in the catalog query,
+// as stores that print scale labels assign them; the rest scan their
+// barcode.
+class ScanBenchmark : public QObject {
+    Q_OBJECT
+
+  private slots:
+    void initTestCase();
+    void buildIndex();
+    void match_data();
+    void match();
+    void wedgeScan();
+
+  private:
+    LiveQueryModel catalog;
+    BarcodeIndex  *index = nullptr;
+    QStringList    plainCodes;
+    QStringList    weightLabels;
+    QStringList    priceLabels;
+};
+
+void ScanBenchmark::initTestCase() {
+    QString error;
+    if (!TestDatabase::open(&error)) { QSKIP(qPrintable(error)); }
+
+    catalog.setQuery("SELECT ProductID, IF(UnitType = 'kg', LPAD(ProductID % 100000, 5, '0'), "
+                     "Barcode) AS Code, UnitType FROM products WHERE status = 'Available' "
+                     "ORDER BY ProductID",
+                     "ProductID");
+    QVERIFY2(!catalog.lastError().isValid(), qPrintable(catalog.lastError().text()));
+    index = new BarcodeIndex(&catalog, 0, 1, this);
+
+    for (int row = 0; row < catalog.rowCount(); ++row) {
+        const QString code = catalog.index(row, 1).data().toString();
+        if (catalog.index(row, 2).data().toString() == "kg") {
+            weightLabels << withCheckDigit("21" + code + "01250");
+            priceLabels << withCheckDigit("22" + code + "00875");
+        } else if (!code.isEmpty()) {
+            plainCodes << code;
+        }
+    }
+    QVERIFY(!plainCodes.isEmpty());
+    QVERIFY(!weightLabels.isEmpty());
+}
+
+void ScanBenchmark::buildIndex() {
+    int codes = 0;
+    QBENCHMARK_ONCE {
+        BarcodeIndex built(&catalog, 0, 1);
+        codes = built.size();
+    }
+    QCOMPARE(codes, index->size());
+}
+
+void ScanBenchmark::match_data() {
+    QTest::addColumn<int>("kind");
+    QTest::newRow("plain barcode") << int(BarcodeMatch::Plain);
+    QTest::newRow("weight label") << int(BarcodeMatch::Weight);
+    QTest::newRow("price label") << int(BarcodeMatch::Price);
+    QTest::newRow("unknown code") << int(BarcodeMatch::NoMatch);
+}
+
+void ScanBenchmark::match() {
+    QFETCH(int, kind);
+
+    QStringList codes;
+    for (int i = 0; i < ScansPerRound; ++i) {
+        switch (kind) {
+        case BarcodeMatch::Plain: codes << plainCodes.at(i % plainCodes.size()); break;
+        case BarcodeMatch::Weight: codes << weightLabels.at(i % weightLabels.size()); break;
+        case BarcodeMatch::Price: codes << priceLabels.at(i % priceLabels.size()); break;
+        default: codes << withCheckDigit(QString::number(990000000000LL + i)); break;
+        }
+    }
+
+    int matched = 0;
+    QBENCHMARK {
+        matched = 0;
+        for (const QString &code : codes) { matched += index->match(code).kind == kind; }
+    }
+    QCOMPARE(matched, ScansPerRound);
+}
+
+// Key presses into a focused line edit on the page, as the scanner types
+// them, through to the product
+void ScanBenchmark::wedgeScan() {
+    QWidget    page;
+    QLineEdit *searchBox = new QLineEdit(&page);
+    (new QVBoxLayout(&page))->addWidget(searchBox);
+    page.show();
+
+    BarcodeWedgeFilter filter(&page);
+    int                found = 0;
+    connect(&filter, &BarcodeWedgeFilter::scanned, this,
+            [this, &found](const QString &code) { found += index->match(code).isValid(); });
+
+    auto type = [searchBox](const QString &code) {
+        for (QChar c : code) {
+            QKeyEvent press(QEvent::KeyPress, Qt::Key_0 + c.digitValue(), Qt::NoModifier,
+                            QString(c));
+            QCoreApplication::sendEvent(searchBox, &press);
+        }
+        QKeyEvent enter(QEvent::KeyPress, Qt::Key_Return, Qt::NoModifier);
+        QCoreApplication::sendEvent(searchBox, &enter);
+    };
+
+    QBENCHMARK {
+        found = 0;
+        for (int i = 0; i < ScansPerRound; ++i) { type(plainCodes.at(i % plainCodes.size())); }
+    }
+    QCOMPARE(found, ScansPerRound);
+    QVERIFY(searchBox->text().isEmpty()); // no scanned digit reached the widget
+}
+
+BAKERYPOS_TEST(ScanBenchmark)
+
+#include "bench_scan.moc"
@@ -0,0 +1,28 @@
+# QBENCHMARK timings; run tst_benchmarks with a class name to time one
+# area, and with -iterations N or -callgrind as for any QTest binary
+TARGET = tst_benchmarks
+
+# The scan benchmark types into a widget through the wedge filter, the
+# core benchmark paints the cashier's products table and the API load
+# test runs the till's HTTP server
+QT += widgets
+
+include(../tests.pri)
+
+SOURCES += \
+    bench_apiload.cpp \
+    bench_core.cpp \
+    bench_import.cpp \
+    bench_orderlines.cpp \
+    bench_parallelscan.cpp \
+    bench_pricing.cpp \
+    bench_scan.cpp \
+    main.cpp \
+    ../../ApiServer.cpp \
+    ../../BarcodeScanner.cpp \
+    ../../InventoryMonitor.cpp
+
+HEADERS += \
+    ../../ApiServer.h \
+    ../../BarcodeScanner.h \
+    ../../InventoryMonitor.h
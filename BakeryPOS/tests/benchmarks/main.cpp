@@ -0,0 +1,12 @@
+#include "TestSuite.h"
+
+#include <QApplication>
+
+int main(int argc, char *argv[]) {
+    // The widgets the benchmarks type into and paint need no screen
+    if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication App(argc, argv);
+    return TestSuite::run(argc, argv);
+}
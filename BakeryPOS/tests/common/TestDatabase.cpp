@@ -0,0 +1,61 @@
+#include "TestDatabase.h"
+
+#include "SchemaMigrator.h"
+
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QTextStream>
+
+static QString setting(const char *name, const QString &fallback) {
+    QString value = qEnvironmentVariable(name);
+    return value.isEmpty() ? fallback : value;
+}
+
+// Returns the reason the database cannot be used, or an empty string
+static QString openAndSeed() {
+    QSqlDatabase db = QSqlDatabase::addDatabase("QMYSQL");
+    db.setHostName(setting("BAKERYPOS_TEST_HOST", "localhost"));
+    db.setPort(setting("BAKERYPOS_TEST_PORT", "3306").toInt());
+    db.setDatabaseName(setting("BAKERYPOS_TEST_DATABASE", "bakerypos_test"));
+    db.setUserName(setting("BAKERYPOS_TEST_USER", "root"));
+    db.setPassword(qEnvironmentVariable("BAKERYPOS_TEST_PASSWORD"));
+    if (!db.open()) { return "No test database: " + db.lastError().text(); }
+
+    QString error;
+    if (!SchemaMigrator::migrate(db, &error)) { return "Migration failed: " + error; }
+
+    QSqlQuery query(db);
+    if (!query.exec("SELECT EXISTS (SELECT 1 FROM Orders)") || !query.next()) {
+        return "Cannot read Orders: " + query.lastError().text();
+    }
+    if (query.value(0).toBool()) { return QString(); } // seeded by an earlier run
+
+    QTextStream log(stdout);
+    log << "Seeding " << db.databaseName() << " for the tests" << Qt::endl;
+    DataSeeder seeder(TestDatabase::plan(), log);
+    if (!seeder.run(&error)) { return "Seeding failed: " + error; }
+    return QString();
+}
+
+SeedPlan TestDatabase::plan() {
+    SeedPlan plan;
+    plan.seed         = 49;
+    plan.products     = 10000;
+    plan.users        = 12;
+    plan.years        = 1;
+    plan.ordersPerDay = 200;
+    plan.lastDay      = QDate(2025, 12, 31);
+    return plan;
+}
+
+bool TestDatabase::open(QString *error) {
+    static bool    tried = false;
+    static QString failure;
+    if (!tried) {
+        tried   = true;
+        failure = openAndSeed();
+    }
+    if (error) { *error = failure; }
+    return failure.isEmpty();
+}
@@ -0,0 +1,35 @@
+#ifndef TESTDATABASE_H
+#define TESTDATABASE_H
+
+#include <QDate>
+#include <QString>
+
+#include "DataSeeder.h"
+
+// The database behind the tests and benchmarks that need one.
+//
+// It is MySQL, like the tills': the migrations use GET_LOCK, ON DUPLICATE
+// KEY UPDATE, partitioned tables and MySQL date functions, so SQLite
+// cannot stand in for it. The connection comes from BAKERYPOS_TEST_HOST,
+// BAKERYPOS_TEST_PORT, BAKERYPOS_TEST_DATABASE (bakerypos_test by default),
+// BAKERYPOS_TEST_USER and BAKERYPOS_TEST_PASSWORD. The tests add orders and
+// change stock, so never point it at a till's database.
+//
+// open() migrates the database and, if it has no orders yet, seeds it with
+// plan(). The plan is fixed, so every machine measures the same catalog
+// and the same year of orders; orders the tests submit are dated today,
+// after the seeded year.
+class TestDatabase {
+  public:
+    static SeedPlan plan();
+
+    // Seeded orders fall on [firstDay(), lastDay()]
+    static QDate firstDay() { return plan().lastDay.addYears(-plan().years).addDays(1); }
+    static QDate lastDay() { return plan().lastDay; }
+
+    // Opens the default connection, once per process. Returns false with
+    // the reason in error; callers QSKIP with it.
+    static bool open(QString *error = nullptr);
+};
+
+#endif // TESTDATABASE_H
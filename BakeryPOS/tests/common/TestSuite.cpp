@@ -0,0 +1,44 @@
+#include "TestSuite.h"
+
+#include <QByteArray>
+#include <QScopedPointer>
+#include <QTest>
+#include <QVector>
+
+struct Registration {
+    const char        *name;
+    TestSuite::Factory create;
+};
+
+// Filled during static initialisation, so it must exist before first use
+static QVector<Registration> &registrations() {
+    static QVector<Registration> list;
+    return list;
+}
+
+int TestSuite::add(const char *name, Factory create) {
+    registrations().append({name, create});
+    return registrations().size();
+}
+
+int TestSuite::run(int argc, char *argv[]) {
+    QVector<char *> arguments(argv, argv + argc);
+    QByteArray      only;
+    if (arguments.size() > 1 && arguments.at(1)[0] != '-') { only = arguments.takeAt(1); }
+
+    int  failures = 0;
+    bool found    = false;
+    for (const Registration &test : registrations()) {
+        if (!only.isEmpty() && only != test.name) { continue; }
+        found = true;
+
+        QScopedPointer<QObject> object(test.create());
+        failures += QTest::qExec(object.data(), arguments.size(), arguments.data());
+    }
+
+    if (!found) {
+        qWarning("No test class named %s", only.constData());
+        return 1;
+    }
+    return failures;
+}
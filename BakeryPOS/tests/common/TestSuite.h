@@ -0,0 +1,23 @@
+#ifndef TESTSUITE_H
+#define TESTSUITE_H
+
+#include <QObject>
+
+// Runs every test class linked into a target, in the order they were
+// registered. Given a class name as the first argument only that class
+// runs; the remaining arguments go to QTest (-functions, -iterations and
+// so on), e.g. "tst_benchmarks PricingBenchmark -iterations 1000".
+class TestSuite {
+  public:
+    using Factory = QObject *(*)();
+
+    static int add(const char *name, Factory create);
+    static int run(int argc, char *argv[]);
+};
+
+// Adds a QObject test class to its target's suite; use once, in its .cpp
+#define BAKERYPOS_TEST(Class)                                                                  \
+    static const int Class##Registered =                                                       \
+        TestSuite::add(#Class, []() -> QObject * { return new Class; });
+
+#endif // TESTSUITE_H
@@ -0,0 +1,20 @@
+# Shared by the test targets: QTest, the core logic, the data seeder and
+# the helpers in common/.
+QT += testlib
+
+CONFIG += c++17 console testcase
+CONFIG -= app_bundle
+
+include(../core.pri)
+include(../tools/Seeder/seeder.pri)
+
+INCLUDEPATH += $$PWD/common
+DEPENDPATH += $$PWD/common
+
+SOURCES += \
+    $$PWD/common/TestDatabase.cpp \
+    $$PWD/common/TestSuite.cpp
+
+HEADERS += \
+    $$PWD/common/TestDatabase.h \
+    $$PWD/common/TestSuite.h
@@ -0,0 +1,12 @@
+# Unit tests and benchmarks for the logic in core.pri.
+#
+#   unit        tst_unit, run by "make check"
+#   benchmarks  tst_benchmarks, QBENCHMARK timings of the hot paths
+#
+# Tests that need a database use the MySQL database described in
+# common/TestDatabase.h and are skipped when it cannot be opened.
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    unit \
+    benchmarks
@@ -0,0 +1,97 @@
+#include "OrderLineStore.h"
+#include "SalesHistory.h"
+#include "TestDatabase.h"
+#include "TestSuite.h"
+
+#include <QHash>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QTest>
+
+// The in-memory analytics stores against the same sums done in SQL, over
+// the seeded year (orders the other tests submit fall after it)
+class AnalyticsTest : public QObject {
+    Q_OBJECT
+
+  private slots:
+    void initTestCase();
+    void revenueMatchesSql();
+    void categoriesMatchSql();
+    void salesSeriesMatchesOrders();
+
+  private:
+    OrderLineStore store;
+    SalesHistory   history;
+};
+
+void AnalyticsTest::initTestCase() {
+    QString error;
+    if (!TestDatabase::open(&error)) { QSKIP(qPrintable(error)); }
+    QVERIFY(store.refresh());
+    QVERIFY(history.refresh());
+    QVERIFY(store.lineCount() > 0);
+}
+
+void AnalyticsTest::revenueMatchesSql() {
+    const QDate from = TestDatabase::firstDay();
+    const QDate to   = TestDatabase::lastDay().addDays(1);
+
+    QSqlQuery query;
+    query.prepare("SELECT SUM(ROUND(od.Quantity * od.Price, 2) - od.Discount) "
+                  "FROM Orders o JOIN OrderDetails od ON od.OrderID = o.OrderID "
+                  "WHERE o.OrderDate >= ? AND o.OrderDate < ?");
+    query.bindValue(0, from.startOfDay());
+    query.bindValue(1, to.startOfDay());
+    QVERIFY2(query.exec() && query.next(), qPrintable(query.lastError().text()));
+    QCOMPARE(store.revenue(from, to), Money::fromVariant(query.value(0)));
+}
+
+void AnalyticsTest::categoriesMatchSql() {
+    const QDate from(2025, 3, 1);
+    const QDate to(2025, 4, 1);
+
+    QSqlQuery query;
+    query.prepare("SELECT p.Category, COUNT(DISTINCT o.OrderID), "
+                  "SUM(ROUND(od.Quantity * od.Price, 2) - od.Discount) "
+                  "FROM Orders o JOIN OrderDetails od ON od.OrderID = o.OrderID "
+                  "JOIN products p ON p.ProductID = od.ProductID "
+                  "WHERE o.OrderDate >= ? AND o.OrderDate < ? GROUP BY p.Category");
+    query.bindValue(0, from.startOfDay());
+    query.bindValue(1, to.startOfDay());
+    QVERIFY2(query.exec(), qPrintable(query.lastError().text()));
+
+    QHash<QString, QPair<int, Money>> expected;
+    while (query.next()) {
+        expected.insert(query.value(0).toString(),
+                        {query.value(1).toInt(), Money::fromVariant(query.value(2))});
+    }
+
+    const QVector<LineGroup> groups = store.byCategory(from, to);
+    QCOMPARE(groups.size(), expected.size());
+    for (const LineGroup &group : groups) {
+        QVERIFY2(expected.contains(group.name), qPrintable(group.name));
+        QCOMPARE(group.orders, expected.value(group.name).first);
+        QCOMPARE(group.revenue, expected.value(group.name).second);
+    }
+}
+
+void AnalyticsTest::salesSeriesMatchesOrders() {
+    const QDateTime from = TestDatabase::firstDay().startOfDay();
+    const QDateTime to   = TestDatabase::lastDay().addDays(1).startOfDay();
+
+    QSqlQuery query;
+    query.prepare("SELECT COUNT(*), SUM(TotalAmount) FROM Orders "
+                  "WHERE OrderDate >= ? AND OrderDate < ?");
+    query.bindValue(0, from);
+    query.bindValue(1, to);
+    QVERIFY2(query.exec() && query.next(), qPrintable(query.lastError().text()));
+
+    const SalesSeries series = history.series(from, to, SalesHistory::Day);
+    QCOMPARE(series.points.size(), int(from.daysTo(to)));
+    QCOMPARE(series.orders, query.value(0).toInt());
+    QCOMPARE(series.gross(), Money::fromVariant(query.value(1)));
+}
+
+BAKERYPOS_TEST(AnalyticsTest)
+
+#include "tst_analytics.moc"
@@ -0,0 +1,107 @@
+#include "CheckoutService.h"
+#include "TestDatabase.h"
+#include "TestSuite.h"
+
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QTest>
+
+static qint64 stockMilli(int productId) {
+    QSqlQuery query;
+    query.prepare("SELECT StockQuantity FROM products WHERE ProductID = ?");
+    query.bindValue(0, productId);
+    if (!query.exec() || !query.next()) { return -1; }
+    return quantityToMilli(query.value(0).toDouble());
+}
+
+// Orders and net cents over the whole hourly rollup
+static QPair<qint64, qint64> rollupTotals() {
+    QSqlQuery query("SELECT COALESCE(SUM(Orders), 0), COALESCE(SUM(NetCents), 0) "
+                    "FROM sales_hourly");
+    if (!query.next()) { return {-1, -1}; }
+    return {query.value(0).toLongLong(), query.value(1).toLongLong()};
+}
+
+class CheckoutTest : public QObject {
+    Q_OBJECT
+
+  private slots:
+    void initTestCase();
+    void submitWritesOrderLinesStockAndRollup();
+    void emptyOrderIsRejected();
+
+  private:
+    QVector<CheckoutLine> cart;
+    int                   userId = 0;
+};
+
+void CheckoutTest::initTestCase() {
+    QString error;
+    if (!TestDatabase::open(&error)) { QSKIP(qPrintable(error)); }
+
+    QSqlQuery query;
+    QVERIFY2(query.exec("SELECT ProductID, Category, PricePerUnit FROM products "
+                        "WHERE UnitType = 'unit' AND status = 'Available' "
+                        "ORDER BY ProductID LIMIT 2"),
+             qPrintable(query.lastError().text()));
+    qint64 quantityMilli = 2000;
+    while (query.next()) {
+        CheckoutLine line;
+        line.productId     = query.value(0).toInt();
+        line.category      = query.value(1).toString();
+        line.unitPrice     = Money::fromVariant(query.value(2));
+        line.quantityMilli = quantityMilli;
+        cart << line;
+        quantityMilli -= 1000;
+    }
+    QCOMPARE(cart.size(), 2);
+
+    QVERIFY(query.exec("SELECT MIN(UserID) FROM users") && query.next());
+    userId = query.value(0).toInt();
+}
+
+void CheckoutTest::submitWritesOrderLinesStockAndRollup() {
+    PricingEngine         pricing;
+    QVector<CheckoutLine> lines  = cart;
+    CheckoutTotals        totals = CheckoutService::price(pricing, lines);
+
+    const qint64                stockBefore0 = stockMilli(lines.at(0).productId);
+    const qint64                stockBefore1 = stockMilli(lines.at(1).productId);
+    const QPair<qint64, qint64> rollupBefore = rollupTotals();
+
+    QString error;
+    int     orderId = CheckoutService::submit(lines, totals, userId, "Cash", &error);
+    QVERIFY2(orderId > 0, qPrintable(error));
+
+    QSqlQuery query;
+    query.prepare("SELECT TotalAmount, UserID, payment_method FROM Orders WHERE OrderID = ?");
+    query.bindValue(0, orderId);
+    QVERIFY(query.exec() && query.next());
+    QCOMPARE(Money::fromVariant(query.value(0)), totals.total);
+    QCOMPARE(query.value(1).toInt(), userId);
+    QCOMPARE(query.value(2).toString(), QString("Cash"));
+
+    query.prepare("SELECT COUNT(*), SUM(ROUND(Quantity * Price, 2) - Discount) "
+                  "FROM OrderDetails WHERE OrderID = ?");
+    query.bindValue(0, orderId);
+    QVERIFY(query.exec() && query.next());
+    QCOMPARE(query.value(0).toInt(), 2);
+    QCOMPARE(Money::fromVariant(query.value(1)), totals.subtotal);
+
+    QCOMPARE(stockMilli(lines.at(0).productId), stockBefore0 - 2000);
+    QCOMPARE(stockMilli(lines.at(1).productId), stockBefore1 - 1000);
+
+    const QPair<qint64, qint64> rollupAfter = rollupTotals();
+    QCOMPARE(rollupAfter.first, rollupBefore.first + 1);
+    QCOMPARE(rollupAfter.second, rollupBefore.second + totals.subtotal.cents());
+}
+
+void CheckoutTest::emptyOrderIsRejected() {
+    QString error;
+    QCOMPARE(CheckoutService::submit({}, CheckoutTotals(), userId, "Cash", &error), -1);
+    QVERIFY(!error.isEmpty());
+}
+
+BAKERYPOS_TEST(CheckoutTest)
+
+#include "tst_checkout.moc"
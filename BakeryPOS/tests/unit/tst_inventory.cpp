@@ -0,0 +1,104 @@
+#include "InventoryMonitor.h"
+#include "LiveQueryModel.h"
+#include "TestDatabase.h"
+#include "TestSuite.h"
+
+#include <QBrush>
+#include <QSignalSpy>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QTest>
+
+static bool renameProduct(int productId, const QString &name) {
+    QSqlQuery query;
+    query.prepare("UPDATE products SET Name = ? WHERE ProductID = ?");
+    query.bindValue(0, name);
+    query.bindValue(1, productId);
+    return query.exec();
+}
+
+class InventoryTest : public QObject {
+    Q_OBJECT
+
+  private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void stockHighlightFollowsMovedRow();
+
+  private:
+    QList<int>          productIds;
+    QHash<int, QString> originalNames;
+};
+
+void InventoryTest::initTestCase() {
+    QString error;
+    if (!TestDatabase::open(&error)) { QSKIP(qPrintable(error)); }
+
+    QSqlQuery query;
+    QVERIFY2(query.exec("SELECT ProductID, Name FROM products WHERE status = 'Available' "
+                        "ORDER BY ProductID LIMIT 3"),
+             qPrintable(query.lastError().text()));
+    while (query.next()) {
+        productIds << query.value(0).toInt();
+        originalNames.insert(query.value(0).toInt(), query.value(1).toString());
+    }
+    QCOMPARE(productIds.size(), 3);
+
+    // Known names, so the test controls the sort order
+    const QStringList names = {"~proxy test a", "~proxy test b", "~proxy test c"};
+    for (int i = 0; i < productIds.size(); ++i) {
+        QVERIFY(renameProduct(productIds.at(i), names.at(i)));
+    }
+}
+
+void InventoryTest::cleanupTestCase() {
+    for (int productId : productIds) { renameProduct(productId, originalNames.value(productId)); }
+}
+
+// Renaming a product moves its row in the live model; stock signals must
+// still reach that product's new row, not whatever took its old place
+void InventoryTest::stockHighlightFollowsMovedRow() {
+    QStringList ids;
+    for (int productId : productIds) { ids << QString::number(productId); }
+
+    LiveQueryModel model;
+    model.setQuery(QString("SELECT ProductID, Name, StockQuantity FROM products "
+                           "WHERE ProductID IN (%1) ORDER BY Name")
+                       .arg(ids.join(", ")),
+                   "ProductID");
+    QVERIFY2(!model.lastError().isValid(), qPrintable(model.lastError().text()));
+    QCOMPARE(model.rowCount(), 3);
+
+    InventoryMonitor       monitor;
+    CatalogStockProxyModel proxy(0, 2);
+    proxy.setSourceModel(&model);
+    proxy.setInventoryMonitor(&monitor);
+    for (int productId : productIds) { monitor.applyStockLevel(productId, 100.0); }
+
+    // The first product sorts last after the rename
+    const int moved = productIds.first();
+    QCOMPARE(model.rowForKey(moved), 0);
+    QVERIFY(renameProduct(moved, "~proxy test z"));
+    model.refreshKeys({moved});
+    QCOMPARE(model.rowForKey(moved), 2);
+
+    QSignalSpy changed(&proxy, &QAbstractItemModel::dataChanged);
+    monitor.applyStockLevel(moved, 0.0);
+
+    QCOMPARE(changed.count(), 1);
+    const QModelIndex topLeft = changed.first().at(0).value<QModelIndex>();
+    QCOMPARE(topLeft.row(), 2);
+    QCOMPARE(proxy.index(2, 0).data().toInt(), moved);
+
+    // Only the sold-out product is greyed out and disabled
+    for (int row = 0; row < proxy.rowCount(); ++row) {
+        const QModelIndex index   = proxy.index(row, 1);
+        const bool        soldOut = proxy.index(row, 0).data().toInt() == moved;
+        QCOMPARE(index.data(Qt::ForegroundRole).isValid(), soldOut);
+        QCOMPARE(bool(proxy.flags(index) & Qt::ItemIsEnabled), !soldOut);
+    }
+}
+
+BAKERYPOS_TEST(InventoryTest)
+
+#include "tst_inventory.moc"
@@ -0,0 +1,72 @@
+#include "Money.h"
+#include "TestSuite.h"
+
+#include <QTest>
+
+Q_DECLARE_METATYPE(Money::Rounding)
+
+class MoneyTest : public QObject {
+    Q_OBJECT
+
+  private slots:
+    void times_data();
+    void times();
+    void percentRoundsLikeTimes();
+    void formats();
+    void sums();
+};
+
+void MoneyTest::times_data() {
+    QTest::addColumn<qint64>("cents");
+    QTest::addColumn<qint64>("quantityMilli");
+    QTest::addColumn<Money::Rounding>("rounding");
+    QTest::addColumn<qint64>("expected");
+
+    QTest::newRow("exact") << qint64(250) << qint64(1500) << Money::Rounding::HalfUp
+                           << qint64(375);
+    QTest::newRow("weighed") << qint64(1999) << qint64(333) << Money::Rounding::HalfUp
+                             << qint64(666);
+    QTest::newRow("half up") << qint64(5) << qint64(500) << Money::Rounding::HalfUp
+                             << qint64(3);
+    QTest::newRow("half even, down") << qint64(5) << qint64(500) << Money::Rounding::HalfEven
+                                     << qint64(2);
+    QTest::newRow("half even, up") << qint64(15) << qint64(500) << Money::Rounding::HalfEven
+                                   << qint64(8);
+    QTest::newRow("down") << qint64(199) << qint64(999) << Money::Rounding::Down
+                          << qint64(198);
+    QTest::newRow("refund") << qint64(-5) << qint64(500) << Money::Rounding::HalfUp
+                            << qint64(-3);
+}
+
+void MoneyTest::times() {
+    QFETCH(qint64, cents);
+    QFETCH(qint64, quantityMilli);
+    QFETCH(Money::Rounding, rounding);
+    QFETCH(qint64, expected);
+
+    QCOMPARE(Money::fromCents(cents).times(quantityMilli, rounding).cents(), expected);
+}
+
+void MoneyTest::percentRoundsLikeTimes() {
+    QCOMPARE(SalesTax::taxOn(Money::fromCents(10)).cents(), qint64(2));
+    QCOMPARE(SalesTax::taxOn(Money::fromCents(-10)).cents(), qint64(-2));
+    QCOMPARE(Money::fromCents(333).percent(500).cents(), qint64(17));
+}
+
+void MoneyTest::formats() {
+    QCOMPARE(Money::fromCents(123456).toString(), QString("$1234.56"));
+    QCOMPARE(Money::fromCents(-5).toString(), QString("-$0.05"));
+    QCOMPARE(Money::fromCents(7).toDecimalString(), QString("0.07"));
+    QCOMPARE(Money::fromDouble(0.1 + 0.2).cents(), qint64(30));
+    QCOMPARE(Money::fromVariant(QVariant("19.99")).cents(), qint64(1999));
+}
+
+void MoneyTest::sums() {
+    const qint64 cents[] = {100, -25, 7, 0, 18};
+    QCOMPARE(Money::sum(cents, 5).cents(), qint64(100));
+    QVERIFY(Money::sum(cents, 0).isZero());
+}
+
+BAKERYPOS_TEST(MoneyTest)
+
+#include "tst_money.moc"
@@ -0,0 +1,92 @@
+#include "OrderLineStore.h"
+#include "TestDatabase.h"
+#include "TestSuite.h"
+
+#include <QTest>
+#include <QThread>
+
+#include <algorithm>
+#include <climits>
+
+// A scan's result must not depend on the number of threads, how the lines
+// were partitioned or the order the partitions finished in. Each setting
+// is run several times and compared with one serial pass.
+class ParallelScanTest : public QObject {
+    Q_OBJECT
+
+  private slots:
+    void initTestCase();
+    void sameResultsAnyWay_data();
+    void sameResultsAnyWay();
+
+  private:
+    OrderLineStore     store;
+    QDate              from;
+    QDate              to;
+    Money              revenue;
+    QVector<LineGroup> products;
+    QVector<LineGroup> categories;
+};
+
+static bool sameGroups(QVector<LineGroup> a, QVector<LineGroup> b, bool withOrders) {
+    // byCategory ranks by orders and ties may fall either way
+    auto byCode = [](const LineGroup &x, const LineGroup &y) { return x.code < y.code; };
+    std::sort(a.begin(), a.end(), byCode);
+    std::sort(b.begin(), b.end(), byCode);
+    if (a.size() != b.size()) { return false; }
+    for (int i = 0; i < a.size(); ++i) {
+        if (a.at(i).code != b.at(i).code || a.at(i).quantityMilli != b.at(i).quantityMilli ||
+            a.at(i).revenue != b.at(i).revenue ||
+            (withOrders && a.at(i).orders != b.at(i).orders)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void ParallelScanTest::initTestCase() {
+    QString error;
+    if (!TestDatabase::open(&error)) { QSKIP(qPrintable(error)); }
+    QVERIFY(store.refresh());
+
+    from = TestDatabase::firstDay();
+    to   = TestDatabase::lastDay().addDays(1);
+
+    store.setPartitioning(INT_MAX, 1);
+    revenue    = store.revenue(from, to);
+    products   = store.byProduct(from, to);
+    categories = store.byCategory(from, to);
+    QVERIFY(!products.isEmpty());
+}
+
+void ParallelScanTest::sameResultsAnyWay_data() {
+    QTest::addColumn<int>("threads");
+    QTest::addColumn<int>("partitionLines");
+
+    const int    cores  = QThread::idealThreadCount();
+    QVector<int> counts = {1, 2, cores, 2 * cores};
+    std::sort(counts.begin(), counts.end());
+    counts.erase(std::unique(counts.begin(), counts.end()), counts.end());
+    for (int threads : counts) {
+        for (int lines : {32768, 4096, 997}) {
+            QTest::addRow("%d threads, %d lines a partition", threads, lines) << threads << lines;
+        }
+    }
+}
+
+void ParallelScanTest::sameResultsAnyWay() {
+    QFETCH(int, threads);
+    QFETCH(int, partitionLines);
+
+    store.setMaxThreads(threads);
+    store.setPartitioning(0, partitionLines);
+    for (int run = 0; run < 3; ++run) {
+        QCOMPARE(store.revenue(from, to), revenue);
+        QVERIFY(sameGroups(store.byProduct(from, to), products, false));
+        QVERIFY(sameGroups(store.byCategory(from, to), categories, true));
+    }
+}
+
+BAKERYPOS_TEST(ParallelScanTest)
+
+#include "tst_parallelscan.moc"
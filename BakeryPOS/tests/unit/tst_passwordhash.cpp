@@ -0,0 +1,164 @@
+#include "PasswordHash.h"
+#include "TestSuite.h"
+
+#include <QTest>
+
+// Known answers from RFC 7914, sections 11 and 12
+class PasswordHashTest : public QObject {
+    Q_OBJECT
+
+  private slots:
+    void pbkdf2Sha256_data();
+    void pbkdf2Sha256();
+    void scrypt_data();
+    void scrypt();
+    void hashVerifies();
+    void plaintextIsUpgraded();
+    void weakerCostIsUpgraded();
+    void malformedIsRejected_data();
+    void malformedIsRejected();
+};
+
+void PasswordHashTest::pbkdf2Sha256_data() {
+    QTest::addColumn<QByteArray>("password");
+    QTest::addColumn<QByteArray>("salt");
+    QTest::addColumn<int>("iterations");
+    QTest::addColumn<QByteArray>("expected");
+
+    QTest::newRow("passwd") << QByteArray("passwd") << QByteArray("salt") << 1
+                            << QByteArray::fromHex(
+                                   "55ac046e56e3089fec1691c22544b605f94185216dde0465e68b9d57c2"
+                                   "0dacbc49ca9cccf179b645991664b39d77ef317c71b845b1e30bd50911"
+                                   "2041d3a19783");
+    QTest::newRow("Password") << QByteArray("Password") << QByteArray("NaCl") << 80000
+                              << QByteArray::fromHex(
+                                     "4ddcd8f60b98be21830cee5ef22701f9641a4418d04c0414aeff0887"
+                                     "6b34ab56a1d425a1225833549adb841b51c9b3176a272bdebba1d078"
+                                     "478f62b397f33c8d");
+}
+
+void PasswordHashTest::pbkdf2Sha256() {
+    QFETCH(QByteArray, password);
+    QFETCH(QByteArray, salt);
+    QFETCH(int, iterations);
+    QFETCH(QByteArray, expected);
+
+    QCOMPARE(PasswordHash::pbkdf2Sha256(password, salt, iterations, 64).toHex(),
+             expected.toHex());
+}
+
+void PasswordHashTest::scrypt_data() {
+    QTest::addColumn<QByteArray>("password");
+    QTest::addColumn<QByteArray>("salt");
+    QTest::addColumn<int>("cost");
+    QTest::addColumn<int>("r");
+    QTest::addColumn<int>("p");
+    QTest::addColumn<QByteArray>("expected");
+
+    QTest::newRow("empty") << QByteArray() << QByteArray() << 4 << 1 << 1
+                           << QByteArray::fromHex(
+                                  "77d6576238657b203b19ca42c18a0497f16b4844e3074ae8dfdffa3fede2"
+                                  "1442fcd0069ded0948f8326a753a0fc81f17e8d3e0fb2e0d3628cf35e20c"
+                                  "38d18906");
+    QTest::newRow("password") << QByteArray("password") << QByteArray("NaCl") << 10 << 8 << 16
+                              << QByteArray::fromHex(
+                                     "fdbabe1c9d3472007856e7190d01e9fe7c6ad7cbc8237830e7737663"
+                                     "4b3731622eaf30d92e22a3886ff109279d9830dac727afb94a83ee6d"
+                                     "8360cbdfa2cc0640");
+    QTest::newRow("pleaseletmein") << QByteArray("pleaseletmein") << QByteArray("SodiumChloride")
+                                   << 14 << 8 << 1
+                                   << QByteArray::fromHex(
+                                          "7023bdcb3afd7348461c06cd81fd38ebfda8fbba904f8e3ea9b5"
+                                          "43f6545da1f2d5432955613f0fcf62d49705242a9af9e61e85dc"
+                                          "0d651e40dfcf017b45575887");
+}
+
+void PasswordHashTest::scrypt() {
+    QFETCH(QByteArray, password);
+    QFETCH(QByteArray, salt);
+    QFETCH(int, cost);
+    QFETCH(int, r);
+    QFETCH(int, p);
+    QFETCH(QByteArray, expected);
+
+    QCOMPARE(PasswordHash::scrypt(password, salt, cost, r, p, 64).toHex(), expected.toHex());
+}
+
+void PasswordHashTest::hashVerifies() {
+    const QString stored = PasswordHash::hash("1234", PasswordHash::PinCost);
+    QVERIFY(PasswordHash::isHashed(stored));
+    QVERIFY(stored.startsWith(QString("scrypt$%1$8$1$").arg(PasswordHash::PinCost)));
+
+    bool needsUpgrade = true;
+    QVERIFY(PasswordHash::verify("1234", stored, &needsUpgrade, PasswordHash::PinCost));
+    QVERIFY(!needsUpgrade);
+    QVERIFY(!PasswordHash::verify("1235", stored, &needsUpgrade, PasswordHash::PinCost));
+    QVERIFY(!needsUpgrade);
+
+    // Salted: the same secret never hashes the same way twice
+    QVERIFY(PasswordHash::hash("1234", PasswordHash::PinCost) != stored);
+}
+
+void PasswordHashTest::plaintextIsUpgraded() {
+    bool needsUpgrade = false;
+    QVERIFY(PasswordHash::verify("secret", "secret", &needsUpgrade));
+    QVERIFY(needsUpgrade);
+
+    QVERIFY(!PasswordHash::verify("Secret", "secret", &needsUpgrade));
+    QVERIFY(!needsUpgrade);
+
+    // An empty stored password never matches, not even an empty one
+    QVERIFY(!PasswordHash::verify(QString(), QString(), &needsUpgrade));
+    QVERIFY(!needsUpgrade);
+}
+
+void PasswordHashTest::weakerCostIsUpgraded() {
+    const QString stored = PasswordHash::hash("baguette", 10);
+
+    bool needsUpgrade = false;
+    QVERIFY(PasswordHash::verify("baguette", stored, &needsUpgrade, 12));
+    QVERIFY(needsUpgrade);
+
+    // A wrong password is never flagged for upgrade
+    QVERIFY(!PasswordHash::verify("croissant", stored, &needsUpgrade, 12));
+    QVERIFY(!needsUpgrade);
+
+    QVERIFY(PasswordHash::verify("baguette", stored, &needsUpgrade, 10));
+    QVERIFY(!needsUpgrade);
+}
+
+void PasswordHashTest::malformedIsRejected_data() {
+    QTest::addColumn<QString>("stored");
+
+    const QString salt    = QString::fromLatin1(QByteArray("0123456789abcdef").toBase64());
+    const QString hash    = QString::fromLatin1(QByteArray(32, 'x').toBase64());
+    const QString tooLong = QString::fromLatin1(QByteArray(65, 'x').toBase64());
+
+    QTest::newRow("prefix only") << "scrypt$";
+    QTest::newRow("missing hash") << QString("scrypt$10$8$1$%1").arg(salt);
+    QTest::newRow("extra field") << QString("scrypt$10$8$1$%1$%2$x").arg(salt, hash);
+    QTest::newRow("cost not a number") << QString("scrypt$ten$8$1$%1$%2").arg(salt, hash);
+    QTest::newRow("cost zero") << QString("scrypt$0$8$1$%1$%2").arg(salt, hash);
+    QTest::newRow("r zero") << QString("scrypt$10$0$1$%1$%2").arg(salt, hash);
+    QTest::newRow("p zero") << QString("scrypt$10$8$0$%1$%2").arg(salt, hash);
+    QTest::newRow("empty salt") << QString("scrypt$10$8$1$$%1").arg(hash);
+    QTest::newRow("empty hash") << QString("scrypt$10$8$1$%1$").arg(salt);
+    QTest::newRow("hash too long") << QString("scrypt$10$8$1$%1$%2").arg(salt, tooLong);
+
+    // Rejected before hashing; each would take gigabytes or minutes
+    QTest::newRow("cost 24") << QString("scrypt$24$8$1$%1$%2").arg(salt, hash);
+    QTest::newRow("r 32") << QString("scrypt$20$32$1$%1$%2").arg(salt, hash);
+    QTest::newRow("p 16") << QString("scrypt$20$8$16$%1$%2").arg(salt, hash);
+}
+
+void PasswordHashTest::malformedIsRejected() {
+    QFETCH(QString, stored);
+
+    bool needsUpgrade = true;
+    QVERIFY(!PasswordHash::verify("secret", stored, &needsUpgrade));
+    QVERIFY(!needsUpgrade);
+}
+
+BAKERYPOS_TEST(PasswordHashTest)
+
+#include "tst_passwordhash.moc"
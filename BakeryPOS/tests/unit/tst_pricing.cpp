@@ -0,0 +1,143 @@
+#include "CheckoutService.h"
+#include "PricingEngine.h"
+#include "TestSuite.h"
+
+#include <QTest>
+
+static PromotionRule percentOff(int id, int basisPoints) {
+    PromotionRule rule;
+    rule.id         = id;
+    rule.name       = QString("%1% off").arg(basisPoints / 100);
+    rule.kind       = PromotionRule::PercentOff;
+    rule.percentOff = basisPoints;
+    return rule;
+}
+
+static CheckoutLine line(int productId, const QString &category, qint64 cents,
+                         qint64 quantityMilli) {
+    CheckoutLine line;
+    line.productId     = productId;
+    line.category      = category;
+    line.unitPrice     = Money::fromCents(cents);
+    line.quantityMilli = quantityMilli;
+    return line;
+}
+
+class PricingTest : public QObject {
+    Q_OBJECT
+
+  private slots:
+    void noRulesChargesGross();
+    void bundlesDiscountCompleteBundles();
+    void timeWindows();
+    void largestDiscountWins();
+    void discountNeverExceedsGross();
+    void rulesOutsideTheirDatesAreDropped();
+    void taxIsRoundedOncePerRate();
+};
+
+void PricingTest::noRulesChargesGross() {
+    PricingEngine pricing;
+    LinePrice     price = pricing.price(1, "Bread", Money::fromCents(250), 2000, 600);
+    QCOMPARE(price.gross.cents(), qint64(500));
+    QVERIFY(price.discount.isZero());
+    QCOMPARE(price.promotionId, 0);
+}
+
+void PricingTest::bundlesDiscountCompleteBundles() {
+    PromotionRule bundle;
+    bundle.id                  = 3;
+    bundle.kind                = PromotionRule::Bundle;
+    bundle.productId           = 7;
+    bundle.bundleQuantityMilli = 3000;
+    bundle.bundlePrice         = Money::fromCents(500);
+
+    PricingEngine pricing;
+    pricing.setRules({bundle}, QDate(2025, 6, 1));
+
+    // Three for $5.00 at $2.00 each: two bundles in seven, $1.00 off each
+    LinePrice price = pricing.price(7, "Pastry", Money::fromCents(200), 7000, 600);
+    QCOMPARE(price.gross.cents(), qint64(1400));
+    QCOMPARE(price.discount.cents(), qint64(200));
+    QCOMPARE(price.promotionId, 3);
+
+    QVERIFY(pricing.price(8, "Pastry", Money::fromCents(200), 7000, 600).discount.isZero());
+}
+
+void PricingTest::timeWindows() {
+    PromotionRule evening = percentOff(1, 3000);
+    evening.category      = "Bread";
+    evening.startMinute   = 18 * 60;
+    evening.endMinute     = 20 * 60;
+
+    PricingEngine pricing;
+    pricing.setRules({evening}, QDate(2025, 6, 1));
+    QCOMPARE(pricing.price(1, "Bread", Money::fromCents(500), 2000, 18 * 60 + 30)
+                 .discount.cents(),
+             qint64(300));
+    QVERIFY(pricing.price(1, "Bread", Money::fromCents(500), 2000, 17 * 60).discount.isZero());
+    QVERIFY(pricing.price(1, "Bread", Money::fromCents(500), 2000, 20 * 60).discount.isZero());
+
+    PromotionRule overnight = percentOff(2, 1000);
+    overnight.startMinute   = 22 * 60;
+    overnight.endMinute     = 2 * 60;
+    QVERIFY(overnight.activeAt(23 * 60));
+    QVERIFY(overnight.activeAt(60));
+    QVERIFY(!overnight.activeAt(12 * 60));
+}
+
+void PricingTest::largestDiscountWins() {
+    PromotionRule product = percentOff(1, 1000);
+    product.productId     = 5;
+    PromotionRule store   = percentOff(2, 2500);
+
+    PricingEngine pricing;
+    pricing.setRules({product, store}, QDate(2025, 6, 1));
+    LinePrice price = pricing.price(5, "Cake", Money::fromCents(1000), 1000, 600);
+    QCOMPARE(price.discount.cents(), qint64(250));
+    QCOMPARE(price.promotionId, 2);
+    QCOMPARE(pricing.promotionName(2), QString("25% off"));
+}
+
+void PricingTest::discountNeverExceedsGross() {
+    PricingEngine pricing;
+    pricing.setRules({percentOff(1, 15000)}, QDate(2025, 6, 1));
+    LinePrice price = pricing.price(1, "Cake", Money::fromCents(1000), 1000, 600);
+    QCOMPARE(price.discount, price.gross);
+    QVERIFY(price.net().isZero());
+}
+
+void PricingTest::rulesOutsideTheirDatesAreDropped() {
+    PromotionRule expired = percentOff(1, 1000);
+    expired.validTo       = QDate(2025, 5, 31);
+    PromotionRule future  = percentOff(2, 1000);
+    future.validFrom      = QDate(2025, 6, 2);
+    PromotionRule today   = percentOff(3, 1000);
+    today.validFrom       = QDate(2025, 6, 1);
+    today.validTo         = QDate(2025, 6, 1);
+
+    PricingEngine pricing;
+    pricing.setRules({expired, future, today}, QDate(2025, 6, 1));
+    QCOMPARE(pricing.ruleCount(), 1);
+    QCOMPARE(pricing.price(1, "Cake", Money::fromCents(1000), 1000, 600).promotionId, 3);
+}
+
+void PricingTest::taxIsRoundedOncePerRate() {
+    PricingEngine pricing;
+    pricing.setTaxRates({{"Beverage", 500}});
+    QCOMPARE(pricing.taxRate("Beverage"), 500);
+    QCOMPARE(pricing.taxRate("Bread"), SalesTax::rate);
+
+    // 15% of 3 cents is 0.45 each; rounded once on 6 cents it is 1
+    QVector<CheckoutLine> lines = {line(1, "Bread", 3, 1000), line(2, "Bread", 3, 1000),
+                                   line(3, "Beverage", 333, 1000)};
+    CheckoutTotals totals = CheckoutService::price(pricing, lines, 600);
+    QCOMPARE(totals.subtotal.cents(), qint64(339));
+    QCOMPARE(totals.tax.cents(), qint64(1 + 17));
+    QCOMPARE(totals.total.cents(), qint64(357));
+    QVERIFY(totals.discounts.isZero());
+}
+
+BAKERYPOS_TEST(PricingTest)
+
+#include "tst_pricing.moc"
@@ -0,0 +1,134 @@
+#include "CheckoutService.h"
+#include "ProcessMemory.h"
+#include "ReceiptWidget.h"
+#include "TestDatabase.h"
+#include "TestSuite.h"
+
+#include <QApplication>
+#include <QPointer>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QTest>
+
+// Growth allowed over the whole run. Allocator and driver caches settle
+// during the warm-up; a leak of even one small widget per sale would pass
+// this well before 10k sales.
+static const qint64 MaxGrowthBytes  = 16 * 1024 * 1024;
+static const int    WarmUpCheckouts = 500;
+
+// A register left running all day: checkouts through CheckoutService, each
+// shown in the receipt preview as the till does, with resident memory and
+// the top-level windows checked along the way. BAKERYPOS_SOAK_CHECKOUTS
+// changes the number of sales (10000 by default).
+class SoakTest : public QObject {
+    Q_OBJECT
+
+  private slots:
+    void initTestCase();
+    void closedPreviewIsFreed();
+    void gaugeShowsMemoryAndWindows();
+    void checkoutsKeepMemoryFlat();
+
+  private:
+    QVector<CheckoutLine> cart;
+    int                   userId = 0;
+    PricingEngine         pricing;
+
+    int checkout(QString *error);
+};
+
+void SoakTest::initTestCase() {
+    QString error;
+    if (!TestDatabase::open(&error)) { QSKIP(qPrintable(error)); }
+
+    QSqlQuery query;
+    QVERIFY2(query.exec("SELECT ProductID, Category, PricePerUnit FROM products "
+                        "WHERE UnitType = 'unit' AND status = 'Available' "
+                        "ORDER BY ProductID DESC LIMIT 3"),
+             qPrintable(query.lastError().text()));
+    while (query.next()) {
+        CheckoutLine line;
+        line.productId     = query.value(0).toInt();
+        line.category      = query.value(1).toString();
+        line.unitPrice     = Money::fromVariant(query.value(2));
+        line.quantityMilli = 1000;
+        cart << line;
+    }
+    QVERIFY(!cart.isEmpty());
+
+    QVERIFY(query.exec("SELECT MIN(UserID) FROM users") && query.next());
+    userId = query.value(0).toInt();
+    QVERIFY(pricing.load());
+}
+
+// What CashierForm::saveOrder and showInvoice do for one sale
+int SoakTest::checkout(QString *error) {
+    QVector<CheckoutLine> lines   = cart;
+    CheckoutTotals        totals  = CheckoutService::price(pricing, lines);
+    int                   orderId = CheckoutService::submit(lines, totals, userId, "Cash", error);
+    if (orderId > 0) { ReceiptWidget::preview(Receipt::load(orderId)); }
+    return orderId;
+}
+
+void SoakTest::closedPreviewIsFreed() {
+    QString error;
+    QVERIFY2(checkout(&error) > 0, qPrintable(error));
+
+    QPointer<ReceiptWidget> first = ReceiptWidget::preview(Receipt());
+    QCOMPARE(ReceiptWidget::preview(Receipt()), first.data());
+
+    first->close();
+    QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+    QVERIFY(first.isNull());
+
+    // The next sale opens a fresh window
+    QVERIFY(ReceiptWidget::preview(Receipt()) != nullptr);
+}
+
+void SoakTest::gaugeShowsMemoryAndWindows() {
+    const int     windows = QApplication::topLevelWidgets().size();
+    const QString text    = ProcessMemory::gaugeText(windows);
+    QVERIFY2(text.endsWith(QString("%1 windows").arg(windows)), qPrintable(text));
+
+    if (ProcessMemory::residentBytes() <= 0) { QSKIP("No resident memory figure here"); }
+    QVERIFY2(text.startsWith("Memory "), qPrintable(text));
+    QVERIFY(ProcessMemory::peakResidentBytes() >= ProcessMemory::residentBytes());
+}
+
+void SoakTest::checkoutsKeepMemoryFlat() {
+    if (ProcessMemory::residentBytes() <= 0) { QSKIP("No resident memory figure here"); }
+
+    const int count = qEnvironmentVariableIsSet("BAKERYPOS_SOAK_CHECKOUTS")
+                          ? qEnvironmentVariableIntValue("BAKERYPOS_SOAK_CHECKOUTS")
+                          : 10000;
+    QString error;
+    for (int i = 0; i < WarmUpCheckouts; ++i) {
+        QVERIFY2(checkout(&error) > 0, qPrintable(error));
+    }
+    QCoreApplication::processEvents();
+
+    const qint64 baseline = ProcessMemory::residentBytes();
+    const int    windows  = QApplication::topLevelWidgets().size();
+    qint64       highest  = baseline;
+    for (int i = 1; i <= count; ++i) {
+        QVERIFY2(checkout(&error) > 0, qPrintable(error));
+
+        // The till's event loop runs between sales
+        if (i % 100 == 0) { QCoreApplication::processEvents(); }
+        if (i % 1000 == 0) {
+            highest = qMax(highest, ProcessMemory::residentBytes());
+            QCOMPARE(QApplication::topLevelWidgets().size(), windows);
+            qInfo("%d checkouts: %s", i, qPrintable(ProcessMemory::gaugeText(windows)));
+        }
+    }
+
+    const qint64 growth = qMax(highest, ProcessMemory::residentBytes()) - baseline;
+    QVERIFY2(growth < MaxGrowthBytes,
+             qPrintable(QString("Resident memory grew %1 KB over %2 checkouts")
+                            .arg(growth / 1024)
+                            .arg(count)));
+}
+
+BAKERYPOS_TEST(SoakTest)
+
+#include "tst_soak.moc"
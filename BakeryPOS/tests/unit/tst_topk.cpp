@@ -0,0 +1,143 @@
+#include "TestSuite.h"
+#include "TopK.h"
+
+#include <QStringList>
+#include <QTest>
+
+template <typename Key>
+static QList<Key> keysOf(const QVector<typename HeavyHitters<Key>::Entry> &entries) {
+    QList<Key> keys;
+    for (const auto &entry : entries) { keys << entry.key; }
+    return keys;
+}
+
+class TopKTest : public QObject {
+    Q_OBJECT
+
+  private slots:
+    void keepsLargestWhenKIsSmaller();
+    void keepsAllWhenKIsLarger();
+    void rankedUsesLess();
+    void tiesKeepKeyOrder();
+    void exactUpToLimit();
+    void sketchKeepsLeadersOfSkewedStream();
+    void refundsCountAgainstKey();
+};
+
+void TopKTest::keepsLargestWhenKIsSmaller() {
+    TopK<int> top(3);
+    for (int value : {7, 2, 9, 4, 10, 1, 8, 3, 6, 5}) { top.offer(value); }
+
+    QCOMPARE(top.size(), 3);
+    QCOMPARE(top.ranked(), QVector<int>({10, 9, 8}));
+}
+
+void TopKTest::keepsAllWhenKIsLarger() {
+    TopK<int> top(10);
+    for (int value : {5, 1, 3}) { top.offer(value); }
+
+    QCOMPARE(top.size(), 3);
+    QCOMPARE(top.ranked(), QVector<int>({5, 3, 1}));
+
+    top.clear();
+    QVERIFY(top.isEmpty());
+    QVERIFY(top.ranked().isEmpty());
+}
+
+// Largest by Less first, whatever order the items came in
+void TopKTest::rankedUsesLess() {
+    TopK<int, std::greater<int>> smallest(4);
+    for (int value : {7, 2, 9, 4, 10, 1, 8, 3, 6, 5}) { smallest.offer(value); }
+    QCOMPARE(smallest.ranked(), QVector<int>({1, 2, 3, 4}));
+
+    auto byLength = [](const QString &a, const QString &b) { return a.size() < b.size(); };
+    TopK<QString, decltype(byLength)> longest(2, byLength);
+    for (const QString &word : {"rye", "baguette", "bun", "croissant", "roll"}) {
+        longest.offer(word);
+    }
+    QCOMPARE(longest.ranked(), QVector<QString>({"croissant", "baguette"}));
+}
+
+void TopKTest::tiesKeepKeyOrder() {
+    HeavyHitters<QString> sellers(2);
+    sellers.add("pear tart", 3);
+    sellers.add("kiwi tart", 1);
+    sellers.add("fig roll", 3);
+    sellers.add("apple pie", 3);
+
+    // Equal weights rank by key, and the cut at k follows the same order
+    QCOMPARE(keysOf<QString>(sellers.ranked()), QList<QString>({"apple pie", "fig roll"}));
+
+    HeavyHitters<QString> all(10);
+    for (const QString &key : {"c", "a", "d", "b"}) { all.add(key, 1); }
+    QCOMPARE(keysOf<QString>(all.ranked()), QList<QString>({"a", "b", "c", "d"}));
+}
+
+void TopKTest::exactUpToLimit() {
+    HeavyHitters<int> hitters(3, 100);
+    for (int key = 0; key < 100; ++key) { hitters.add(key, key); }
+    QVERIFY(!hitters.isApproximate());
+
+    const auto ranked = hitters.ranked();
+    QCOMPARE(keysOf<int>(ranked), QList<int>({99, 98, 97}));
+    QCOMPARE(ranked.first().weight, qint64(99));
+
+    // One key past the limit moves the totals into the sketch
+    hitters.add(100, 1);
+    QVERIFY(hitters.isApproximate());
+    QCOMPARE(keysOf<int>(hitters.ranked()), QList<int>({99, 98, 97}));
+}
+
+// Three heavy keys among ten thousand light ones, interleaved as sales are
+void TopKTest::sketchKeepsLeadersOfSkewedStream() {
+    HeavyHitters<int> hitters(3, 100);
+    for (int i = 0; i < 10000; ++i) {
+        hitters.add(100 + i, 1);
+        hitters.add(1, 1);
+        if (i % 2 == 0) { hitters.add(2, 1); }
+        if (i % 4 == 0) { hitters.add(3, 1); }
+    }
+    QVERIFY(hitters.isApproximate());
+
+    const auto ranked = hitters.ranked();
+    QCOMPARE(keysOf<int>(ranked), QList<int>({1, 2, 3}));
+
+    // Estimates never fall below the true totals, and collisions add little
+    const qint64 totals[] = {10000, 5000, 2500};
+    for (int i = 0; i < 3; ++i) {
+        QVERIFY(ranked.at(i).weight >= totals[i]);
+        QVERIFY(ranked.at(i).weight < totals[i] + 500);
+    }
+}
+
+void TopKTest::refundsCountAgainstKey() {
+    HeavyHitters<QString> exact(3);
+    exact.add("bun", 5);
+    exact.add("bun", -2);
+    exact.add("roll", 4);
+    QVERIFY(!exact.isApproximate());
+    const auto exactRanked = exact.ranked();
+    QCOMPARE(keysOf<QString>(exactRanked), QList<QString>({"roll", "bun"}));
+    QCOMPARE(exactRanked.last().weight, qint64(3));
+
+    // A refund before the switch is carried over, one after it is applied
+    HeavyHitters<int> hitters(3, 100);
+    hitters.add(4, -50);
+    for (int i = 0; i < 10000; ++i) {
+        hitters.add(100 + i, 1);
+        hitters.add(1, 1);
+        if (i % 2 == 0) { hitters.add(2, 1); }
+        if (i % 4 == 0) { hitters.add(3, 1); }
+    }
+    hitters.add(1, -9000);
+    QVERIFY(hitters.isApproximate());
+
+    const auto ranked = hitters.ranked();
+    QCOMPARE(keysOf<int>(ranked), QList<int>({2, 3, 1}));
+    QVERIFY(ranked.last().weight >= 1000);
+    QVERIFY(ranked.last().weight < 1500);
+}
+
+BAKERYPOS_TEST(TopKTest)
+
+#include "tst_topk.moc"
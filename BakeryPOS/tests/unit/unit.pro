@@ -0,0 +1,25 @@
+# Unit tests: "make check", or run tst_unit with a class name to run one
+TARGET = tst_unit
+
+# The soak test drives the till's receipt preview
+QT += widgets printsupport
+
+include(../tests.pri)
+
+SOURCES += \
+    main.cpp \
+    tst_analytics.cpp \
+    tst_checkout.cpp \
+    tst_inventory.cpp \
+    tst_money.cpp \
+    tst_parallelscan.cpp \
+    tst_passwordhash.cpp \
+    tst_pricing.cpp \
+    tst_soak.cpp \
+    tst_topk.cpp \
+    ../../InventoryMonitor.cpp \
+    ../../ReceiptWidget.cpp
+
+HEADERS += \
+    ../../InventoryMonitor.h \
+    ../../ReceiptWidget.h
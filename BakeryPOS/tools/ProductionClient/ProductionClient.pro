@@ -0,0 +1,12 @@
+# Headless production display: prints what the register's ProductionFeed
+# pushes and how late each message arrived.
+QT       += core network
+QT       -= gui
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = ProductionClient
+
+SOURCES += \
+    main.cpp
@@ -0,0 +1,92 @@
+// Connects to a register's production feed like a display would and
+// prints each message with its push latency. With --count it stops after
+// that many jobs and prints latency percentiles; with --ack it marks every
+// job done so the round trip through the other displays can be watched.
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLocalSocket>
+#include <QTextStream>
+#include <QVector>
+
+#include <algorithm>
+
+static QTextStream out(stdout);
+
+static void printLatencies(QVector<qint64> latencies) {
+    if (latencies.isEmpty()) {
+        out << "No jobs received" << Qt::endl;
+        return;
+    }
+    std::sort(latencies.begin(), latencies.end());
+    auto at = [&latencies](double fraction) {
+        return latencies.at(qMin(latencies.size() - 1, int(latencies.size() * fraction)));
+    };
+    out << latencies.size() << " jobs, push latency ms: min " << latencies.first()
+        << ", median " << at(0.5) << ", p99 " << at(0.99) << ", max " << latencies.last()
+        << Qt::endl;
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication App(argc, argv);
+    App.setApplicationName("ProductionClient");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Headless production display for BakeryPOS");
+    parser.addHelpOption();
+    parser.addOption({"server", "Feed name (production/serverName).", "name",
+                      "BakeryPOS-production"});
+    parser.addOption({"count", "Exit after this many jobs.", "jobs", "0"});
+    parser.addOption({"ack", "Mark every job done."});
+    parser.addOption({"quiet", "Only print the summary."});
+    parser.process(App);
+
+    const int  count = parser.value("count").toInt();
+    const bool ack   = parser.isSet("ack");
+    const bool quiet = parser.isSet("quiet");
+
+    QLocalSocket    socket;
+    QVector<qint64> latencies;
+
+    QObject::connect(&socket, &QLocalSocket::readyRead, [&]() {
+        while (socket.canReadLine()) {
+            QByteArray  line    = socket.readLine();
+            QJsonObject message = QJsonDocument::fromJson(line).object();
+            QString     type    = message.value("type").toString();
+            qint64      latency = QDateTime::currentMSecsSinceEpoch() -
+                             qint64(message.value("sentAt").toDouble());
+
+            if (!quiet) { out << latency << " ms  " << line.trimmed() << Qt::endl; }
+            if (type != "job") { continue; }
+
+            latencies.append(latency);
+            if (ack) {
+                QJsonObject done{{"type", "done"},
+                                 {"orderId", message.value("orderId")},
+                                 {"productId", message.value("productId")}};
+                socket.write(QJsonDocument(done).toJson(QJsonDocument::Compact) + '\n');
+            }
+            if (count > 0 && latencies.size() >= count) {
+                printLatencies(latencies);
+                App.quit();
+                return;
+            }
+        }
+    });
+    QObject::connect(&socket, &QLocalSocket::disconnected, [&]() {
+        out << "Feed closed" << Qt::endl;
+        printLatencies(latencies);
+        App.exit(1);
+    });
+    QObject::connect(&socket, &QLocalSocket::errorOccurred, [&](QLocalSocket::LocalSocketError error) {
+        if (error == QLocalSocket::PeerClosedError) { return; } // reported as disconnected
+        out << "Feed error: " << socket.errorString() << Qt::endl;
+        App.exit(1);
+    });
+
+    socket.connectToServer(parser.value("server"));
+    return App.exec();
+}
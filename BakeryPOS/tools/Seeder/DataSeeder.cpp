@@ -0,0 +1,366 @@
+#include "DataSeeder.h"
+
+#include "PasswordHash.h"
+
+#include <QElapsedTimer>
+#include <QSet>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QStringList>
+#include <QVariantList>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+// Rows per INSERT; MySQL allows 65535 placeholders a statement
+static constexpr int RowsPerInsert = 500;
+
+struct CategoryPlan {
+    const char *name;
+    int         share;      // percent of the catalog
+    int         minCents;   // price range, per kg for weighed categories
+    int         maxCents;
+    bool        weighed;
+    QStringList bases;
+};
+
+static const QVector<CategoryPlan> &categoryPlans() {
+    static const QVector<CategoryPlan> plans = {
+        {"Bread", 25, 150, 600, false,
+         {"Sourdough", "Rye Loaf", "Baguette", "Ciabatta", "Brioche", "Focaccia", "Bagel"}},
+        {"Pastry", 20, 120, 450, false,
+         {"Croissant", "Danish", "Cinnamon Roll", "Eclair", "Turnover", "Palmier"}},
+        {"Cake", 10, 1200, 4500, false,
+         {"Sponge Cake", "Cheesecake", "Carrot Cake", "Gateau", "Tart", "Roulade"}},
+        {"Cookie", 15, 80, 300, false,
+         {"Cookie", "Shortbread", "Biscotti", "Macaron", "Brownie", "Florentine"}},
+        // Sold by the kilo at the till (see CashierForm)
+        {"Sweet", 10, 800, 3000, true,
+         {"Fudge", "Toffee", "Nougat", "Baklava", "Turkish Delight", "Marzipan"}},
+        {"Savory", 12, 200, 600, false,
+         {"Sausage Roll", "Quiche", "Pasty", "Cheese Straw", "Pretzel", "Empanada"}},
+        {"Beverage", 8, 150, 500, false,
+         {"Coffee", "Tea", "Hot Chocolate", "Juice", "Smoothie", "Lemonade"}},
+    };
+    return plans;
+}
+
+static const QStringList flavors = {"Classic", "Almond", "Walnut", "Raisin", "Honey", "Lemon",
+                                    "Cocoa", "Vanilla", "Seeded", "Olive", "Apple", "Cherry",
+                                    "Sesame", "Cranberry", "Maple", "Pistachio"};
+
+static void check(bool ok, const QSqlQuery &query, const char *what) {
+    if (!ok) {
+        throw std::runtime_error(QString("%1: %2")
+                                     .arg(QLatin1String(what), query.lastError().text())
+                                     .toStdString());
+    }
+}
+
+// One INSERT per RowsPerInsert rows of columns values each
+static void insertRows(QSqlQuery &query, const QString &head, int columns,
+                       const QVariantList &values, const char *what,
+                       const QString &tail = QString()) {
+    QStringList placeholders;
+    for (int i = 0; i < columns; ++i) { placeholders << "?"; }
+    const QString row = "(" + placeholders.join(", ") + ")";
+
+    const int rows = values.size() / columns;
+    for (int first = 0; first < rows; first += RowsPerInsert) {
+        int         count = qMin(RowsPerInsert, rows - first);
+        QStringList list;
+        for (int i = 0; i < count; ++i) { list << row; }
+
+        query.prepare(head + " VALUES " + list.join(", ") + tail);
+        for (int i = 0; i < count * columns; ++i) {
+            query.bindValue(i, values.at(first * columns + i));
+        }
+        check(query.exec(), query, what);
+    }
+}
+
+static int highestId(QSqlQuery &query, const QString &sql) {
+    check(query.exec(sql) && query.next(), query, "Reading the highest ID");
+    return query.value(0).toInt();
+}
+
+// In-store EAN-13 (prefix 20) with its check digit
+static QString barcodeFor(int number) {
+    QString digits = "20" + QString::number(number).rightJustified(10, '0');
+    int     sum    = 0;
+    for (int i = 0; i < 12; ++i) { sum += digits.at(i).digitValue() * (i % 2 ? 3 : 1); }
+    return digits + QString::number((10 - sum % 10) % 10);
+}
+
+static QString quantityText(qint64 quantityMilli) {
+    return QString::number(quantityMilli / 1000.0, 'f', 3);
+}
+
+DataSeeder::DataSeeder(const SeedPlan &plan, QTextStream &log)
+    : plan(plan), log(log), random(plan.seed) {}
+
+bool DataSeeder::run(QString *error) {
+    QElapsedTimer timer;
+    timer.start();
+
+    try {
+        QSqlQuery query;
+        seedCategories(query);
+        seedProducts(query);
+        seedUsers(query);
+        seedOrders(query);
+    } catch (const std::exception &e) {
+        QSqlDatabase::database().rollback();
+        if (error) { *error = e.what(); }
+        return false;
+    }
+
+    log << "Done in " << timer.elapsed() / 1000 << " s" << Qt::endl;
+    return true;
+}
+
+void DataSeeder::seedCategories(QSqlQuery &query) {
+    QSet<QString> existing;
+    check(query.exec("SELECT Category FROM categories"), query, "Reading categories");
+    while (query.next()) { existing.insert(query.value(0).toString()); }
+
+    QVariantList values;
+    for (const CategoryPlan &category : categoryPlans()) {
+        if (existing.contains(category.name)) { continue; }
+        values << QString(category.name) << plan.lastDay.addYears(-plan.years);
+    }
+    if (values.isEmpty()) { return; }
+
+    insertRows(query, "INSERT INTO categories (Category, Date)", 2, values,
+               "Adding categories");
+    log << "Added " << values.size() / 2 << " categories" << Qt::endl;
+}
+
+void DataSeeder::seedProducts(QSqlQuery &query) {
+    const int firstId =
+        highestId(query, "SELECT COALESCE(MAX(ProductID), 0) FROM products") + 1;
+    const QString added =
+        plan.lastDay.addYears(-plan.years).toString(Qt::ISODate) + " 06:00:00";
+
+    int shares = 0;
+    for (const CategoryPlan &category : categoryPlans()) { shares += category.share; }
+
+    QVariantList values;
+    for (int i = 0; i < plan.products; ++i) {
+        // Categories by their share of the catalog
+        int                 pick     = random.bounded(shares);
+        const CategoryPlan *category = &categoryPlans().first();
+        for (const CategoryPlan &candidate : categoryPlans()) {
+            if (pick < candidate.share) {
+                category = &candidate;
+                break;
+            }
+            pick -= candidate.share;
+        }
+
+        SeedProduct product;
+        product.id       = firstId + i;
+        product.category = category->name;
+        product.weighed  = category->weighed;
+        // Whole five cents, like a shelf label
+        product.price = Money::fromCents(
+            (category->minCents + random.bounded(category->maxCents - category->minCents + 1)) /
+            5 * 5);
+        catalog << product;
+
+        // Drawn one at a time so every compiler draws in the same order;
+        // the number keeps names unique however big the catalog
+        QString flavor = flavors.at(random.bounded(flavors.size()));
+        QString base   = category->bases.at(random.bounded(category->bases.size()));
+        QString name   = QString("%1 %2 %3").arg(flavor, base).arg(product.id);
+        qint64 stockMilli = product.weighed ? 5000 + random.bounded(45000)
+                                            : 1000 * (20 + random.bounded(380));
+
+        values << product.id << name << product.category
+               << (product.weighed ? QVariant(product.price.toDecimalString())
+                                   : QVariant(QMetaType(QMetaType::QString)))
+               << product.price.toDecimalString() << quantityText(stockMilli)
+               << (product.weighed ? "kg" : "unit") << barcodeFor(product.id) << added;
+    }
+
+    insertRows(query,
+               "INSERT INTO products (ProductID, Name, Category, PricePerKg, PricePerUnit, "
+               "StockQuantity, UnitType, Barcode, date_added)",
+               9, values, "Adding products");
+
+    // Few products sell most: weight 1 / rank, ranks shuffled over the catalog
+    QVector<int> ranks(catalog.size());
+    for (int i = 0; i < ranks.size(); ++i) { ranks[i] = i + 1; }
+    for (int i = ranks.size() - 1; i > 0; --i) {
+        std::swap(ranks[i], ranks[random.bounded(i + 1)]);
+    }
+
+    double total = 0;
+    popularity.clear();
+    for (int rank : ranks) {
+        total += 1.0 / rank;
+        popularity << total;
+    }
+    log << "Added " << catalog.size() << " products" << Qt::endl;
+}
+
+void DataSeeder::seedUsers(QSqlQuery &query) {
+    const int firstId = highestId(query, "SELECT COALESCE(MAX(UserID), 0) FROM users") + 1;
+
+    // One manager for every five; each logs in with their username as password
+    QVariantList values;
+    for (int i = 0; i < plan.users; ++i) {
+        int     id       = firstId + i;
+        QString role     = i % 5 == 0 ? "manager" : "cashier";
+        QString username = QString("%1%2").arg(role).arg(id, 3, 10, QChar('0'));
+        values << id << username << PasswordHash::hash(username) << role << "Active"
+               << plan.lastDay.addYears(-plan.years);
+        staff << id;
+    }
+
+    insertRows(query, "INSERT INTO users (UserID, username, password, role, status, date)", 6,
+               values, "Adding users");
+    log << "Added " << staff.size() << " users" << Qt::endl;
+}
+
+void DataSeeder::seedOrders(QSqlQuery &query) {
+    if (catalog.isEmpty() || staff.isEmpty()) { return; }
+
+    int nextOrderId = highestId(query, "SELECT COALESCE(MAX(OrderID), 0) FROM Orders") + 1;
+
+    const QDate  first = plan.lastDay.addYears(-plan.years).addDays(1);
+    const qint64 days  = first.daysTo(plan.lastDay) + 1;
+
+    qint64 orders      = 0;
+    qint64 lines       = 0;
+    qint64 monthOrders = 0;
+    int    months      = 0;
+    for (QDate day = first; day <= plan.lastDay; day = day.addDays(1)) {
+        int count = ordersOn(day, double(first.daysTo(day)) / days);
+        seedDay(query, day, count, &nextOrderId, &lines);
+        orders += count;
+        monthOrders += count;
+
+        if (day == plan.lastDay || day.addDays(1).month() != day.month()) {
+            log << day.toString("yyyy-MM") << ": " << monthOrders << " orders" << Qt::endl;
+            monthOrders = 0;
+            ++months;
+        }
+    }
+    log << "Added " << orders << " orders with " << lines << " lines over " << months
+        << " months" << Qt::endl;
+}
+
+void DataSeeder::seedDay(QSqlQuery &query, const QDate &day, int count, int *nextOrderId,
+                         qint64 *lines) {
+    // Taken in time order, so OrderID rises with OrderDate as it does at a till
+    QVector<QTime> times;
+    for (int i = 0; i < count; ++i) { times << openingTime(); }
+    std::sort(times.begin(), times.end());
+
+    QVariantList                orderValues;
+    QVariantList                lineValues;
+    QMap<QDateTime, HourTotals> hourly;
+    for (const QTime &time : times) {
+        const int orderId = (*nextOrderId)++;
+
+        // One item is the usual basket, a few run to eight
+        int lineCount = 1;
+        while (lineCount < 8 && random.generateDouble() < 0.45) { ++lineCount; }
+
+        QSet<int> picked;
+        Money     net;
+        for (int i = 0; i < lineCount; ++i) {
+            int index = pickProduct();
+            if (picked.contains(index)) { continue; }
+            picked.insert(index);
+
+            const SeedProduct &product  = catalog.at(index);
+            qint64             quantity = pickQuantity(product);
+            net += product.price.times(quantity);
+            lineValues << orderId << product.id << quantityText(quantity)
+                       << product.price.toDecimalString() << "0.00";
+        }
+        *lines += picked.size();
+
+        Money     tax  = SalesTax::taxOn(net);
+        QDateTime when(day, time);
+        orderValues << orderId << when << staff.at(random.bounded(staff.size()))
+                    << (net + tax).toDecimalString() << pickPayment();
+
+        HourTotals &hour = hourly[QDateTime(day, QTime(time.hour(), 0))];
+        hour.orders += 1;
+        hour.net += net;
+        hour.tax += tax;
+    }
+
+    QVariantList hourValues;
+    for (auto it = hourly.constBegin(); it != hourly.constEnd(); ++it) {
+        hourValues << it.key() << it.value().orders << it.value().net.cents()
+                   << it.value().tax.cents();
+    }
+
+    QSqlDatabase db = QSqlDatabase::database();
+    db.transaction();
+    insertRows(query,
+               "INSERT INTO Orders (OrderID, OrderDate, UserID, TotalAmount, payment_method)",
+               5, orderValues, "Adding orders");
+    insertRows(query,
+               "INSERT INTO OrderDetails (OrderID, ProductID, Quantity, Price, Discount)", 5,
+               lineValues, "Adding order lines");
+    // Added to what is there, as SalesHistory::recordOrder does at checkout
+    insertRows(query, "INSERT INTO sales_hourly (BucketStart, Orders, NetCents, TaxCents)", 4,
+               hourValues, "Adding hourly sales",
+               " ON DUPLICATE KEY UPDATE Orders = Orders + VALUES(Orders), "
+               "NetCents = NetCents + VALUES(NetCents), "
+               "TaxCents = TaxCents + VALUES(TaxCents)");
+    if (!db.commit()) { throw std::runtime_error(db.lastError().text().toStdString()); }
+}
+
+int DataSeeder::ordersOn(const QDate &day, double progress) {
+    // Monday to Sunday; weekends are busiest
+    static const double weekday[] = {0.85, 0.9, 0.95, 1.0, 1.15, 1.35, 1.1};
+    double factor = weekday[day.dayOfWeek() - 1];
+
+    // Slow after the holidays, busy before Christmas
+    if (day.month() == 1) { factor *= 0.85; }
+    if (day.month() == 12) { factor *= day.day() <= 24 ? 1.3 : 1.0; }
+
+    // Trade grows over the seeded years, and no two days are alike
+    factor *= 0.85 + 0.15 * progress;
+    factor *= 0.9 + 0.2 * random.generateDouble();
+    return qMax(0, int(std::lround(plan.ordersPerDay * factor)));
+}
+
+QTime DataSeeder::openingTime() {
+    // Open 7:00 to 19:59 with breakfast, lunch and after-work peaks
+    static const int hourWeights[] = {6, 12, 9, 7, 8, 12, 11, 6, 6, 7, 9, 5, 2};
+    int total = 0;
+    for (int weight : hourWeights) { total += weight; }
+
+    int pick = random.bounded(total);
+    int hour = 0;
+    while (pick >= hourWeights[hour]) { pick -= hourWeights[hour++]; }
+    return QTime(7 + hour, random.bounded(60), random.bounded(60));
+}
+
+int DataSeeder::pickProduct() {
+    double pick  = random.generateDouble() * popularity.last();
+    auto   found = std::upper_bound(popularity.constBegin(), popularity.constEnd(), pick);
+    return qMin(int(found - popularity.constBegin()), popularity.size() - 1);
+}
+
+qint64 DataSeeder::pickQuantity(const SeedProduct &product) {
+    // 100 g to 1.5 kg, weighed to the 5 g
+    if (product.weighed) { return 100 + 5 * random.bounded(281); }
+
+    double pick = random.generateDouble();
+    if (pick < 0.6) { return 1000; }
+    if (pick < 0.85) { return 2000; }
+    return 1000 * (3 + random.bounded(4));
+}
+
+QString DataSeeder::pickPayment() {
+    return random.generateDouble() < 0.55 ? "Cash" : "Card";
+}
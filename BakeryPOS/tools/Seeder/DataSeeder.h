@@ -0,0 +1,76 @@
+#ifndef DATASEEDER_H
+#define DATASEEDER_H
+
+#include "Money.h"
+
+#include <QDate>
+#include <QDateTime>
+#include <QMap>
+#include <QRandomGenerator>
+#include <QSqlQuery>
+#include <QString>
+#include <QTextStream>
+#include <QVector>
+
+struct SeedPlan {
+    quint32 seed         = 1;
+    int     products     = 10000;
+    int     users        = 12;
+    int     years        = 3;
+    int     ordersPerDay = 250;
+    QDate   lastDay; // orders run up to and including this day
+};
+
+// Fills a database with a bakery's worth of made-up data: categories, a
+// catalog, staff and years of orders with their hourly rollup. The same
+// seed and plan give the same rows every time (apart from the password
+// salts), so timings taken on two machines, or before and after a change,
+// compare like for like.
+//
+// Rows are only ever added. New products, users and orders are numbered
+// after the highest IDs already there, and each day of orders is written
+// in one transaction with multi-row INSERTs.
+class DataSeeder {
+  public:
+    DataSeeder(const SeedPlan &plan, QTextStream &log);
+
+    // Returns false with the reason in error
+    bool run(QString *error = nullptr);
+
+  private:
+    struct SeedProduct {
+        int     id = 0;
+        QString category;
+        Money   price;
+        bool    weighed = false;
+    };
+
+    struct HourTotals {
+        int   orders = 0;
+        Money net;
+        Money tax;
+    };
+
+    SeedPlan         plan;
+    QTextStream     &log;
+    QRandomGenerator random;
+
+    QVector<SeedProduct> catalog;
+    QVector<double>      popularity; // running total of each product's weight
+    QVector<int>         staff;
+
+    void seedCategories(QSqlQuery &query);
+    void seedProducts(QSqlQuery &query);
+    void seedUsers(QSqlQuery &query);
+    void seedOrders(QSqlQuery &query);
+    void seedDay(QSqlQuery &query, const QDate &day, int count, int *nextOrderId,
+                 qint64 *lines);
+
+    int     ordersOn(const QDate &day, double progress);
+    QTime   openingTime();
+    int     pickProduct();
+    qint64  pickQuantity(const SeedProduct &product);
+    QString pickPayment();
+};
+
+#endif // DATASEEDER_H
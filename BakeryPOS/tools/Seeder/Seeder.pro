@@ -0,0 +1,15 @@
+# Seeds a MySQL database with a deterministic catalog, staff and years of
+# orders, for timing the register against realistic volumes.
+QT       += core sql
+QT       -= gui
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = Seeder
+
+include(../../core.pri)
+include(seeder.pri)
+
+SOURCES += \
+    main.cpp
@@ -0,0 +1,84 @@
+// Seeds a database for timing the register: categories, --products
+// products, --users staff and --years of orders at about --orders-per-day.
+// The same --seed and --last-day always give the same data. Migrations are
+// applied first, so an empty database works. A database that already has
+// orders is left alone unless --append is given; nothing is ever deleted.
+//
+// Seeded users log in with their username as password.
+
+#include "DataSeeder.h"
+#include "SchemaMigrator.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QTextStream>
+
+static QTextStream out(stdout);
+
+static int fail(const QString &message) {
+    QTextStream(stderr) << message << Qt::endl;
+    return 1;
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication App(argc, argv);
+    App.setApplicationName("Seeder");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Deterministic test data for BakeryPOS");
+    parser.addHelpOption();
+    parser.addOption({"host", "MySQL host.", "host", "localhost"});
+    parser.addOption({"port", "MySQL port.", "port", "3306"});
+    parser.addOption({"database", "Database name.", "name", "mydb"});
+    parser.addOption({"user", "MySQL user.", "user", "root"});
+    parser.addOption({"password", "MySQL password.", "password"});
+    parser.addOption({"seed", "Random seed.", "seed", "1"});
+    parser.addOption({"products", "Products to add.", "count", "10000"});
+    parser.addOption({"users", "Users to add.", "count", "12"});
+    parser.addOption({"years", "Years of orders.", "years", "3"});
+    parser.addOption({"orders-per-day", "Orders on an average day.", "count", "250"});
+    parser.addOption({"last-day", "Last day with orders (yyyy-MM-dd), yesterday by default.",
+                      "date"});
+    parser.addOption({"append", "Add to a database that already has orders."});
+    parser.process(App);
+
+    SeedPlan plan;
+    plan.seed         = parser.value("seed").toUInt();
+    plan.products     = qMax(1, parser.value("products").toInt());
+    plan.users        = qMax(1, parser.value("users").toInt());
+    plan.years        = qMax(0, parser.value("years").toInt());
+    plan.ordersPerDay = qMax(0, parser.value("orders-per-day").toInt());
+    plan.lastDay      = parser.isSet("last-day")
+                            ? QDate::fromString(parser.value("last-day"), Qt::ISODate)
+                            : QDate::currentDate().addDays(-1);
+    if (!plan.lastDay.isValid()) { return fail("--last-day is not a yyyy-MM-dd date"); }
+
+    QSqlDatabase db = QSqlDatabase::addDatabase("QMYSQL");
+    db.setHostName(parser.value("host"));
+    db.setPort(parser.value("port").toInt());
+    db.setDatabaseName(parser.value("database"));
+    db.setUserName(parser.value("user"));
+    db.setPassword(parser.value("password"));
+    if (!db.open()) { return fail("Cannot connect: " + db.lastError().text()); }
+
+    QString error;
+    if (!SchemaMigrator::migrate(db, &error)) { return fail("Migration failed: " + error); }
+
+    QSqlQuery query;
+    if (!query.exec("SELECT EXISTS (SELECT 1 FROM Orders)") || !query.next()) {
+        return fail("Cannot read Orders: " + query.lastError().text());
+    }
+    if (query.value(0).toBool() && !parser.isSet("append")) {
+        return fail("The database already has orders; pass --append to add to them");
+    }
+
+    out << "Seeding " << db.databaseName() << " with seed " << plan.seed << ", "
+        << plan.years << " years to " << plan.lastDay.toString(Qt::ISODate) << Qt::endl;
+
+    DataSeeder seeder(plan, out);
+    if (!seeder.run(&error)) { return fail("Seeding failed: " + error); }
+    return 0;
+}
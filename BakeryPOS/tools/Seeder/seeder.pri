@@ -0,0 +1,11 @@
+# DataSeeder on its own, for the Seeder tool and the test targets under
+# tests/. Needs core.pri.
+
+INCLUDEPATH += $$PWD
+DEPENDPATH += $$PWD
+
+SOURCES += \
+    $$PWD/DataSeeder.cpp
+
+HEADERS += \
+    $$PWD/DataSeeder.h